@@ -22,16 +22,38 @@
  * ============================================================================
  */
 
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/* Identyfikatory zadań App_Tick (ślad dla crash: bieżące zadanie + zdarzenia) */
+typedef enum {
+    APP_TASK_IDLE = 0,
+    APP_TASK_INIT,
+    APP_TASK_EDGE,
+    APP_TASK_SHELL,
+    APP_TASK_LOG,        // blackbox/matchlog (zrzut, zapis FLASH)
+    APP_TASK_LUNA_TRIG,
+    APP_TASK_TANK,
+    APP_TASK_SENS,
+    APP_TASK_OLED,
+    APP_TASK_UART,
+    APP_TASK_COUNT
+} AppTask_t;
+
+const char* App_TaskName(uint8_t id);
+
 /* Jednorazowa inicjalizacja aplikacji (wywołaj po initach Cube/HAL w main.c) */
 void App_Init(void);
 
 /* Pętla zadań cyklicznych — wołana w każdej iteracji while(1) w main.c */
 void App_Tick(void);
 
+/* 1 = napęd stoi: cele i wyjścia Tank 0/0, brak ucieczki od krawędzi (erase FLASH dozwolony) */
+uint8_t App_DriveIdle(void);
+
 #ifdef __cplusplus
 }
 #endif
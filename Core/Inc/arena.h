@@ -0,0 +1,50 @@
+/*
+ * ============================================================================
+ *  MODULE: arena — statyczna arena na bufory (zamiast sterty)
+ *  ----------------------------------------------------------------------------
+ *  CO:
+ *    - Jeden statyczny blok ARENA_SIZE B w .bss; Arena_Alloc() przydziela kolejne
+ *      kawałki (wyrównanie 8 B, bez zwalniania) z etykietą do raportu.
+ *    - Arena_Seal() po App_Init(): od tej chwili każda próba przydziału zwraca NULL
+ *      i jest liczona (fails) — czas działania pętli nie zależy od alokatora.
+ *    - Statystyka: zajęte/rozmiar, liczba przydziałów, odmowy; lista w "dump mem".
+ *
+ *  KIEDY:
+ *    - Tylko przy inicjalizacji modułów (Init), dla buforów, które nie muszą być
+ *      na stosie ani w osobnym static każdego modułu (np. bufory panelu UART).
+ *    - Sterty nie ma: _Min_Heap_Size = 0, malloc w sysmem.c = pułapka (UDF), _sbrk → ENOMEM.
+ * ============================================================================
+ */
+
+#ifndef ARENA_H_
+#define ARENA_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ARENA_SIZE      512u     // B — zwiększać przy Arena_GetInfo().fails > 0
+#define ARENA_MAX_TAGS  8u       // przydziały zapamiętane z etykietą (raport)
+
+typedef struct {
+    uint32_t size;       // ARENA_SIZE
+    uint32_t used;       // zajęte (z wyrównaniem)
+    uint16_t allocs;     // udane przydziały
+    uint16_t fails;      // odmowy: brak miejsca albo po Arena_Seal()
+    uint8_t  sealed;
+} Arena_Info_t;
+
+/* Przydział z areny (8 B align); NULL = brak miejsca / zapieczętowana */
+void *Arena_Alloc(size_t size, const char *tag);
+void  Arena_Seal(void);
+void  Arena_GetInfo(Arena_Info_t *out);
+/* i-ty przydział: etykieta + rozmiar; 0 = brak */
+uint8_t Arena_GetEntry(uint8_t i, const char **tag, uint32_t *size);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* ARENA_H_ */
@@ -0,0 +1,63 @@
+/*
+ * ============================================================================
+ *  MODULE: bench — mikrobenchmarki czystej logiki (host + target, DZB_BENCH)
+ *  ----------------------------------------------------------------------------
+ *  CO:
+ *    - Tabela przypadków: rampa/EMA/okno ESC (tank_drive), Throttle_Apply,
+ *      mediana i filtry TF-Luna, TCS3472_Process (EMA) i wybór kroku auto-gain,
+ *      rysowanie znaków/tekstu SSD1306, Fmt_Fixed, render panelu OLED i koszt
+ *      komunikatu DZLOG (binarnie z -DDZB_LOG_BINARY, inaczej tekst).
+ *    - Każdy przypadek to pętla n iteracji zwracająca sumę kontrolną (wynik nie
+ *      może zostać wycięty przez optymalizator).
+ *    - Pomiar: rozgrzewka + BENCH_REPEAT powtórzeń, bierzemy minimum (najmniej
+ *      zakłóceń: przerwania na targecie, planista na hoście).
+ *    - Wynik: linie "BENCH <case> <iters> <ns/op> <cyc/op>" — parsowane przez
+ *      Tools/bench.py i porównywane z zapisaną bazą (Tools/bench/baseline_*.txt).
+ *
+ *  PORTY (weak w bench.c):
+ *    - Bench_PortCycles(): licznik cykli — target: DWT->CYCCNT (prof.h),
+ *      host: Tools/host/bench_main.c (zegar monotoniczny przeliczony na „cykle”).
+ *    - Bench_PortHz(): częstotliwość licznika — target: SystemCoreClock.
+ *    - Bench_PortPrint(): jedna linia wyniku — target: DebugUART_Crit (czeka na miejsce).
+ *
+ *  KIEDY:
+ *    - Tylko build z -DDZB_BENCH (target: shell "bench"; host: Tools/bench.py).
+ *      Bez flagi moduł jest pusty, a akcesory statycznych funkcji nie istnieją.
+ *    - Na targecie blokuje pętlę główną na ~kilkadziesiąt ms — tylko na postoju.
+ * ============================================================================
+ */
+
+#ifndef BENCH_H_
+#define BENCH_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef DZB_BENCH
+
+#define BENCH_REPEAT  5u          // powtórzeń pomiaru (minimum z nich)
+
+typedef struct {
+    const char *name;             // "modul.funkcja" — klucz w pliku bazowym
+    uint32_t  (*fn)(uint32_t n);  // n iteracji → suma kontrolna
+    uint32_t    iters;            // iteracje na targecie (host: × scale)
+} Bench_Case_t;
+
+/* Przypadki z nazwą zaczynającą się od prefix (NULL/"" = wszystkie); scale mnoży
+   iteracje (target: 1, host: np. 50). Zwraca liczbę wykonanych przypadków. */
+uint16_t Bench_Run(const char *prefix, uint32_t scale);
+
+/* Porty (weak) */
+uint32_t Bench_PortCycles(void);
+uint32_t Bench_PortHz(void);
+void     Bench_PortPrint(const char *line);
+
+#endif /* DZB_BENCH */
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* BENCH_H_ */
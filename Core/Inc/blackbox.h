@@ -0,0 +1,93 @@
+/*
+ * ============================================================================
+ *  MODULE: blackbox — rejestrator „czarna skrzynka” w SRAM2
+ *  ----------------------------------------------------------------------------
+ *  CO:
+ *    - Pierścień bloków (BLACKBOX_BLOCKS × BLACKBOX_BLOCK_SIZE) w SRAM2 (sekcja
+ *      .ram2_noinit — startup jej nie zeruje). Rekord na każdy tick Tank: czas,
+ *      cel/stan napędu, µs ESC, TF-Luna, clear TCS, czasy zadań, flagi krawędzi.
+ *    - Kompresja strumieniowa: pierwszy rekord bloku = keyframe (pełne wartości),
+ *      kolejne = delty względem poprzedniego (czas: delta drugiego rzędu), zigzag +
+ *      varint, maska zmienionych pól na początku. Blok dekoduje się samodzielnie;
+ *      pełny pierścień gubi najstarszy blok w całości. Rekord ≤ BB_ENC_MAX B,
+ *      koszt kodowania stały (15 pól).
+ *    - SRAM2 przeżywa reset ciepły (pin, watchdog, software, BOR bez zaniku zasilania):
+ *      po takim starcie log poprzedniej sesji jest nadal w pamięci.
+ *    - Reset „nienormalny” (watchdog, software/fault, BOR) albo BlackBox_Freeze()
+ *      → log ZAMROŻONY (bez nadpisywania) i automatyczny zrzut po UART.
+ *      Log zamrożony przy starcie: po pełnym zrzucie (automatycznym albo "bb dump/raw")
+ *      nagrywanie wraca samo — jeden brown-out nie wyłącza rejestracji (ani matchlogu)
+ *      na resztę dnia. Freeze w trakcie sesji ("bb freeze") trzyma log do "bb arm".
+ *    - Zrzut CSV (dekodowany na MCU) albo surowe bloki hex ("bb raw" →
+ *      Tools/bb_decode.py) w pasie CRIT, stronicowany (BlackBox_DumpPoll nigdy nie czeka na UART);
+ *      w trakcie zrzutu nagrywanie wstrzymane (pierścień się nie przesuwa).
+ *
+ *  KIEDY:
+ *    - BlackBox_Init() na początku App_Init() (czyta i kasuje flagi resetu RCC->CSR).
+ *    - BlackBox_Push() co tick Tank; BlackBox_DumpPoll() co iterację App_Tick().
+ *    - Po power-on SRAM2 ma losową zawartość → nagłówek nieważny → czysty log.
+ * ============================================================================
+ */
+
+#ifndef BLACKBOX_H_
+#define BLACKBOX_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BLACKBOX_BLOCK_SIZE  256u   // blok = keyframe + delty (niezależnie dekodowalny)
+#define BLACKBOX_BLOCKS      48u    // 48 × 256 B = 12 KB SRAM2 (~7–10 B/rekord → ~25–35 s przy 50 Hz)
+#define BB_ENC_MAX           48u    // najgorszy przypadek rekordu po kodowaniu (B)
+
+/* flags rekordu */
+#define BB_F_EDGE_R     0x01u    // krawędź widziana przez prawy TCS
+#define BB_F_EDGE_L     0x02u    // krawędź widziana przez lewy TCS
+#define BB_F_ESCAPE     0x04u    // manewr ucieczki (edge_detect)
+#define BB_F_OVERRIDE   0x08u    // Tank w trybie override
+#define BB_F_BOOT       0x80u    // pierwszy rekord sesji (po starcie)
+
+typedef struct {
+    uint32_t t_ms;               // HAL_GetTick()
+    int8_t   tgt_l, tgt_r;       // cel Tank (%)
+    int8_t   cur_l, cur_r;       // po rampie (%)
+    uint16_t esc_r_us, esc_l_us; // impuls ESC (µs)
+    uint16_t luna_r, luna_l;     // dystans TF-Luna (cm, filtrowany)
+    uint16_t clr_r, clr_l;       // kanał clear TCS
+    uint16_t dt_ms;              // odstęp od poprzedniego ticku Tank
+    uint16_t tank_us;            // czas Tank_Update()
+    uint16_t loop_us;            // maks. czas App_Tick() od poprzedniego rekordu
+    uint8_t  flags;              // BB_F_*
+    uint8_t  rsv;
+} BlackBox_Rec_t;
+
+typedef struct {
+    uint16_t count;              // rekordy w logu
+    uint16_t blocks;             // bloki zajęte (z BLACKBOX_BLOCKS)
+    uint16_t bytes;              // bajty zakodowanych rekordów
+    uint16_t boots;              // starty od ostatniego "bb arm"/power-on
+    uint8_t  reset_flags;        // RCC->CSR[31:24] z tego startu
+    uint8_t  frozen;             // 1 = log zamrożony (nie nadpisywany)
+    uint8_t  dumping;            // 1 = zrzut w toku
+} BlackBox_Info_t;
+
+void    BlackBox_Init(void);
+void    BlackBox_Push(const BlackBox_Rec_t *r);
+void    BlackBox_Freeze(void);           // bezpieczne także z handlera błędu
+void    BlackBox_Arm(void);              // wyczyść log i nagrywaj
+void    BlackBox_DumpStart(uint8_t raw);   // 0 = CSV, 1 = bloki hex (Tools/bb_decode.py)
+void    BlackBox_DumpPoll(void);
+void    BlackBox_GetInfo(BlackBox_Info_t *out);
+
+/* Bloki zamknięte tej sesji (matchlog): numer bieżącego (otwartego) bloku;
+ * Peek(n) = blok n (len w [0..1] LE), NULL gdy otwarty, nadpisany lub z poprzedniej sesji */
+uint32_t       BlackBox_BlockSeq(void);
+const uint8_t* BlackBox_PeekBlock(uint32_t seq);
+uint8_t BlackBox_ResetFlags(void);       // RCC->CSR[31:24] zapamiętane w Init
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* BLACKBOX_H_ */
@@ -0,0 +1,67 @@
+/*
+ * ============================================================================
+ *  MODULE: cfg_store — trwała konfiguracja we FLASH (emulacja EEPROM)
+ *  ----------------------------------------------------------------------------
+ *  CO:
+ *    - Dwie ostatnie strony FLASH (2 × 2 KB, region FLASH_CFG w linkerze) pracują
+ *      naprzemiennie (ping-pong). Strona: nagłówek {magic, seq} + log rekordów.
+ *    - Rekord: {magic, blok, wersja, len} + dane (do 8 B) + {CRC32, COMMIT}.
+ *      Programowanie po double-word (64 bit); trailer z CRC zapisywany OSTATNI
+ *      (przerwany zapis = zły CRC → rekord pominięty).
+ *    - Nowe wartości dopisywane na koniec logu (wear-levelling); pełna strona →
+ *      kompaktowanie: erase drugiej strony, wszystkie bloki z RAM, nagłówek z seq+1
+ *      na końcu (atomowa zamiana — do zapisu nagłówka aktywna jest stara strona).
+ *    - Bloki i wersje z config.c (CFG_Blocks). Inna wersja/rozmiar → rekord ignorowany,
+ *      zostają domyślne z config.c. Pole spoza zakresu z CFG_Fields() (np. tick_ms = 0)
+ *      → cały blok odrzucony przy Load (rejected), też zostają domyślne.
+ *
+ *  KIEDY:
+ *    - CfgStore_Load() na starcie, PRZED inicjalizacją modułów (czas ograniczony:
+ *      2 nagłówki + max 128 rekordów na stronie).
+ *    - CfgStore_Save() z shella ("store save") — blokuje pętlę (zapis ~ms, erase ~25 ms):
+ *      nie w trakcie walki.
+ *    - Dostęp do FLASH przez weak porty (CfgStore_Port*) — podmiana na symulację hosta.
+ * ============================================================================
+ */
+
+#ifndef CFG_STORE_H_
+#define CFG_STORE_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CFGS_PAGE_SIZE   2048u          // strona FLASH STM32L432
+#define CFGS_PAGES       2u             // ping-pong
+
+typedef struct {
+    int8_t   active;                    // aktywna strona (0/1), −1 = brak
+    uint32_t seq;                       // numer generacji aktywnej strony
+    uint16_t used;                      // bajty zajęte w aktywnej stronie
+    uint8_t  loaded;                    // bloki wczytane przy ostatnim Load
+    uint8_t  bad;                       // rekordy z błędnym CRC/układem
+    uint8_t  rejected;                  // bloki z polem spoza zakresu (zostały domyślne)
+} CfgStore_Info_t;
+
+/* Wczytaj zapisane bloki do RAM configu; zwraca liczbę wczytanych bloków */
+uint8_t CfgStore_Load(void);
+
+/* Zapisz bloki różne od zapisanych; 1 = OK, 0 = błąd FLASH */
+uint8_t CfgStore_Save(void);
+
+/* Skasuj obie strony (po restarcie: wartości domyślne z config.c); 1 = OK */
+uint8_t CfgStore_Erase(void);
+
+void CfgStore_GetInfo(CfgStore_Info_t *out);
+
+/* Porty FLASH (weak; domyślnie HAL) — adresy względne w obszarze magazynu */
+const uint8_t* CfgStore_PortBase(void);
+uint8_t        CfgStore_PortErase(uint8_t page);
+uint8_t        CfgStore_PortProgram(uint32_t offset, uint64_t dword);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* CFG_STORE_H_ */
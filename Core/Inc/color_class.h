@@ -0,0 +1,69 @@
+/*
+ * ============================================================================
+ *  MODULE: color_class — klasyfikacja koloru TCS3472 (czarny ring / biała krawędź)
+ *  ----------------------------------------------------------------------------
+ *  CO:
+ *    - Chromatyczność r/c, g/c, b/c w stałym przecinku Q10 (1024 = 1.0).
+ *    - Jasność znormalizowana: Clear / (gain × cykle ATIME) w Q4 → niezależna
+ *      od auto-gain/ATIME drivera.
+ *    - Tabela wzorców w FLASH (const): BLACK, WHITE (+ UNKNOWN, gdy nic nie pasuje).
+ *    - Wynik: klasa + pewność 0..255; koszt stały (tabela o stałej długości, bez float).
+ *    - Tryb kalibracji: polecenia shella UART (cal b = czerń, cal w = biel, cal p = wydruk) —
+ *      uśrednia COLOR_CAL_SAMPLES świeżych próbek z obu czujników i drukuje
+ *      gotowy wiersz do wklejenia w k_color_table[].
+ *
+ *  KIEDY:
+ *    - ColorClass_Classify() — dowolnie (np. w panelu UART / logice taktyki).
+ *    - ColorClass_CaptureTick() — po każdym odczycie TCS w App_Tick() (NULL = brak próbki).
+ *    - ColorClass_RequestCapture() — z shella UART (albo z ISR: tylko flaga).
+ * ============================================================================
+ */
+
+#ifndef COLOR_CLASS_H_
+#define COLOR_CLASS_H_
+
+#include <stdint.h>
+#include "tcs3472.h"   // TCS3472_Data_t
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define COLOR_Q_ONE          1024u   // 1.0 w Q10
+#define COLOR_CAL_SAMPLES    16u     // świeże próbki na jeden wzorzec kalibracji
+
+typedef enum {
+    COLOR_UNKNOWN = 0,
+    COLOR_BLACK   = 1,               // czarny ring dohyo
+    COLOR_WHITE   = 2,               // biała krawędź
+    COLOR_CLASS_COUNT
+} ColorClass_t;
+
+/* Wzorzec (FLASH): środek chromatyczności + jasność + tolerancje */
+typedef struct {
+    ColorClass_t cls;
+    uint16_t     r_q, g_q, b_q;      // chromatyczność Q10
+    uint16_t     bright_q4;          // jasność Q4 (Clear / (gain·cykle))
+    uint16_t     tol_chroma_q;       // tolerancja Σ|Δchroma| (Q10)
+    uint8_t      tol_bright_pct;     // tolerancja jasności (% wzorca)
+} ColorRef_t;
+
+typedef struct {
+    ColorClass_t cls;                // klasa (UNKNOWN, gdy poza tolerancją)
+    uint8_t      conf;               // pewność 0..255 (255 = środek wzorca)
+    uint16_t     r_q, g_q, b_q;      // policzona chromatyczność Q10
+    uint16_t     bright_q4;          // policzona jasność Q4
+} ColorResult_t;
+
+ColorResult_t ColorClass_Classify(const TCS3472_Data_t *d);
+const char*   ColorClass_Name(ColorClass_t c);
+
+/* Kalibracja przez UART */
+void ColorClass_RequestCapture(ColorClass_t c);   // ISR-safe (ustawia flagę)
+void ColorClass_RequestPrint(void);               // ISR-safe
+void ColorClass_CaptureTick(const TCS3472_Data_t *right, const TCS3472_Data_t *left);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* COLOR_CLASS_H_ */
@@ -3,9 +3,11 @@
  *  MODULE: config.h — Jedno źródło prawdy dla parametrów projektu DzikiBoT
  * -----------------------------------------------------------------------------
  *  CO:
- *    - Struktury konfiguracyjne (Motors, TF-Luna, TCS3472, Scheduler).
+ *    - Struktury konfiguracyjne (Motors, TF-Luna, TCS3472, Edge, Scheduler).
  *    - Enum TCS_Gain_t.
  *    - Prototypy getterów CFG_*() oraz (opcjonalnie) getterów tuningu TCS.
+ *    - Tabela pól CFG_Fields() — strojenie na żywo z shella UART (set/get/list).
+ *    - Tabela bloków CFG_Blocks() — zapis/odczyt we FLASH (cfg_store, wersjonowane).
  *
  *  JAK CZYTAĆ:
  *    - Wartości domyślne są w config.c — tylko tam stroimy.
@@ -45,29 +47,117 @@ typedef struct {
     uint8_t  ma_win;                 // okno średniej kroczącej (trend)
     float    temp_scale;             // skala temperatury (zwykle 1.0)
     float    temp_offset_c;          // offset ambientu względem temp. układu
-    int16_t  dist_offset_right_mm;   // offset dystansu (prawy)
-    int16_t  dist_offset_left_mm;    // offset dystansu (lewy)
+    uint8_t  trigger_mode;           // 0 = ciągły (FPS sensora), 1 = one-shot zsynchronizowany z tickiem Tank
+    uint8_t  trig_lead_ms;           // wyprzedzenie triggera przed tickiem Tank (≥ czas jednego pomiaru)
+    uint8_t  provision;              // 1 = przy starcie przeadresuj 0x10 → jedyny milczący addr7 magistrali
 } ConfigLuna_t;
 
+/* ==== TF-LUNA: tabela czujników (N sztuk, wiele na jednej magistrali) ==== */
+typedef enum {
+    CFG_BUS_I2C1 = 0,
+    CFG_BUS_I2C3 = 1
+} CFG_I2CBus_t;
+
+typedef struct {
+    CFG_I2CBus_t bus;                // magistrala (I2C1 / I2C3)
+    uint8_t      addr7;              // adres 7-bit (fabrycznie 0x10; unikalny w obrębie magistrali)
+    int16_t      dist_offset_mm;     // offset dystansu (mm; driver przelicza na cm)
+    const char  *name;               // krótka etykieta (UART/OLED)
+} ConfigLunaDev_t;
+
 /* ==== TCS3472 ==== */
 typedef struct {
     uint16_t   atime_ms;             // czas integracji (≈ czułość)
     TCS_Gain_t gain;                 // gain startowy (auto-gain przejmie po starcie)
+    uint16_t   atime_min_ms;         // dolna granica ATIME dla auto-ATIME (min. 2.4 ms)
+    uint16_t   atime_max_ms;         // górna granica ATIME (min==max → sam auto-gain)
 } ConfigTCS_t;
 
+/* ==== TCS3472: tabela czujników (adres stały 0x29 → max 1 na magistralę bez muxa) ==== */
+typedef struct {
+    CFG_I2CBus_t bus;                // magistrala (I2C1 / I2C3)
+    const char  *name;               // krótka etykieta (UART/OLED/log gain)
+} ConfigTcsDev_t;
+
+/* ==== EDGE DETECT (krawędź dohyo na TCS3472, tryb szybki) ==== */
+typedef struct {
+    uint8_t    enable;               // 1 = detektor aktywny (TCS w trybie szybkim)
+    uint8_t    poll_ms;              // okres odczytu Clear (≥ ATIME; 0 = każda pętla)
+    uint8_t    atime_cycles;         // ATIME w cyklach 2.4 ms (1..4)
+    TCS_Gain_t gain;                 // stały gain w trybie szybkim
+    uint8_t    cal_samples;          // ile próbek na kalibrację poziomu czerni (start)
+    uint16_t   delta_on;             // próg wejścia: Clear ≥ czerń + delta_on  (zliczenia)
+    uint16_t   delta_off;            // próg wyjścia: Clear ≤ czerń + delta_off (histereza)
+    uint8_t    confirm;              // ile kolejnych próbek ≥ progu do detekcji (1 = najszybciej)
+    int8_t     rev_pct;              // manewr: moc cofania (0..100)
+    uint16_t   rev_ms;               // manewr: czas cofania od detekcji (z neutral_dwell)
+    int8_t     turn_pct;             // manewr: moc obrotu (0..100)
+    uint16_t   turn_ms;              // manewr: czas obrotu (od krawędzi)
+} ConfigEdge_t;
+
 /* ==== SCHEDULER ==== */
 typedef struct {
     uint16_t sens_ms;                // rytm sensorów (TF-Luna + TCS)
     uint16_t oled_ms;                // rytm OLED
-    uint16_t uart_ms;                // rytm UART
+    uint16_t uart_ms;                // rytm UART (start; stały, gdy uart_adapt=0)
+    uint8_t  uart_adapt;             // 1 = okres/poziom panelu UART wg zajętości i dropów kolejki
+    uint8_t  uart_util_pct;          // cel wykorzystania łącza (% przepływności)
+    uint16_t uart_min_ms;            // adaptacja: najkrótszy okres
+    uint16_t uart_max_ms;            // adaptacja: najdłuższy okres (powyżej → panel skrócony)
 } ConfigScheduler_t;
 
+/* ==== Tabela pól (strojenie na żywo: shell get/set/list) ==== */
+typedef enum {
+    CFG_T_U8 = 0,
+    CFG_T_I8,
+    CFG_T_U16,
+    CFG_T_U32,
+    CFG_T_F32,
+    CFG_T_GAIN                       // TCS_Gain_t (0..3 = 1×/4×/16×/60×)
+} CFG_Type_t;
+
+typedef struct {
+    const char *block;               // "motors" / "luna" / "tcs" / "edge" / "sched"
+    const char *name;                // nazwa pola (jak w strukturze)
+    CFG_Type_t  type;
+    void       *ptr;                 // adres pola w bloku (RAM)
+    float       min, max;            // dozwolony zakres
+    uint8_t     live;                // 1 = efekt od następnego ticku, 0 = po restarcie
+} CFG_Field_t;
+
+/* ==== Bloki do zapisu we FLASH (cfg_store) ==== */
+#define CFG_BLOCKS_MAX  8u
+
+typedef struct {
+    uint8_t     id;                  // stały identyfikator bloku w magazynie
+    uint8_t     version;             // podbij przy zmianie układu struktury (stare rekordy → ignorowane)
+    void       *ptr;                 // blok w RAM
+    uint16_t    size;                // sizeof(struktury)
+    const char *name;
+} CFG_Block_t;
+
 /* ==== Gettery (jedyny sposób dostępu) ==== */
 const ConfigMotors_t*     CFG_Motors(void);
 const ConfigLuna_t*       CFG_Luna(void);
+const ConfigLunaDev_t*    CFG_LunaDevs(uint8_t *count);   // tabela czujników; [0]=Right, [1]=Left
 const ConfigTCS_t*        CFG_TCS(void);
+const ConfigTcsDev_t*     CFG_TcsDevs(uint8_t *count);    // tabela czujników; [0]=Right, [1]=Left
+const ConfigEdge_t*       CFG_Edge(void);
 const ConfigScheduler_t*  CFG_Scheduler(void);
 
+/* Pola do strojenia: lista, wyszukanie "blok.pole", odczyt/zapis (zapis z kontrolą zakresu
+ * i reguł bloku); Conflict = reguła, którą złamałoby f = v (NULL = brak) — komunikat shella */
+const CFG_Field_t* CFG_Fields(uint8_t *count);
+const CFG_Field_t* CFG_FieldFind(const char *path);
+float              CFG_FieldGet(const CFG_Field_t *f);
+uint8_t            CFG_FieldSet(const CFG_Field_t *f, float v);
+const char*        CFG_FieldConflict(const CFG_Field_t *f, float v);
+
+/* Bloki skalarne do trwałego zapisu (cfg_store); BlockCheck(ptr bloku): reguły między
+ * polami (np. esc_max_pct > esc_start_pct) — NULL = spójny, inaczej opis reguły */
+const CFG_Block_t* CFG_Blocks(uint8_t *count);
+const char*        CFG_BlockCheck(const void *blk);
+
 /* ============================================================================
  *  OPCJONALNE GETTERY TUNINGU TCS (override „weak” z drivera — bez zmiany struktur)
  *  Zakresy:
@@ -0,0 +1,62 @@
+/*
+ * ============================================================================
+ *  MODULE: crash — przechwycenie HardFault/MemManage/BusFault/UsageFault
+ *  ----------------------------------------------------------------------------
+ *  CO:
+ *    - Handlery błędów (naked, w crash.c — CubeMX ich nie generuje): ramka stosu
+ *      (r0–r3, r12, lr, pc, xPSR), CFSR/HFSR/MMFAR/BFAR, bieżące zadanie App i
+ *      ostatnie CRASH_EVENTS zdarzeń harmonogramu → rekord w SRAM2 (.ram2_noinit,
+ *      przeżywa reset).
+ *    - Potem: ESC_FailSafe() (neutral rejestrami TIM1), BlackBox_Freeze(),
+ *      NVIC_SystemReset() — robot wraca do startu w neutralu w ~µs, nie „zamarza”.
+ *    - Raport przy następnym starcie (Crash_Report) + "crash" w shellu.
+ *
+ *  KIEDY:
+ *    - Crash_Task()/Crash_Event() w App_Tick na wejściu do zadań (kilka zapisów do RAM).
+ *    - Crash_Report() w App_Init po starcie UART.
+ * ============================================================================
+ */
+
+#ifndef CRASH_H_
+#define CRASH_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CRASH_EVENTS  16u     // ostatnie zdarzenia harmonogramu (potęga 2)
+
+/* Ślad zadań: zdarzenie = (t_ms mod 2^24 << 8) | id zadania */
+typedef struct {
+    volatile uint8_t  task;   // bieżące zadanie (AppTask_t)
+    volatile uint8_t  head;
+    volatile uint32_t ev[CRASH_EVENTS];
+} Crash_Trace_t;
+
+extern Crash_Trace_t g_crashTrace;
+
+static inline void Crash_Task(uint8_t id)
+{
+    g_crashTrace.task = id;
+}
+
+static inline void Crash_Event(uint8_t id, uint32_t now)
+{
+    g_crashTrace.task = id;
+    g_crashTrace.ev[g_crashTrace.head & (CRASH_EVENTS - 1u)] = (now << 8) | id;
+    g_crashTrace.head = (uint8_t)(g_crashTrace.head + 1u);
+}
+
+/* Raport ostatniego błędu (CRIT); force = 1 → także już zgłoszony. Zwraca 1, gdy był rekord. */
+uint8_t Crash_Report(uint8_t force);
+void    Crash_Clear(void);
+
+/* Wejście z handlerów (asm): frame = MSP/PSP z ramką, exc_return = LR */
+void    Crash_FaultEntry(uint32_t *frame, uint32_t exc_return);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* CRASH_H_ */
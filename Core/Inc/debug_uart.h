@@ -7,12 +7,21 @@
  *   - DebugUART_Init()       : inicjalizacja z uchwytem HAL UART (np. &huart2).
  *   - DebugUART_Print()      : szybkie wysłanie stringa + CRLF (enqueue, bez blokowania).
  *   - DebugUART_Printf()     : printf -> enqueue + CRLF (bez blokowania).
- *   - DebugUART_SensorsDual(): dwukolumnowy panel (RIGHT I2C1 | LEFT I2C3).
+ *   - DebugUART_SensorsDual(): dwukolumnowy panel (RIGHT I2C1 | LEFT I2C3) — różnicowy:
+ *     po pierwszym rysowaniu wysyła tylko zmienione pola (ESC[r;cH).
  *   - DebugUART_Dropped()    : licznik bajtów utraconych przy przepełnieniu kolejki TX.
+ *   - (NOWE) DebugUART_Crit()/CritPrintf(): pas krytyczny (init, gain, kalibracja, błędy).
+ *   - (NOWE) DebugUART_FrameBegin()/FrameEnd(): ramka BULK — cała albo wcale.
+ *   - (NOWE) DebugUART_GetLaneStats(): dropy i latencja per pas.
+ *   - (NOWE) DebugUART_SensorsCompact(): 1-liniowy panel (tryb oszczędny łącza).
  *   - (NOWE) DebugUART_PrintJitter(): 1-liniowy raport jittera rytmu napędu (Tank).
+ *   - (NOWE) DebugUART_OnRxChar(): weak hook RX (bajt po bajcie, kontekst ISR).
+ *   - (NOWE) DebugUART_ReadChar(): kolejka RX zasilana z ISR (czyta shell w pętli).
  *
  * Założenia:
  *   - TX realizowany przez HAL_UART_Transmit_IT z wewnętrznego bufora kołowego.
+ *   - Kolejka SPSC: Print/Printf wołamy TYLKO z pętli głównej (jeden producent);
+ *     z ISR — ustaw flagę i drukuj w pętli.
  *   - Brak HAL_MAX_DELAY i brak blokad pętli głównej — nadmiar danych jest odrzucany.
  */
 
@@ -25,11 +34,52 @@
 extern "C" {
 #endif
 
-/* Rozmiar bufora TX (bajtów). 1024 to bezpieczne minimum dla Twojego panelu. */
+/* Rozmiar bufora TX BULK (bajtów, potęga 2). Cała ramka panelu (~1.1 kB) musi się zmieścić. */
 #ifndef DEBUG_UART_RB_SIZE
-#define DEBUG_UART_RB_SIZE 1024u
+#define DEBUG_UART_RB_SIZE 2048u
 #endif
 
+/* Rozmiar bufora TX CRIT (bajtów, potęga 2) — krótkie, rzadkie linie. */
+#ifndef DEBUG_UART_CRIT_RB_SIZE
+#define DEBUG_UART_CRIT_RB_SIZE 512u
+#endif
+
+/* Zapas pasa CRIT tylko dla zdarzeń (gain, krawędź, błąd, dzlog): stronicowanie shella
+ * i zrzuty (blackbox, matchlog) piszą wyłącznie przez DebugUART_CritRoom(), więc nawet
+ * w trakcie zrzutu tyle bajtów zostaje wolne na linie zdarzeń. */
+#ifndef DEBUG_UART_CRIT_RESERVE
+#define DEBUG_UART_CRIT_RESERVE 128u
+#endif
+
+/* Rozmiar kolejki RX (bajtów, potęga 2) — bufor między ISR a shellem. */
+#ifndef DEBUG_UART_RX_SIZE
+#define DEBUG_UART_RX_SIZE 128u
+#endif
+
+/* Panel różnicowy: wymuszone pełne przerysowanie co tyle ms (resynchronizacja terminala). */
+#ifndef DEBUG_UART_REPAINT_MS
+#define DEBUG_UART_REPAINT_MS 5000u
+#endif
+
+/* Pasy kolejki TX */
+typedef enum {
+    DEBUG_UART_LANE_CRIT = 0,   // wysyłany przed BULK, ramki całe albo wcale
+    DEBUG_UART_LANE_BULK = 1,   // panel/telemetria, odrzucany całymi ramkami
+    DEBUG_UART_LANES
+} DebugUART_Lane_t;
+
+/* Statystyki pasa */
+typedef struct {
+    uint32_t frames_ok;         // ramki przyjęte do kolejki
+    uint32_t frames_dropped;    // ramki odrzucone w całości (pas pełny)
+    uint32_t bytes_dropped;     // bajty odrzuconych ramek
+    uint32_t lat_last_ms;       // ostatnia próbka latencji commit → ostatni bajt wysłany
+    uint32_t lat_max_ms;        // maksimum latencji od startu
+    uint32_t last_frame_bytes;  // rozmiar ostatniej ramki (przyjętej lub odrzuconej)
+    uint32_t used;              // bieżąca zajętość (B)
+    uint32_t size;              // rozmiar bufora (B)
+} DebugUART_LaneStats_t;
+
 /* =============================== API ================================== */
 
 /* Inicjalizacja: zapamiętujemy uchwyt UART, czyścimy kolejkę TX. */
@@ -41,6 +91,28 @@ void DebugUART_Print(const char *msg);
 /* Wysłanie sformatowanego tekstu (printf) + CRLF, nieblokujące (enqueue). */
 void DebugUART_Printf(const char *fmt, ...);
 
+/* Pas krytyczny: linia + CRLF wysyłana przed BULK; w pętli bez czekania — gdy pas pełny,
+ * linia odrzucona w całości i policzona (frames_dropped). Długie wydruki porcjuj wg
+ * wolnego miejsca (DebugUART_GetLaneStats). Tylko z pętli głównej, nie z ISR. */
+void DebugUART_Crit(const char *msg);
+void DebugUART_CritPrintf(const char *fmt, ...);
+
+/* Wydruki wieloliniowe w CRIT (strony shella, zrzuty): 1 = linia do line_max B zmieści się
+ * i zostawi DEBUG_UART_CRIT_RESERVE B na zdarzenia. Inaczej odczekaj (następny Poll). */
+uint8_t DebugUART_CritRoom(size_t line_max);
+
+/* Start: 1 (od DebugUART_Init) = CRIT czeka na miejsce (max 100 ms na linię) — log startu
+ * bez strat; koniec App_Init → 0 (pętla główna nigdy nie czeka na UART). */
+void DebugUART_SetCritWait(uint8_t on);
+
+/* Surowe bajty do pasa (np. rekordy dzlog): CRIT/BULK: 1 = przyjęte, 0 = odrzucone. Bez CRLF. */
+uint8_t DebugUART_WriteRaw(DebugUART_Lane_t lane, const void *data, size_t len);
+
+/* Ramka BULK: Print/Printf między Begin i End trafiają do kolejki w całości albo wcale.
+ * Poza ramką każda linia jest osobną ramką. End zwraca 1 = przyjęta, 0 = odrzucona. */
+void    DebugUART_FrameBegin(void);
+uint8_t DebugUART_FrameEnd(void);
+
 /* Panel dwukolumnowy — zgodny z baseline (działa na danych driverów). */
 #include "tf_luna_i2c.h"   // TF_LunaData_t, TF_Luna_AmbientEstimateC()
 #include "tcs3472.h"       // TCS3472_Data_t
@@ -48,10 +120,30 @@ void DebugUART_SensorsDual(
     const TF_LunaData_t *RightLuna, const TF_LunaData_t *LeftLuna,
     const TCS3472_Data_t *RightColor, const TCS3472_Data_t *LeftColor);
 
+/* Panel skrócony — jedna linia (dystans, clear, klasa koloru); dla słabego łącza. */
+void DebugUART_SensorsCompact(
+    const TF_LunaData_t *RightLuna, const TF_LunaData_t *LeftLuna,
+    const TCS3472_Data_t *RightColor, const TCS3472_Data_t *LeftColor);
+
 /* Getter liczby bajtów, których nie udało się wstawić do kolejki (przepełnienie). */
 uint32_t DebugUART_Dropped(void);
 
-/* NOWE: 1-liniowy raport jittera; valid=0 → komunikat „zbieram próbki...” */
+/* Statystyki pasa (dropy, latencja, zajętość). */
+void DebugUART_GetLaneStats(DebugUART_Lane_t lane, DebugUART_LaneStats_t *out);
+
+/* Najdłuższy czas zapisu producenta do kolejki TX (µs, DWT) — dawniej cały ten czas był z IRQ off.
+ * To tylko koszt Write w pętli, NIE latencja do wysłania: ta (commit → ostatni bajt na linii)
+ * jest w DebugUART_LaneStats_t.lat_* — oba w "dump uart". */
+uint32_t DebugUART_WriteMaxUs(void);
+
+/* NOWE: hook RX — wołany z przerwania dla każdego bajtu; nadpisz (np. w app.c).
+ * Tylko krótkie akcje (flagi) — bez Printf w ISR. */
+void DebugUART_OnRxChar(char c);
+
+/* RX z kolejki (pętla główna, nieblokujące): bajt 0..255 albo -1 = brak danych. */
+int DebugUART_ReadChar(void);
+
+/* NOWE: 1-liniowy raport jittera; valid=0 → komunikat „zbieram probki...” */
 void DebugUART_PrintJitter(uint32_t tick_ms,
                            uint32_t jMin_ms,
                            uint32_t jAvg_ms,
@@ -15,6 +15,7 @@
 
 void DriveTest_Start(void);
 void DriveTest_Tick(void);
+void DriveTest_Stop(void);   /* przerwij scenariusz → cel 0/0 */
 bool DriveTest_IsRunning(void);
 
 #endif /* DRIVE_TEST_H */
@@ -0,0 +1,124 @@
+/*
+ * ============================================================================
+ *  MODULE: dzlog — logowanie binarne po ID (format rozwiązywany na hoście)
+ *  ----------------------------------------------------------------------------
+ *  CO:
+ *    - DZLOG()/DZLOG_CRIT(): jak Printf/CritPrintf, ale z flagą DZB_LOG_BINARY
+ *      MCU NIE formatuje tekstu. Format trafia do sekcji .dzlog (INFO — tylko w ELF,
+ *      0 B we FLASH), a jego adres w tej sekcji jest ID komunikatu.
+ *    - Na UART idzie: [0x00][len][ID lo][ID hi][argumenty (len B)].
+ *      Argumenty wg typu (_Generic): liczby całkowite → 4 B LE, float/double → f32,
+ *      char* → [n][n B] (max DZLOG_STR_MAX).
+ *    - Tools/dzlog_decode.py <firmware.elf> — dekoder strumienia (tekst ANSI panelu
+ *      przechodzi bez zmian; tekst nigdy nie zawiera bajtu 0x00).
+ *    - Bez DZB_LOG_BINARY makra = DebugUART_Printf/CritPrintf (zachowanie jak dotąd).
+ *
+ *  KIEDY:
+ *    - Tylko z pętli głównej (kolejka TX SPSC), max 8 argumentów, bez 64-bit.
+ *    - Flaga kompilacji: -DDZB_LOG_BINARY (CubeIDE: Preprocessor → Defined symbols).
+ * ============================================================================
+ */
+
+#ifndef DZLOG_H_
+#define DZLOG_H_
+
+#include <stdint.h>
+#include "debug_uart.h"   // DebugUART_Lane_t, DebugUART_WriteRaw(), DebugUART_Printf()
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DZLOG_SYNC         0x00u   // znacznik rekordu binarnego w strumieniu
+#define DZLOG_HDR_LEN      4u      // sync + len + ID(2)
+#define DZLOG_PAYLOAD_MAX  48u     // max bajtów argumentów w rekordzie
+#define DZLOG_STR_MAX      24u     // max znaków argumentu %s
+
+#ifdef DZB_LOG_BINARY
+
+/* Rekord w budowie (na stosie wywołującego) */
+typedef struct {
+    uint8_t buf[DZLOG_HDR_LEN + DZLOG_PAYLOAD_MAX];
+    uint8_t n;                     // bajty w buf
+    uint8_t overflow;              // 1 = argumenty się nie zmieściły → rekord odrzucony
+} DzLog_Rec_t;
+
+static inline void DzLog_Begin(DzLog_Rec_t *r, uint16_t id)
+{
+    r->buf[0] = DZLOG_SYNC;
+    r->buf[2] = (uint8_t)id;
+    r->buf[3] = (uint8_t)(id >> 8);
+    r->n = DZLOG_HDR_LEN;
+    r->overflow = 0u;
+}
+
+static inline void DzLog_U32(DzLog_Rec_t *r, uint32_t v)
+{
+    if (r->n + 4u > sizeof(r->buf)) { r->overflow = 1u; return; }
+    r->buf[r->n++] = (uint8_t)v;
+    r->buf[r->n++] = (uint8_t)(v >> 8);
+    r->buf[r->n++] = (uint8_t)(v >> 16);
+    r->buf[r->n++] = (uint8_t)(v >> 24);
+}
+
+static inline void DzLog_F32(DzLog_Rec_t *r, double v)
+{
+    union { float f; uint32_t u; } c = { .f = (float)v };
+    DzLog_U32(r, c.u);
+}
+
+void DzLog_Str(DzLog_Rec_t *r, const char *s);
+void DzLog_End(DzLog_Rec_t *r, DebugUART_Lane_t lane);
+
+/* Liczba odrzuconych rekordów (za dużo argumentów) */
+uint32_t DzLog_Overflows(void);
+
+/* Kontrola formatu przez kompilator (-Wformat) bez generowania kodu */
+static inline __attribute__((format(printf, 1, 2))) void DzLog__Check(const char *fmt, ...) { (void)fmt; }
+
+/* ---- rozwinięcie argumentów (max 8) ---- */
+#define DZLOG__N(...)   DZLOG__N_(_0, ##__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define DZLOG__N_(_0, _1, _2, _3, _4, _5, _6, _7, _8, N, ...) N
+#define DZLOG__CAT(a, b)  DZLOG__CAT_(a, b)
+#define DZLOG__CAT_(a, b) a##b
+#define DZLOG__FE_0(m)
+#define DZLOG__FE_1(m, a)      m(a)
+#define DZLOG__FE_2(m, a, ...) m(a) DZLOG__FE_1(m, __VA_ARGS__)
+#define DZLOG__FE_3(m, a, ...) m(a) DZLOG__FE_2(m, __VA_ARGS__)
+#define DZLOG__FE_4(m, a, ...) m(a) DZLOG__FE_3(m, __VA_ARGS__)
+#define DZLOG__FE_5(m, a, ...) m(a) DZLOG__FE_4(m, __VA_ARGS__)
+#define DZLOG__FE_6(m, a, ...) m(a) DZLOG__FE_5(m, __VA_ARGS__)
+#define DZLOG__FE_7(m, a, ...) m(a) DZLOG__FE_6(m, __VA_ARGS__)
+#define DZLOG__FE_8(m, a, ...) m(a) DZLOG__FE_7(m, __VA_ARGS__)
+#define DZLOG__FOREACH(m, ...) DZLOG__CAT(DZLOG__FE_, DZLOG__N(__VA_ARGS__))(m, ##__VA_ARGS__)
+
+#define DZLOG__ARG(x) _Generic((x),                 \
+        char*:        DzLog_Str,                    \
+        const char*:  DzLog_Str,                    \
+        float:        DzLog_F32,                    \
+        double:       DzLog_F32,                    \
+        default:      DzLog_U32)(&_dz_rec, (x));
+
+#define DZLOG__EMIT(lane, fmt, ...) do {                                               \
+        static const char _dz_fmt[] __attribute__((section(".dzlog"), used)) = fmt;     \
+        if (0) DzLog__Check(fmt, ##__VA_ARGS__);                                        \
+        DzLog_Rec_t _dz_rec;                                                            \
+        DzLog_Begin(&_dz_rec, (uint16_t)(uintptr_t)_dz_fmt);                            \
+        DZLOG__FOREACH(DZLOG__ARG, ##__VA_ARGS__)                                       \
+        DzLog_End(&_dz_rec, (lane));                                                    \
+    } while (0)
+
+#define DZLOG(fmt, ...)       DZLOG__EMIT(DEBUG_UART_LANE_BULK, fmt, ##__VA_ARGS__)
+#define DZLOG_CRIT(fmt, ...)  DZLOG__EMIT(DEBUG_UART_LANE_CRIT, fmt, ##__VA_ARGS__)
+
+#else  /* !DZB_LOG_BINARY — tekst formatowany na MCU */
+
+#define DZLOG(...)       DebugUART_Printf(__VA_ARGS__)
+#define DZLOG_CRIT(...)  DebugUART_CritPrintf(__VA_ARGS__)
+
+#endif /* DZB_LOG_BINARY */
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* DZLOG_H_ */
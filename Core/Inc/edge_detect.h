@@ -0,0 +1,87 @@
+/*
+ * ============================================================================
+ *  MODULE: edge_detect — detekcja krawędzi dohyo (TCS3472, tryb szybki) + ucieczka
+ *  ----------------------------------------------------------------------------
+ *  CO:
+ *    - TCS3472 Right/Left w trybie szybkim: stały krótki ATIME (1 cykl = 2.4 ms) i gain.
+ *    - Co poll_ms odczyt samego Clear (2 B) z obu czujników.
+ *    - Próg kalibrowany: czerń mierzona przy starcie (cal_samples), progi
+ *      czerń+delta_on / czerń+delta_off (histereza), potwierdzenie 'confirm' próbek.
+ *    - Detekcja → Edge_OnEscape() (hook aplikacji) i natychmiastowy Tank_Override(): cofanie
+ *      rev_ms, obrót od krawędzi turn_ms, potem Tank_Stop() + zwolnienie override (robot stoi).
+ *
+ *  PO CO:
+ *    - Krawędź to najbardziej krytyczna latencja minisumo; panel kolorów (100+ ms) za wolny.
+ *
+ *  KOMPROMIS (jeden ATIME/gain na czujnik):
+ *    - Tryb szybki tylko, gdy napęd jest w ruchu (cel/rampa ≠ 0 albo manewr). Po 1 s postoju
+ *      czujniki wracają do auto-gain/ATIME (kolory, klasyfikator, kalibracja kolorów) — na
+ *      postoju krawędź nie jest śledzona. W ruchu dane kolorów mają stałą skalę trybu
+ *      szybkiego (2.4 ms, 16x; klasyfikator normalizuje gain × cykle — niższa rozdzielczość).
+ *    - Start ruchu po postoju: przepięcie + 2 integracje (≈ 5 ms) bez detekcji.
+ *
+ *  KIEDY:
+ *    - Edge_Init()  — po Sensors_Init() i Tank_Init(), PRZED startem jazdy: kalibracja czerni
+ *      synchronicznie (≈ 5 ms + cal_samples × poll_ms ≈ 0.1 s, robot stoi na macie).
+ *    - Edge_Poll()  — w każdej iteracji App_Tick() (własny soft-timer poll_ms).
+ *    - Edge_IsEscaping() — App pomija DriveTest_Tick(), gdy trwa manewr.
+ *    - Edge_OnEscape() — weak hook; App zatrzymuje test jazdy (po ucieczce nie wraca na krawędź).
+ *
+ *  LATENCJA (najgorszy przypadek: krawędź → impuls ESC), domyślny config:
+ *    t_int   = 2 × ATIME               = 4.8 ms (krawędź w trakcie integracji → pełna kolejna)
+ *    t_poll  = poll_ms                 = 3 ms
+ *    t_conf  = (confirm − 1) × poll_ms = 0 ms
+ *    t_i2c   = 2 × odczyt 2 B @400 kHz ≈ 0.2 ms
+ *    t_loop  = najdłuższe blokujące zadanie App_Tick: ramka OLED ≈ 25 ms,
+ *              TF-Luna bez odpowiedzi ≈ 3 × (10+10+2) ms ≈ 66 ms (awaria)
+ *    t_pwm   = ramka RC 50 Hz          ≤ 20 ms (nowe CCR od kolejnego okresu)
+ *    t_gate  = neutral_dwell_ms + tick_ms = 120 ms (bramka wygasa w Tank_Update co tick_ms)
+ *    ⇒ neutral (przestajemy pchać):  ≈ 8 ms + t_loop + t_pwm  (typ. 53 ms z OLED, 94 ms przy awarii lidaru)
+ *    ⇒ ciąg wsteczny:               ≈ neutral + t_gate      (typ. 173 ms, 214 ms przy awarii lidaru)
+ *    Symulator (Tools/sim.py) mierzy do zapisu CCR (bez t_pwm, pętla bez blokad):
+ *    neutral ≤ 8 ms, wsteczny ≤ 8 + 120 ms (domyślny scenariusz: 4 ms / 105 ms).
+ *
+ *  TESTY:
+ *    - EdgeDet_Step() jest czystą funkcją (bez HAL) — nadaje się do odtwarzania
+ *      nagranych śladów Clear poza targetem.
+ * ============================================================================
+ */
+
+#ifndef EDGE_DETECT_H_
+#define EDGE_DETECT_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "config.h"    // ConfigEdge_t
+#include "tcs3472.h"   // TCS3472_t
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Stan detektora jednego czujnika (kalibracja + histereza) */
+typedef struct {
+    uint32_t cal_sum;    // suma próbek kalibracji
+    uint8_t  cal_n;      // zebrane próbki kalibracji
+    uint16_t black;      // poziom czerni (po kalibracji)
+    uint8_t  on;         // 1 = krawędź widoczna
+    uint8_t  cnt;        // licznik potwierdzeń (≥ progu)
+} EdgeDet_t;
+
+/* Czysty krok detektora. Zwraca 1 na zboczu narastającym (nowa krawędź), inaczej 0.
+ * Pierwsze cfg->cal_samples próbek kalibruje czerń (detekcja wyłączona). */
+uint8_t EdgeDet_Step(EdgeDet_t *d, uint16_t clear, const ConfigEdge_t *cfg);
+
+void    Edge_Init(TCS3472_t *right, TCS3472_t *left);   // NULL = brak czujnika (strona pomijana)
+void    Edge_Poll(void);
+bool    Edge_IsEscaping(void);
+uint8_t Edge_Flags(void);          // bit0 = Right widzi krawędź, bit1 = Left
+uint32_t Edge_Count(void);         // liczba detekcji od startu
+
+/* Weak hook: start ucieczki, wołany przed Tank_Override() (hitR/hitL = strona krawędzi) */
+void    Edge_OnEscape(uint8_t hitR, uint8_t hitL);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* EDGE_DETECT_H_ */
@@ -0,0 +1,89 @@
+/*
+ * ============================================================================
+ *  MODULE: fmt.h — liczby stałoprzecinkowe w tekście bez %f (bez sterty)
+ *  ----------------------------------------------------------------------------
+ *  CO:
+ *    - Fmt_Fixed(): float → "[-]I.F" (0..3 miejsc po przecinku, zaokrąglenie),
+ *      wyrównany do prawej na width znaków — zamiennik "%5.1f" itp. Liczba, która nie
+ *      mieści się w buforze, to same '#' (nigdy obcięte cyfry udające inną wartość).
+ *    - Fmt_ParseNum(): "[-+]I[.F]" → float — zamiennik strtof() w shellu.
+ *
+ *  DLACZEGO:
+ *    - newlib-nano formatuje %f przez _dtoa_r (Balloc → malloc), strtof przez
+ *      _strtod_r (też malloc). Firmware jest bez sterty (malloc = pułapka w sysmem.c),
+ *      więc liczby ułamkowe formatujemy na liczbach całkowitych.
+ * ============================================================================
+ */
+
+#ifndef FMT_H_
+#define FMT_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* v z dec (0..3) miejscami; |v| powyżej ~4e6 obcinane; NaN → "nan". Zwraca buf.
+ * Najdłuższy wynik bez wyrównania: "-4000000.000" = 12 znaków (+ '\0'). */
+static inline const char *Fmt_Fixed(char *buf, size_t size, float v, uint8_t dec, uint8_t width)
+{
+    static const uint32_t k_pow10[4] = { 1u, 10u, 100u, 1000u };
+    char tmp[16];
+    if (dec > 3u) dec = 3u;
+
+    if (v != v) {
+        (void)snprintf(tmp, sizeof(tmp), "nan");
+    } else {
+        const uint8_t neg = (uint8_t)(v < 0.0f);
+        float a = neg ? -v : v;
+        if (a > 4.0e6f) a = 4.0e6f;                           // (a·10^dec) mieści się w u32
+        const uint32_t q  = (uint32_t)(a * (float)k_pow10[dec] + 0.5f);
+        const uint32_t ip = q / k_pow10[dec], fp = q % k_pow10[dec];
+        const char *sg = (neg && q != 0u) ? "-" : "";         // bez "-0.0"
+        if (dec) (void)snprintf(tmp, sizeof(tmp), "%s%lu.%0*lu", sg, (unsigned long)ip, (int)dec, (unsigned long)fp);
+        else     (void)snprintf(tmp, sizeof(tmp), "%s%lu", sg, (unsigned long)ip);
+    }
+    if (size == 0u) return buf;
+    const size_t len = strlen(tmp);
+    const size_t out = (width > len) ? width : len;
+    if (out >= size) {                                        // za mały bufor → "###…"
+        memset(buf, '#', size - 1u);
+        buf[size - 1u] = '\0';
+        return buf;
+    }
+    memset(buf, ' ', out - len);                              // wyrównanie do prawej
+    memcpy(buf + (out - len), tmp, len + 1u);
+    return buf;
+}
+
+/* Liczba dziesiętna bez wykładnika; 1 = OK (cały token poprawny) */
+static inline uint8_t Fmt_ParseNum(const char *s, float *out)
+{
+    if (!s || !out) return 0u;
+    float sign = 1.0f;
+    if (*s == '-' || *s == '+') { if (*s == '-') sign = -1.0f; s++; }
+
+    uint32_t ip = 0u, fp = 0u, scale = 1u;
+    uint8_t digits = 0u;
+    for (; *s >= '0' && *s <= '9'; s++, digits++) {
+        if (ip > 100000000u) return 0u;                       // poza zakresem pól configu
+        ip = ip * 10u + (uint32_t)(*s - '0');
+    }
+    if (*s == '.') {
+        for (s++; *s >= '0' && *s <= '9'; s++, digits++) {
+            if (scale < 1000000u) { fp = fp * 10u + (uint32_t)(*s - '0'); scale *= 10u; }
+        }
+    }
+    if (digits == 0u || *s != '\0') return 0u;
+    *out = sign * ((float)ip + (float)fp / (float)scale);
+    return 1u;
+}
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* FMT_H_ */
@@ -0,0 +1,79 @@
+/*
+ * ============================================================================
+ *  MODULE: matchlog — trwały log meczów we FLASH (bloki z blackbox)
+ *  ----------------------------------------------------------------------------
+ *  CO:
+ *    - Region FLASH_LOG (MATCHLOG_PAGES × 2 KB, linker) jako pierścień stron.
+ *      Strona: nagłówek 16 B {magic, seq, mecz, nr strony w meczu} + 7 slotów
+ *      po 256 B = zamknięte bloki blackbox (delta/varint) kopiowane 1:1.
+ *    - Mecz = okno zapisu: od pierwszego ruchu napędu (cel/rampa ≠ 0 albo ucieczka)
+ *      do MATCHLOG_TAIL_MS po powrocie do postoju. Na postoju bloki blackbox NIE
+ *      trafiają do FLASH; kolejne okno = nowy numer meczu od świeżej strony.
+ *      Indeks meczów budowany przy starcie ze skanu nagłówków (32 odczyty).
+ *    - Pisarz w tle: MatchLog_Poll() programuje max MATCHLOG_DW_PER_POLL double-wordów
+ *      (~80 µs każdy) na wywołanie. Pierwszy dword slotu (len bloku) zapisywany
+ *      OSTATNI → przerwany zapis = pusty slot.
+ *    - Erase strony (~22 ms, stall CPU — jeden bank FLASH) tylko gdy napęd stoi
+ *      (allow_erase) i nie częściej niż co MATCHLOG_ERASE_GAP_MS; na starcie
+ *      przygotowane MATCHLOG_AHEAD pustych stron (~40 s meczu bez żadnego erase).
+ *      Brak pustej strony w trakcie jazdy → pisarz czeka, bufor = pierścień SRAM2.
+ *    - Zużycie FLASH (L4: 10k cykli erase/strona): strona mieści ~5 s jazdy, pierścień
+ *      32 stron ≈ 160 s zapisu, każda strona wymazywana raz na obieg. Liczy się tylko
+ *      czas w oknach zapisu (jazda + ogon), nie czas zasilania: 10k × 160 s ≈ 440 h
+ *      jazdy (~8000 meczów po 3 min). Każde okno zajmuje ≥ 1 stronę — bardzo krótkie
+ *      przejazdy (np. "drive" z shella) kosztują pełną stronę.
+ *    - Zrzut meczu w pasie CRIT jako linie "BBX <blok> <off> <hex>" (format
+ *      Tools/bb_decode.py), od zadanego bloku → wznowienie po przerwanym transferze.
+ *
+ *  KIEDY:
+ *    - MatchLog_Init() w App_Init (po BlackBox_Init), MatchLog_Poll(App_DriveIdle()) co
+ *      iterację App_Tick.
+ *    - Shell: "ml list | get <mecz> [blok] | info | erase".
+ * ============================================================================
+ */
+
+#ifndef MATCHLOG_H_
+#define MATCHLOG_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MATCHLOG_PAGE_SIZE    2048u
+#define MATCHLOG_PAGES        32u      // 64 KB (region FLASH_LOG)
+#define MATCHLOG_SLOTS        7u       // bloki 256 B na stronę
+#define MATCHLOG_DW_PER_POLL  4u       // double-wordy na MatchLog_Poll() (~0.35 ms)
+#define MATCHLOG_AHEAD        8u       // puste strony przygotowane z wyprzedzeniem
+#define MATCHLOG_ERASE_GAP_MS 100u     // min. odstęp między erase w trakcie pracy
+#define MATCHLOG_TAIL_MS      5000u    // zapis trwa jeszcze tyle po powrocie do postoju
+
+typedef struct {
+    uint16_t match;                    // numer meczu w zapisie
+    uint8_t  matches;                  // mecze w indeksie
+    uint8_t  blank;                    // puste strony gotowe do zapisu
+    uint32_t blocks;                   // bloki zapisane w tej sesji
+    uint32_t lost;                     // bloki nadpisane w SRAM2 przed zapisem
+    uint8_t  waiting;                  // 1 = pisarz czeka na erase (napęd pracuje)
+    uint8_t  recording;                // 1 = okno zapisu otwarte (jazda / ogon)
+    uint8_t  dumping;
+} MatchLog_Info_t;
+
+void MatchLog_Init(void);
+void MatchLog_Poll(uint8_t idle);      // idle = napęd stoi: wolno erase; ruch otwiera okno zapisu
+
+uint8_t MatchLog_ListLine(uint8_t line);                // linia indeksu meczów (CRIT), 0 = koniec
+uint8_t MatchLog_DumpStart(uint16_t match, uint16_t from_block);   // 0 = brak meczu
+void    MatchLog_Erase(void);                           // skasuj cały region (blokuje)
+void    MatchLog_GetInfo(MatchLog_Info_t *out);
+
+/* Porty FLASH (weak; domyślnie HAL) — offsety względne w regionie */
+const uint8_t* MatchLog_PortBase(void);
+uint8_t        MatchLog_PortErase(uint8_t page);
+uint8_t        MatchLog_PortProgram(uint32_t offset, uint64_t dword);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* MATCHLOG_H_ */
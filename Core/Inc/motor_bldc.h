@@ -87,6 +87,18 @@ uint16_t ESC_GetMinUs(void);         // zwraca dolną granicę (np. 1000 µs)
 uint16_t ESC_GetNeuUs(void);         // zwraca neutral (np. 1500 µs)
 uint16_t ESC_GetMaxUs(void);         // zwraca górną granicę (np. 2000 µs)
 
+/* ----------------------------------------------------------------------------
+ *  Aktualny impuls kanału (odczyt CCR; 1 tick TIM1 = 1 µs) — diagnostyka/blackbox.
+ *  Przed ESC_Init() zwraca neutral.
+ * ---------------------------------------------------------------------------- */
+uint16_t ESC_GetPulseUs(ESC_Channel_t ch);
+
+/* ----------------------------------------------------------------------------
+ *  Neutral na obu kanałach bezpośrednio w rejestrach TIM1 (bez HAL i stanu RAM).
+ *  Dla handlerów błędów (crash) — działa nawet przy uszkodzonych zmiennych.
+ * ---------------------------------------------------------------------------- */
+void ESC_FailSafe(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -25,6 +25,13 @@ void OLED_Panel_ShowSensors(const TF_LunaData_t *R,
                             const TCS3472_Data_t *CR,
                             const TCS3472_Data_t *CL);
 
+/* Sam render panelu do bufora SSD1306 (formatowanie + tekst), bez wysyłki I2C.
+   ShowSensors = Render + SSD1306_UpdateScreen(); osobno dla benchmarku (bench.c). */
+void OLED_Panel_Render(const TF_LunaData_t *R,
+                       const TF_LunaData_t *L,
+                       const TCS3472_Data_t *CR,
+                       const TCS3472_Data_t *CL);
+
 #ifdef __cplusplus
 }
 #endif
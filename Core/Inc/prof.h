@@ -0,0 +1,52 @@
+/*
+ * ============================================================================
+ *  MODULE: prof.h — licznik cykli DWT (pomiary czasu krótkich sekcji)
+ *  ----------------------------------------------------------------------------
+ *  CO:
+ *    - Prof_Init(): włącza DWT->CYCCNT (TRCENA + CYCCNTENA).
+ *    - Prof_Cycles(): bieżący licznik cykli (zawija co 2^32 / SystemCoreClock s).
+ *    - Prof_CyclesToUs(): przelicznik cykle → µs (dla raportów UART).
+ *    - PROF_MAX_UPDATE(): „high-water mark” czasu sekcji w cyklach.
+ *
+ *  KIEDY:
+ *    - Pomiar sekcji z wyłączonymi IRQ, czasu zapisu do kolejek, benchmarki.
+ *    - Różnica (uint32_t)(t1 - t0) jest poprawna przez zawinięcie licznika.
+ * ============================================================================
+ */
+
+#ifndef PROF_H_
+#define PROF_H_
+
+#include "main.h"   // CMSIS: DWT, CoreDebug, SystemCoreClock
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static inline void Prof_Init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;  // włącz blok trace (DWT)
+    DWT->CYCCNT = 0u;
+    DWT->CTRL  |= DWT_CTRL_CYCCNTENA_Msk;            // start licznika cykli
+}
+
+static inline uint32_t Prof_Cycles(void)
+{
+    return DWT->CYCCNT;
+}
+
+static inline uint32_t Prof_CyclesToUs(uint32_t cycles)
+{
+    const uint32_t mhz = SystemCoreClock / 1000000u;
+    return (mhz != 0u) ? (cycles / mhz) : 0u;
+}
+
+/* Aktualizacja maksimum: max = max(max, Prof_Cycles() - t0) */
+#define PROF_MAX_UPDATE(max_var, t0) \
+    do { const uint32_t _d = Prof_Cycles() - (t0); if (_d > (max_var)) (max_var) = _d; } while (0)
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* PROF_H_ */
@@ -0,0 +1,85 @@
+/*
+ * ============================================================================
+ *  MODULE: ramfunc — kod wykonywany z SRAM2 (bez wait-state FLASH) + pomiar
+ *  ----------------------------------------------------------------------------
+ *  CO:
+ *    - RAMFUNC: atrybut funkcji → sekcja .ramfunc (linker: VMA w RAM2 pod 0x10000000,
+ *      LMA we FLASH, kopiowana w Reset_Handler jak .data). SRAM2 jest widoczna na
+ *      szynie I-Code/D-Code — pobieranie instrukcji bez 4 wait-state FLASH
+ *      (80 MHz, FLASH_LATENCY_4) i bez zależności od trafień w ICache.
+ *    - Zysk NIE jest zmierzony na płytce (przy trafieniach ICache/prefetch FLASH bywa
+ *      równie szybki, a pobrania z SRAM2 konkurują z danymi na D-Code). Decyzja o
+ *      pozostawieniu RAMFUNC — dopiero po pomiarze A/B "ramfn" (ramfunc.c).
+ *    - Handlery IRQ (SysTick, USART2, I2C1/I2C3) oznaczone deklaracją w USER CODE
+ *      stm32l4xx_it.c; biblioteka HAL (HAL_*_IRQHandler) zostaje we FLASH.
+ *    - Statystyka cykli DWT (n/min/avg/max) dla oznaczonych ścieżek: Tank_Update,
+ *      TCS3472_Process, HAL_UART_TxCpltCallback → "ramfn" w shellu.
+ *    - DZB_RAMFUNC=0 (flaga kompilatora) wyłącza przenoszenie — porównanie A/B
+ *      na tym samym stanowisku: ta sama statystyka, kod z FLASH.
+ *
+ *  KIEDY:
+ *    - Tylko krótkie, gorące funkcje: SRAM2 dzieli 16 KB z .ram2_noinit (blackbox
+ *      12 KB, crash) — ASSERT w STM32L432KCUX_FLASH.ld przerywa build po przekroczeniu.
+ *    - Wywołania RAM↔FLASH (odległość > 16 MB) idą przez weneery linkera (+kilka cykli).
+ * ============================================================================
+ */
+
+#ifndef RAMFUNC_H_
+#define RAMFUNC_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef DZB_RAMFUNC
+#define DZB_RAMFUNC  1
+#endif
+
+/* RAMFUNC: funkcja wywoływana z innych miejsc (noinline — kopia inline w wołającym
+ *   byłaby we FLASH). RAMFUNC_HELPER: helper static gorącej ścieżki — kompilator może
+ *   go wkleić; jeśli zostanie osobną funkcją, też ląduje w SRAM2. */
+#if DZB_RAMFUNC
+#define RAMFUNC         __attribute__((section(".ramfunc"), noinline))
+#define RAMFUNC_HELPER  __attribute__((section(".ramfunc")))
+#else
+#define RAMFUNC
+#define RAMFUNC_HELPER
+#endif
+
+/* Ścieżki mierzone (kolejność = kolejność w raporcie) */
+typedef enum {
+    RAMFN_TANK = 0,           // Tank_Update (pełne wywołanie z App_Tick)
+    RAMFN_TCS,                // TCS3472_Process (EMA + auto-gain, bez I²C odczytu)
+    RAMFN_UART_TXC,           // HAL_UART_TxCpltCallback (ciało callbacku w ISR)
+    RAMFN_COUNT
+} RamFn_Id_t;
+
+typedef struct {
+    uint32_t n;
+    uint32_t min, max;        // cykle DWT
+    uint64_t sum;
+} RamFn_Stat_t;
+
+extern RamFn_Stat_t g_ramfnStat[RAMFN_COUNT];
+
+/* Dopisanie pomiaru (cykle) — kilka instrukcji, wołane także z ISR */
+static inline void RamFn_Add(RamFn_Id_t id, uint32_t cyc)
+{
+    RamFn_Stat_t *s = &g_ramfnStat[id];
+    if (s->n == 0u || cyc < s->min) s->min = cyc;
+    if (cyc > s->max) s->max = cyc;
+    s->sum += cyc;
+    s->n++;
+}
+
+void RamFn_Reset(void);
+/* Raport na CRIT, jedna linia na wywołanie (0 = nagłówek; 0 = koniec raportu):
+ * tryb (SRAM2/FLASH), adres funkcji, n, min/avg/max cykli i µs */
+uint8_t RamFn_ReportLine(uint8_t line);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* RAMFUNC_H_ */
@@ -0,0 +1,90 @@
+/*
+ * ============================================================================
+ *  MODULE: sensor — wspólny interfejs driverów czujników + statyczny rejestr
+ *  ----------------------------------------------------------------------------
+ *  CO:
+ *    - SensorOps_t: init / start / poll / complete (+ snapshot wyniku w 'out').
+ *    - Rejestr: jedna statyczna tabela instancji (TF-Luna + TCS3472) budowana
+ *      przy starcie z CFG_LunaDevs() / CFG_TcsDevs(); bez alokacji dynamicznej.
+ *    - Harmonogram: Sensors_ServiceNext(bus, kind) — round-robin po instancjach
+ *      danego typu na magistrali (N czujników na bus bez duplikacji kodu).
+ *    - Snapshoty za seqlockiem (seqlock.h): pisarz (complete — dziś pętla, docelowo
+ *      callback I²C w ISR) nie blokuje, czytelnicy dostają spójną kopię (getter zwraca
+ *      strukturę przez wartość) bez wyłączania przerwań.
+ *
+ *  CYKL POMIARU:
+ *    start()    — opcjonalnie: rozpocznij pomiar (np. trigger TF-Luna); NULL = ciągły.
+ *    poll()     — 1 = wynik gotowy (np. STATUS AINT w TCS); NULL = zawsze gotowy.
+ *    complete() — odczyt + filtry → bufor roboczy → snapshot (SeqLock_Store).
+ *    stale()    — opcjonalnie: poll()=0 → oznacz snapshot jako nieświeży (pod seqlockiem).
+ *
+ *  KIEDY:
+ *    - Sensors_Init()         — w App_Init() (po I2C i UART).
+ *    - Sensors_StartKind()/ServiceKind() — tryb trigger (wszystkie naraz).
+ *    - Sensors_ServiceNext()  — w slocie sensorów (po jednym na typ i magistralę).
+ * ============================================================================
+ */
+
+#ifndef SENSOR_H_
+#define SENSOR_H_
+
+#include <stdint.h>
+#include "config.h"        // CFG_I2CBus_t
+#include "seqlock.h"       // SeqLock_t
+#include "tf_luna_i2c.h"   // TF_Luna_t, TF_LunaData_t
+#include "tcs3472.h"       // TCS3472_t, TCS3472_Data_t
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SENSOR_LUNA_MAX   6u       // instancje TF-Luna
+#define SENSOR_TCS_MAX    2u       // instancje TCS3472 (adres stały → 1 na bus)
+#define SENSOR_MAX        (SENSOR_LUNA_MAX + SENSOR_TCS_MAX)
+
+typedef enum {
+    SENSOR_LUNA = 0,
+    SENSOR_TCS  = 1,
+    SENSOR_KIND_COUNT
+} SensorKind_t;
+
+typedef struct {
+    void    (*start)   (void *dev);               // NULL = pomiar ciągły
+    uint8_t (*poll)    (void *dev);               // NULL = zawsze gotowy
+    void    (*complete)(void *dev, void *out);    // odczyt → bufor roboczy
+    void    (*stale)   (void *out);               // NULL = snapshot bez zmian przy poll()=0
+} SensorOps_t;
+
+typedef struct {
+    SensorKind_t       kind;
+    CFG_I2CBus_t       bus;
+    uint8_t            idx;     // indeks w obrębie typu (0=Right, 1=Left, …)
+    const char        *name;
+    const SensorOps_t *ops;
+    void              *dev;     // instancja drivera (TF_Luna_t / TCS3472_t)
+    void              *out;     // snapshot wyniku (TF_LunaData_t / TCS3472_Data_t)
+    uint16_t           out_size;// rozmiar snapshotu (B)
+    SeqLock_t         *lock;    // seqlock snapshotu
+} Sensor_t;
+
+void            Sensors_Init(void);
+uint8_t         Sensors_Count(void);
+const Sensor_t* Sensors_Get(uint8_t i);
+
+/* Wszystkie instancje typu: start (np. trigger) / poll+complete */
+void            Sensors_StartKind(SensorKind_t kind);
+void            Sensors_ServiceKind(SensorKind_t kind);
+/* Kolejna instancja typu na magistrali (round-robin); zwraca obsłużoną lub NULL */
+const Sensor_t* Sensors_ServiceNext(CFG_I2CBus_t bus, SensorKind_t kind);
+
+/* Spójne kopie snapshotów wg indeksu w obrębie typu (brak → pusty); instancje (brak → NULL) */
+uint8_t               Sensors_LunaCount(void);
+TF_LunaData_t         Sensors_Luna(uint8_t idx);
+uint8_t               Sensors_TcsCount(void);
+TCS3472_Data_t        Sensors_Color(uint8_t idx);
+TCS3472_t*            Sensors_ColorDev(uint8_t idx);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* SENSOR_H_ */
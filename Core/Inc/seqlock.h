@@ -0,0 +1,91 @@
+/*
+ * ============================================================================
+ *  MODULE: seqlock.h — bezblokadowe snapshoty danych współdzielonych ISR ⇄ pętla
+ *  ----------------------------------------------------------------------------
+ *  CO:
+ *    - Licznik sekwencji: nieparzysty = zapis w toku, parzysty = dane spójne.
+ *    - Pisarz nigdy nie czeka (2 inkrementy + bariery), czytelnik kopiuje dane
+ *      i powtarza, gdy licznik zmienił się w trakcie kopiowania.
+ *    - Bez wyłączania przerwań; bariery __atomic_thread_fence() (DMB na Cortex-M4).
+ *
+ *  ZAŁOŻENIA (jeden rdzeń):
+ *    - Jeden pisarz na snapshot (np. callback I²C w ISR albo pętla główna).
+ *    - Pisarz ma priorytet ≥ czytelnika (ISR pisze, pętla czyta) — wtedy czytelnik
+ *      nigdy nie wywłaszcza pisarza w połowie zapisu, a retry jest ograniczony.
+ *    - Odwrotny układ (pętla pisze, ISR czyta) → SeqLock_Load() z max_tries
+ *      zwróci 0 zamiast kręcić się w przerwaniu.
+ *
+ *  UŻYCIE:
+ *    SeqLock_Store(&lock, &snap, &fresh, sizeof(snap));        // pisarz
+ *    if (SeqLock_Load(&lock, &copy, &snap, sizeof(copy), 4))   // czytelnik
+ * ============================================================================
+ */
+
+#ifndef SEQLOCK_H_
+#define SEQLOCK_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    volatile uint32_t seq;           // parzysty = spójne, nieparzysty = zapis w toku
+} SeqLock_t;
+
+#define SEQLOCK_INIT  { 0u }
+
+/* ==== Pisarz ==== */
+static inline void SeqLock_WriteBegin(SeqLock_t *l)
+{
+    l->seq = l->seq + 1u;                            // → nieparzysty
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);         // licznik przed danymi
+}
+
+static inline void SeqLock_WriteEnd(SeqLock_t *l)
+{
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);         // dane przed licznikiem
+    l->seq = l->seq + 1u;                            // → parzysty
+}
+
+static inline void SeqLock_Store(SeqLock_t *l, void *dst, const void *src, size_t n)
+{
+    SeqLock_WriteBegin(l);
+    memcpy(dst, src, n);
+    SeqLock_WriteEnd(l);
+}
+
+/* ==== Czytelnik ==== */
+static inline uint32_t SeqLock_ReadBegin(const SeqLock_t *l)
+{
+    const uint32_t s = l->seq;
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);         // licznik przed danymi
+    return s;
+}
+
+/* 1 = kopia niespójna (zapis w toku lub w trakcie kopiowania) → powtórz */
+static inline uint8_t SeqLock_ReadRetry(const SeqLock_t *l, uint32_t start)
+{
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);         // dane przed ponownym licznikiem
+    return (uint8_t)(((start & 1u) != 0u) || (l->seq != start));
+}
+
+/* Spójna kopia src → dst; 1 = OK, 0 = nie udało się w max_tries próbach (0 = bez limitu) */
+static inline uint8_t SeqLock_Load(const SeqLock_t *l, void *dst, const void *src, size_t n, uint8_t max_tries)
+{
+    uint8_t tries = 0u;
+    for (;;) {
+        const uint32_t s = SeqLock_ReadBegin(l);
+        memcpy(dst, src, n);
+        if (!SeqLock_ReadRetry(l, s)) return 1u;
+        if (max_tries != 0u && ++tries >= max_tries) return 0u;
+    }
+}
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* SEQLOCK_H_ */
@@ -0,0 +1,61 @@
+/*
+ * ============================================================================
+ *  MODULE: shell — interaktywny shell na USART2 RX (strojenie na żywo)
+ *  ----------------------------------------------------------------------------
+ *  CO:
+ *    - Linia poleceń z kolejki RX (DebugUART_ReadChar), zakończona CR lub LF;
+ *      backspace kasuje znak. Echo linii po Enter (lokalne echo w terminalu opcjonalnie).
+ *    - Polecenia:
+ *        help                      — lista poleceń
+ *        list [blok]               — pola konfiguracji (motors/luna/tcs/edge/sched)
+ *        get  blok.pole            — odczyt
+ *        set  blok.pole wartość    — zapis z kontrolą zakresu (efekt od następnego ticku
+ *                                    dla pól live=1, pozostałe po restarcie)
+ *        drive L R [ms]            — ręczny cel Tank (−100..100) na czas ms (domyślnie 1000)
+ *        drive test | stop         — scenariusz DriveTest / natychmiastowy stop
+ *        dump cfg | uart | mem | sens — zrzut konfiguracji / statystyk UART / stosu i areny /
+ *                                    czujników
+ *        cal b | w | p             — kalibracja klasyfikatora koloru (czerń/biel/wydruk)
+ *        panel on | off            — panel czujników UART (off = spokojny terminal)
+ *        store save|load|erase|info — konfiguracja we FLASH (cfg_store; save/erase blokują
+ *                                    pętlę — tylko na postoju, w ruchu odmowa)
+ *        bb dump|raw|arm|freeze|info — czarna skrzynka w SRAM2 (CSV / hex dla
+ *                                    Tools/bb_decode.py; arm = wyczyść i nagrywaj)
+ *        ml list | get m [b] | info | erase — log meczów we FLASH (get = hex od bloku b,
+ *                                    wznowienie po przerwanym transferze; erase na postoju)
+ *        crash [clear | test]      — raport ostatniego HardFault (test = celowy błąd → reset)
+ *        ramfn [reset]             — cykle DWT min/avg/max ścieżek RAMFUNC (SRAM2 vs FLASH)
+ *        bench [prefiks]           — mikrobenchmarki czystej logiki (tylko build -DDZB_BENCH;
+ *                                    zatrzymuje napęd, blokuje pętlę; log → Tools/bench.py --log)
+ *    - Odpowiedzi w pasie CRIT; wielolinijkowe (help, list, dump, ml list, ramfn)
+ *      stronicowane — kolejna linia tylko, gdy w pasie jest miejsce i zostaje zapas
+ *      DEBUG_UART_CRIT_RESERVE na zdarzenia (Shell_Poll nigdy nie czeka na UART, a CRIT
+ *      nie odrzuca linii strony).
+ *
+ *  KIEDY:
+ *    - Shell_Poll() co iterację App_Tick(): max SHELL_POLL_CHARS znaków i jedno
+ *      polecenie na wywołanie — stały, krótki koszt.
+ * ============================================================================
+ */
+
+#ifndef SHELL_H_
+#define SHELL_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SHELL_LINE_MAX    64u    // maks. długość linii polecenia
+#define SHELL_POLL_CHARS  16u    // maks. znaków RX przetwarzanych w jednym Shell_Poll()
+
+void    Shell_Init(void);
+void    Shell_Poll(void);
+void    Shell_DriveCancel(void);    // Edge_OnEscape: koniec ręcznego celu 'drive L R'
+uint8_t Shell_PanelEnabled(void);   // 0 = panel UART wyłączony poleceniem "panel off"
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* SHELL_H_ */
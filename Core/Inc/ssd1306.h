@@ -46,6 +46,11 @@ void SSD1306_DrawChar(uint8_t x, uint8_t page, char c);
 void SSD1306_DrawText(uint8_t page, const char *text);                 /* x=0 */
 void SSD1306_DrawTextAt(uint8_t page, uint8_t x, const char *text);    /* x=0..127 */
 
+#ifdef DZB_BENCH
+/* Benchmark draw_char_6x8 (bench.c): n znaków do bufora, bez I²C */
+uint32_t SSD1306_BenchDrawChar(uint32_t n);
+#endif
+
 /* Drobne narzędzia rysujące */
 void SSD1306_SetContrast(uint8_t value);        /* 0..255 */
 void SSD1306_DrawPixel(uint8_t x, uint8_t y, uint8_t on);  /* on: 0/1 */
@@ -0,0 +1,46 @@
+/*
+ * ============================================================================
+ *  MODULE: stack_mon — „high-water mark” stosu MSP (malowanie wzorcem)
+ *  ----------------------------------------------------------------------------
+ *  CO:
+ *    - Reset_Handler maluje RAM [_sstack.._estack) wzorcem STACK_MON_PAINT, zanim
+ *      ruszy jakikolwiek kod C (linker: _sstack = koniec sterty, dół obszaru stosu).
+ *    - StackMon_Poll(): skan porcjami STACK_MON_SCAN_WORDS słów od dołu obszaru do
+ *      pierwszego nadpisanego słowa → najgłębszy zasięg stosu od startu.
+ *    - Wynik w panelu UART (linia JIT) — porównanie z _Min_Stack_Size z linkera;
+ *      analiza statyczna łańcuchów wywołań: Tools/stack_report.py (-fstack-usage).
+ *
+ *  KIEDY:
+ *    - StackMon_Poll() co iterację App_Tick() — stały koszt (kilkadziesiąt cykli).
+ *    - Pełny przebieg skanu trwa (obszar / 4 / STACK_MON_SCAN_WORDS) wywołań;
+ *      po osiągnięciu poprzedniego znaku skan zaczyna od dołu.
+ * ============================================================================
+ */
+
+#ifndef STACK_MON_H_
+#define STACK_MON_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define STACK_MON_PAINT       0xA5A5A5A5u   // ten sam wzorzec w startup_stm32l432kcux.s
+#define STACK_MON_SCAN_WORDS  64u           // słów na StackMon_Poll()
+
+typedef struct {
+    uint32_t used;       // najgłębszy zasięg stosu od startu (B, od _estack)
+    uint32_t reserve;    // _Min_Stack_Size z linkera (B)
+    uint32_t region;     // malowany obszar _sstack.._estack (B) — twardy limit
+    uint8_t  over;       // 1 = used > reserve (stos wszedł poniżej rezerwy)
+    uint8_t  exhausted;  // 1 = nadpisany sam dół obszaru (kolizja ze stertą/.bss)
+} StackMon_Info_t;
+
+void StackMon_Poll(void);
+void StackMon_GetInfo(StackMon_Info_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* STACK_MON_H_ */
@@ -81,6 +81,30 @@ void Tank_RotateRight(int8_t pct);             // obrót w miejscu: lewe +pct, p
  * ---------------------------------------------------------------------------- */
 void Tank_SetTarget(int8_t left_pct, int8_t right_pct);
 
+/* ----------------------------------------------------------------------------
+ *  Override (np. edge_detect): cel natychmiast, bez rampy/EMA, wyjście PWM od razu.
+ *  Bramka neutralu przy zmianie kierunku pozostaje aktywna (ochrona ESC).
+ *  Cele z SetTarget/Stop/Forward/... w trakcie override są zatrzaskiwane i wchodzą
+ *  po Release (manewru nie przerwie np. limit czasu shella). Release wraca do rampy
+ *  od bieżącej wartości.
+ * ---------------------------------------------------------------------------- */
+void    Tank_Override(int8_t left_pct, int8_t right_pct);
+void    Tank_OverrideRelease(void);
+uint8_t Tank_IsOverridden(void);
+
+/* ----------------------------------------------------------------------------
+ *  Podgląd stanu (diagnostyka / blackbox): cel i wartość po rampie (−100..+100).
+ *  Dowolny wskaźnik może być NULL.
+ * ---------------------------------------------------------------------------- */
+void    Tank_GetState(int8_t *tgt_l, int8_t *tgt_r, int8_t *cur_l, int8_t *cur_r);
+
+#ifdef DZB_BENCH
+/* Benchmarki helperów (bench.c): n iteracji → suma kontrolna */
+uint32_t Tank_BenchRamp(uint32_t n);
+uint32_t Tank_BenchEma(uint32_t n);
+uint32_t Tank_BenchEscWindow(uint32_t n);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
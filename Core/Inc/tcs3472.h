@@ -3,18 +3,25 @@
  *  MODULE: tcs3472.h — Driver TCS3472 (I²C) dla DzikiBoT
  * -----------------------------------------------------------------------------
  *  CO:
- *    - Init Right/Left (oddzielne I²C), odczyt stabilizowanych RAW C/R/G/B.
+ *    - Instancje TCS3472_t (bus + nazwa + stan), odczyt stabilizowanych RAW C/R/G/B.
+ *    - Adres 0x29 jest stały → jeden TCS na magistralę (więcej = mux I²C).
  *
  *  JAK DZIAŁA (wewnątrz drivera):
  *    - EMA na kanałach C/R/G/B (wygładza szumy).
- *    - Auto-gain (1×/4×/16×/60×) z histerezą na kanale Clear.
- *    - Przy zmianie gainu: reskalowanie EMA (anty-skoki).
+ *    - Wspólny auto-gain + auto-ATIME: drabinka (gain×ATIME) posortowana wg czułości;
+ *      wybieramy najkrótszą integrację, przy której Clear mieści się w [Lo..Hi]·FS,
+ *      gdzie FS = min(65535, 1024·cykle) dla bieżącego ATIME (histereza Lo/Hi).
+ *    - Przy zmianie gain/ATIME: reskalowanie EMA przez stosunek czułości (anty-skoki).
+ *    - Odczyt bramkowany STATUS: dane czytamy tylko, gdy AINT (PERS=0 → co cykl)
+ *      zgłosi zakończoną integrację; flaga kasowana komendą specjalną 0xE6.
+ *    - Pierwsza integracja po zmianie gainu jest odrzucana (mieszana).
+ *    - fresh=1 tylko dla nowej integracji; rate_hz = efektywna częstość próbek.
  *
  *  TUNING BEZ ZMIANY STRUKTUR (opcjonalnie w config.c):
  *    float CFG_TCS_EMA_Alpha(void); // alfa EMA (domyślnie 0.30)
  *    float CFG_TCS_AG_LoPct(void);  // próg dolny (domyślnie 0.60)
  *    float CFG_TCS_AG_HiPct(void);  // próg górny (domyślnie 0.70)
- *    void  TCS3472_OnGainChange(const char* side, TCS_Gain_t oldg, TCS_Gain_t newg); // weak hook
+ *    void  TCS3472_OnGainChange(const char* name, TCS_Gain_t oldg, TCS_Gain_t newg); // weak hook
  * ============================================================================
  */
 
@@ -22,6 +29,7 @@
 #define TCS3472_H_
 
 #include "main.h"
+#include "config.h"   // TCS_Gain_t
 #include <stdint.h>
 
 #ifdef __cplusplus
@@ -33,16 +41,55 @@ typedef struct {
     uint16_t red;    // kanał Red
     uint16_t green;  // kanał Green
     uint16_t blue;   // kanał Blue
+    uint8_t  fresh;  // 1 = nowa integracja w tym odczycie, 0 = powtórzone ostatnie wartości
+    float    rate_hz;// efektywna częstość nowych próbek (okno ~1 s)
+    TCS_Gain_t gain; // gain, przy którym zebrano próbkę
+    float    itime_ms;   // czas integracji próbki (ms)
+    uint16_t latency_ms; // górne oszacowanie wieku: integracja + czas od poprzedniego odpytania
 } TCS3472_Data_t;
 
-/* Right = I2C1, Left = I2C3 */
-void           TCS3472_Right_Init(I2C_HandleTypeDef *hi2c1);
-void           TCS3472_Left_Init (I2C_HandleTypeDef *hi2c3);
-TCS3472_Data_t TCS3472_Right_Read(void);
-TCS3472_Data_t TCS3472_Left_Read (void);
+/* Instancja czujnika (stan drivera; pola prywatne — nie modyfikować z zewnątrz) */
+typedef struct {
+    I2C_HandleTypeDef *bus;      // magistrala I²C
+    const char        *name;     // etykieta (log/hook)
+    TCS_Gain_t         gain;     // aktualny gain
+    float ema_c, ema_r, ema_g, ema_b; // stan EMA
+    uint8_t  ema_init;           // 0=niezainicjalizowany, 1=zainicjalizowany
+    uint8_t  step;               // pozycja na drabince gain×ATIME (0 = najmniej czuła)
+    uint8_t  a_min, a_max;       // zakres indeksów ATIME (z configu)
+    uint8_t  pinned;             // 1 = tryb szybki (edge): gain/ATIME zablokowane
+    uint8_t  skip;               // ile kolejnych integracji odrzucić (po zmianie gainu/ATIME)
+    uint32_t last_poll;          // czas bieżącego odpytania (latency)
+    uint32_t poll_prev;          // czas poprzedniego odpytania
+    TCS3472_Data_t last;         // ostatni wynik (zwracany, gdy brak nowej integracji)
+    uint32_t rate_t0;            // początek okna rate
+    uint16_t rate_cnt;           // nowe próbki w oknie
+} TCS3472_t;
+
+void           TCS3472_Init(TCS3472_t *dev, I2C_HandleTypeDef *hi2c, const char *name);
+
+/* Odczyt dzielony (rejestr czujników): Poll = STATUS, Complete = dane + filtry */
+uint8_t        TCS3472_Poll(TCS3472_t *dev);
+TCS3472_Data_t TCS3472_Complete(TCS3472_t *dev);
+/* Sama obróbka surowej próbki (EMA + auto-gain/ATIME) — wołana przez Complete, kod w SRAM2 */
+TCS3472_Data_t TCS3472_Process(TCS3472_t *dev, const TCS3472_Data_t *raw);
+/* Odczyt „w jednym”: Poll ? Complete : ostatni wynik (fresh=0) */
+TCS3472_Data_t TCS3472_Read(TCS3472_t *dev);
 
-/* Konfiguracja rejestrów (PON/AEN/ATIME/GAIN) – publiczna jak w baseline */
-void           TCS3472_Config(I2C_HandleTypeDef *hi2c);
+/* Konfiguracja rejestrów (PON/AEN/ATIME/GAIN) + reset stanu */
+void           TCS3472_Config(TCS3472_t *dev);
+
+/* Tryb szybki (edge_detect): stały ATIME (cykle × 2.4 ms) + stały gain, bez auto-gain/ATIME.
+ * Odczyty kolorów nadal działają (itime_ms/gain w próbce opisują skalę). Powrót do
+ * auto-gain/ATIME: TCS3472_Config() (edge_detect robi to po postoju napędu). */
+void           TCS3472_SetFastClear(TCS3472_t *dev, uint8_t atime_cycles, TCS_Gain_t gain);
+/* Sam kanał Clear (2 B) — 1 = OK; bez bramki STATUS (wołać co ≥ ATIME) */
+uint8_t        TCS3472_ReadClear(TCS3472_t *dev, uint16_t *clear);
+
+#ifdef DZB_BENCH
+/* Benchmark wyboru kroku auto-gain/ATIME (bench.c): n iteracji → suma kontrolna */
+uint32_t       TCS3472_BenchPickStep(uint32_t n);
+#endif
 
 #ifdef __cplusplus
 }
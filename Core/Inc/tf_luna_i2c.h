@@ -7,13 +7,19 @@
  *    • Odczyt rejestrów 0x00..0x05: distance [cm], strength [raw], temperature [0.01°C].
  *    • Filtry: mediana (distance) + średnia krocząca (strength) wg okien z config.c.
  *    • Temperatura zwracana jako °C (float) z dokładnością 0.1°C.
+ *    • (Opcja) tryb trigger: pomiar one-shot wyzwalany na stałe wyprzedzenie przed
+ *      tickiem Tank → deterministyczny wiek próbki (age_ms) zamiast losowego 0..1/fps.
+ *    • Instancje TF_Luna_t (bus + adres + filtry) → N czujników na magistralę
+ *      po przeprogramowaniu adresów (TF_Luna_ProvisionAddr).
  *
  *  PO CO:
  *    • Stabilny, prosty i czytelny odczyt — bez nieużywanych ścieżek (burst/CRC/auto-detect).
  *
  *  KIEDY:
- *    • *_Init() wywołaj raz po starcie.
- *    • *_Read() wywołuj cyklicznie (np. co CFG_Scheduler()->sens_ms).
+ *    • TF_Luna_Init() wywołaj raz po starcie dla każdej instancji.
+ *    • TF_Luna_Read() wywołuj cyklicznie (np. co CFG_Scheduler()->sens_ms).
+ *    • Tryb trigger (CFG_Luna()->trigger_mode=1): TF_Luna_Trigger() na trig_lead_ms przed
+ *      tickiem Tank, TF_Luna_Read() tuż przed Tank_Update() (harmonogram w app.c).
  * ============================================================================
  */
 
@@ -29,25 +35,80 @@ extern "C" {
 
 /* Struktura danych z jednego odczytu (z filtrami) */
 typedef struct {
-    uint16_t distance;       /* [cm]  surowy dystans z rejestrów 0x00/0x01                */
-    uint16_t distance_filt;  /* [cm]  dystans po medianie (okno z config)                 */
+    uint16_t distance;       /* [cm]  surowy dystans z rejestrów 0x00/0x01 (+ offset instancji) */
+    uint16_t distance_filt;  /* [cm]  dystans z offsetem po medianie (okno z config)      */
     uint16_t strength;       /* [raw] surowa siła sygnału z 0x02/0x03                     */
     uint16_t strength_filt;  /* [raw] siła po średniej kroczącej (okno z config)          */
     float    temperature;    /* [°C]  temp. układu: (int16_t(0x05:0x04) / 100.0f) → 0.1°C */
     uint8_t  frameReady;     /* 1 = nowy poprawny odczyt; 0 = brak (zwracamy ostatnie filtry) */
+    uint32_t timestamp;      /* [ms]  HAL_GetTick() w chwili odczytu rejestrów                */
+    uint16_t age_ms;         /* [ms]  trigger → odczyt (tryb trigger); TFLUNA_AGE_UNKNOWN w ciągłym */
 } TF_LunaData_t;
 
-/* Inicjalizacja komunikacji dla prawego i lewego czujnika (zapamiętujemy uchwyty I²C) */
-void          TF_Luna_Right_Init(I2C_HandleTypeDef *hi2c1);
-void          TF_Luna_Left_Init (I2C_HandleTypeDef *hi2c3);
+/* Wiek próbki nieznany (tryb ciągły: 0..1/fps, zależnie od fazy sensora) */
+#define TFLUNA_AGE_UNKNOWN   0xFFFFu
 
-/* Odczyt pojedynczej ramki (rejestry 0x00..0x05 + filtracja) */
-TF_LunaData_t TF_Luna_Right_Read(void);
-TF_LunaData_t TF_Luna_Left_Read (void);
+/* Fabryczny adres 7-bit każdej TF-Luny */
+#define TFLUNA_ADDR_DEFAULT  0x10u
+
+/* Maks. okno filtrów MED/MA (config: 1..TFLUNA_WIN_MAX) */
+#define TFLUNA_WIN_MAX       5u
+
+/* Stan filtrów jednej instancji (MED/MA w buforze pierścieniowym + trigger) */
+typedef struct {
+    uint16_t dist_hist[TFLUNA_WIN_MAX];  /* historia dystansu (dla mediany)            */
+    uint16_t str_hist [TFLUNA_WIN_MAX];  /* historia siły (dla średniej)               */
+    uint8_t  count;               /* ile wpisów mamy (<= TFLUNA_WIN_MAX)               */
+    uint8_t  idx;                 /* indeks do nadpisania (ring buffer)         */
+    float    last_tempC;          /* ostatnia dobra temperatura (°C)            */
+    uint16_t last_med;            /* ostatnia mediana dystansu (cm)             */
+    uint16_t last_ma;             /* ostatnia średnia siły (raw)                */
+    uint32_t trig_ts;             /* HAL_GetTick() ostatniego triggera          */
+    uint8_t  trig_pending;        /* 1 = trigger wysłany, wynik jeszcze nieodczytany */
+} TF_LunaFilt_t;
+
+/* Instancja czujnika: magistrala + adres + offset + własny stan filtrów.
+   Pamięć instancji należy do wołającego (rejestr statyczny w sensor.c) — driver nie alokuje. */
+typedef struct {
+    I2C_HandleTypeDef *hi2c;      /* magistrala (I2C1 / I2C3)                    */
+    uint8_t            addr7;     /* adres 7-bit (fabrycznie 0x10)               */
+    int16_t            dist_offset_mm; /* korekta dystansu (mm → cm z zaokr.; przed filtrami) */
+    const char        *name;      /* etykieta do logów/panelu (np. "R", "L")     */
+    TF_LunaFilt_t      filt;      /* stan filtrów MED/MA + triggera              */
+} TF_Luna_t;
+
+/* Inicjalizacja instancji: zapamiętuje bus/adres/offset, zeruje filtry,
+   ustawia tryb z CFG_Luna()->trigger_mode (ciągły/trigger). */
+void          TF_Luna_Init(TF_Luna_t *dev, I2C_HandleTypeDef *hi2c, uint8_t addr7,
+                           int16_t dist_offset_mm, const char *name);
+
+/* Tryb pracy: 1 = one-shot (trigger), 0 = ciągły.
+   TF_Luna_Init() ustawia go sam; publiczne do przełączania w locie (np. diagnostyka). */
+void          TF_Luna_SetTriggerMode(TF_Luna_t *dev, uint8_t enable);
+
+/* Wyzwolenie pojedynczego pomiaru (tylko tryb trigger) — zapamiętuje czas dla age_ms */
+void          TF_Luna_Trigger(TF_Luna_t *dev);
+
+/* Odczyt pojedynczej ramki (rejestry 0x00..0x05 + filtracja instancji) */
+TF_LunaData_t TF_Luna_Read(TF_Luna_t *dev);
+
+/* Provisioning adresu: czujnik odpowiadający pod from_addr7 dostaje new_addr7
+   (rejestr 0x22 → SAVE 0x20 → REBOOT 0x21), weryfikacja pod nowym adresem.
+   BLOKUJĄCE (~100 ms) — tylko przy starcie/serwisie. Zwraca 1 = OK. */
+uint8_t       TF_Luna_ProvisionAddr(I2C_HandleTypeDef *hi2c, uint8_t from_addr7, uint8_t new_addr7);
+
+/* Czy pod adresem odpowiada urządzenie (krótki probe I²C) */
+uint8_t       TF_Luna_IsPresent(I2C_HandleTypeDef *hi2c, uint8_t addr7);
 
 /* Szacowanie temperatury otoczenia: module °C + offset z CFG_Luna()->temp_offset_c (0.1°C) */
 float         TF_Luna_AmbientEstimateC(const TF_LunaData_t *d);
 
+#ifdef DZB_BENCH
+/* Benchmarki filtrów (bench.c): mediana okna 5 i pełny krok MED+MA wg CFG_Luna() */
+uint32_t      TF_Luna_BenchMedian(uint32_t n);
+uint32_t      TF_Luna_BenchFilter(uint32_t n);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
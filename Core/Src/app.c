@@ -8,11 +8,21 @@
  *
  *  ZAŁOŻENIA:
  *    - main.c minimalny: wywołuje tylko App_Init/App_Tick.
- *    - Brak HAL_Delay w App_Tick; jedyny HAL_Delay to ESC_ArmNeutral(3000).
+ *    - Brak HAL_Delay w App_Tick; w App_Init blokują ESC_ArmNeutral(3000) i kalibracja
+ *      czerni Edge_Init() (~0.1 s, przed startem jazdy).
  *    - TIM1: CH1=PA8 (Right), CH4=PA11 (Left).
  *    - Interwały PERIOD_* z config.c (utrzymujemy stare nazwy makr).
- *    - Odczyty sensorów rozfazowane Right⇄Left (mniejsze szczyty na I²C).
+ *    - Odczyty sensorów rozfazowane I2C1⇄I2C3 (mniejsze szczyty na I²C); czujniki
+ *      z rejestru sensor.c (round-robin po instancjach typu na magistrali).
  *    - Jitter Tank mierzony i drukowany „po UART” w takcie panelu.
+ *    - TF-Luna w trybie trigger: wyzwolenie trig_lead_ms przed tickiem Tank,
+ *      odczyt tuż przed Tank_Update() (stały, minimalny wiek próbki lidaru).
+ *    - Edge: Edge_Poll() w każdej iteracji (własny okres); podczas ucieczki
+ *      od krawędzi DriveTest_Tick() jest wstrzymany (Tank w override), a start ucieczki
+ *      kończy test jazdy (Edge_OnEscape) — po manewrze robot stoi.
+ *    - Panel pokazuje czujniki [0]=Right, [1]=Left każdego typu.
+ *    - Shell UART (shell.c): strojenie configu na żywo, drive/dump/cal; "panel off" wycisza panel.
+ *    - UART: okres i poziom panelu (pełny/skrócony) adaptacyjne — cel uart_util_pct łącza.
  * ============================================================================
  */
 
@@ -22,8 +32,7 @@
 #include "i2c.h"
 #include "usart.h"
 #include "tim.h"
-#include "tf_luna_i2c.h"
-#include "tcs3472.h"
+#include "sensor.h"
 #include "ssd1306.h"
 #include "oled_panel.h"
 #include "debug_uart.h"
@@ -31,6 +40,18 @@
 #include "motor_bldc.h"
 #include "tank_drive.h"
 #include "drive_test.h"
+#include "edge_detect.h"
+#include "color_class.h"
+#include "dzlog.h"
+#include "shell.h"
+#include "cfg_store.h"
+#include "blackbox.h"
+#include "matchlog.h"
+#include "crash.h"
+#include "prof.h"
+#include "ramfunc.h"
+#include "stack_mon.h"
+#include "arena.h"
 #include <stdbool.h>
 
 /* Okresy (źródło: config.c) */
@@ -44,22 +65,22 @@
 #  define PERIOD_UART_MS  (CFG_Scheduler()->uart_ms)
 #endif
 
-/* Bufory danych sensorów */
-static TF_LunaData_t   g_RightLuna = {0};
-static TF_LunaData_t   g_LeftLuna  = {0};
-static TCS3472_Data_t  g_RightColor= {0};
-static TCS3472_Data_t  g_LeftColor = {0};
-
 /* Cache konfiguracji */
 static const ConfigMotors_t    *g_MotorsCfg = NULL;
 static const ConfigScheduler_t *g_SchedCfg  = NULL;
+static const ConfigLuna_t      *g_LunaCfg   = NULL;
 
 /* Soft-timery */
 static uint32_t tTank = 0, tSens = 0, tOLED = 0, tUART = 0;
 
-/* Rozfazowanie: 0=Right, 1=Left */
+/* Rozfazowanie: 0=I2C1 (Right), 1=I2C3 (Left) */
 static uint8_t  s_sensPhase = 0;
 
+/* TF-Luna trigger: Armed = czekamy na okno triggera w bieżącym okresie Tank,
+ *                  Fired = pomiar wyzwolony, wynik do odczytu w ticku Tank */
+static uint8_t  s_lunaTrigArmed = 0;
+static uint8_t  s_lunaTrigFired = 0;
+
 /* Jitter Tank — zbierany między kolejnymi printami UART */
 static uint32_t s_lastTankExec = 0;
 static uint32_t s_jMin = 0xFFFFFFFF;
@@ -67,6 +88,20 @@ static uint32_t s_jMax = 0;
 static uint64_t s_jSum = 0;
 static uint32_t s_jCnt = 0;
 
+/* blackbox: czasy zadań (cykle DWT) do rekordu z ticku Tank */
+static uint32_t s_loopMaxCyc = 0;          // maks. czas App_Tick() od poprzedniego rekordu
+
+/* UART: adaptacyjny okres i poziom panelu (sprzężenie od zajętości i dropów kolejki BULK).
+ * Cel: ramka zajmuje uart_util_pct łącza; zaległość/drop → wydłuż okres; gdy pełny panel
+ * nie mieści się nawet przy uart_max_ms → linia skrócona, powrót przy zapasie 20%. */
+typedef enum { UART_LVL_FULL = 0, UART_LVL_COMPACT = 1 } UartLevel_t;
+static uint16_t    s_uartPeriod    = 0;
+static UartLevel_t s_uartLevel     = UART_LVL_FULL;
+static uint32_t    s_uartFullBytes = 0;    // ostatni rozmiar pełnego panelu (B)
+static uint32_t    s_uartDropPrev  = 0;    // licznik odrzuconych ramek BULK (poprzednio)
+static uint8_t     s_uartHold      = 0;    // ramki do najbliższej zmiany poziomu (histereza)
+#define UART_LEVEL_HOLD  (10u)
+
 /* Harmonogram: anti-drift (trzymamy fazę) */
 static inline bool App_TaskDue(uint32_t now, uint32_t *last, uint32_t period)
 {
@@ -83,100 +118,305 @@ static inline void App_TaskPrime(uint32_t now, uint32_t *last, uint32_t period)
     *last = (period == 0U) ? now : (now - period);    // start „od razu”
 }
 
+/* Okres (ms), przy którym ramka bytes zajmuje uart_util_pct przepływności (8N1 = 10 bit/B) */
+static uint32_t App_UartNeedMs(uint32_t bytes)
+{
+    const uint32_t bps = huart2.Init.BaudRate / 10u;
+    const uint32_t pct = (g_SchedCfg->uart_util_pct != 0u) ? g_SchedCfg->uart_util_pct : 100u;
+    if (bps == 0u) return g_SchedCfg->uart_max_ms;
+    return (uint32_t)(((uint64_t)bytes * 1000u * 100u) / ((uint64_t)bps * pct));
+}
+
+/* Po ramce: nowy okres/poziom. backlog = zajętość BULK tuż przed ramką (>0 → łącze nie nadąża) */
+static void App_UartPace(uint32_t backlog)
+{
+    if (!g_SchedCfg->uart_adapt) return;
+
+    DebugUART_LaneStats_t st;
+    DebugUART_GetLaneStats(DEBUG_UART_LANE_BULK, &st);
+    const uint8_t dropped = (st.frames_dropped != s_uartDropPrev);
+    s_uartDropPrev = st.frames_dropped;
+    if (s_uartLevel == UART_LVL_FULL) s_uartFullBytes = st.last_frame_bytes;
+
+    const uint32_t lo   = g_SchedCfg->uart_min_ms;
+    const uint32_t hi   = g_SchedCfg->uart_max_ms;
+    const uint32_t need = App_UartNeedMs(st.last_frame_bytes);
+    uint32_t p = s_uartPeriod;
+
+    if (dropped)           p += p / 2u;                  // drop → mocny back-off
+    else if (backlog > 0u) p += p / 4u;                  // zaległość → łagodny back-off
+    else if (need > p)     p  = need;                    // w górę od razu
+    else                   p  = (3u * p + need) / 4u;    // w dół powoli (EMA 1/4)
+
+    /* Poziom: pełny panel nie mieści się w hi → skrócony; powrót przy zapasie 20%
+     * (min. UART_LEVEL_HOLD ramek na poziomie — bez przełączania co ramkę) */
+    if (s_uartHold > 0u) {
+        s_uartHold--;
+    } else if (s_uartLevel == UART_LVL_FULL && (p > hi || App_UartNeedMs(s_uartFullBytes) > hi)) {
+        s_uartLevel = UART_LVL_COMPACT;
+        s_uartHold  = UART_LEVEL_HOLD;
+        p = lo;                                          // krótka linia — od najczęstszego okresu
+    } else if (s_uartLevel == UART_LVL_COMPACT && !dropped && backlog == 0u &&
+               App_UartNeedMs(s_uartFullBytes) <= (hi * 80u) / 100u) {
+        s_uartLevel = UART_LVL_FULL;
+        s_uartHold  = UART_LEVEL_HOLD;
+        p = hi;                                          // pełny panel — od bezpiecznego okresu
+    }
+
+    if (p < lo) p = lo;
+    if (p > hi) p = hi;
+    s_uartPeriod = (uint16_t)p;
+}
+
+/* TCS3472: log zmiany gainu (pas CRIT — nie ginie przy zapchanym panelu) */
+void TCS3472_OnGainChange(const char* name, TCS_Gain_t oldg, TCS_Gain_t newg)
+{
+    static const char *const k_gain[] = { "1x", "4x", "16x", "60x" };
+    DZLOG_CRIT("[TCS %s] gain %s -> %s", name ? name : "?",
+                         k_gain[(unsigned)oldg & 3u], k_gain[(unsigned)newg & 3u]);
+}
+
+/* Edge: ucieczka od krawędzi kończy test jazdy i ręczny cel shella (pojechałyby z powrotem za krawędź) */
+void Edge_OnEscape(uint8_t hitR, uint8_t hitL)
+{
+    (void)hitR; (void)hitL;
+    Shell_DriveCancel();                    // ręczny cel 'drive L R' też się kończy
+    if (DriveTest_IsRunning()) {
+        DriveTest_Stop();
+        DZLOG_CRIT("EDGE: ucieczka -> test jazdy zatrzymany");
+    }
+}
+
+const char* App_TaskName(uint8_t id)
+{
+    static const char *const k_names[APP_TASK_COUNT] = {
+        "idle", "init", "edge", "shell", "log", "luna_trig", "tank", "sens", "oled", "uart",
+    };
+    return (id < APP_TASK_COUNT) ? k_names[id] : "?";
+}
+
+/* Napęd stoi (cel i rampa = 0, bez ucieczki) → wolno wstrzymać CPU na erase FLASH */
+uint8_t App_DriveIdle(void)
+{
+    int8_t tl, tr, cl, cr;
+    Tank_GetState(&tl, &tr, &cl, &cr);
+    return (uint8_t)(tl == 0 && tr == 0 && cl == 0 && cr == 0 && !Edge_IsEscaping());
+}
+
+/* ==== Blackbox: rekord stanu z ticku Tank (SRAM2) ==== */
+static inline uint16_t App_Sat16(uint32_t v) { return (uint16_t)((v > 0xFFFFu) ? 0xFFFFu : v); }
+
+static void App_BlackBoxRecord(uint32_t now, uint32_t dt, uint32_t tankCyc)
+{
+    BlackBox_Rec_t r;
+    const TF_LunaData_t  lR = Sensors_Luna(0),  lL = Sensors_Luna(1);
+    const TCS3472_Data_t cR = Sensors_Color(0), cL = Sensors_Color(1);
+    const uint8_t edge = Edge_Flags();
+
+    r.t_ms = now;
+    Tank_GetState(&r.tgt_l, &r.tgt_r, &r.cur_l, &r.cur_r);
+    r.esc_r_us = ESC_GetPulseUs(ESC_CH1);
+    r.esc_l_us = ESC_GetPulseUs(ESC_CH4);
+    r.luna_r   = lR.distance_filt;
+    r.luna_l   = lL.distance_filt;
+    r.clr_r    = cR.clear;
+    r.clr_l    = cL.clear;
+    r.dt_ms    = App_Sat16(dt);
+    r.tank_us  = App_Sat16(Prof_CyclesToUs(tankCyc));
+    r.loop_us  = App_Sat16(Prof_CyclesToUs(s_loopMaxCyc));
+    r.flags    = (uint8_t)(((edge & 0x01u) ? BB_F_EDGE_R : 0u) | ((edge & 0x02u) ? BB_F_EDGE_L : 0u) |
+                           (Edge_IsEscaping() ? BB_F_ESCAPE : 0u) | (Tank_IsOverridden() ? BB_F_OVERRIDE : 0u));
+    r.rsv      = 0u;
+    BlackBox_Push(&r);
+    s_loopMaxCyc = 0u;                     // nowe okno maksimum do następnego rekordu
+}
+
 /* ==== Init systemu i modułów ==== */
 void App_Init(void)
 {
+    Crash_Task(APP_TASK_INIT);
+    BlackBox_Init();                           // SRAM2: log poprzedniej sesji / flagi resetu
+    MatchLog_Init();                           // FLASH: indeks meczów + puste strony (napęd jeszcze w neutralu)
+    const uint8_t cfgLoaded = CfgStore_Load();   // zapisane bloki nadpisują domyślne (przed startem modułów)
+
     g_MotorsCfg = CFG_Motors();            // cache wskaźników
     g_SchedCfg  = CFG_Scheduler();
+    g_LunaCfg   = CFG_Luna();
 
     DebugUART_Init(&huart2);
-    DebugUART_Printf("\r\n=== DzikiBoT – start (clean) ===");
-    DebugUART_Printf("UART ready @115200 8N1");
+    DZLOG_CRIT("\r\n=== DzikiBoT – start (clean) ===");   // log startu: pas CRIT
+    DZLOG_CRIT("UART ready @115200 8N1");
+    (void)Crash_Report(0u);                    // raport błędu z poprzedniej sesji (jeśli był)
+    {
+        CfgStore_Info_t ci;
+        CfgStore_GetInfo(&ci);
+        DZLOG_CRIT("CFG: %u blok(ow) z FLASH (strona %d, seq %lu, bledne %u, poza zakresem %u)",
+                   (unsigned)cfgLoaded, (int)ci.active, (unsigned long)ci.seq, (unsigned)ci.bad,
+                   (unsigned)ci.rejected);
+    }
+    {
+        BlackBox_Info_t bi;
+        BlackBox_GetInfo(&bi);
+        DZLOG_CRIT("BB: %u rek. w %u/%u blokach SRAM2, rst=0x%02X", (unsigned)bi.count,
+                   (unsigned)bi.blocks, (unsigned)BLACKBOX_BLOCKS, (unsigned)bi.reset_flags);
+        if (bi.frozen) DZLOG_CRIT("BB: log zamrozony -> zrzut, potem nagrywanie");
+    }
+    Shell_Init();                          // polecenia z USART2 RX (Shell_Poll w App_Tick)
     I2C_Scan_All();                        // szybka diagnostyka I²C
 
-    TF_Luna_Right_Init(&hi2c1);            // Right (I2C1)
-    TF_Luna_Left_Init (&hi2c3);            // Left  (I2C3)
-    TCS3472_Right_Init(&hi2c1);            // Right (I2C1)
-    TCS3472_Left_Init (&hi2c3);            // Left  (I2C3)
+    Sensors_Init();                        // rejestr: TF-Luna + TCS3472 z tabel configu
 
     SSD1306_Init();
-    DebugUART_Printf("SSD1306 init OK.");
+    DZLOG_CRIT("SSD1306 init OK.");
 
     ESC_Init(&htim1);                      // TIM1: CH1=PA8 (Right), CH4=PA11 (Left)
     ESC_ArmNeutral(3000);                  // wymaganie ESC (neutral ~3 s)
     Tank_Init(&htim1);                     // rampa + mapowanie %→µs
+    Edge_Init(Sensors_ColorDev(0), Sensors_ColorDev(1)); // kalibracja czerni TCS R/L (robot jeszcze stoi)
 
     DriveTest_Start();                     // nieblokujący test jazdy
 
     /* pierwsze dane do OLED/UART „na start” */
-    g_RightLuna  = TF_Luna_Right_Read();
-    g_LeftLuna   = TF_Luna_Left_Read();
-    g_RightColor = TCS3472_Right_Read();
-    g_LeftColor  = TCS3472_Left_Read();
+    Sensors_ServiceKind(SENSOR_LUNA);
+    Sensors_ServiceKind(SENSOR_TCS);
 
     /* prime soft-timerów */
     const uint32_t now = HAL_GetTick();
     App_TaskPrime(now, &tTank, g_MotorsCfg->tick_ms);
     App_TaskPrime(now, &tSens, g_SchedCfg->sens_ms);
     App_TaskPrime(now, &tOLED, g_SchedCfg->oled_ms);
-    App_TaskPrime(now, &tUART, g_SchedCfg->uart_ms);
+    s_uartPeriod = g_SchedCfg->uart_ms;    // start adaptacji UART (pełny panel)
+    s_uartLevel  = UART_LVL_FULL;
+    App_TaskPrime(now, &tUART, s_uartPeriod);
 
     /* reset zmiennych pomocniczych */
     s_sensPhase    = 0u;
+    s_lunaTrigArmed = g_LunaCfg->trigger_mode ? 1u : 0u;
+    s_lunaTrigFired = 0u;
     s_lastTankExec = 0u; s_jMin = 0xFFFFFFFFu; s_jMax = 0u; s_jSum = 0u; s_jCnt = 0u;
+
+    Arena_Seal();                          // bufory przydzielone — w pętli nic nie alokujemy
+    {
+        Arena_Info_t ai;
+        Arena_GetInfo(&ai);
+        DZLOG_CRIT("MEM: arena %lu/%lu B (%u przydz.%s), sterta 0 B", (unsigned long)ai.used,
+                   (unsigned long)ai.size, (unsigned)ai.allocs, ai.fails ? ", ODMOWY!" : "");
+    }
+    DebugUART_SetCritWait(0u);             // od pętli: CRIT bez miejsca → linia odrzucona (licznik)
 }
 
 /* ==== Pętla zadań (nieblokująca) ==== */
 void App_Tick(void)
 {
     const uint32_t now = HAL_GetTick();
-    if (!g_MotorsCfg || !g_SchedCfg) return; // guard
+    if (!g_MotorsCfg || !g_SchedCfg || !g_LunaCfg) return; // guard
+    const uint32_t tLoop = Prof_Cycles();
+
+    const bool lunaTrig = (g_LunaCfg->trigger_mode != 0u);
+
+    /* 0a) Krawędź dohyo — najkrótsza ścieżka do ESC (własny soft-timer) */
+    Crash_Task(APP_TASK_EDGE);
+    Edge_Poll();
+
+    /* 0b) Shell UART — max kilka znaków i jedno polecenie; zmiany configu działają od następnego ticku */
+    Crash_Task(APP_TASK_SHELL);
+    Shell_Poll();
+    Crash_Task(APP_TASK_LOG);
+    BlackBox_DumpPoll();                   // zrzut blackbox (stronicowany, gdy aktywny)
+    MatchLog_Poll(App_DriveIdle());        // bloki SRAM2 → FLASH tylko w oknie jazdy; erase na postoju
+
+    /* 0) TF-Luna trigger — trig_lead_ms przed kolejnym tickiem Tank (tTank = faza ostatniego) */
+    if (lunaTrig && s_lunaTrigArmed) {
+        uint32_t lead = g_LunaCfg->trig_lead_ms;
+        if (lead >= g_MotorsCfg->tick_ms) lead = g_MotorsCfg->tick_ms - 1u; // ≥1 ms przed tickiem
+        if ((uint32_t)(now - tTank) >= (g_MotorsCfg->tick_ms - lead)) {
+            Crash_Event(APP_TASK_LUNA_TRIG, now);
+            Sensors_StartKind(SENSOR_LUNA);         // trigger wszystkich TF-Luna
+            s_lunaTrigArmed = 0u;
+            s_lunaTrigFired = 1u;
+        }
+    }
 
     /* 1) Napęd — rampa + reverse-gate */
     if (App_TaskDue(now, &tTank, g_MotorsCfg->tick_ms)) {
+        Crash_Event(APP_TASK_TANK, now);
+
+        /* lidar „just in time”: wynik triggera czytany tuż przed Tank_Update() */
+        if (lunaTrig) {
+            if (s_lunaTrigFired) {
+                Sensors_ServiceKind(SENSOR_LUNA);
+                s_lunaTrigFired = 0u;
+            }
+            s_lunaTrigArmed = 1u;                 // kolejny trigger w tym okresie
+        }
 
         /* pomiar jittera interwału między wywołaniami Tank_Update() */
+        const uint32_t dt = (s_lastTankExec != 0u) ? (uint32_t)(now - s_lastTankExec) : 0u;
         if (s_lastTankExec != 0u) {
-            const uint32_t dt = (uint32_t)(now - s_lastTankExec);
             if (dt < s_jMin) s_jMin = dt;
             if (dt > s_jMax) s_jMax = dt;
             s_jSum += dt; s_jCnt++;
         }
         s_lastTankExec = now;
 
-        DriveTest_Tick();                 // nieblokujący krok testu jazdy
-        Tank_Update();                    // rampa + mapowanie %→µs
+        if (!Edge_IsEscaping()) DriveTest_Tick(); // test jazdy wstrzymany w trakcie ucieczki
+        const uint32_t tTankCyc = Prof_Cycles();
+        Tank_Update();                    // rampa + mapowanie %→µs (SRAM2)
+        const uint32_t tankCyc = Prof_Cycles() - tTankCyc;
+        RamFn_Add(RAMFN_TANK, tankCyc);
+        App_BlackBoxRecord(now, dt, tankCyc);
     }
 
-    /* 2) Sensory — rozfazowane Right ⇄ Left (mniejsze szczyty I²C) */
+    /* 2) Sensory — rozfazowane I2C1 ⇄ I2C3 (mniejsze szczyty I²C); po 1 instancji typu na slot */
     if (App_TaskDue(now, &tSens, g_SchedCfg->sens_ms)) {
-        if (s_sensPhase == 0u) {
-            g_RightLuna  = TF_Luna_Right_Read();   // I2C1: TF-Luna Right
-            g_RightColor = TCS3472_Right_Read();   // I2C1: TCS Right
-            s_sensPhase  = 1u;
-        } else {
-            g_LeftLuna   = TF_Luna_Left_Read();    // I2C3: TF-Luna Left
-            g_LeftColor  = TCS3472_Left_Read();    // I2C3: TCS Left
-            s_sensPhase  = 0u;
+        Crash_Event(APP_TASK_SENS, now);
+        const CFG_I2CBus_t bus = (s_sensPhase == 0u) ? CFG_BUS_I2C1 : CFG_BUS_I2C3;
+
+        if (!lunaTrig) (void)Sensors_ServiceNext(bus, SENSOR_LUNA);  // TF-Luna (tryb ciągły)
+        const Sensor_t *tcs = Sensors_ServiceNext(bus, SENSOR_TCS);   // TCS3472
+        if (tcs) {                                                     // kalibracja (gdy aktywna)
+            const TCS3472_Data_t c = Sensors_Color(tcs->idx);
+            ColorClass_CaptureTick(&c, NULL);
         }
+
+        s_sensPhase = (uint8_t)(s_sensPhase ^ 1u);
     }
 
     /* 3) OLED — panel 7 linii */
     if (App_TaskDue(now, &tOLED, g_SchedCfg->oled_ms)) {
-        OLED_Panel_ShowSensors(&g_RightLuna, &g_LeftLuna, &g_RightColor, &g_LeftColor);
+        Crash_Event(APP_TASK_OLED, now);
+        const TF_LunaData_t  lR = Sensors_Luna(0),  lL = Sensors_Luna(1);   // spójne kopie
+        const TCS3472_Data_t cR = Sensors_Color(0), cL = Sensors_Color(1);
+        OLED_Panel_ShowSensors(&lR, &lL, &cR, &cL);
     }
 
-    /* 4) UART — panel + JIT linia (druk „po UART”, w tym samym takcie) */
-    if (App_TaskDue(now, &tUART, g_SchedCfg->uart_ms)) {
-        DebugUART_SensorsDual(&g_RightLuna, &g_LeftLuna, &g_RightColor, &g_LeftColor);
+    /* 4) UART — panel + JIT linia (druk „po UART”, w tym samym takcie); okres adaptacyjny */
+    if (App_TaskDue(now, &tUART, s_uartPeriod) && Shell_PanelEnabled()) {
+        Crash_Event(APP_TASK_UART, now);
+        const TF_LunaData_t  lR = Sensors_Luna(0),  lL = Sensors_Luna(1);   // spójne kopie
+        const TCS3472_Data_t cR = Sensors_Color(0), cL = Sensors_Color(1);
+        DebugUART_LaneStats_t st;
+        DebugUART_GetLaneStats(DEBUG_UART_LANE_BULK, &st);   // zaległość przed ramką
 
-        if (s_jCnt > 0u) {
-            const uint32_t avg = (uint32_t)(s_jSum / s_jCnt);
-            DebugUART_PrintJitter(g_MotorsCfg->tick_ms, s_jMin, avg, s_jMax, 1u);
+        DebugUART_FrameBegin();                        // panel + JIT = jedna ramka BULK
+        if (s_uartLevel == UART_LVL_FULL) {
+            DebugUART_SensorsDual(&lR, &lL, &cR, &cL);
+            if (s_jCnt > 0u) {
+                const uint32_t avg = (uint32_t)(s_jSum / s_jCnt);
+                DebugUART_PrintJitter(g_MotorsCfg->tick_ms, s_jMin, avg, s_jMax, 1u);
+            } else {
+                DebugUART_PrintJitter(g_MotorsCfg->tick_ms, 0u, 0u, 0u, 0u);
+            }
         } else {
-            DebugUART_PrintJitter(g_MotorsCfg->tick_ms, 0u, 0u, 0u, 0u);
+            DebugUART_SensorsCompact(&lR, &lL, &cR, &cL);
         }
+        (void)DebugUART_FrameEnd();
+        App_UartPace(st.used);
         /* wyczyść okno statystyk do następnego cyklu UART */
         s_jMin = 0xFFFFFFFFu; s_jMax = 0u; s_jSum = 0u; s_jCnt = 0u;
     }
+
+    StackMon_Poll();                                   // porcja skanu high-water mark stosu
+    PROF_MAX_UPDATE(s_loopMaxCyc, tLoop);
+    Crash_Task(APP_TASK_IDLE);
 }
@@ -0,0 +1,62 @@
+/*
+ * ============================================================================
+ *  MODULE: arena — statyczna arena na bufory (implementacja)
+ *  ----------------------------------------------------------------------------
+ *  CO:
+ *    - Wskaźnik „bump” po s_mem; brak free — przydziały żyją do resetu.
+ *    - Wołana tylko z pętli głównej (Init modułów) — bez blokad.
+ * ============================================================================
+ */
+
+#include "arena.h"
+
+#define ARENA_ALIGN  8u
+
+static uint8_t  s_mem[ARENA_SIZE] __attribute__((aligned(ARENA_ALIGN)));
+static uint32_t s_used   = 0;
+static uint16_t s_allocs = 0;
+static uint16_t s_fails  = 0;
+static uint8_t  s_sealed = 0;
+
+static const char *s_tag[ARENA_MAX_TAGS];
+static uint32_t    s_tagSize[ARENA_MAX_TAGS];
+
+void *Arena_Alloc(size_t size, const char *tag)
+{
+    const uint32_t need = ((uint32_t)size + (ARENA_ALIGN - 1u)) & ~(ARENA_ALIGN - 1u);
+    if (s_sealed || size == 0u || need > ARENA_SIZE - s_used) {
+        s_fails++;
+        return NULL;
+    }
+    void *p = &s_mem[s_used];
+    s_used += need;
+    if (s_allocs < ARENA_MAX_TAGS) {
+        s_tag[s_allocs]     = tag ? tag : "?";
+        s_tagSize[s_allocs] = need;
+    }
+    s_allocs++;
+    return p;
+}
+
+void Arena_Seal(void)
+{
+    s_sealed = 1u;
+}
+
+void Arena_GetInfo(Arena_Info_t *out)
+{
+    if (!out) return;
+    out->size   = ARENA_SIZE;
+    out->used   = s_used;
+    out->allocs = s_allocs;
+    out->fails  = s_fails;
+    out->sealed = s_sealed;
+}
+
+uint8_t Arena_GetEntry(uint8_t i, const char **tag, uint32_t *size)
+{
+    if (i >= s_allocs || i >= ARENA_MAX_TAGS) return 0u;
+    if (tag)  *tag  = s_tag[i];
+    if (size) *size = s_tagSize[i];
+    return 1u;
+}
@@ -0,0 +1,201 @@
+/*
+ * ============================================================================
+ *  MODULE: bench — mikrobenchmarki czystej logiki (implementacja, DZB_BENCH)
+ *  ----------------------------------------------------------------------------
+ *  CO:
+ *    - k_cases[]: przypadki z akcesorów modułów (*_Bench*) i z publicznego API
+ *      (Throttle_Apply, TCS3472_Process w trybie pinned, SSD1306_DrawTextAt,
+ *      Fmt_Fixed, OLED_Panel_Render, rekord DZLOG) — nic tu nie dotyka I²C ani UART.
+ *    - bench_measure(): rozgrzewka n/8, potem BENCH_REPEAT × n iteracji, minimum.
+ *    - Wynik stałoprzecinkowo (×10) na liczbach całkowitych — bez %f (brak sterty).
+ * ============================================================================
+ */
+
+#include "bench.h"
+
+#ifdef DZB_BENCH
+
+#include "tank_drive.h"
+#include "throttle_map.h"
+#include "tf_luna_i2c.h"
+#include "tcs3472.h"
+#include "ssd1306.h"
+#include "oled_panel.h"
+#include "fmt.h"
+#include "prof.h"
+#include "debug_uart.h"
+#include "dzlog.h"
+#include <stdio.h>
+#include <string.h>
+
+/* Suma kontrolna ostatniego przypadku — volatile, by pętla nie została wycięta */
+static volatile uint32_t s_sink;
+
+/* ==== Porty (weak — host podmienia w Tools/host/bench_main.c) ==== */
+__attribute__((weak)) uint32_t Bench_PortCycles(void) { return Prof_Cycles(); }
+__attribute__((weak)) uint32_t Bench_PortHz(void)     { return SystemCoreClock; }
+__attribute__((weak)) void     Bench_PortPrint(const char *line) { DebugUART_Crit(line); }
+
+/* ==== Przypadki z publicznego API ==== */
+
+static uint32_t bench_throttle(uint32_t n)
+{
+    Throttle_Init(&THROTTLE_DEFAULTS);                 // moduł nieużywany w pętli — bez skutków
+    uint32_t acc = 0u;
+    for (uint32_t i = 0; i < n; ++i) {
+        acc += (uint8_t)Throttle_Apply((int8_t)((int)(i % 201u) - 100), (i & 1u) ? THR_RIGHT : THR_LEFT);
+    }
+    return acc;
+}
+
+/* TCS3472_Process: EMA + saturacja + metadane; pinned=1 → krok stały, zero zapisów I²C */
+static uint32_t bench_tcs_process(uint32_t n)
+{
+    TCS3472_t S;
+    memset(&S, 0, sizeof(S));
+    S.pinned = 1u;
+    S.gain   = TCS_GAIN_16X;
+
+    TCS3472_Data_t raw = {0};
+    uint32_t acc = 0u, x = 5u;
+    for (uint32_t i = 0; i < n; ++i) {
+        x = x * 1103515245u + 12345u;
+        raw.clear = (uint16_t)(x >> 16);
+        raw.red   = (uint16_t)(raw.clear >> 2);
+        raw.green = (uint16_t)(raw.clear >> 1);
+        raw.blue  = (uint16_t)(raw.clear >> 3);
+        S.last_poll += 24u;
+        acc += TCS3472_Process(&S, &raw).clear;
+    }
+    return acc;
+}
+
+static uint32_t bench_draw_text(uint32_t n)
+{
+    static const char k_line[] = "D  R:123cm  L: 45cm  ";   // 21 znaków = pełna linia
+    for (uint32_t i = 0; i < n; ++i) {
+        SSD1306_DrawTextAt((uint8_t)(i & 7u), 0u, k_line);
+    }
+    return n;
+}
+
+static uint32_t bench_fmt_fixed(uint32_t n)
+{
+    char buf[12];
+    uint32_t acc = 0u;
+    for (uint32_t i = 0; i < n; ++i) {
+        acc += (uint8_t)Fmt_Fixed(buf, sizeof(buf), (float)(int32_t)(i * 7919u % 20001u) * 0.01f - 100.0f, 1u, 6u)[5];
+    }
+    return acc;
+}
+
+static uint32_t bench_panel_render(uint32_t n)
+{
+    TF_LunaData_t  R, L;
+    TCS3472_Data_t CR, CL;
+    memset(&R, 0, sizeof(R));   memset(&L, 0, sizeof(L));
+    memset(&CR, 0, sizeof(CR)); memset(&CL, 0, sizeof(CL));
+    for (uint32_t i = 0; i < n; ++i) {
+        R.distance_filt = (uint16_t)(i % 800u);  L.distance_filt = (uint16_t)(799u - i % 800u);
+        R.strength_filt = (uint16_t)(i * 13u);   L.strength_filt = (uint16_t)(i * 17u);
+        R.temperature   = 25.0f + (float)(i & 15u) * 0.1f;
+        L.temperature   = 26.5f - (float)(i & 7u)  * 0.1f;
+        CR.clear = (uint16_t)(i * 101u); CR.red = (uint16_t)(i * 31u); CR.green = (uint16_t)(i * 47u); CR.blue = (uint16_t)(i * 23u);
+        CL = CR;
+        OLED_Panel_Render(&R, &L, &CR, &CL);
+    }
+    return n;
+}
+
+/* Koszt komunikatu CRIT na MCU bez wysyłki: z DZB_LOG_BINARY = rozwinięcie DZLOG_CRIT
+ * bez DzLog_End (ID + argumenty do rekordu), bez flagi = formatowanie jak CritPrintf.
+ * Ten sam komunikat co "dump sens" — porównuj wyniki obu buildów. */
+static uint32_t bench_dzlog_emit(uint32_t n)
+{
+    static const char *const k_name[2] = { "RIGHT", "LEFT" };
+    uint32_t acc = 0u;
+    for (uint32_t i = 0; i < n; ++i) {
+        const char    *name = k_name[i & 1u];
+        const unsigned cm   = (unsigned)(i % 800u);
+        const unsigned str  = (unsigned)((i * 13u) & 0xFFFFu);
+#ifdef DZB_LOG_BINARY
+        DzLog_Rec_t r;
+        DzLog_Begin(&r, (uint16_t)i);
+        DzLog_Str(&r, name);
+        DzLog_U32(&r, cm);
+        DzLog_U32(&r, str);
+        DzLog_Str(&r, "OK");
+        acc += r.n + r.buf[DZLOG_HDR_LEN + 1u];
+#else
+        char line[96];
+        acc += (uint32_t)snprintf(line, sizeof(line), "Luna %s: %u cm str=%u %s", name, cm, str, "OK");
+#endif
+    }
+    return acc;
+}
+
+/* ==== Tabela przypadków (iteracje dla targetu — rząd pojedynczych ms na przypadek) ==== */
+static const Bench_Case_t k_cases[] = {
+    { "tank.ramp_once",     Tank_BenchRamp,        4000u },
+    { "tank.ema_step",      Tank_BenchEma,         4000u },
+    { "tank.esc_window",    Tank_BenchEscWindow,   4000u },
+    { "throttle.apply",     bench_throttle,        1000u },
+    { "luna.median_u16",    TF_Luna_BenchMedian,   2000u },
+    { "luna.filt_update",   TF_Luna_BenchFilter,   1000u },
+    { "tcs.process",        bench_tcs_process,     1000u },
+    { "tcs.pick_step",      TCS3472_BenchPickStep, 1000u },
+    { "oled.draw_char",     SSD1306_BenchDrawChar, 4000u },
+    { "oled.draw_text",     bench_draw_text,        200u },
+    { "fmt.fixed",          bench_fmt_fixed,        500u },
+    { "oled.panel_render",  bench_panel_render,      20u },
+    { "dzlog.emit",         bench_dzlog_emit,       500u },
+};
+#define BENCH_NCASES  (sizeof(k_cases) / sizeof(k_cases[0]))
+
+/* Minimum cykli z BENCH_REPEAT przebiegów po n iteracji (po rozgrzewce) */
+static uint32_t bench_measure(const Bench_Case_t *c, uint32_t n)
+{
+    s_sink = c->fn(n / 8u + 1u);
+    uint32_t best = 0xFFFFFFFFu;
+    for (uint32_t r = 0; r < BENCH_REPEAT; ++r) {
+        const uint32_t t0 = Bench_PortCycles();
+        s_sink = c->fn(n);
+        const uint32_t d = Bench_PortCycles() - t0;
+        if (d < best) best = d;
+    }
+    return best;
+}
+
+uint16_t Bench_Run(const char *prefix, uint32_t scale)
+{
+    const size_t   plen = prefix ? strlen(prefix) : 0u;
+    const uint32_t hz   = Bench_PortHz();
+    char line[96];
+    uint16_t done = 0u;
+
+    if (scale == 0u) scale = 1u;
+    (void)snprintf(line, sizeof(line), "BENCH # hz=%lu repeat=%u scale=%lu",
+                   (unsigned long)hz, (unsigned)BENCH_REPEAT, (unsigned long)scale);
+    Bench_PortPrint(line);
+    Bench_PortPrint("BENCH # case                 iters      ns/op     cyc/op");
+
+    for (uint32_t i = 0; i < BENCH_NCASES; ++i) {
+        const Bench_Case_t *c = &k_cases[i];
+        if (plen && strncmp(c->name, prefix, plen) != 0) continue;
+
+        const uint32_t n   = c->iters * scale;
+        const uint64_t cyc = bench_measure(c, n);
+        const uint64_t c10 = (cyc * 10u + n / 2u) / n;                          // cyc/op ×10
+        const uint64_t n10 = (hz >= 100u) ? (cyc * 100000000ull / (hz / 100u) + n / 2u) / n : 0u; // ns/op ×10
+
+        (void)snprintf(line, sizeof(line), "BENCH %-20s %7lu %8lu.%lu %8lu.%lu",
+                       c->name, (unsigned long)n,
+                       (unsigned long)(n10 / 10u), (unsigned long)(n10 % 10u),
+                       (unsigned long)(c10 / 10u), (unsigned long)(c10 % 10u));
+        Bench_PortPrint(line);
+        done++;
+    }
+    return done;
+}
+
+#endif /* DZB_BENCH */
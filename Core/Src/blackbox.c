@@ -0,0 +1,398 @@
+/*
+ * ============================================================================
+ *  MODULE: blackbox — rejestrator w SRAM2 (implementacja)
+ *  ----------------------------------------------------------------------------
+ *  CO:
+ *    - Nagłówek + pierścień bloków w jednej strukturze w .ram2_noinit; nagłówek ważny,
+ *      gdy zgadza się magic i geometria (inaczej: czysty log).
+ *    - Blok: [len u16][nrec u8][rsv u8] + rekordy. Rekord:
+ *        [maska varint: bit i = pole i ≠ predykcji] + [zigzag varint różnicy] dla bitów 1.
+ *      Predykcja: keyframe → 0 (czas: 0), dalej poprzedni rekord (czas: t + Δt poprz.).
+ *      Kolejność pól (rec_to_vec) = od najczęściej zmiennych (maska zwykle 1 B).
+ *    - Nowy blok: rekord się nie mieści, BB_BLOCK_RECS rekordów lub nowa sesja.
+ *    - Zrzut: nagłówek + wiersz kolumn + CSV (dekoder jak w Tools/bb_decode.py),
+ *      lub bloki hex po 32 B; linia tylko przy wolnym miejscu w CRIT.
+ * ============================================================================
+ */
+
+#include "blackbox.h"
+#include "debug_uart.h"
+#include "dzlog.h"           // DZLOG_CRIT() — komunikaty; wiersze CSV/BBX zostają tekstem (narzędzia)
+#include "stm32l4xx_hal.h"   // RCC->CSR
+#include <string.h>
+
+#define BB_MAGIC        0x42425A45u   // "EZBB" — format v2 (bloki delta/varint)
+#define BB_BLK_HDR      4u            // [len u16][nrec u8][rsv u8]
+#define BB_BLOCK_RECS   64u           // maks. rekordów w bloku (ogranicza koszt dekodowania)
+#define BB_NFIELDS      15u
+#define BB_DUMP_LINE    112u          // maks. linia zrzutu — + zapas zdarzeń CRIT
+#define BB_DUMP_LINES   4u            // maks. linii na jedno DumpPoll()
+#define BB_RAW_CHUNK    32u           // bajty bloku na linię "bb raw"
+
+/* Reset „nienormalny” → zamroź log poprzedniej sesji (RCC->CSR[31:24]) */
+#define BB_RST_FREEZE   ((RCC_CSR_SFTRSTF | RCC_CSR_IWDGRSTF | RCC_CSR_WWDGRSTF | RCC_CSR_BORRSTF) >> 24)
+
+_Static_assert(BLACKBOX_BLOCK_SIZE <= 0xFFFFu && BLACKBOX_BLOCK_SIZE >= BB_BLK_HDR + BB_ENC_MAX, "rozmiar bloku");
+
+typedef struct {
+    uint32_t magic;
+    uint16_t block_size;
+    uint16_t blocks;
+    uint16_t head;                     // blok w zapisie
+    uint16_t used;                     // bloki w logu (z head włącznie)
+    uint16_t boots;
+    uint8_t  frozen;
+    uint8_t  reset_flags;
+    uint8_t  blk[BLACKBOX_BLOCKS][BLACKBOX_BLOCK_SIZE];
+} BlackBox_Mem_t;
+
+/* SRAM2, bez zerowania przez startup — przeżywa reset ciepły */
+static BlackBox_Mem_t s_bb __attribute__((section(".ram2_noinit"), aligned(8)));
+
+/* Stan kodera (RAM; po resecie nowa sesja zaczyna nowy blok) */
+typedef struct {
+    int32_t v[BB_NFIELDS];             // poprzedni rekord (wektor pól)
+    int32_t dt;                        // poprzednia delta czasu
+} BB_Pred_t;
+
+static BB_Pred_t s_enc;
+static uint8_t   s_newBlock = 1;       // następny Push zaczyna blok (keyframe)
+static uint8_t   s_bootPending = 0;    // następny Push = pierwszy rekord sesji
+static uint8_t   s_rstFlags = 0;
+static uint32_t  s_blkSeq = 0;         // numer bloku w zapisie (od startu; 0 = brak bloku)
+static uint8_t   s_autoArm = 0;        // log zamrożony przy starcie → po pełnym zrzucie nagrywaj
+
+/* Zrzut: blok/pozycja/predykcja dekodera + linie nagłówka */
+static uint8_t   s_dumping = 0;
+static uint8_t   s_dumpRaw = 0;
+static uint8_t   s_dumpHdr = 0;        // 0 = nagłówek, 1 = kolumny, 2 = dane
+static uint16_t  s_dumpBlk = 0;        // n-ty najstarszy blok
+static uint16_t  s_dumpPos = 0;        // offset w bloku
+static BB_Pred_t s_dec;
+
+/* ==== Wektor pól (kolejność = częstość zmian) ==== */
+
+static void rec_to_vec(const BlackBox_Rec_t *r, int32_t *v)
+{
+    v[0]  = (int32_t)r->t_ms;
+    v[1]  = r->luna_r;   v[2]  = r->luna_l;
+    v[3]  = r->clr_r;    v[4]  = r->clr_l;
+    v[5]  = r->tank_us;  v[6]  = r->loop_us;
+    v[7]  = r->cur_l;    v[8]  = r->cur_r;
+    v[9]  = r->tgt_l;    v[10] = r->tgt_r;
+    v[11] = r->esc_r_us; v[12] = r->esc_l_us;
+    v[13] = r->dt_ms;    v[14] = r->flags;
+}
+
+static void vec_to_rec(const int32_t *v, BlackBox_Rec_t *r)
+{
+    r->t_ms     = (uint32_t)v[0];
+    r->luna_r   = (uint16_t)v[1];  r->luna_l   = (uint16_t)v[2];
+    r->clr_r    = (uint16_t)v[3];  r->clr_l    = (uint16_t)v[4];
+    r->tank_us  = (uint16_t)v[5];  r->loop_us  = (uint16_t)v[6];
+    r->cur_l    = (int8_t)v[7];    r->cur_r    = (int8_t)v[8];
+    r->tgt_l    = (int8_t)v[9];    r->tgt_r    = (int8_t)v[10];
+    r->esc_r_us = (uint16_t)v[11]; r->esc_l_us = (uint16_t)v[12];
+    r->dt_ms    = (uint16_t)v[13]; r->flags    = (uint8_t)v[14];
+    r->rsv      = 0u;
+}
+
+/* ==== Zigzag + varint ==== */
+
+static inline uint32_t zz_enc(int32_t d) { return ((uint32_t)d << 1) ^ (uint32_t)(d >> 31); }
+static inline int32_t  zz_dec(uint32_t u) { return (int32_t)(u >> 1) ^ -(int32_t)(u & 1u); }
+
+static uint8_t *put_varint(uint8_t *p, uint32_t u)
+{
+    while (u >= 0x80u) { *p++ = (uint8_t)(u | 0x80u); u >>= 7; }
+    *p++ = (uint8_t)u;
+    return p;
+}
+
+/* 0 = koniec danych w trakcie varinta (blok uszkodzony) */
+static uint8_t get_varint(const uint8_t **p, const uint8_t *end, uint32_t *u)
+{
+    uint32_t v = 0u;
+    for (uint8_t sh = 0; sh < 35u; sh = (uint8_t)(sh + 7u)) {
+        if (*p >= end) return 0u;
+        const uint8_t b = *(*p)++;
+        v |= (uint32_t)(b & 0x7Fu) << sh;
+        if (!(b & 0x80u)) { *u = v; return 1u; }
+    }
+    return 0u;
+}
+
+static inline int32_t predict(const BB_Pred_t *pr, uint8_t i)
+{
+    return (i == 0u) ? (int32_t)((uint32_t)pr->v[0] + (uint32_t)pr->dt) : pr->v[i];
+}
+
+static void pred_update(BB_Pred_t *pr, const int32_t *v)
+{
+    pr->dt = (int32_t)((uint32_t)v[0] - (uint32_t)pr->v[0]);
+    memcpy(pr->v, v, sizeof(pr->v));
+}
+
+/* Kodowanie rekordu (≤ BB_ENC_MAX B); zwraca liczbę bajtów */
+static uint16_t bb_encode(uint8_t *out, const int32_t *v, BB_Pred_t *pr)
+{
+    uint32_t mask = 0u;
+    uint32_t zz[BB_NFIELDS];
+    for (uint8_t i = 0; i < BB_NFIELDS; i++) {
+        zz[i] = zz_enc((int32_t)((uint32_t)v[i] - (uint32_t)predict(pr, i)));
+        if (zz[i] != 0u) mask |= 1u << i;
+    }
+    uint8_t *p = put_varint(out, mask);
+    for (uint8_t i = 0; i < BB_NFIELDS; i++) if (mask & (1u << i)) p = put_varint(p, zz[i]);
+    pred_update(pr, v);
+    return (uint16_t)(p - out);
+}
+
+/* Dekodowanie rekordu; 0 = błąd formatu */
+static uint8_t bb_decode(const uint8_t **p, const uint8_t *end, int32_t *v, BB_Pred_t *pr)
+{
+    uint32_t mask;
+    if (!get_varint(p, end, &mask) || mask >= (1u << BB_NFIELDS)) return 0u;
+    for (uint8_t i = 0; i < BB_NFIELDS; i++) {
+        uint32_t zz = 0u;
+        if ((mask & (1u << i)) && !get_varint(p, end, &zz)) return 0u;
+        v[i] = (int32_t)((uint32_t)predict(pr, i) + (uint32_t)zz_dec(zz));
+    }
+    pred_update(pr, v);
+    return 1u;
+}
+
+/* ==== Bloki ==== */
+
+static inline uint16_t blk_len(const uint8_t *b)  { return (uint16_t)(b[0] | (b[1] << 8)); }
+static inline void     blk_set_len(uint8_t *b, uint16_t n) { b[0] = (uint8_t)n; b[1] = (uint8_t)(n >> 8); }
+
+static inline uint16_t blk_index(uint16_t nth)   // n-ty najstarszy blok → indeks w pierścieniu
+{
+    return (uint16_t)((s_bb.head + 1u + BLACKBOX_BLOCKS - s_bb.used + nth) % BLACKBOX_BLOCKS);
+}
+
+static uint8_t blk_valid(const uint8_t *b)
+{
+    const uint16_t n = blk_len(b);
+    return (uint8_t)(n >= BB_BLK_HDR && n <= BLACKBOX_BLOCK_SIZE);
+}
+
+static void blk_open(void)
+{
+    if (s_bb.used > 0u) s_bb.head = (uint16_t)((s_bb.head + 1u) % BLACKBOX_BLOCKS);
+    if (s_bb.used < BLACKBOX_BLOCKS) s_bb.used++;          // pełny pierścień → najstarszy blok znika
+    uint8_t *b = s_bb.blk[s_bb.head];
+    blk_set_len(b, BB_BLK_HDR);
+    b[2] = 0u;
+    b[3] = 0u;
+    memset(&s_enc, 0, sizeof(s_enc));                      // keyframe: predykcja = 0
+    s_newBlock = 0u;
+    s_blkSeq++;
+}
+
+static void bb_clear(void)
+{
+    s_bb.magic      = BB_MAGIC;
+    s_bb.block_size = (uint16_t)BLACKBOX_BLOCK_SIZE;
+    s_bb.blocks     = (uint16_t)BLACKBOX_BLOCKS;
+    s_bb.head       = 0u;
+    s_bb.used       = 0u;
+    s_bb.boots      = 0u;
+    s_bb.frozen     = 0u;
+}
+
+static uint8_t crit_room(void)
+{
+    return DebugUART_CritRoom(BB_DUMP_LINE);
+}
+
+/* ==== API ==== */
+
+void BlackBox_Init(void)
+{
+    s_rstFlags = (uint8_t)(RCC->CSR >> 24);
+    __HAL_RCC_CLEAR_RESET_FLAGS();
+
+    uint8_t valid = (s_bb.magic == BB_MAGIC && s_bb.block_size == BLACKBOX_BLOCK_SIZE &&
+                     s_bb.blocks == BLACKBOX_BLOCKS && s_bb.head < BLACKBOX_BLOCKS &&
+                     s_bb.used <= BLACKBOX_BLOCKS);
+    for (uint16_t i = 0; valid && i < s_bb.used; i++) valid = blk_valid(s_bb.blk[blk_index(i)]);
+    if (!valid) bb_clear();
+
+    s_bb.boots++;
+    s_bb.reset_flags = s_rstFlags;
+    if (valid && s_bb.used > 0u && (s_rstFlags & BB_RST_FREEZE) != 0u) s_bb.frozen = 1u;
+
+    s_newBlock    = 1u;                   // sesja zaczyna własny blok
+    s_bootPending = 1u;
+    s_dumping     = 0u;
+    s_autoArm     = s_bb.frozen;
+    if (s_bb.frozen) BlackBox_DumpStart(0u);   // log poprzedniej sesji od razu na UART
+}
+
+void BlackBox_Push(const BlackBox_Rec_t *r)
+{
+    if (s_bb.frozen || s_dumping) return;
+
+    int32_t v[BB_NFIELDS];
+    rec_to_vec(r, v);
+    if (s_bootPending) { v[14] |= BB_F_BOOT; s_bootPending = 0u; }
+
+    /* kodowanie do bufora: nie mieści się → nowy blok i ponownie jako keyframe (max 2 × koszt) */
+    uint8_t   tmp[BB_ENC_MAX];
+    BB_Pred_t pr = s_enc;
+    uint8_t  *b  = s_bb.blk[s_bb.head];
+    uint16_t  n  = s_newBlock ? 0u : bb_encode(tmp, v, &pr);
+    if (s_newBlock || s_bb.used == 0u || b[2] >= BB_BLOCK_RECS ||
+        blk_len(b) + n > BLACKBOX_BLOCK_SIZE) {
+        blk_open();
+        b  = s_bb.blk[s_bb.head];
+        pr = s_enc;
+        n  = bb_encode(tmp, v, &pr);
+    }
+    const uint16_t len = blk_len(b);
+    memcpy(b + len, tmp, n);
+    blk_set_len(b, (uint16_t)(len + n));
+    b[2]++;
+    s_enc = pr;
+}
+
+uint32_t BlackBox_BlockSeq(void)
+{
+    return s_blkSeq;
+}
+
+const uint8_t* BlackBox_PeekBlock(uint32_t seq)
+{
+    if (seq == 0u || seq >= s_blkSeq) return NULL;         // brak / blok jeszcze otwarty
+    const uint32_t back = s_blkSeq - seq;                  // 1 = poprzedni zamknięty
+    if (back >= s_bb.used) return NULL;                    // już nadpisany
+    return s_bb.blk[(s_bb.head + BLACKBOX_BLOCKS - back) % BLACKBOX_BLOCKS];
+}
+
+void BlackBox_Freeze(void)
+{
+    s_bb.frozen = 1u;
+    s_autoArm   = 0u;                             // ręczne / z błędu: czeka na "bb arm" albo restart
+}
+
+void BlackBox_Arm(void)
+{
+    bb_clear();
+    if (s_blkSeq) s_blkSeq += BLACKBOX_BLOCKS;    // stare numery tej sesji → „nadpisane” dla czytelników
+    s_autoArm     = 0u;
+    s_bb.boots    = 1u;
+    s_dumping     = 0u;
+    s_newBlock    = 1u;
+    s_bootPending = 1u;
+}
+
+void BlackBox_DumpStart(uint8_t raw)
+{
+    s_dumping = 1u;
+    s_dumpRaw = raw;
+    s_dumpHdr = 0u;
+    s_dumpBlk = 0u;
+    s_dumpPos = 0u;
+}
+
+/* Kolejna linia CSV; 0 = koniec logu */
+static uint8_t dump_csv_line(void)
+{
+    while (s_dumpBlk < s_bb.used) {
+        const uint8_t *b   = s_bb.blk[blk_index(s_dumpBlk)];
+        const uint8_t *end = b + blk_len(b);
+        if (s_dumpPos == 0u) { s_dumpPos = BB_BLK_HDR; memset(&s_dec, 0, sizeof(s_dec)); }
+        const uint8_t *p = b + s_dumpPos;
+        int32_t v[BB_NFIELDS];
+        if (p < end && bb_decode(&p, end, v, &s_dec)) {
+            BlackBox_Rec_t r;
+            vec_to_rec(v, &r);
+            s_dumpPos = (uint16_t)(p - b);
+            DebugUART_CritPrintf("%lu,%d,%d,%d,%d,%u,%u,%u,%u,%u,%u,%u,%u,%u,%02X",
+                                 (unsigned long)r.t_ms, (int)r.tgt_l, (int)r.tgt_r,
+                                 (int)r.cur_l, (int)r.cur_r, (unsigned)r.esc_r_us,
+                                 (unsigned)r.esc_l_us, (unsigned)r.luna_r, (unsigned)r.luna_l,
+                                 (unsigned)r.clr_r, (unsigned)r.clr_l, (unsigned)r.dt_ms,
+                                 (unsigned)r.tank_us, (unsigned)r.loop_us, (unsigned)r.flags);
+            return 1u;
+        }
+        s_dumpBlk++;                      // koniec bloku (lub blok uszkodzony) → następny
+        s_dumpPos = 0u;
+    }
+    return 0u;
+}
+
+/* Kolejna linia hex: "BBX <blok> <offset> <hex>"; 0 = koniec logu */
+static uint8_t dump_raw_line(void)
+{
+    static const char k_hex[] = "0123456789ABCDEF";
+    while (s_dumpBlk < s_bb.used) {
+        const uint8_t *b = s_bb.blk[blk_index(s_dumpBlk)];
+        const uint16_t n = blk_len(b);
+        if (s_dumpPos < n) {
+            char line[2u * BB_RAW_CHUNK + 1u];
+            uint16_t k = 0u;
+            for (uint16_t i = s_dumpPos; i < n && k < 2u * BB_RAW_CHUNK; i++) {
+                line[k++] = k_hex[b[i] >> 4];
+                line[k++] = k_hex[b[i] & 0x0Fu];
+            }
+            line[k] = '\0';
+            DebugUART_CritPrintf("BBX %u %u %s", (unsigned)s_dumpBlk, (unsigned)s_dumpPos, line);
+            s_dumpPos = (uint16_t)(s_dumpPos + k / 2u);
+            return 1u;
+        }
+        s_dumpBlk++;
+        s_dumpPos = 0u;
+    }
+    return 0u;
+}
+
+void BlackBox_DumpPoll(void)
+{
+    for (uint8_t n = 0; s_dumping && n < BB_DUMP_LINES && crit_room(); n++) {
+        if (s_dumpHdr == 0u) {
+            BlackBox_Info_t bi;
+            BlackBox_GetInfo(&bi);
+            DZLOG_CRIT("BB: %u rek. w %u/%u blokach (%u B), boot %u, rst=0x%02X%s",
+                       (unsigned)bi.count, (unsigned)bi.blocks, (unsigned)BLACKBOX_BLOCKS,
+                       (unsigned)bi.bytes, (unsigned)s_bb.boots, (unsigned)s_bb.reset_flags,
+                       s_bb.frozen ? " (zamrozony)" : "");
+            s_dumpHdr = 1u;
+        } else if (s_dumpHdr == 1u) {
+            if (!s_dumpRaw) DebugUART_Crit("t_ms,tgtL,tgtR,curL,curR,escR,escL,lunaR,lunaL,clrR,clrL,dt,tank_us,loop_us,flags");
+            s_dumpHdr = 2u;
+        } else if (!(s_dumpRaw ? dump_raw_line() : dump_csv_line())) {
+            DZLOG_CRIT("BB: koniec");
+            s_dumping = 0u;
+            if (s_autoArm && s_bb.frozen) {          // log z poprzedniej sesji już na UART
+                BlackBox_Arm();
+                DZLOG_CRIT("BB: zrzucony -> nagrywanie wznowione");
+            }
+        }
+    }
+}
+
+void BlackBox_GetInfo(BlackBox_Info_t *out)
+{
+    if (!out) return;
+    uint16_t recs = 0u, bytes = 0u;
+    for (uint16_t i = 0; i < s_bb.used; i++) {
+        const uint8_t *b = s_bb.blk[blk_index(i)];
+        recs  = (uint16_t)(recs + b[2]);
+        bytes = (uint16_t)(bytes + blk_len(b) - BB_BLK_HDR);
+    }
+    out->count       = recs;
+    out->blocks      = s_bb.used;
+    out->bytes       = bytes;
+    out->boots       = s_bb.boots;
+    out->reset_flags = s_rstFlags;
+    out->frozen      = s_bb.frozen;
+    out->dumping     = s_dumping;
+}
+
+uint8_t BlackBox_ResetFlags(void)
+{
+    return s_rstFlags;
+}
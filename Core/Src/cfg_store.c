@@ -0,0 +1,281 @@
+/*
+ * ============================================================================
+ *  MODULE: cfg_store — trwała konfiguracja we FLASH (implementacja)
+ *  ----------------------------------------------------------------------------
+ *  CO:
+ *    - Układ strony:  [0]    PageHdr  {magic "DZCF", seq}
+ *                     [8..]  rekordy  Hdr(8) + dane(pad 8) + Trailer(8)
+ *                     dalej  0xFF (wymazane) — koniec logu.
+ *    - CRC32 (IEEE, tablica 16 pozycji) z nagłówka i danych rekordu.
+ *    - Skan strony zatrzymuje się na pierwszym wymazanym nagłówku; uszkodzony
+ *      rekord (przerwany zapis) kończy log → kolejny zapis kompaktuje.
+ *    - Po wczytaniu bloku każde jego pole z tabeli CFG_Fields() musi mieścić się w min..max
+ *      (F32: także nie NaN); inaczej cały blok wraca do wartości sprzed Load (na starcie:
+ *      domyślne z config.c).
+ * ============================================================================
+ */
+
+#include "cfg_store.h"
+#include "config.h"          // CFG_Blocks()
+#include "stm32l4xx_hal.h"   // HAL_FLASH_*
+#include <string.h>
+
+#define CFGS_PAGE_MAGIC  0x46435A44u   // "DZCF"
+#define CFGS_REC_MAGIC   0xC5F0u
+#define CFGS_COMMIT      0x600DC0DEu
+#define CFGS_HDR         8u            // nagłówek strony / rekordu / trailer
+#define CFGS_REC_MAX     128u          // maks. rozmiar rekordu (bufor roboczy)
+
+typedef struct {
+    uint16_t magic;
+    uint8_t  block;
+    uint8_t  version;
+    uint16_t len;
+    uint16_t rsv;                      // 0xFFFF
+} RecHdr_t;
+
+typedef struct {
+    uint32_t crc;
+    uint32_t commit;
+} RecTrl_t;
+
+_Static_assert(sizeof(RecHdr_t) == CFGS_HDR && sizeof(RecTrl_t) == CFGS_HDR, "uklad rekordu");
+
+static CfgStore_Info_t s_info = { -1, 0u, 0u, 0u, 0u, 0u };
+
+/* Obszar magazynu z linkera (region FLASH_CFG) */
+extern const uint8_t __cfg_store_start[];
+
+/* ==== Porty FLASH (weak — host podmienia na symulację) ==== */
+
+__attribute__((weak)) const uint8_t* CfgStore_PortBase(void)
+{
+    return __cfg_store_start;
+}
+
+__attribute__((weak)) uint8_t CfgStore_PortErase(uint8_t page)
+{
+    FLASH_EraseInitTypeDef er = {0};
+    uint32_t bad = 0u;
+    er.TypeErase = FLASH_TYPEERASE_PAGES;
+    er.Banks     = FLASH_BANK_1;
+    er.Page      = (uint32_t)((uintptr_t)__cfg_store_start - FLASH_BASE) / FLASH_PAGE_SIZE + page;
+    er.NbPages   = 1u;
+    HAL_FLASH_Unlock();
+    __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_ALL_ERRORS);
+    const HAL_StatusTypeDef st = HAL_FLASHEx_Erase(&er, &bad);
+    HAL_FLASH_Lock();
+    return (uint8_t)(st == HAL_OK);
+}
+
+__attribute__((weak)) uint8_t CfgStore_PortProgram(uint32_t offset, uint64_t dword)
+{
+    HAL_FLASH_Unlock();
+    __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_ALL_ERRORS);
+    const HAL_StatusTypeDef st = HAL_FLASH_Program(FLASH_TYPEPROGRAM_DOUBLEWORD,
+                                                   (uint32_t)(uintptr_t)__cfg_store_start + offset, dword);
+    HAL_FLASH_Lock();
+    return (uint8_t)(st == HAL_OK);
+}
+
+/* ==== Pomocnicze ==== */
+
+static uint32_t crc32_upd(uint32_t crc, const uint8_t *p, uint32_t n)
+{
+    static const uint32_t k_tab[16] = {
+        0x00000000u, 0x1DB71064u, 0x3B6E20C8u, 0x26D930ACu, 0x76DC4190u, 0x6B6B51F4u, 0x4DB26158u, 0x5005713Cu,
+        0xEDB88320u, 0xF00F9344u, 0xD6D6A3E8u, 0xCB61B38Cu, 0x9B64C2B0u, 0x86D3D2D4u, 0xA00AE278u, 0xBDBDF21Cu,
+    };
+    while (n--) {
+        crc ^= *p++;
+        crc = (crc >> 4) ^ k_tab[crc & 0x0Fu];
+        crc = (crc >> 4) ^ k_tab[crc & 0x0Fu];
+    }
+    return crc;
+}
+
+static inline uint32_t pad8(uint32_t n) { return (n + 7u) & ~7u; }
+
+static inline const uint8_t* page_ptr(uint8_t page)
+{
+    return CfgStore_PortBase() + (uint32_t)page * CFGS_PAGE_SIZE;
+}
+
+/* Numer generacji strony (0 = strona bez ważnego nagłówka) */
+static uint32_t page_seq(uint8_t page)
+{
+    uint32_t hdr[2];
+    memcpy(hdr, page_ptr(page), sizeof(hdr));
+    return (hdr[0] == CFGS_PAGE_MAGIC && hdr[1] != 0xFFFFFFFFu) ? hdr[1] : 0u;
+}
+
+/* Skan aktywnej strony: ostatni ważny rekord każdego bloku (offset danych; 0 = brak).
+ * Zwraca offset końca logu (miejsce na kolejny rekord). */
+static uint16_t scan_page(uint8_t page, uint16_t *latest, uint8_t nblk, uint8_t *bad)
+{
+    const uint8_t *pg = page_ptr(page);
+    uint8_t n = 0u;
+    const CFG_Block_t *blk = CFG_Blocks(&n);
+    uint32_t off = CFGS_HDR;
+
+    while (off + 2u * CFGS_HDR <= CFGS_PAGE_SIZE) {
+        RecHdr_t h;
+        memcpy(&h, pg + off, sizeof(h));
+        if (h.magic == 0xFFFFu) break;                       // wymazane → koniec logu
+        const uint32_t total = CFGS_HDR + pad8(h.len) + CFGS_HDR;
+        if (h.magic != CFGS_REC_MAGIC || off + total > CFGS_PAGE_SIZE) {
+            (*bad)++;
+            return (uint16_t)CFGS_PAGE_SIZE;                 // log nieczytelny → tylko kompaktowanie
+        }
+        RecTrl_t t;
+        memcpy(&t, pg + off + CFGS_HDR + pad8(h.len), sizeof(t));
+        const uint32_t crc = crc32_upd(0xFFFFFFFFu, pg + off, CFGS_HDR + h.len) ^ 0xFFFFFFFFu;
+        if (t.commit != CFGS_COMMIT || t.crc != crc) {
+            (*bad)++;                                        // przerwany zapis — pomiń
+        } else {
+            for (uint8_t i = 0; i < n && i < nblk; i++) {
+                if (blk[i].id == h.block && blk[i].version == h.version && blk[i].size == h.len) {
+                    latest[i] = (uint16_t)(off + CFGS_HDR);
+                }
+            }
+        }
+        off += total;
+    }
+    return (uint16_t)off;
+}
+
+/* Pola bloku (adres w [ptr, ptr+size)) w zakresach z tabeli pól config.c + reguły bloku */
+static uint8_t block_valid(const CFG_Block_t *b)
+{
+    uint8_t n = 0u;
+    const CFG_Field_t *f = CFG_Fields(&n);
+    const uint8_t *lo = (const uint8_t *)b->ptr, *hi = lo + b->size;
+    for (uint8_t i = 0; i < n; i++) {
+        const uint8_t *p = (const uint8_t *)f[i].ptr;
+        if (p < lo || p >= hi) continue;
+        const float v = CFG_FieldGet(&f[i]);
+        if (v != v || v < f[i].min || v > f[i].max) return 0u;   // v != v: NaN
+    }
+    return (uint8_t)(CFG_BlockCheck(b->ptr) == NULL);
+}
+
+static void refresh_active(void)
+{
+    const uint32_t s0 = page_seq(0u), s1 = page_seq(1u);
+    if (s0 == 0u && s1 == 0u) { s_info.active = -1; s_info.seq = 0u; s_info.used = 0u; return; }
+    s_info.active = (s1 > s0) ? 1 : 0;
+    s_info.seq    = (s1 > s0) ? s1 : s0;
+}
+
+/* Zapis rekordu (nagłówek + dane, trailer na końcu) pod offset w stronie */
+static uint8_t write_record(uint8_t page, uint32_t off, const CFG_Block_t *b)
+{
+    uint8_t buf[CFGS_REC_MAX];
+    const uint32_t dlen  = pad8(b->size);
+    const uint32_t total = CFGS_HDR + dlen + CFGS_HDR;
+    if (total > sizeof(buf)) return 0u;
+
+    memset(buf, 0xFF, sizeof(buf));
+    const RecHdr_t h = { CFGS_REC_MAGIC, b->id, b->version, b->size, 0xFFFFu };
+    memcpy(buf, &h, sizeof(h));
+    memcpy(buf + CFGS_HDR, b->ptr, b->size);
+    const RecTrl_t t = { crc32_upd(0xFFFFFFFFu, buf, CFGS_HDR + b->size) ^ 0xFFFFFFFFu, CFGS_COMMIT };
+    memcpy(buf + CFGS_HDR + dlen, &t, sizeof(t));
+
+    const uint32_t base = (uint32_t)page * CFGS_PAGE_SIZE + off;
+    for (uint32_t i = 0; i < total; i += 8u) {               // trailer (ostatni dword) — commit
+        uint64_t dw;
+        memcpy(&dw, buf + i, sizeof(dw));
+        if (!CfgStore_PortProgram(base + i, dw)) return 0u;
+    }
+    return 1u;
+}
+
+/* Kompaktowanie: wszystkie bloki z RAM na drugą stronę, nagłówek z seq+1 na końcu */
+static uint8_t compact(void)
+{
+    const uint8_t dst = (s_info.active == 0) ? 1u : 0u;
+    if (!CfgStore_PortErase(dst)) return 0u;
+
+    uint8_t n = 0u;
+    const CFG_Block_t *b = CFG_Blocks(&n);
+    uint32_t off = CFGS_HDR;
+    for (uint8_t i = 0; i < n; i++) {
+        if (!write_record(dst, off, &b[i])) return 0u;
+        off += 2u * CFGS_HDR + pad8(b[i].size);
+    }
+    const uint32_t seq = s_info.seq + 1u;
+    const uint64_t hdr = (uint64_t)CFGS_PAGE_MAGIC | ((uint64_t)seq << 32);
+    if (!CfgStore_PortProgram((uint32_t)dst * CFGS_PAGE_SIZE, hdr)) return 0u;   // zamiana
+
+    s_info.active = (int8_t)dst;
+    s_info.seq    = seq;
+    s_info.used   = (uint16_t)off;
+    return 1u;
+}
+
+/* ==== API ==== */
+
+uint8_t CfgStore_Load(void)
+{
+    uint8_t n = 0u;
+    const CFG_Block_t *b = CFG_Blocks(&n);
+    uint16_t latest[CFG_BLOCKS_MAX] = {0};
+
+    s_info.loaded   = 0u;
+    s_info.bad      = 0u;
+    s_info.rejected = 0u;
+    refresh_active();
+    if (s_info.active < 0) return 0u;
+
+    s_info.used = scan_page((uint8_t)s_info.active, latest, CFG_BLOCKS_MAX, &s_info.bad);
+    const uint8_t *pg = page_ptr((uint8_t)s_info.active);
+    for (uint8_t i = 0; i < n && i < CFG_BLOCKS_MAX; i++) {
+        if (latest[i] == 0u || b[i].size > CFGS_REC_MAX) continue;   // brak → domyślne z config.c
+        uint8_t prev[CFGS_REC_MAX];
+        memcpy(prev, b[i].ptr, b[i].size);
+        memcpy(b[i].ptr, pg + latest[i], b[i].size);
+        if (!block_valid(&b[i])) {                           // CRC OK, ale wartość spoza zakresu
+            memcpy(b[i].ptr, prev, b[i].size);
+            s_info.rejected++;
+            continue;
+        }
+        s_info.loaded++;
+    }
+    return s_info.loaded;
+}
+
+uint8_t CfgStore_Save(void)
+{
+    uint8_t n = 0u;
+    const CFG_Block_t *b = CFG_Blocks(&n);
+    uint16_t latest[CFG_BLOCKS_MAX] = {0};
+    uint8_t  bad = 0u;
+
+    refresh_active();
+    if (s_info.active < 0) return compact();                 // pierwszy zapis → formatowanie
+
+    uint32_t off = scan_page((uint8_t)s_info.active, latest, CFG_BLOCKS_MAX, &bad);
+    const uint8_t *pg = page_ptr((uint8_t)s_info.active);
+    for (uint8_t i = 0; i < n && i < CFG_BLOCKS_MAX; i++) {
+        if (latest[i] != 0u && memcmp(pg + latest[i], b[i].ptr, b[i].size) == 0) continue;   // bez zmian
+        const uint32_t total = 2u * CFGS_HDR + pad8(b[i].size);
+        if (off + total > CFGS_PAGE_SIZE) return compact();  // brak miejsca → nowa strona z całością
+        if (!write_record((uint8_t)s_info.active, off, &b[i])) return 0u;
+        off += total;
+    }
+    s_info.used = (uint16_t)off;
+    return 1u;
+}
+
+uint8_t CfgStore_Erase(void)
+{
+    const uint8_t ok = (uint8_t)(CfgStore_PortErase(0u) & CfgStore_PortErase(1u));
+    refresh_active();
+    return ok;
+}
+
+void CfgStore_GetInfo(CfgStore_Info_t *out)
+{
+    if (out) *out = s_info;
+}
@@ -0,0 +1,149 @@
+/*
+ * ============================================================================
+ *  MODULE: color_class.c — chromatyczność Q10 + tabela wzorców (FLASH) + kalibracja
+ *  ----------------------------------------------------------------------------
+ *  MECHANIKA:
+ *    - r_q = R·1024/C (itd.), bright_q4 = C·16 / (gain × cykle).
+ *    - Dla każdego wzorca: n = max(Σ|Δchroma|·255/tol_c, |Δbright|%·255/tol_b).
+ *      Najmniejsze n ≤ 255 wygrywa; conf = 255 − n. Inaczej UNKNOWN.
+ *    - Wzorce domyślne to punkt startowy — skalibruj na własnej macie (shell: cal b/w/p).
+ * ============================================================================
+ */
+
+#include "color_class.h"
+#include "dzlog.h"
+#include <string.h>
+
+/* ==== Tabela wzorców (FLASH) — wklej tu wiersze wydrukowane przez 'p' ==== */
+static const ColorRef_t k_color_table[] = {
+    /* cls          r_q  g_q  b_q  bright  tol_c tol_b% */
+    { COLOR_BLACK,  340, 330, 280,     40,   180,  70 },   // mata: ciemna, lekko ciepła
+    { COLOR_WHITE,  330, 340, 300,    600,   150,  60 },   // krawędź: jasna, neutralna
+};
+#define COLOR_TABLE_LEN  ((uint8_t)(sizeof(k_color_table) / sizeof(k_color_table[0])))
+
+/* ==== Stan kalibracji ==== */
+static volatile ColorClass_t s_capReq   = COLOR_UNKNOWN;   // żądanie z UART (ISR)
+static volatile uint8_t      s_printReq = 0u;
+static ColorClass_t          s_capCls   = COLOR_UNKNOWN;   // trwające zbieranie
+static uint8_t               s_capN     = 0u;
+static uint32_t              s_capSum[4];                  // r, g, b, bright
+static ColorRef_t            s_capRes[COLOR_CLASS_COUNT];  // ostatnie wyniki kalibracji
+
+static inline uint16_t u_abs_diff(uint16_t a, uint16_t b) { return (a > b) ? (uint16_t)(a - b) : (uint16_t)(b - a); }
+
+static inline uint32_t gain_mult(TCS_Gain_t g)
+{
+    switch (g) {
+        case TCS_GAIN_1X:  return 1u;
+        case TCS_GAIN_4X:  return 4u;
+        case TCS_GAIN_16X: return 16u;
+        case TCS_GAIN_60X: return 60u;
+        default:           return 1u;
+    }
+}
+
+/* Cechy próbki: chromatyczność Q10 + jasność Q4 */
+static void color_features(const TCS3472_Data_t *d, ColorResult_t *r)
+{
+    const uint32_t c = (d->clear == 0u) ? 1u : d->clear;
+    r->r_q = (uint16_t)(((uint32_t)d->red   * COLOR_Q_ONE) / c);
+    r->g_q = (uint16_t)(((uint32_t)d->green * COLOR_Q_ONE) / c);
+    r->b_q = (uint16_t)(((uint32_t)d->blue  * COLOR_Q_ONE) / c);
+
+    /* cykle ATIME z itime_ms (2.4 ms/cykl), zaokrąglenie */
+    uint32_t cycles = (uint32_t)(d->itime_ms * (10.0f / 24.0f) + 0.5f);
+    if (cycles == 0u) cycles = 1u;
+    uint32_t b = ((uint32_t)d->clear * 16u) / (gain_mult(d->gain) * cycles);
+    r->bright_q4 = (uint16_t)((b > 0xFFFFu) ? 0xFFFFu : b);
+}
+
+ColorResult_t ColorClass_Classify(const TCS3472_Data_t *d)
+{
+    ColorResult_t res;
+    memset(&res, 0, sizeof(res));
+    res.cls = COLOR_UNKNOWN;
+    if (!d) return res;
+
+    color_features(d, &res);
+
+    uint32_t best = 256u;                                   // > 255 = brak dopasowania
+    for (uint8_t i = 0; i < COLOR_TABLE_LEN; ++i) {
+        const ColorRef_t *t = &k_color_table[i];
+        const uint32_t dc = (uint32_t)u_abs_diff(res.r_q, t->r_q) + u_abs_diff(res.g_q, t->g_q) + u_abs_diff(res.b_q, t->b_q);
+        const uint32_t ref = (t->bright_q4 == 0u) ? 1u : t->bright_q4;
+        const uint32_t db_pct = ((uint32_t)u_abs_diff(res.bright_q4, t->bright_q4) * 100u) / ref;
+
+        const uint32_t nc = (t->tol_chroma_q   ? (dc * 255u) / t->tol_chroma_q   : 256u);
+        const uint32_t nb = (t->tol_bright_pct ? (db_pct * 255u) / t->tol_bright_pct : 256u);
+        const uint32_t n  = (nc > nb) ? nc : nb;
+        if (n < best) { best = n; res.cls = t->cls; }
+    }
+    res.conf = (best <= 255u) ? (uint8_t)(255u - best) : 0u;
+    if (best > 255u) res.cls = COLOR_UNKNOWN;
+    return res;
+}
+
+const char* ColorClass_Name(ColorClass_t c)
+{
+    switch (c) {
+        case COLOR_BLACK: return "BLACK";
+        case COLOR_WHITE: return "WHITE";
+        default:          return "UNKN";
+    }
+}
+
+/* ==== Kalibracja ==== */
+void ColorClass_RequestCapture(ColorClass_t c) { s_capReq = c; }
+void ColorClass_RequestPrint(void)             { s_printReq = 1u; }
+
+static void cal_accumulate(const TCS3472_Data_t *d)
+{
+    if (!d || !d->fresh || s_capN >= COLOR_CAL_SAMPLES) return;
+    ColorResult_t f;
+    color_features(d, &f);
+    s_capSum[0] += f.r_q; s_capSum[1] += f.g_q; s_capSum[2] += f.b_q; s_capSum[3] += f.bright_q4;
+    s_capN++;
+}
+
+void ColorClass_CaptureTick(const TCS3472_Data_t *right, const TCS3472_Data_t *left)
+{
+    /* start nowego zbierania (żądanie z ISR) */
+    if (s_capReq != COLOR_UNKNOWN) {
+        s_capCls = s_capReq;
+        s_capReq = COLOR_UNKNOWN;
+        s_capN   = 0u;
+        memset(s_capSum, 0, sizeof(s_capSum));
+        DZLOG_CRIT("[CAL] %s: zbieram %u probek...", ColorClass_Name(s_capCls), (unsigned)COLOR_CAL_SAMPLES);
+    }
+
+    if (s_capCls != COLOR_UNKNOWN) {
+        cal_accumulate(right);
+        cal_accumulate(left);
+        if (s_capN >= COLOR_CAL_SAMPLES) {
+            ColorRef_t *r = &s_capRes[s_capCls];
+            r->cls       = s_capCls;
+            r->r_q       = (uint16_t)(s_capSum[0] / s_capN);
+            r->g_q       = (uint16_t)(s_capSum[1] / s_capN);
+            r->b_q       = (uint16_t)(s_capSum[2] / s_capN);
+            r->bright_q4 = (uint16_t)(s_capSum[3] / s_capN);
+            DZLOG_CRIT("[CAL] %s: r=%u g=%u b=%u bright=%u",
+                             ColorClass_Name(r->cls), (unsigned)r->r_q, (unsigned)r->g_q,
+                             (unsigned)r->b_q, (unsigned)r->bright_q4);
+            s_capCls = COLOR_UNKNOWN;
+        }
+    }
+
+    /* wydruk wierszy do k_color_table[] (tolerancje z bieżącej tabeli) */
+    if (s_printReq) {
+        s_printReq = 0u;
+        for (uint8_t i = 0; i < COLOR_TABLE_LEN; ++i) {
+            const ColorRef_t *t = &k_color_table[i];
+            const ColorRef_t *c = (s_capRes[t->cls].cls == t->cls) ? &s_capRes[t->cls] : t;
+            DZLOG_CRIT("    { COLOR_%s, %4u, %4u, %4u, %6u, %5u, %3u },",
+                             ColorClass_Name(t->cls), (unsigned)c->r_q, (unsigned)c->g_q,
+                             (unsigned)c->b_q, (unsigned)c->bright_q4,
+                             (unsigned)t->tol_chroma_q, (unsigned)t->tol_bright_pct);
+        }
+    }
+}
@@ -3,22 +3,30 @@
  *  DzikiBoT — DOMYŚLNE wartości konfiguracji (strojenie w jednym miejscu)
  * -----------------------------------------------------------------------------
  *  CO TU JEST:
- *    • Zestaw „gałek” dla: TankDrive, TF-Luna, TCS3472, Scheduler.
+ *    • Zestaw „gałek” dla: TankDrive, TF-Luna, TCS3472, Edge, Scheduler.
  *    • Gettery CFG_*() — moduły czytają TYLKO przez nie.
  *    • (Nowe) gettery tuningu TCS (EMA + progi auto-gain) — override „weak”.
+ *    • (Nowe) Bloki skalarne w RAM (nie const) + tabela pól CFG_Fields() — strojenie na żywo
+ *      z shella UART (get/set/list). Moduły trzymają wskaźniki → zmiana działa od następnego ticku.
+ *      Tabele czujników (LunaDev/TcsDev) zostają const.
+ *    • (Nowe) Tabela bloków CFG_Blocks() — cfg_store zapisuje je we FLASH; przy starcie
+ *      zapisane wartości nadpisują domyślne (te poniżej to fallback).
  *
  *  QUICK REF (typowe zakresy):
  *  [Motors] tick_ms:10..50 | ramp_step:1..10 | neutral_dwell:200..800 | smooth_alpha:0.10..0.40
- *  [Luna]   median:1..7 | ma:1..8 | temp_offset_c:~−30..+10
- *  [TCS]    atime:24..154 ms | start gain:1×/4×/16×/60× | tuning: CFG_TCS_*()
- *  [Sched]  sens:50..200 | oled:100..500 | uart:100..500
+ *  [Luna]   median:1..7 | ma:1..8 | temp_offset_c:~−30..+10 | trig_lead:3..10 (min. 3 = czas pomiaru; < tick_ms)
+ *  [LunaDev] addr7:0x08..0x77 (unikalny na magistrali) | max 6 szt. | [0]=Right, [1]=Left
+ *  [TCS]    atime:24..154 ms | start gain:1×/4×/16×/60× | auto-ATIME:3..154 ms | tuning: CFG_TCS_*()
+ *  [Edge]   poll:3..5 ms | atime:1..2 cykle | delta_on:100..400 | delta_off≈½ delta_on | confirm:1..2
+ *  [Sched]  sens:50..200 | oled:100..500 | uart:100..500 | uart_util:50..85 % | uart_min/max:100..2000
  * =============================================================================
  */
 
 #include "config.h"
+#include <string.h>   // strchr/strcmp (tabela pól)
 
 /* ==== MOTORS / TANK DRIVE ==== */
-static const ConfigMotors_t g_motors = {
+static ConfigMotors_t g_motors = {
     .tick_ms               = 20,     // 20 ms → 50 Hz (responsywne i stabilne)
     .neutral_dwell_ms      = 100,    // ms neutralu przy zmianie kierunku
     .ramp_step_pct         = 6,      // %/tick – większe = żwawiej, mniejsze = łagodniej
@@ -31,34 +39,263 @@ static const ConfigMotors_t g_motors = {
 };
 
 /* ==== TF-LUNA ==== */
-static const ConfigLuna_t g_luna = {
+static ConfigLuna_t g_luna = {
     .median_win             = 3,      // okno mediany
     .ma_win                 = 4,      // okno średniej kroczącej
     .temp_scale             = 1.0f,   // skala temp.
     .temp_offset_c          = -25.0f, // °C: przybliżony offset do ambientu
-    .dist_offset_right_mm   = 0,      // mm offset (prawy)
-    .dist_offset_left_mm    = 0,      // mm offset (lewy)
+    .trigger_mode           = 0,      // 0=ciągły, 1=trigger przed tickiem Tank (deterministyczny wiek próbki)
+    .trig_lead_ms           = 5,      // ms: trigger → odczyt (pomiar ~2..3 ms + zapas)
+    .provision              = 0,      // 1=przeadresuj fabryczne 0x10 przy starcie (podłączaj po jednym; 0x10 nie w tabeli)
+};
+
+/* ==== TF-LUNA: czujniki ====
+ *  Kolejne czujniki na tej samej magistrali wymagają unikalnych adresów.
+ *  Przykład pierścienia 6× (po 3 na magistralę, adresy zaprogramowane raz przez .provision=1):
+ *    { CFG_BUS_I2C1, 0x11, 0, "R"  }, { CFG_BUS_I2C3, 0x11, 0, "L"  },
+ *    { CFG_BUS_I2C1, 0x12, 0, "RF" }, { CFG_BUS_I2C3, 0x12, 0, "LF" },
+ *    { CFG_BUS_I2C1, 0x13, 0, "RB" }, { CFG_BUS_I2C3, 0x13, 0, "LB" },
+ *  Provisioning działa tylko, gdy 0x10 nie ma w tabeli danej magistrali i milczy dokładnie
+ *  jeden adres z tabeli — każdy nowy układ dołączaj osobno i zrestartuj.
+ */
+static const ConfigLunaDev_t g_luna_devs[] = {
+    { CFG_BUS_I2C1, 0x10, 0, "R" },   // prawy (I2C1) — offset mm
+    { CFG_BUS_I2C3, 0x10, 0, "L" },   // lewy  (I2C3) — offset mm
 };
 
 /* ==== TCS3472 ==== */
-static const ConfigTCS_t g_tcs = {
+static ConfigTCS_t g_tcs = {
     .atime_ms = 100,            // ms integracji: dobry punkt startowy
     .gain     = TCS_GAIN_16X,   // start gain (auto-gain dalej steruje)
+    .atime_min_ms = 3,          // ms: najkrótsza integracja (jasny biały brzeg → świeże próbki)
+    .atime_max_ms = 154,        // ms: najdłuższa (ciemna mata)
+};
+
+/* ==== TCS3472: czujniki ==== */
+static const ConfigTcsDev_t g_tcs_devs[] = {
+    { CFG_BUS_I2C1, "R" },          // prawy (I2C1)
+    { CFG_BUS_I2C3, "L" },          // lewy  (I2C3)
+};
+
+/* ==== EDGE DETECT ==== */
+static ConfigEdge_t g_edge = {
+    .enable       = 1,              // detektor aktywny (TCS w trybie szybkim tylko w ruchu)
+    .poll_ms      = 3,              // ms: ≥ ATIME (2.4 ms) → każda próbka świeża
+    .atime_cycles = 1,              // 2.4 ms integracji (FS = 1024)
+    .gain         = TCS_GAIN_16X,   // biały brzeg ≈ połowa FS, czarna mata blisko zera
+    .cal_samples  = 32,             // ~0.1 s kalibracji czerni w Edge_Init (robot na macie!)
+    .delta_on     = 200,            // zliczenia ponad czerń → krawędź
+    .delta_off    = 100,            // zliczenia ponad czerń → powrót na matę
+    .confirm      = 1,              // 1 próbka wystarcza (najniższa latencja)
+    .rev_pct      = 80,             // % cofania
+    .rev_ms       = 350,            // ms od detekcji (w tym neutral_dwell ~100 ms)
+    .turn_pct     = 70,             // % obrotu od krawędzi
+    .turn_ms      = 200,            // ms obrotu
 };
 
 /* ==== SCHEDULER ==== */
-static const ConfigScheduler_t g_sched = {
+static ConfigScheduler_t g_sched = {
     .sens_ms = 100,   // ms: odczyt sensorów
     .oled_ms = 200,   // ms: odświeżanie OLED
-    .uart_ms = 200,   // ms: odświeżanie UART
+    .uart_ms = 200,   // ms: odświeżanie UART (start adaptacji)
+    .uart_adapt    = 1,     // 1 = okres i poziom panelu dobierane do przepustowości łącza
+    .uart_util_pct = 70,    // % przepływności UART zajęty przez panel (zapas na CRIT)
+    .uart_min_ms   = 100,   // ms: najczęstsze odświeżanie
+    .uart_max_ms   = 1000,  // ms: najrzadsze; gdy pełny panel nie mieści się → linia skrócona
 };
 
 /* ==== Gettery CFG_*() ==== */
 const ConfigMotors_t*     CFG_Motors(void)    { return &g_motors; }
 const ConfigLuna_t*       CFG_Luna(void)      { return &g_luna;   }
+const ConfigLunaDev_t*    CFG_LunaDevs(uint8_t *count)
+{
+    if (count) *count = (uint8_t)(sizeof(g_luna_devs) / sizeof(g_luna_devs[0]));
+    return g_luna_devs;
+}
 const ConfigTCS_t*        CFG_TCS(void)       { return &g_tcs;    }
+const ConfigEdge_t*       CFG_Edge(void)      { return &g_edge;   }
+const ConfigTcsDev_t*     CFG_TcsDevs(uint8_t *count)
+{
+    if (count) *count = (uint8_t)(sizeof(g_tcs_devs) / sizeof(g_tcs_devs[0]));
+    return g_tcs_devs;
+}
 const ConfigScheduler_t*  CFG_Scheduler(void) { return &g_sched;  }
 
+/* =============================================================================
+ *  Tabela pól — opis bloków dla shella (nazwa, typ, adres, zakres, live)
+ *  • live=1 → moduł czyta pole na bieżąco (efekt od następnego ticku),
+ *    live=0 → pole używane tylko przy starcie (efekt po restarcie).
+ * =============================================================================
+ */
+#define F(blk, var, fld, typ, lo, hi, lv) { blk, #fld, typ, &var.fld, lo, hi, lv }
+static const CFG_Field_t g_fields[] = {
+    F("motors", g_motors, tick_ms,               CFG_T_U32,    5,    100, 1),
+    F("motors", g_motors, neutral_dwell_ms,      CFG_T_U32,    0,   2000, 1),
+    F("motors", g_motors, ramp_step_pct,         CFG_T_U8,     1,    100, 1),
+    F("motors", g_motors, reverse_threshold_pct, CFG_T_U8,     0,     20, 1),
+    F("motors", g_motors, smooth_alpha,          CFG_T_F32,    0,      1, 1),
+    F("motors", g_motors, left_scale,            CFG_T_F32,  0.5f,  1.5f, 1),
+    F("motors", g_motors, right_scale,           CFG_T_F32,  0.5f,  1.5f, 1),
+    F("motors", g_motors, esc_start_pct,         CFG_T_U8,     0,    100, 1),
+    F("motors", g_motors, esc_max_pct,           CFG_T_U8,     0,    100, 1),
+
+    F("luna",   g_luna,   median_win,            CFG_T_U8,     1,      5, 1),
+    F("luna",   g_luna,   ma_win,                CFG_T_U8,     1,      5, 1),
+    F("luna",   g_luna,   temp_scale,            CFG_T_F32,  0.5f,  2.0f, 1),
+    F("luna",   g_luna,   temp_offset_c,         CFG_T_F32,  -50,     50, 1),
+    F("luna",   g_luna,   trigger_mode,          CFG_T_U8,     0,      1, 0),
+    F("luna",   g_luna,   trig_lead_ms,          CFG_T_U8,     3,     50, 1),
+    F("luna",   g_luna,   provision,             CFG_T_U8,     0,      1, 0),
+
+    F("tcs",    g_tcs,    atime_ms,              CFG_T_U16,    3,    614, 0),
+    F("tcs",    g_tcs,    gain,                  CFG_T_GAIN,   0,      3, 0),
+    F("tcs",    g_tcs,    atime_min_ms,          CFG_T_U16,    3,    614, 0),
+    F("tcs",    g_tcs,    atime_max_ms,          CFG_T_U16,    3,    614, 0),
+
+    F("edge",   g_edge,   enable,                CFG_T_U8,     0,      1, 0),
+    F("edge",   g_edge,   poll_ms,               CFG_T_U8,     0,     50, 1),
+    F("edge",   g_edge,   atime_cycles,          CFG_T_U8,     1,      4, 0),
+    F("edge",   g_edge,   gain,                  CFG_T_GAIN,   0,      3, 0),
+    F("edge",   g_edge,   cal_samples,           CFG_T_U8,     1,    255, 0),
+    F("edge",   g_edge,   delta_on,              CFG_T_U16,    1,  60000, 1),
+    F("edge",   g_edge,   delta_off,             CFG_T_U16,    0,  60000, 1),
+    F("edge",   g_edge,   confirm,               CFG_T_U8,     1,     10, 1),
+    F("edge",   g_edge,   rev_pct,               CFG_T_I8,     0,    100, 1),
+    F("edge",   g_edge,   rev_ms,                CFG_T_U16,    0,   3000, 1),
+    F("edge",   g_edge,   turn_pct,              CFG_T_I8,     0,    100, 1),
+    F("edge",   g_edge,   turn_ms,               CFG_T_U16,    0,   3000, 1),
+
+    F("sched",  g_sched,  sens_ms,               CFG_T_U16,   10,   1000, 1),
+    F("sched",  g_sched,  oled_ms,               CFG_T_U16,   50,   5000, 1),
+    F("sched",  g_sched,  uart_ms,               CFG_T_U16,   50,   5000, 1),
+    F("sched",  g_sched,  uart_adapt,            CFG_T_U8,     0,      1, 1),
+    F("sched",  g_sched,  uart_util_pct,         CFG_T_U8,    10,    100, 1),
+    F("sched",  g_sched,  uart_min_ms,           CFG_T_U16,   50,   5000, 1),
+    F("sched",  g_sched,  uart_max_ms,           CFG_T_U16,   50,  10000, 1),
+};
+#undef F
+
+const CFG_Field_t* CFG_Fields(uint8_t *count)
+{
+    if (count) *count = (uint8_t)(sizeof(g_fields) / sizeof(g_fields[0]));
+    return g_fields;
+}
+
+/* Szukanie pola po nazwie "blok.pole" */
+const CFG_Field_t* CFG_FieldFind(const char *path)
+{
+    if (!path) return NULL;
+    const char *dot = strchr(path, '.');
+    if (!dot) return NULL;
+    const size_t blen = (size_t)(dot - path);
+    for (uint8_t i = 0; i < (uint8_t)(sizeof(g_fields) / sizeof(g_fields[0])); i++) {
+        const CFG_Field_t *f = &g_fields[i];
+        if (strlen(f->block) == blen && strncmp(f->block, path, blen) == 0 &&
+            strcmp(f->name, dot + 1) == 0) {
+            return f;
+        }
+    }
+    return NULL;
+}
+
+float CFG_FieldGet(const CFG_Field_t *f)
+{
+    if (!f) return 0.0f;
+    switch (f->type) {
+        case CFG_T_U8:   return (float)*(const uint8_t  *)f->ptr;
+        case CFG_T_I8:   return (float)*(const int8_t   *)f->ptr;
+        case CFG_T_U16:  return (float)*(const uint16_t *)f->ptr;
+        case CFG_T_U32:  return (float)*(const uint32_t *)f->ptr;
+        case CFG_T_F32:  return *(const float *)f->ptr;
+        case CFG_T_GAIN: return (float)*(const TCS_Gain_t *)f->ptr;
+        default:         return 0.0f;
+    }
+}
+
+static void field_write(const CFG_Field_t *f, float v)
+{
+    if (f->type != CFG_T_F32) v = (v >= 0.0f) ? (v + 0.5f) : (v - 0.5f);   // zaokrąglenie
+    switch (f->type) {
+        case CFG_T_U8:   *(uint8_t  *)f->ptr = (uint8_t)v;    break;
+        case CFG_T_I8:   *(int8_t   *)f->ptr = (int8_t)v;     break;
+        case CFG_T_U16:  *(uint16_t *)f->ptr = (uint16_t)v;   break;
+        case CFG_T_U32:  *(uint32_t *)f->ptr = (uint32_t)v;   break;
+        case CFG_T_F32:  *(float    *)f->ptr = v;             break;
+        case CFG_T_GAIN: *(TCS_Gain_t *)f->ptr = (TCS_Gain_t)(int)v; break;
+        default:         break;
+    }
+}
+
+static const void* field_block(const CFG_Field_t *f);
+
+/* Reguła między polami złamana przez f = v (pole bez zmian); NULL = spójne */
+const char* CFG_FieldConflict(const CFG_Field_t *f, float v)
+{
+    if (!f) return NULL;
+    const float old = CFG_FieldGet(f);
+    field_write(f, v);
+    const char *rule = CFG_BlockCheck(field_block(f));
+    field_write(f, old);
+    return rule;
+}
+
+/* Zapis z kontrolą zakresu i reguł bloku; 1 = OK, 0 = poza zakresem / sprzeczne (pole bez zmian) */
+uint8_t CFG_FieldSet(const CFG_Field_t *f, float v)
+{
+    if (!f || v < f->min || v > f->max || f->type > CFG_T_GAIN) return 0u;
+    if (CFG_FieldConflict(f, v)) return 0u;
+    field_write(f, v);
+    return 1u;
+}
+
+/* =============================================================================
+ *  Bloki trwałe (cfg_store) — id stałe; version podbij przy zmianie struktury,
+ *  wtedy zapisany rekord jest pomijany i obowiązują wartości domyślne powyżej.
+ * =============================================================================
+ */
+static const CFG_Block_t g_blocks[] = {
+    { 1, 1, &g_motors, (uint16_t)sizeof(g_motors), "motors" },
+    { 2, 1, &g_luna,   (uint16_t)sizeof(g_luna),   "luna"   },
+    { 3, 1, &g_tcs,    (uint16_t)sizeof(g_tcs),    "tcs"    },
+    { 4, 1, &g_edge,   (uint16_t)sizeof(g_edge),   "edge"   },
+    { 5, 1, &g_sched,  (uint16_t)sizeof(g_sched),  "sched"  },
+};
+
+const CFG_Block_t* CFG_Blocks(uint8_t *count)
+{
+    if (count) *count = (uint8_t)(sizeof(g_blocks) / sizeof(g_blocks[0]));
+    return g_blocks;
+}
+
+/* Blok zawierający pole (adres w [ptr, ptr+size)); NULL = poza blokami */
+static const void* field_block(const CFG_Field_t *f)
+{
+    for (uint8_t i = 0; i < (uint8_t)(sizeof(g_blocks) / sizeof(g_blocks[0])); i++) {
+        const uint8_t *lo = (const uint8_t *)g_blocks[i].ptr;
+        const uint8_t *p  = (const uint8_t *)f->ptr;
+        if (p >= lo && p < lo + g_blocks[i].size) return g_blocks[i].ptr;
+    }
+    return NULL;
+}
+
+/* Reguły między polami bloku — zakresy pojedynczych pól ich nie wyrażają:
+ *  - okno ESC niepuste (inaczej każda komenda = neutral),
+ *  - histereza krawędzi we właściwą stronę (off < on),
+ *  - integracja TCS w granicach auto-ATIME, okno okresu panelu UART min ≤ max. */
+const char* CFG_BlockCheck(const void *blk)
+{
+    if (blk == &g_motors && g_motors.esc_max_pct <= g_motors.esc_start_pct)
+        return "motors: esc_max_pct > esc_start_pct";
+    if (blk == &g_tcs && (g_tcs.atime_min_ms > g_tcs.atime_max_ms ||
+                          g_tcs.atime_ms < g_tcs.atime_min_ms || g_tcs.atime_ms > g_tcs.atime_max_ms))
+        return "tcs: atime_min_ms <= atime_ms <= atime_max_ms";
+    if (blk == &g_edge && g_edge.delta_off >= g_edge.delta_on)
+        return "edge: delta_off < delta_on";
+    if (blk == &g_sched && g_sched.uart_min_ms > g_sched.uart_max_ms)
+        return "sched: uart_min_ms <= uart_max_ms";
+    return NULL;
+}
+
 /* =============================================================================
  *  TCS — tuning runtime (EMA + progi auto-gain) przez gettery (override „weak”)
  *  • Zdefiniowane tutaj → driver TCS użyje tych wartości.
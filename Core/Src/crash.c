@@ -0,0 +1,170 @@
+/*
+ * ============================================================================
+ *  MODULE: crash — przechwycenie błędów rdzenia (implementacja)
+ *  ----------------------------------------------------------------------------
+ *  CO:
+ *    - Handlery naked: LR bit 2 wybiera MSP/PSP, skok do Crash_FaultEntry (bez
+ *      prologu — ramka jest dokładnie pod SP). MemManage/BusFault/UsageFault to
+ *      aliasy HardFault; rodzaj błędu z IPSR.
+ *    - SP spoza RAM/SRAM2 (np. przepełnienie stosu) → ramka pominięta (zera),
+ *      żeby nie wywołać błędu w handlerze błędu (lockup).
+ *    - Rekord ważny, gdy magic i suma kontrolna się zgadzają (SRAM2 po power-on = losowe).
+ *
+ *  CUBEMX:
+ *    - NVIC → Code generation: fault handlery bez „Generate IRQ handler”
+ *      (w .ioc ustawione) — inaczej duplikaty w stm32l4xx_it.c.
+ * ============================================================================
+ */
+
+#include "crash.h"
+#include "app.h"             // App_TaskName
+#include "blackbox.h"
+#include "motor_bldc.h"      // ESC_FailSafe
+#include "debug_uart.h"
+#include "dzlog.h"           // DZLOG_CRIT()
+#include "stm32l4xx_hal.h"   // SCB, HAL_GetTick, NVIC_SystemReset
+#include <string.h>
+#include <stddef.h>          // offsetof
+
+#define CRASH_MAGIC   0x43525348u   // "CRSH"
+
+typedef struct {
+    uint32_t magic;
+    uint32_t frame[8];                 // r0 r1 r2 r3 r12 lr pc xpsr
+    uint32_t exc_return, sp;
+    uint32_t cfsr, hfsr, mmfar, bfar;
+    uint32_t uptime_ms;
+    uint8_t  exc;                      // numer wyjątku (3 = HardFault, 4 = MemManage, ...)
+    uint8_t  task;
+    uint8_t  head;
+    uint8_t  count;                    // błędy od power-on
+    uint32_t ev[CRASH_EVENTS];
+    uint32_t reported;
+    uint32_t check;
+} Crash_Record_t;
+
+Crash_Trace_t g_crashTrace;                   // .bss — kopiowany do rekordu przy błędzie
+static Crash_Record_t s_crash __attribute__((section(".ram2_noinit"), aligned(8)));
+
+static uint32_t crash_check(const Crash_Record_t *c)
+{
+    const uint32_t *w = (const uint32_t *)c;
+    uint32_t x = 0xA5A5A5A5u;
+    for (uint32_t i = 0; i < offsetof(Crash_Record_t, reported) / 4u; i++) x = (x << 1 | x >> 31) ^ w[i];
+    return x;
+}
+
+static uint8_t crash_valid(void)
+{
+    return (uint8_t)(s_crash.magic == CRASH_MAGIC && s_crash.check == crash_check(&s_crash));
+}
+
+static uint8_t sp_in_ram(uint32_t sp)
+{
+    if (sp & 3u) return 0u;
+    return (uint8_t)((sp >= 0x20000000u && sp + 32u <= 0x2000C000u) ||    // SRAM1 48 KB
+                     (sp >= 0x10000000u && sp + 32u <= 0x10004000u));     // SRAM2 16 KB
+}
+
+/* ==== Handlery (naked) ==== */
+
+__attribute__((naked)) void HardFault_Handler(void)
+{
+    __asm volatile(
+        "tst   lr, #4            \n"
+        "ite   eq                \n"
+        "mrseq r0, msp           \n"
+        "mrsne r0, psp           \n"
+        "mov   r1, lr            \n"
+        "b     Crash_FaultEntry  \n");
+}
+
+void MemManage_Handler(void)  __attribute__((alias("HardFault_Handler")));
+void BusFault_Handler(void)   __attribute__((alias("HardFault_Handler")));
+void UsageFault_Handler(void) __attribute__((alias("HardFault_Handler")));
+
+__attribute__((used, noreturn)) void Crash_FaultEntry(uint32_t *frame, uint32_t exc_return)
+{
+    ESC_FailSafe();                                    // najpierw napęd: neutral
+
+    const uint8_t count = crash_valid() ? s_crash.count : 0u;
+    s_crash.magic      = CRASH_MAGIC;
+    s_crash.exc_return = exc_return;
+    s_crash.sp         = (uint32_t)(uintptr_t)frame;
+    if (sp_in_ram(s_crash.sp)) {
+        for (uint8_t i = 0; i < 8u; i++) s_crash.frame[i] = frame[i];
+    } else {
+        for (uint8_t i = 0; i < 8u; i++) s_crash.frame[i] = 0u;
+    }
+    s_crash.cfsr      = SCB->CFSR;
+    s_crash.hfsr      = SCB->HFSR;
+    s_crash.mmfar     = SCB->MMFAR;
+    s_crash.bfar      = SCB->BFAR;
+    s_crash.uptime_ms = HAL_GetTick();
+    s_crash.exc       = (uint8_t)(__get_IPSR() & 0xFFu);
+    s_crash.task      = g_crashTrace.task;
+    s_crash.head      = g_crashTrace.head;
+    s_crash.count     = (uint8_t)(count + 1u);
+    for (uint8_t i = 0; i < CRASH_EVENTS; i++) s_crash.ev[i] = g_crashTrace.ev[i];
+    s_crash.reported  = 0u;
+    s_crash.check     = crash_check(&s_crash);
+
+    BlackBox_Freeze();                                 // log przed błędem zostaje
+    NVIC_SystemReset();
+    for (;;) { }
+}
+
+/* ==== Raport ==== */
+
+static void cfsr_names(uint32_t cfsr, uint32_t hfsr, char *out, uint32_t n)
+{
+    static const struct { uint8_t bit; const char *name; } k_bits[] = {
+        { 0, "IACCVIOL" }, { 1, "DACCVIOL" }, { 3, "MUNSTKERR" }, { 4, "MSTKERR" }, { 5, "MLSPERR" },
+        { 8, "IBUSERR" }, { 9, "PRECISERR" }, { 10, "IMPRECISERR" }, { 11, "UNSTKERR" }, { 12, "STKERR" },
+        { 13, "LSPERR" }, { 16, "UNDEFINSTR" }, { 17, "INVSTATE" }, { 18, "INVPC" }, { 19, "NOCP" },
+        { 24, "UNALIGNED" }, { 25, "DIVBYZERO" },
+    };
+    out[0] = '\0';
+    for (uint32_t i = 0; i < sizeof(k_bits) / sizeof(k_bits[0]); i++) {
+        if (!(cfsr & (1u << k_bits[i].bit))) continue;
+        strncat(out, " ", n - strlen(out) - 1u);
+        strncat(out, k_bits[i].name, n - strlen(out) - 1u);
+    }
+    if (hfsr & (1u << 30)) strncat(out, " FORCED", n - strlen(out) - 1u);
+    if (hfsr & (1u << 1))  strncat(out, " VECTTBL", n - strlen(out) - 1u);
+}
+
+uint8_t Crash_Report(uint8_t force)
+{
+    if (!crash_valid() || (s_crash.reported && !force)) return 0u;
+
+    static const char *const k_exc[] = { "?", "?", "NMI", "HardFault", "MemManage", "BusFault", "UsageFault" };
+    const Crash_Record_t *c = &s_crash;
+    char flags[96];
+    cfsr_names(c->cfsr, c->hfsr, flags, sizeof(flags));
+
+    DZLOG_CRIT("!!! CRASH #%u: %s po %lu ms, zadanie %s", (unsigned)c->count,
+               (c->exc < 7u) ? k_exc[c->exc] : "?", (unsigned long)c->uptime_ms, App_TaskName(c->task));
+    DZLOG_CRIT("  pc=%08lX lr=%08lX sp=%08lX xpsr=%08lX exc_ret=%08lX",
+               (unsigned long)c->frame[6], (unsigned long)c->frame[5], (unsigned long)c->sp,
+               (unsigned long)c->frame[7], (unsigned long)c->exc_return);
+    DZLOG_CRIT("  r0=%08lX r1=%08lX r2=%08lX r3=%08lX r12=%08lX",
+               (unsigned long)c->frame[0], (unsigned long)c->frame[1], (unsigned long)c->frame[2],
+               (unsigned long)c->frame[3], (unsigned long)c->frame[4]);
+    /* nazwy bitów (do ~90 znaków) > DZLOG_STR_MAX → ta linia zostaje tekstem */
+    DebugUART_CritPrintf("  CFSR=%08lX HFSR=%08lX MMFAR=%08lX BFAR=%08lX%s",
+                         (unsigned long)c->cfsr, (unsigned long)c->hfsr, (unsigned long)c->mmfar,
+                         (unsigned long)c->bfar, flags);
+    for (uint8_t i = 0; i < CRASH_EVENTS; i++) {                 // od najstarszego
+        const uint32_t e = c->ev[(uint8_t)(c->head + i) & (CRASH_EVENTS - 1u)];
+        if (e == 0u) continue;                                   // pusty slot
+        DZLOG_CRIT("  ev %lu ms %s", (unsigned long)(e >> 8), App_TaskName((uint8_t)e));
+    }
+    s_crash.reported = 1u;
+    return 1u;
+}
+
+void Crash_Clear(void)
+{
+    s_crash.magic = 0u;
+}
@@ -6,11 +6,25 @@
  * Założenia:
  *   - Brak użycia HAL_MAX_DELAY, brak blokowania pętli głównej.
  *   - HAL_UART_Transmit_IT + wewnętrzny bufor kołowy TX (ring buffer).
+ *   - (NOWE) Kolejka TX SPSC bez blokady: producent = pętla główna, konsument = ISR TX;
+ *     zapis = memcpy w max. 2 odcinkach, zero czasu z wyłączonymi IRQ po stronie producenta.
+ *   - (NOWE) Panel utrzymywany: pełne przerysowanie raz (i co DEBUG_UART_REPAINT_MS / po
+ *     utracie synchronizacji), potem tylko zmienione odcinki wierszy z pozycjonowaniem kursora.
+ *   - (NOWE) Dwa pasy: CRIT (pierwszeństwo, bez czekania producenta) i BULK (ramki całe albo wcale).
+ *     Nagłówek: "drop fr=BULK/CRIT  lat=BULK/CRIT" (ramki odrzucone, max latencja commit→TX).
  *   - Kompatybilne API z Twoim core.zip (Init/Print/Printf/SensorsDual).
- *   - (NOWE) Nagłówek: "DzikiBoT (Sensors)   UART dropped=X" — X odświeżany co 2 s.
+ *   - (NOWE) Nagłówek: "DzikiBoT (Sensors)   UART drop fr=X/.." — X odświeżany co 2 s.
+ *   - (NOWE) RX: po 1 bajcie przez HAL_UART_Receive_IT → kolejka RX (DebugUART_ReadChar()
+ *     w pętli, np. shell) + weak hook DebugUART_OnRxChar() (ISR).
  */
 
 #include "debug_uart.h"     // publiczne API tego modułu
+#include "color_class.h"    // klasyfikacja koloru w panelu
+#include "prof.h"           // DWT: pomiar czasu zapisu do kolejki
+#include "ramfunc.h"        // RAMFUNC — ścieżka TxCplt w SRAM2
+#include "stack_mon.h"      // high-water mark stosu w linii JIT
+#include "arena.h"          // bufory panelu (zamiast stosu)
+#include "fmt.h"            // liczby ułamkowe bez %f (bez sterty)
 #include <string.h>         // strlen, memset
 #include <stdio.h>          // snprintf, vsnprintf
 #include <stdarg.h>         // va_list, va_start, va_end
@@ -20,89 +34,250 @@
 /* Wskaźnik na uchwyt UART przekazany w DebugUART_Init() */
 static UART_HandleTypeDef *s_uart = NULL;
 
-/* Bufor kołowy TX — kolejka wysyłanych bajtów (wewnętrzna) */
-static uint8_t s_tx_rb[DEBUG_UART_RB_SIZE];  // pamięć bufora
-static volatile size_t s_head = 0;           // indeks dopisywania (head)
-static volatile size_t s_tail = 0;           // indeks czytania (tail)
+/* Kolejki TX — dwa pasy (lanes), każdy SPSC (producent: pętla główna, konsument: ISR TX).
+ * Indeksy „wolnobieżne” (free-running, zawijają przez 2^32): zajętość = head - tail,
+ * pozycja w buforze = indeks & (size-1). Pełny bufor bez „1 bajtu pustki”.
+ *   CRIT : init/gain/kalibracja/błędy — ramka cała albo wcale; czeka na miejsce tylko
+ *          w starcie (DebugUART_SetCritWait), w pętli bez czekania,
+ *          wysyłane przed BULK (wywłaszczenie na granicy porcji BULK).
+ *   BULK : panel/telemetria — ramka odrzucana w całości, gdy się nie mieści (bez „pół ramek”).
+ * Ramka: bajty „stage” (head..stage) są zapisane, ale niewidoczne dla ISR do commit. */
+typedef struct {
+    uint8_t          *buf;           // pamięć bufora
+    uint32_t          size;          // rozmiar (potęga 2)
+    volatile uint32_t head;          // zapisuje TYLKO producent (publikacja ramki)
+    volatile uint32_t tail;          // zapisuje TYLKO konsument (TxCplt)
+    uint32_t          stage;         // producent: koniec ramki w budowie (≥ head)
+    uint32_t          pending;       // bajty, które ramka próbowała dopisać
+    uint8_t           overflow;      // 1 = ramka się nie zmieściła → odrzucona przy commit
+    /* statystyki (producent) */
+    uint32_t          frames_ok;
+    uint32_t          frames_dropped;
+    uint32_t          bytes_dropped;
+    uint32_t          last_frame;    // rozmiar ostatniej ramki (B)
+    /* latencja: próbkowany znacznik „commit → ostatni bajt wysłany” (producent ustawia, ISR kasuje) */
+    volatile uint8_t  mark_on;
+    volatile uint32_t mark_end;
+    volatile uint32_t mark_t;
+    volatile uint32_t lat_last_ms;
+    volatile uint32_t lat_max_ms;
+} TxLane_t;
+
+static uint8_t s_crit_buf[DEBUG_UART_CRIT_RB_SIZE];
+static uint8_t s_bulk_buf[DEBUG_UART_RB_SIZE];
+static TxLane_t s_lane[DEBUG_UART_LANES] = {
+    [DEBUG_UART_LANE_CRIT] = { .buf = s_crit_buf, .size = DEBUG_UART_CRIT_RB_SIZE },
+    [DEBUG_UART_LANE_BULK] = { .buf = s_bulk_buf, .size = DEBUG_UART_RB_SIZE },
+};
+
+_Static_assert((DEBUG_UART_RB_SIZE & (DEBUG_UART_RB_SIZE - 1u)) == 0u,
+               "DEBUG_UART_RB_SIZE musi byc potega 2");
+_Static_assert((DEBUG_UART_CRIT_RB_SIZE & (DEBUG_UART_CRIT_RB_SIZE - 1u)) == 0u,
+               "DEBUG_UART_CRIT_RB_SIZE musi byc potega 2");
+
+/* Porcja BULK ograniczona → CRIT czeka najwyżej tyle bajtów (64 B @115200 ≈ 5.6 ms) */
+#define DEBUG_UART_BULK_CHUNK   (64u)
+/* CRIT w starcie: maks. czekanie producenta na miejsce (bezpiecznik, gdy TX stoi) */
+#define DEBUG_UART_CRIT_WAIT_MS (100u)
 
 /* Flagi/zmienne stanu TX */
-static volatile uint8_t s_tx_busy = 0;       // 1 = aktualnie trwa wysyłka (IT)
-static size_t s_active_len = 0;              // ile bajtów ma bieżąca porcja (chunk)
-
-/* Licznik “utraconych bajtów” przy przepełnieniu bufora (diagnostyka) */
-static volatile uint32_t s_tx_dropped = 0;
+static volatile uint8_t s_tx_busy = 0;       // 1 = trwa wysyłka (IT); przejmowana atomowo (CAS)
+static TxLane_t *volatile s_active_lane = NULL; // pas bieżącej porcji
+static volatile uint32_t s_active_len = 0;   // ile bajtów ma bieżąca porcja (chunk)
+
+/* Ramka BULK: głębokość zagnieżdżenia Begin/End (0 = każda linia to osobna ramka) */
+static uint8_t s_frame_depth = 0;
+
+/* 1 = start (App_Init): CRIT czeka na miejsce — log startu dłuższy niż pas, pętla jeszcze nie biegnie */
+static uint8_t s_crit_wait = 1;
+
+/* Panel utrzymywany (retained): kopia tego, co jest na ekranie terminala.
+ * Wiersze panelu (0-based; na terminalu row+1). */
+enum {
+    PANEL_ROW_HDR = 0, PANEL_ROW_SEP1, PANEL_ROW_TITLE, PANEL_ROW_SEP2,
+    PANEL_ROW_DIST, PANEL_ROW_AGE, PANEL_ROW_STR, PANEL_ROW_TEMP, PANEL_ROW_AMB,
+    PANEL_ROW_SEP3, PANEL_ROW_RGBC, PANEL_ROW_RATE, PANEL_ROW_CLS,
+    PANEL_ROW_SEP4, PANEL_ROW_JIT,
+    PANEL_ROWS
+};
+#define PANEL_COLS      (80u)                // wiersz ≤ 80 znaków, tylko ASCII (różnice liczone w bajtach)
+#define PANEL_DIFF_GAP  (8u)                 // ≤ tyle zgodnych znaków między zmianami → jeden odcinek
+static char     s_scr[PANEL_ROWS][PANEL_COLS + 1];
+/* Bufory panelu z areny (DebugUART_Init) — tylko pętla główna; NULL = panel wyłączony */
+#define PANEL_LINE_MAX  160u
+static char    *s_panel_line = NULL;    // linia formatowana (SensorsDual / PrintJitter)
+static char    *s_panel_new  = NULL;    // nowy wiersz do porównania w panel_line()
+static uint8_t  s_scr_valid = 0;             // 1 = ekran zgodny z s_scr (można wysyłać różnice)
+static uint8_t  s_scr_dirty = 0;             // 1 = w ramce wysłano zmiany → zaparkuj kursor
+static uint32_t s_scr_ts    = 0;             // czas ostatniego pełnego przerysowania
+static const char k_panel_sep[] = "-------------------------------+-------------------------------------";
+static void term_goto(uint8_t row, uint8_t col);
+
+/* RX: pojedynczy bajt odbierany w przerwaniu → kolejka RX (SPSC: ISR → pętla) + hook */
+static uint8_t s_rx_byte = 0;
+static uint8_t s_rx_rb[DEBUG_UART_RX_SIZE];
+static volatile uint32_t s_rx_head = 0;      // zapisuje TYLKO ISR
+static volatile uint32_t s_rx_tail = 0;      // zapisuje TYLKO pętla (DebugUART_ReadChar)
+static volatile uint32_t s_rx_dropped = 0;   // bajty utracone przy pełnej kolejce RX
+
+_Static_assert((DEBUG_UART_RX_SIZE & (DEBUG_UART_RX_SIZE - 1u)) == 0u,
+               "DEBUG_UART_RX_SIZE musi byc potega 2");
+
+/* Pomiar: najdłuższy zapis producenta (cykle DWT) — IRQ NIE są w nim blokowane */
+static uint32_t s_wr_max_cyc = 0;
 
 /* Krótki cache nagłówka: wartość dropów odświeżana co 2 s, by nie "migała" */
 static uint32_t s_drop_cached = 0;           // ostatnia zapamiętana wartość
 static uint32_t s_drop_last_ts = 0;          // kiedy ostatnio zaktualizowano cache
 #define DEBUG_UART_DROP_REFRESH_MS  (2000u)  // co 2 sekundy odświeżamy wartość
 
-/* Krótkie makra sekcji krytycznej (blokada przerwań na modyfikację head/tail) */
-#ifndef ENTER_CRIT
-#define ENTER_CRIT()  uint32_t _primask = __get_PRIMASK(); __disable_irq()
-#define EXIT_CRIT()   do { if(!_primask) __enable_irq(); } while(0)
-#endif
-
-/* Pomocnicze: ile zajęte/ile wolne w kolejce (1 bajt pustki dla rozróżnienia) */
-static inline size_t rb_used(void) { return (s_head - s_tail) % DEBUG_UART_RB_SIZE; }
-static inline size_t rb_free(void) { return DEBUG_UART_RB_SIZE - 1u - rb_used(); }
+/* Pomocnicze: wolne miejsce za ramką w budowie (odczyt tail z acquire) */
+static inline uint32_t lane_free(const TxLane_t *L)
+{
+    return L->size - (L->stage - __atomic_load_n(&L->tail, __ATOMIC_ACQUIRE));
+}
+static inline uint32_t lane_used(TxLane_t *L)
+{
+    return __atomic_load_n(&L->head, __ATOMIC_ACQUIRE) - L->tail;
+}
 
 /* ================== Rozpoczęcie wysyłki porcji (prywatne) ============= */
 
-/* Startuje wysyłanie kolejnej porcji, jeśli nic nie leci.
- * Porcja = ciągły fragment od tail do końca bufora (żeby nie owijać). */
-static void try_kick_tx(void)
+/* Startuje wysyłanie kolejnej porcji, jeśli nic nie leci. CRIT ma pierwszeństwo.
+ * Porcja = ciągły fragment od tail do końca danych lub końca bufora (bez owijania).
+ * Wołana z pętli (po commit) i z ISR (TxCplt) — „właściciela” TX wybiera CAS na s_tx_busy. */
+RAMFUNC_HELPER static void try_kick_tx(void)
 {
     if (!s_uart) return;                 // brak uchwytu UART → nic nie robimy
-    if (s_tx_busy) return;               // poprzednia porcja jeszcze leci → poczekaj
 
-    size_t head = s_head;                // lokalne kopie (atomowe odczyty)
-    size_t tail = s_tail;
+    uint8_t idle = 0u;                   // przejmij TX tylko, gdy wolny (0 → 1)
+    if (!__atomic_compare_exchange_n(&s_tx_busy, &idle, 1u, 0,
+                                     __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+        return;                          // poprzednia porcja jeszcze leci → poczekaj
+    }
 
-    if (head == tail) return;            // kolejka pusta → nie ma czego wysłać
+    TxLane_t *L = &s_lane[DEBUG_UART_LANE_CRIT];
+    uint32_t used = lane_used(L);
+    uint32_t lim  = L->size;
+    if (used == 0u) {                    // CRIT pusty → BULK (porcje ograniczone)
+        L    = &s_lane[DEBUG_UART_LANE_BULK];
+        used = lane_used(L);
+        lim  = DEBUG_UART_BULK_CHUNK;
+    }
+    if (used == 0u) {                    // obie kolejki puste → oddaj TX
+        __atomic_store_n(&s_tx_busy, 0u, __ATOMIC_RELEASE);
+        /* Producent mógł opublikować ramkę między odczytem a zwolnieniem — sprawdź ponownie */
+        if (lane_used(&s_lane[DEBUG_UART_LANE_CRIT]) || lane_used(&s_lane[DEBUG_UART_LANE_BULK])) {
+            try_kick_tx();
+        }
+        return;
+    }
 
-    /* Wyznacz “chunk” jako liniowy fragment do końca bufora */
-    size_t chunk = (head > tail) ? (head - tail) : (DEBUG_UART_RB_SIZE - tail);
+    /* Wyznacz “chunk” jako liniowy fragment do końca bufora (i limitu pasa) */
+    const uint32_t off = L->tail & (L->size - 1u);
+    uint32_t chunk = L->size - off;
+    if (chunk > used) chunk = used;
+    if (chunk > lim)  chunk = lim;
 
-    s_active_len = chunk;                // zapamiętaj, ile bajtów wysyłamy w tej porcji
-    s_tx_busy = 1;                       // oznacz, że TX jest zajęty
+    s_active_lane = L;                   // zapamiętaj pas i długość porcji
+    s_active_len  = chunk;
 
     /* Uruchom asynchroniczną transmisję przerwaniami (bez blokowania) */
-    HAL_StatusTypeDef st = HAL_UART_Transmit_IT(s_uart, &s_tx_rb[tail], (uint16_t)chunk);
+    HAL_StatusTypeDef st = HAL_UART_Transmit_IT(s_uart, &L->buf[off], (uint16_t)chunk);
     if (st != HAL_OK)                    // jeśli HAL nie wystartował (np. błąd)
     {
-        s_tx_busy = 0;                   // zwolnij busy — spróbujemy później
-        s_active_len = 0;                // nic nie poszło
-        /* Uwaga: nie przesuwamy tail, bo nic nie wysłano. */
+        s_active_len = 0;                // nic nie poszło; tail bez zmian
+        __atomic_store_n(&s_tx_busy, 0u, __ATOMIC_RELEASE);   // spróbujemy później
     }
 }
 
 /* ============================ Enqueue (priv) ========================== */
 
-/* Wrzuca len bajtów do kolejki TX. Zwraca ile faktycznie dopisano.
- * Jeśli brak miejsca — nadmiar jest odrzucany, a licznik dropów inkrementowany. */
-static size_t DebugUART_Write(const void *data, size_t len)
+/* Dopisuje len bajtów do ramki w budowie (niewidoczne dla ISR do commit).
+ * Jeden producent (pętla główna) → bez sekcji krytycznej: memcpy w max. 2 odcinkach.
+ * Brak miejsca → ramka oznaczona jako przepełniona (odrzucona w całości przy commit). */
+static void lane_stage(TxLane_t *L, const void *data, size_t len)
 {
-    if (!s_uart || !data || len == 0) return 0;   // brak UART/danych → nic do zrobienia
-
-    const uint8_t *p = (const uint8_t*)data;      // rzut na bajty
-    size_t written = 0;                            // ile dopisaliśmy
+    if (len == 0u) return;
+    L->pending += (uint32_t)len;
+    if (L->overflow) return;                       // ramka i tak przepadnie
+    if (len > lane_free(L)) { L->overflow = 1u; return; }
+
+    const uint32_t t0   = Prof_Cycles();
+    const uint8_t *p    = (const uint8_t*)data;    // rzut na bajty
+    const uint32_t off  = L->stage & (L->size - 1u);
+    const uint32_t lin  = L->size - off;
+    const size_t   n1   = (len < lin) ? len : lin; // odcinek do końca bufora
+    memcpy(&L->buf[off], p, n1);
+    if (len > n1) memcpy(&L->buf[0], p + n1, len - n1);   // reszta od początku
+    L->stage += (uint32_t)len;
+    PROF_MAX_UPDATE(s_wr_max_cyc, t0);
+}
 
-    ENTER_CRIT();                                  // modyfikacja wskaźników wymaga sekcji krytycznej
-    while (written < len)                          // dopóki mamy bajty na wejściu
-    {
-        if (rb_free() == 0) {                      // brak miejsca w buforze?
-            s_tx_dropped += (uint32_t)(len - written); // zlicz “utracone” bajty
-            break;                                  // przerwij (bez blokowania CPU)
+/* Zamyka ramkę: publikacja head (release) albo odrzucenie całości. 1 = wysłana do kolejki. */
+static uint8_t lane_commit(TxLane_t *L)
+{
+    uint8_t ok = 0u;
+    L->last_frame = L->pending;
+    if (L->overflow) {
+        if (L == &s_lane[DEBUG_UART_LANE_BULK]) s_scr_valid = 0u;   // terminal nie dostał różnic
+        L->frames_dropped++;
+        L->bytes_dropped += L->pending;
+        L->stage = L->head;                        // cofnij ramkę (ISR jej nie widział)
+    } else if (L->stage != L->head) {
+        __atomic_store_n(&L->head, L->stage, __ATOMIC_RELEASE);   // publikacja
+        L->frames_ok++;
+        if (!__atomic_load_n(&L->mark_on, __ATOMIC_ACQUIRE)) {    // próbka latencji
+            L->mark_end = L->stage;
+            L->mark_t   = HAL_GetTick();
+            __atomic_store_n(&L->mark_on, 1u, __ATOMIC_RELEASE);
         }
-        s_tx_rb[s_head] = p[written];              // zapisz bajt pod head
-        s_head = (s_head + 1u) % DEBUG_UART_RB_SIZE; // przesuwamy head (zawijanie)
-        written++;                                  // policz zapisany bajt
+        ok = 1u;
     }
-    EXIT_CRIT();                                   // odblokuj IRQ
+    L->overflow = 0u;
+    L->pending  = 0u;
+    try_kick_tx();                                 // spróbuj wystartować wysyłkę, jeśli stoi
+    return ok;
+}
+
+/* BULK: surowe bajty (ESC) do otwartej ramki albo jako osobna ramka */
+static void bulk_raw(const void *data, size_t len)
+{
+    TxLane_t *L = &s_lane[DEBUG_UART_LANE_BULK];
+    lane_stage(L, data, len);
+    if (s_frame_depth == 0u) (void)lane_commit(L);
+}
+
+/* BULK: linia dopisana do otwartej ramki albo jako osobna ramka (poza Begin/End) */
+static void bulk_line(const char *s, size_t len)
+{
+    TxLane_t *L = &s_lane[DEBUG_UART_LANE_BULK];
+    s_scr_valid = 0u;                              // zwykły wydruk przesuwa ekran → panel do odrysowania
+    lane_stage(L, s, len);
+    lane_stage(L, "\r\n", 2u);                     // CRLF (spójny styl)
+    if (s_frame_depth == 0u) (void)lane_commit(L);
+}
 
-    try_kick_tx();                                 // spróbuj wystartować wysyłkę, jeśli stoję
-    return written;                                // może być < len przy przepełnieniu
+/* CRIT: ramka = linia/rekord; brak miejsca → w starcie czekaj (max DEBUG_UART_CRIT_WAIT_MS),
+ * w pętli głównej odrzuć w całości i policz. Gdy TX stoi (np. błąd HAL), popchnij go. */
+static uint8_t crit_put(const void *data, size_t len, uint8_t crlf)
+{
+    TxLane_t *L = &s_lane[DEBUG_UART_LANE_CRIT];
+    const size_t tail = crlf ? 2u : 0u;
+    s_scr_valid = 0u;                              // linia CRIT w środku ekranu → panel do odrysowania
+    if (len + tail > L->size) len = L->size - tail;   // dłuższe niż pas — przytnij
+    const uint32_t t0 = HAL_GetTick();
+    while (lane_free(L) < len + tail) {
+        try_kick_tx();
+        if (!s_crit_wait || (uint32_t)(HAL_GetTick() - t0) >= DEBUG_UART_CRIT_WAIT_MS) break;
+    }
+    lane_stage(L, data, len);
+    if (crlf) lane_stage(L, "\r\n", 2u);
+    return lane_commit(L);
+}
+static void crit_line(const char *s, size_t len)
+{
+    (void)crit_put(s, len, 1u);
 }
 
 /* ============================== API ================================== */
@@ -110,31 +285,63 @@ static size_t DebugUART_Write(const void *data, size_t len)
 /* Inicjalizacja modułu: zapamiętuje uchwyt, czyści kolejkę/flagę/liczniki. */
 void DebugUART_Init(UART_HandleTypeDef *huart)
 {
-    s_uart = huart;                 // pamiętaj, którego UARTu używamy (np. &huart2)
-    ENTER_CRIT();                   // reset stanu w sekcji krytycznej
-    s_head = s_tail = 0;            // pusta kolejka TX
+    s_uart = NULL;                  // TX wyłączony na czas resetu (przed startem IT)
+    for (uint8_t i = 0; i < DEBUG_UART_LANES; i++) {   // puste kolejki TX, zerowe statystyki
+        TxLane_t *L = &s_lane[i];
+        L->head = L->tail = L->stage = 0u;
+        L->pending = 0u; L->overflow = 0u;
+        L->frames_ok = L->frames_dropped = L->bytes_dropped = L->last_frame = 0u;
+        L->mark_on = 0u; L->lat_last_ms = L->lat_max_ms = 0u;
+    }
     s_tx_busy = 0;                  // brak trwającej wysyłki
-    s_active_len = 0;               // brak aktywnej porcji
-    s_tx_dropped = 0;               // wyzeruj licznik dropów
-    EXIT_CRIT();                    // koniec resetu
+    s_active_lane = NULL;           // brak aktywnej porcji
+    s_active_len = 0;
+    s_frame_depth = 0;
+    s_crit_wait = 1u;               // log startu bez strat (DebugUART_SetCritWait(0) po App_Init)
+    s_rx_head = s_rx_tail = 0;      // pusta kolejka RX
+    s_rx_dropped = 0;
+    s_wr_max_cyc = 0;               // pomiar od zera
+    if (!s_panel_line) s_panel_line = Arena_Alloc(PANEL_LINE_MAX, "uart.line");
+    if (!s_panel_new)  s_panel_new  = Arena_Alloc(PANEL_COLS + 1u, "uart.scr");
+    Prof_Init();                    // DWT->CYCCNT do pomiarów czasu zapisu
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    s_uart = huart;                 // pamiętaj, którego UARTu używamy (np. &huart2)
 
     /* Wyzeruj cache nagłówka */
     s_drop_cached = 0;
     s_drop_last_ts = HAL_GetTick();
+
+    /* RX: uzbrój odbiór pierwszego bajtu (kolejne w callbacku) */
+    if (s_uart) (void)HAL_UART_Receive_IT(s_uart, &s_rx_byte, 1u);
+}
+
+/* RX: następny bajt z kolejki (pętla główna); -1 = brak danych */
+int DebugUART_ReadChar(void)
+{
+    const uint32_t tail = s_rx_tail;
+    if (__atomic_load_n(&s_rx_head, __ATOMIC_ACQUIRE) == tail) return -1;
+    const uint8_t c = s_rx_rb[tail & (DEBUG_UART_RX_SIZE - 1u)];
+    __atomic_store_n(&s_rx_tail, tail + 1u, __ATOMIC_RELEASE);      // zwolnij miejsce dla ISR
+    return (int)c;
+}
+
+/* Hook RX (weak): wołany z przerwania dla każdego odebranego bajtu — tylko krótkie akcje! */
+__attribute__((weak)) void DebugUART_OnRxChar(char c)
+{
+    (void)c;                                        // domyślnie ignorujemy wejście
 }
 
-/* Wysyła podany string + CRLF (enqueue, nieblokujące). */
+/* Wysyła podany string + CRLF (BULK, enqueue, nieblokujące). */
 void DebugUART_Print(const char *s)
 {
-    if (!s) return;                                 // brak tekstu → nic
-    (void)DebugUART_Write(s, strlen(s));            // wrzuć treść do kolejki
-    (void)DebugUART_Write("\r\n", 2u);              // dopisz CRLF (spójny styl)
+    if (!s || !s_uart) return;                      // brak tekstu/UART → nic
+    bulk_line(s, strlen(s));
 }
 
-/* Wysyła sformatowany tekst (printf) + CRLF (enqueue, nieblokujące). */
+/* Wysyła sformatowany tekst (printf) + CRLF (BULK, enqueue, nieblokujące). */
 void DebugUART_Printf(const char *fmt, ...)
 {
-    if (!fmt) return;                               // brak formatu → nic
+    if (!fmt || !s_uart) return;                    // brak formatu/UART → nic
 
     char buf[160];                                  // lokalny bufor formatowania
     va_list ap;                                     // lista argumentów zmiennych
@@ -142,14 +349,97 @@ void DebugUART_Printf(const char *fmt, ...)
     (void)vsnprintf(buf, sizeof(buf), fmt, ap);     // sformatuj
     va_end(ap);                                     // koniec pobierania argumentów
 
-    (void)DebugUART_Write(buf, strlen(buf));        // wrzuć sformatowaną treść
-    (void)DebugUART_Write("\r\n", 2u);              // CRLF
+    bulk_line(buf, strlen(buf));
+}
+
+/* CRIT: string + CRLF, wysyłany przed BULK. W pętli bez miejsca → odrzucony i policzony
+ * (zapas DEBUG_UART_CRIT_RESERVE chroni zdarzenia przed stronicowaniem i zrzutami). */
+void DebugUART_Crit(const char *s)
+{
+    if (!s || !s_uart) return;
+    crit_line(s, strlen(s));
+}
+
+/* CRIT: printf + CRLF — jak DebugUART_Crit(). */
+void DebugUART_CritPrintf(const char *fmt, ...)
+{
+    if (!fmt || !s_uart) return;
+
+    char buf[160];
+    va_list ap;
+    va_start(ap, fmt);
+    (void)vsnprintf(buf, sizeof(buf), fmt, ap);
+    va_end(ap);
+
+    crit_line(buf, strlen(buf));
+}
+
+uint8_t DebugUART_CritRoom(size_t line_max)
+{
+    return (uint8_t)(lane_free(&s_lane[DEBUG_UART_LANE_CRIT]) >= line_max + DEBUG_UART_CRIT_RESERVE);
+}
+
+/* Start: CRIT czeka na miejsce (log startu bez strat); pętla główna → 0 */
+void DebugUART_SetCritWait(uint8_t on)
+{
+    s_crit_wait = on ? 1u : 0u;
+}
+
+/* Surowe bajty (np. rekord dzlog) — CRIT: jak CritPrintf (odrzucone w całości, gdy brak
+ * miejsca), BULK: część otwartej ramki albo osobna ramka. Bez CRLF. */
+uint8_t DebugUART_WriteRaw(DebugUART_Lane_t lane, const void *data, size_t len)
+{
+    if (!s_uart || !data || len == 0u) return 0u;
+    if (lane == DEBUG_UART_LANE_CRIT) return crit_put(data, len, 0u);
+    if (lane != DEBUG_UART_LANE_BULK) return 0u;
+    s_scr_valid = 0u;                               // dekoder wypisze linię → panel do odrysowania
+    lane_stage(&s_lane[DEBUG_UART_LANE_BULK], data, len);
+    if (s_frame_depth == 0u) return lane_commit(&s_lane[DEBUG_UART_LANE_BULK]);
+    return 1u;
+}
+
+/* Ramka BULK: wszystko między Begin/End trafia do kolejki w całości albo wcale. */
+void DebugUART_FrameBegin(void)
+{
+    if (s_frame_depth < 0xFFu) s_frame_depth++;     // zagnieżdżenie → jedna ramka zewnętrzna
+}
+
+uint8_t DebugUART_FrameEnd(void)
+{
+    if (s_frame_depth == 0u) return 0u;             // End bez Begin
+    if (s_frame_depth == 1u && s_scr_dirty) {       // po zmianach panelu: kursor pod panel
+        s_scr_dirty = 0u;
+        term_goto((uint8_t)(PANEL_ROWS + 1u), 1u);
+    }
+    if (--s_frame_depth != 0u) return 1u;           // wewnętrzny End — ramka dalej otwarta
+    return lane_commit(&s_lane[DEBUG_UART_LANE_BULK]);
 }
 
-/* Getter liczby bajtów utraconych (przepełnienia kolejki). */
+/* Getter liczby bajtów utraconych (odrzucone ramki obu pasów). */
 uint32_t DebugUART_Dropped(void)
 {
-    return s_tx_dropped;                            // prosty odczyt licznika
+    return s_lane[DEBUG_UART_LANE_CRIT].bytes_dropped + s_lane[DEBUG_UART_LANE_BULK].bytes_dropped;
+}
+
+/* Statystyki pasa: ramki OK/odrzucone, bajty odrzucone, latencja commit→wysłane, zajętość. */
+void DebugUART_GetLaneStats(DebugUART_Lane_t lane, DebugUART_LaneStats_t *out)
+{
+    if (!out || lane >= DEBUG_UART_LANES) return;
+    TxLane_t *L = &s_lane[lane];
+    out->frames_ok      = L->frames_ok;
+    out->frames_dropped = L->frames_dropped;
+    out->bytes_dropped  = L->bytes_dropped;
+    out->lat_last_ms    = L->lat_last_ms;
+    out->lat_max_ms     = L->lat_max_ms;
+    out->last_frame_bytes = L->last_frame;
+    out->used           = lane_used(L);
+    out->size           = L->size;
+}
+
+/* Najdłuższy zapis producenta w µs (IRQ w tym czasie NIE są blokowane). */
+uint32_t DebugUART_WriteMaxUs(void)
+{
+    return Prof_CyclesToUs(s_wr_max_cyc);
 }
 
 /* ========================= ANSI helper (priv) ======================== */
@@ -158,7 +448,58 @@ uint32_t DebugUART_Dropped(void)
 static void term_clear(void)
 {
     static const char cmd[] = "\x1b[2J\x1b[H";      // ESC[2J (clear) + ESC[H (home)
-    (void)DebugUART_Write(cmd, sizeof(cmd) - 1u);   // do kolejki TX
+    bulk_raw(cmd, sizeof(cmd) - 1u);                // do ramki BULK
+}
+
+/* Kursor na (row, col), 1-based: ESC[row;colH */
+static void term_goto(uint8_t row, uint8_t col)
+{
+    char cmd[12];
+    const int n = snprintf(cmd, sizeof(cmd), "\x1b[%u;%uH", (unsigned)row, (unsigned)col);
+    if (n > 0) bulk_raw(cmd, (size_t)n);
+}
+
+/* Start panelu: pełne przerysowanie przy pierwszym użyciu, po utracie synchronizacji
+ * (inny wydruk, odrzucona ramka) i co DEBUG_UART_REPAINT_MS; inaczej nic nie wysyła. */
+static void panel_begin(void)
+{
+    const uint32_t now = HAL_GetTick();
+    if (s_scr_valid && (uint32_t)(now - s_scr_ts) < DEBUG_UART_REPAINT_MS) return;
+    term_clear();
+    memset(s_scr, 0, sizeof(s_scr));                // „ekran pusty” → każdy wiersz różny
+    s_scr_valid = 1u;
+    s_scr_ts    = now;
+}
+
+/* Wiersz panelu: porównanie z kopią ekranu i wysyłka tylko zmienionych odcinków
+ * (ESC[r;cH + znaki). Odcinki bliżej niż PANEL_DIFF_GAP łączymy — taniej niż nowy ESC. */
+static void panel_line(uint8_t row, const char *txt)
+{
+    if (row >= PANEL_ROWS || !txt || !s_panel_new) return;
+    char *old = s_scr[row];
+    char *nw  = s_panel_new;
+
+    size_t n = strlen(txt);
+    if (n > PANEL_COLS) n = PANEL_COLS;
+    const size_t oldn = strlen(old);
+    const size_t m    = (n > oldn) ? n : oldn;
+    memcpy(nw, txt, n);
+    memset(&nw[n], ' ', m - n);                     // dopełnij spacjami (czyści ogon starej treści)
+    nw[m] = '\0';
+
+    size_t i = 0;
+    while (i < m) {
+        if (nw[i] == old[i]) { i++; continue; }
+        size_t last = i;
+        for (size_t j = i + 1; j < m && (j - last) <= PANEL_DIFF_GAP; j++) {
+            if (nw[j] != old[j]) last = j;
+        }
+        term_goto((uint8_t)(row + 1u), (uint8_t)(i + 1u));
+        bulk_raw(&nw[i], last - i + 1u);
+        s_scr_dirty = 1u;
+        i = last + 1u;
+    }
+    memcpy(old, nw, m + 1u);
 }
 
 /* ======================== Panel dwukolumnowy ========================= */
@@ -168,12 +509,13 @@ void DebugUART_SensorsDual(const TF_LunaData_t *RightLuna,
                            const TCS3472_Data_t *RightColor,
                            const TCS3472_Data_t *LeftColor)
 {
-    if (!s_uart || !RightLuna || !LeftLuna || !RightColor || !LeftColor)
+    if (!s_uart || !RightLuna || !LeftLuna || !RightColor || !LeftColor || !s_panel_line)
         return;                                     // brak danych/uart → nic nie drukuj
 
-    term_clear();                                   // nowa „rama” panelu
+    DebugUART_FrameBegin();                         // panel = jedna ramka BULK (cała albo wcale)
+    panel_begin();                                  // pełne przerysowanie tylko gdy trzeba
 
-    char line[160];                                 // wspólny bufor linii
+    char *const line = s_panel_line;                // wspólny bufor linii (arena)
     const char *stR = RightLuna->frameReady ? "OK " : "NO FRAME"; // status prawej Luny
     const char *stL = LeftLuna->frameReady  ? "OK " : "NO FRAME"; // status lewej Luny
 
@@ -182,52 +524,73 @@ void DebugUART_SensorsDual(const TF_LunaData_t *RightLuna,
     {
         const uint32_t now = HAL_GetTick();
         if ((uint32_t)(now - s_drop_last_ts) >= DEBUG_UART_DROP_REFRESH_MS) {
-            s_drop_cached  = DebugUART_Dropped();   // pobierz aktualną wartość
+            s_drop_cached  = s_lane[DEBUG_UART_LANE_BULK].frames_dropped;   // aktualna wartość
             s_drop_last_ts = now;                   // zapamiętaj czas odświeżenia
         }
-        (void)snprintf(line, sizeof(line),
-                       "DzikiBoT (Sensors)   UART dropped=%lu",
-                       (unsigned long)s_drop_cached);
-        DebugUART_Print(line);
+        (void)snprintf(line, PANEL_LINE_MAX,
+                       "DzikiBoT (Sensors)   UART drop fr=%lu/%lu  lat=%lu/%lums  wr_max=%luus",
+                       (unsigned long)s_drop_cached,
+                       (unsigned long)s_lane[DEBUG_UART_LANE_CRIT].frames_dropped,
+                       (unsigned long)s_lane[DEBUG_UART_LANE_BULK].lat_max_ms,
+                       (unsigned long)s_lane[DEBUG_UART_LANE_CRIT].lat_max_ms,
+                       (unsigned long)DebugUART_WriteMaxUs());
+        panel_line(PANEL_ROW_HDR, line);
     }
 
-    DebugUART_Print("-------------------------------+-------------------------------------");
-    DebugUART_Print("            RIGHT (I2C1)       |               LEFT (I2C3)");
-    DebugUART_Print("-------------------------------+-------------------------------------");
+    panel_line(PANEL_ROW_SEP1, k_panel_sep);
+    panel_line(PANEL_ROW_TITLE, "            RIGHT (I2C1)       |               LEFT (I2C3)");
+    panel_line(PANEL_ROW_SEP2, k_panel_sep);
 
     /* DIST – filtr (mediana) */
-    (void)snprintf(line, sizeof(line),
+    (void)snprintf(line, PANEL_LINE_MAX,
                    " Dist:  %4u cm  (%-8s)    | Dist:  %4u cm  (%-8s)",
                    (unsigned)RightLuna->distance_filt, stR,
                    (unsigned)LeftLuna->distance_filt,  stL);
-    DebugUART_Print(line);
+    panel_line(PANEL_ROW_DIST, line);
+
+    /* AGE – wiek próbki lidaru (trigger → odczyt); w trybie ciągłym nieznany */
+    {
+        char ageR[12], ageL[12];
+        if (RightLuna->age_ms != TFLUNA_AGE_UNKNOWN) (void)snprintf(ageR, sizeof(ageR), "%3u ms", (unsigned)RightLuna->age_ms);
+        else                                         (void)snprintf(ageR, sizeof(ageR), "  --  ");
+        if (LeftLuna->age_ms  != TFLUNA_AGE_UNKNOWN) (void)snprintf(ageL, sizeof(ageL), "%3u ms", (unsigned)LeftLuna->age_ms);
+        else                                         (void)snprintf(ageL, sizeof(ageL), "  --  ");
+        (void)snprintf(line, PANEL_LINE_MAX,
+                       " Age : %-8s                | Age : %-8s",
+                       ageR, ageL);
+        panel_line(PANEL_ROW_AGE, line);
+    }
 
     /* STR – EMA/średnia krocząca siły sygnału */
-    (void)snprintf(line, sizeof(line),
+    (void)snprintf(line, PANEL_LINE_MAX,
                    " Str : %5u                   | Str : %5u",
                    (unsigned)RightLuna->strength_filt,
                    (unsigned)LeftLuna->strength_filt);
-    DebugUART_Print(line);
+    panel_line(PANEL_ROW_STR, line);
 
     /* TEMP – temperatura modułu (°C) */
-    (void)snprintf(line, sizeof(line),
-                   " Temp: %5.1f C                 | Temp: %5.1f C",
-                   (double)RightLuna->temperature,
-                   (double)LeftLuna->temperature);
-    DebugUART_Print(line);
+    {
+        char tR[8], tL[8];
+        (void)snprintf(line, PANEL_LINE_MAX,
+                       " Temp: %s C                 | Temp: %s C",
+                       Fmt_Fixed(tR, sizeof(tR), RightLuna->temperature, 1u, 5u),
+                       Fmt_Fixed(tL, sizeof(tL), LeftLuna->temperature,  1u, 5u));
+        panel_line(PANEL_ROW_TEMP, line);
+    }
 
     /* AMBIENT (est.) – estymacja otoczenia z drivera TF_Luna */
     {
         float ambR = TF_Luna_AmbientEstimateC(RightLuna);  // estymacja prawej
         float ambL = TF_Luna_AmbientEstimateC(LeftLuna);   // estymacja lewej
+        char aR[8], aL[8];
 
-        (void)snprintf(line, sizeof(line),
-                       " Amb.: %5.1f C (est)           | Amb.: %5.1f C (est)",
-                       (double)ambR, (double)ambL);
-        DebugUART_Print(line);
+        (void)snprintf(line, PANEL_LINE_MAX,
+                       " Amb.: %s C (est)           | Amb.: %s C (est)",
+                       Fmt_Fixed(aR, sizeof(aR), ambR, 1u, 5u), Fmt_Fixed(aL, sizeof(aL), ambL, 1u, 5u));
+        panel_line(PANEL_ROW_AMB, line);
     }
 
-    DebugUART_Print("-------------------------------+-------------------------------------");
+    panel_line(PANEL_ROW_SEP3, k_panel_sep);
 
     /* RGB/C — spójnie z UI (skalowanie /64) */
     {
@@ -241,33 +604,114 @@ void DebugUART_SensorsDual(const TF_LunaData_t *RightLuna,
         unsigned bL = LeftColor->blue   / 64u;
         unsigned cL = LeftColor->clear  / 64u;
 
-        (void)snprintf(line, sizeof(line),
+        (void)snprintf(line, PANEL_LINE_MAX,
                        " R:%4u G:%4u B:%4u C:%5u  | R:%4u G:%4u B:%4u C:%5u",
                        rR, gR, bR, cR, rL, gL, bL, cL);
-        DebugUART_Print(line);
+        panel_line(PANEL_ROW_RGBC, line);
     }
+
+    /* RATE/LAT — częstość nowych integracji TCS (bramka AINT) + wiek próbki (ATIME + czekanie) */
+    {
+        char rR[8], iR[8], rL[8], iL[8];
+        (void)snprintf(line, PANEL_LINE_MAX,
+                       " Rate:%sHz It/Lat:%s/%3ums | Rate:%sHz It/Lat:%s/%3ums",
+                       Fmt_Fixed(rR, sizeof(rR), RightColor->rate_hz, 1u, 4u),
+                       Fmt_Fixed(iR, sizeof(iR), RightColor->itime_ms, 1u, 5u), (unsigned)RightColor->latency_ms,
+                       Fmt_Fixed(rL, sizeof(rL), LeftColor->rate_hz, 1u, 4u),
+                       Fmt_Fixed(iL, sizeof(iL), LeftColor->itime_ms, 1u, 5u), (unsigned)LeftColor->latency_ms);
+        panel_line(PANEL_ROW_RATE, line);
+    }
+
+    /* KLASA — wynik klasyfikatora koloru (pewność w %) */
+    {
+        const ColorResult_t kR = ColorClass_Classify(RightColor);
+        const ColorResult_t kL = ColorClass_Classify(LeftColor);
+        (void)snprintf(line, PANEL_LINE_MAX,
+                       " Cls : %-5s %3u%%              | Cls : %-5s %3u%%",
+                       ColorClass_Name(kR.cls), (unsigned)((kR.conf * 100u) / 255u),
+                       ColorClass_Name(kL.cls), (unsigned)((kL.conf * 100u) / 255u));
+        panel_line(PANEL_ROW_CLS, line);
+    }
+
+    (void)DebugUART_FrameEnd();                     // commit (albo odrzucenie całej ramki)
+}
+
+/* ======================== Panel skrócony (1 linia) ==================== */
+
+void DebugUART_SensorsCompact(const TF_LunaData_t *RightLuna,
+                              const TF_LunaData_t *LeftLuna,
+                              const TCS3472_Data_t *RightColor,
+                              const TCS3472_Data_t *LeftColor)
+{
+    if (!s_uart || !RightLuna || !LeftLuna || !RightColor || !LeftColor)
+        return;                                     // brak danych/uart → nic nie drukuj
+
+    const ColorResult_t kR = ColorClass_Classify(RightColor);
+    const ColorResult_t kL = ColorClass_Classify(LeftColor);
+    DebugUART_Printf("R %4ucm C%5u %-5s | L %4ucm C%5u %-5s | drop fr=%lu",
+                     (unsigned)RightLuna->distance_filt, (unsigned)RightColor->clear, ColorClass_Name(kR.cls),
+                     (unsigned)LeftLuna->distance_filt,  (unsigned)LeftColor->clear,  ColorClass_Name(kL.cls),
+                     (unsigned long)s_lane[DEBUG_UART_LANE_BULK].frames_dropped);
 }
 
 /* ===================== HAL callback przerwania TX ==================== */
 
 /* Wywoływana przez HAL po zakończeniu wysyłania bieżącej porcji (chunk). */
-void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
+RAMFUNC void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
 {
     if (huart != s_uart) return;                     // filtr: tylko nasz UART
-
-    ENTER_CRIT();                                    // modyfikujemy tail/flagę
-    s_tail = (s_tail + s_active_len) % DEBUG_UART_RB_SIZE; // przesuń ogon o wysłaną porcję
-    s_active_len = 0;                                // porcja już wysłana
-    s_tx_busy = 0;                                   // TX wolny — można ruszyć następną
-    EXIT_CRIT();                                     // koniec sekcji krytycznej
+    const uint32_t t0 = Prof_Cycles();
+
+    /* Konsument: zwolnij wysłaną porcję (release → producent widzi wolne miejsce) */
+    TxLane_t *L = s_active_lane;
+    if (L) {
+        const uint32_t tail = L->tail + s_active_len;
+        __atomic_store_n(&L->tail, tail, __ATOMIC_RELEASE);
+        if (__atomic_load_n(&L->mark_on, __ATOMIC_ACQUIRE) &&
+            (int32_t)(tail - L->mark_end) >= 0) {    // próbkowana ramka w całości wysłana
+            const uint32_t lat = HAL_GetTick() - L->mark_t;
+            L->lat_last_ms = lat;
+            if (lat > L->lat_max_ms) L->lat_max_ms = lat;
+            __atomic_store_n(&L->mark_on, 0u, __ATOMIC_RELEASE);
+        }
+    }
+    s_active_lane = NULL;
+    s_active_len  = 0;                               // porcja już wysłana
+    __atomic_store_n(&s_tx_busy, 0u, __ATOMIC_RELEASE);   // TX wolny — można ruszyć następną
 
     try_kick_tx();                                   // jeśli są kolejne bajty — start kolejnej porcji
+    RamFn_Add(RAMFN_UART_TXC, Prof_Cycles() - t0);
+}
+
+/* ===================== HAL callbacki przerwania RX ==================== */
+
+/* Odebrano 1 bajt: przekaż do hooka i uzbrój kolejny odbiór. */
+void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
+{
+    if (huart != s_uart) return;                     // filtr: tylko nasz UART
+    const uint32_t head = s_rx_head;
+    if ((head - __atomic_load_n(&s_rx_tail, __ATOMIC_ACQUIRE)) < DEBUG_UART_RX_SIZE) {
+        s_rx_rb[head & (DEBUG_UART_RX_SIZE - 1u)] = s_rx_byte;
+        __atomic_store_n(&s_rx_head, head + 1u, __ATOMIC_RELEASE);   // publikacja bajtu
+    } else {
+        s_rx_dropped++;                              // pętla nie nadąża → bajt tracony
+    }
+    DebugUART_OnRxChar((char)s_rx_byte);             // krótka akcja w ISR
+    (void)HAL_UART_Receive_IT(s_uart, &s_rx_byte, 1u);
+}
+
+/* Błąd (np. overrun przy szybkim wklejaniu): HAL przerywa odbiór — uzbrój ponownie. */
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
+{
+    if (huart != s_uart) return;
+    (void)HAL_UART_Receive_IT(s_uart, &s_rx_byte, 1u);
 }
 
 /* ====================== NOWE: linia z jitterem ======================= */
 /* Proste API do dopisania 1 linii z min/avg/max jittera rytmu Tank.
- * Wołaj po DebugUART_SensorsDual(...) (np. w bloku tUART w App_Tick).
- * Gdy valid==0, drukuje komunikat „zbieram próbki...”.
+ * Wołaj po DebugUART_SensorsDual(...) (np. w bloku tUART w App_Tick) — wtedy linia
+ * trafia do utrzymywanego panelu (różnicowo), inaczej jako zwykły wydruk.
+ * Gdy valid==0, drukuje komunikat „zbieram probki...”. Wiersz ≤ PANEL_COLS, tylko ASCII.
  */
 void DebugUART_PrintJitter(uint32_t tick_ms,
                            uint32_t jMin_ms,
@@ -275,15 +719,28 @@ void DebugUART_PrintJitter(uint32_t tick_ms,
                            uint32_t jMax_ms,
                            uint8_t  valid)
 {
+    if (!s_panel_line) return;
+    char *const line = s_panel_line;                // bufor z areny (pętla główna)
+    StackMon_Info_t sk;
+    StackMon_GetInfo(&sk);
+    const char *skFlag = sk.exhausted ? " KOLIZJA" : (sk.over ? " >REZERWA" : "");
+    if (!valid) {
+        (void)snprintf(line, PANEL_LINE_MAX, " [JIT] tick=%lums (zbieram probki...) stack=%lu/%luB%s",
+                       (unsigned long)tick_ms, (unsigned long)sk.used, (unsigned long)sk.reserve, skFlag);
+    } else {
+        (void)snprintf(line, PANEL_LINE_MAX, " [JIT] tick=%lums min/avg/max=%lu/%lu/%lums stack=%lu/%luB%s",
+                       (unsigned long)tick_ms,
+                       (unsigned long)jMin_ms,
+                       (unsigned long)jAvg_ms,
+                       (unsigned long)jMax_ms,
+                       (unsigned long)sk.used, (unsigned long)sk.reserve, skFlag);
+    }
 
-	 DebugUART_Print("-------------------------------+-------------------------------------");
-	if (!valid) {
-        DebugUART_Printf("     [JIT] Tank tick=%lums  (zbieram próbki...)", (unsigned long)tick_ms);
+    if (s_scr_valid) {                              // panel utrzymywany → wiersze pod panelem
+        panel_line(PANEL_ROW_SEP4, k_panel_sep);
+        panel_line(PANEL_ROW_JIT,  line);
         return;
     }
-    DebugUART_Printf("     [JIT] Tank tick=%lums  min=%lums  avg=%lums  max=%lums",
-                     (unsigned long)tick_ms,
-                     (unsigned long)jMin_ms,
-                     (unsigned long)jAvg_ms,
-                     (unsigned long)jMax_ms);
+    DebugUART_Print(k_panel_sep);
+    DebugUART_Print(line);
 }
@@ -10,6 +10,7 @@
  *   - apply_target(int8_t l, int8_t r)
  *   - DriveTest_Start(void)
  *   - DriveTest_Tick(void)
+ *   - DriveTest_Stop(void)
  *   - DriveTest_IsRunning(void)
  */
 
@@ -68,6 +69,13 @@ void DriveTest_Tick(void)
     }
 }
 
+void DriveTest_Stop(void)
+{
+    if (!s_running) return;
+    s_running = false;
+    Tank_SetTarget(0, 0);
+}
+
 bool DriveTest_IsRunning(void)
 {
     return s_running;
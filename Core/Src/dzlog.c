@@ -0,0 +1,40 @@
+/*
+ * ============================================================================
+ *  MODULE: dzlog — logowanie binarne po ID (część wykonywalna)
+ *  ----------------------------------------------------------------------------
+ *  CO:
+ *    - DzLog_Str(): argument %s jako [n][n B] (przycięty do DZLOG_STR_MAX).
+ *    - DzLog_End(): uzupełnia długość i wysyła rekord jednym zapisem do pasa TX.
+ *    - Bez DZB_LOG_BINARY moduł jest pusty (makra → DebugUART_Printf).
+ * ============================================================================
+ */
+
+#include "dzlog.h"
+
+#ifdef DZB_LOG_BINARY
+
+static uint32_t s_overflows = 0;   // rekordy odrzucone (za dużo argumentów)
+
+void DzLog_Str(DzLog_Rec_t *r, const char *s)
+{
+    if (!s) s = "";
+    uint8_t n = 0u;
+    while (n < DZLOG_STR_MAX && s[n] != '\0') n++;
+    if (r->n + 1u + n > sizeof(r->buf)) { r->overflow = 1u; return; }
+    r->buf[r->n++] = n;
+    for (uint8_t i = 0; i < n; i++) r->buf[r->n++] = (uint8_t)s[i];
+}
+
+void DzLog_End(DzLog_Rec_t *r, DebugUART_Lane_t lane)
+{
+    if (r->overflow) { s_overflows++; return; }
+    r->buf[1] = (uint8_t)(r->n - DZLOG_HDR_LEN);     // długość argumentów
+    (void)DebugUART_WriteRaw(lane, r->buf, r->n);
+}
+
+uint32_t DzLog_Overflows(void)
+{
+    return s_overflows;
+}
+
+#endif /* DZB_LOG_BINARY */
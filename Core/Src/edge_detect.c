@@ -0,0 +1,213 @@
+/*
+ * ============================================================================
+ *  MODULE: edge_detect.c — krawędź dohyo: szybki Clear + histereza + manewr ucieczki
+ *  ----------------------------------------------------------------------------
+ *  MECHANIKA:
+ *    - EdgeDet_Step(): kalibracja czerni → progi (czerń+delta_on / czerń+delta_off).
+ *    - Edge_Poll(): najpierw zegar manewru (precyzyjne przejścia), potem odczyt co poll_ms.
+ *    - Manewr: REVERSE (rev_ms) → TURN (turn_ms, od strony krawędzi) → Stop + release.
+ *      Nowa krawędź w fazie TURN restartuje manewr (REVERSE).
+ *    - Kierunek obrotu: krawędź po prawej → obrót w lewo; po lewej → w prawo;
+ *      obie → w lewo (domyślnie).
+ *    - Tryb szybki tylko w ruchu: TCS przypięte (SetFastClear), gdy napęd ma cel/rampę ≠ 0
+ *      albo trwa manewr; po EDGE_IDLE_RELEASE_MS postoju wracają do auto-gain/ATIME
+ *      (TCS3472_Config) — panel kolorów/klasyfikator dostają pełną rozdzielczość.
+ *      Po ponownym przypięciu pierwsze EDGE_SETTLE integracje są pomijane (mieszane).
+ *    - Kalibracja czerni synchronicznie w Edge_Init() (przed startem jazdy).
+ * ============================================================================
+ */
+
+#include "edge_detect.h"
+#include "tcs3472.h"
+#include "tank_drive.h"
+#include "stm32l4xx_hal.h"
+#include <string.h>
+
+typedef enum {
+    EDGE_IDLE = 0,
+    EDGE_REVERSE,
+    EDGE_TURN
+} EdgePhase_t;
+
+static const ConfigEdge_t *s_cfg = NULL;
+static TCS3472_t          *s_tcsR = NULL, *s_tcsL = NULL;
+static EdgeDet_t           s_detR, s_detL;
+static EdgePhase_t         s_phase = EDGE_IDLE;
+static uint32_t            s_tPhase = 0;      // start bieżącej fazy
+static uint32_t            s_tPoll  = 0;      // ostatni odczyt
+static int8_t              s_turnL = 0, s_turnR = 0; // cele obrotu (ustalone przy detekcji)
+static uint32_t            s_count  = 0;
+static uint8_t             s_fast   = 0;      // 1 = czujniki w trybie szybkim
+static uint32_t            s_tIdle  = 0;      // ostatnia chwila z napędem w ruchu
+static uint32_t            s_tValid = 0;      // od kiedy odczyty Clear są ważne (po przypięciu)
+
+#define EDGE_IDLE_RELEASE_MS  1000u           // postój → czujniki wracają do trybu kolorów
+#define EDGE_SETTLE_INT       2u              // integracje pomijane po przypięciu (1. mieszana)
+
+/* ==== Czysty krok detektora ==== */
+uint8_t EdgeDet_Step(EdgeDet_t *d, uint16_t clear, const ConfigEdge_t *cfg)
+{
+    if (!d || !cfg) return 0u;
+
+    /* kalibracja czerni (robot na macie) */
+    if (d->cal_n < cfg->cal_samples) {
+        d->cal_sum += clear;
+        d->cal_n++;
+        if (d->cal_n == cfg->cal_samples) d->black = (uint16_t)(d->cal_sum / d->cal_n);
+        return 0u;
+    }
+
+    const uint32_t thr_on  = (uint32_t)d->black + cfg->delta_on;
+    const uint32_t thr_off = (uint32_t)d->black + cfg->delta_off;
+    const uint8_t  need    = (cfg->confirm == 0u) ? 1u : cfg->confirm;
+
+    if (!d->on) {
+        if ((uint32_t)clear >= thr_on) {
+            if (++d->cnt >= need) { d->on = 1u; d->cnt = 0u; return 1u; }
+        } else {
+            d->cnt = 0u;
+        }
+    } else if ((uint32_t)clear <= thr_off) {
+        d->on = 0u;                                 // z powrotem na macie
+    }
+    return 0u;
+}
+
+/* ==== Tryb szybki ⇄ tryb kolorów ==== */
+static uint32_t edge_settle_ms(void)
+{
+    return (EDGE_SETTLE_INT * s_cfg->atime_cycles * 24u + 9u) / 10u;   // ATIME = cykle × 2.4 ms
+}
+
+static void edge_pin(uint32_t now)
+{
+    TCS3472_SetFastClear(s_tcsR, s_cfg->atime_cycles, s_cfg->gain);
+    TCS3472_SetFastClear(s_tcsL, s_cfg->atime_cycles, s_cfg->gain);
+    s_fast   = 1u;
+    s_tValid = now + edge_settle_ms();
+    s_detR.on = s_detR.cnt = 0u;                    // stan histerezy sprzed postoju nieaktualny
+    s_detL.on = s_detL.cnt = 0u;
+}
+
+static void edge_release(void)
+{
+    TCS3472_Config(s_tcsR);                         // auto-gain/ATIME od configu TCS
+    TCS3472_Config(s_tcsL);
+    s_fast = 0u;
+}
+
+/* Napęd w ruchu: cel lub rampa ≠ 0, albo trwa manewr ucieczki */
+static uint8_t edge_drive_active(void)
+{
+    int8_t tl, tr, cl, cr;
+    Tank_GetState(&tl, &tr, &cl, &cr);
+    return (uint8_t)(tl != 0 || tr != 0 || cl != 0 || cr != 0 || s_phase != EDGE_IDLE);
+}
+
+/* ==== Manewr ==== */
+/* Hook: start ucieczki (przed przejęciem napędu) — aplikacja zatrzymuje swój plan jazdy */
+__attribute__((weak)) void Edge_OnEscape(uint8_t hitR, uint8_t hitL)
+{
+    (void)hitR; (void)hitL;
+}
+
+static void edge_start_escape(uint8_t hitR, uint8_t hitL, uint32_t now)
+{
+    const int8_t rev  = s_cfg->rev_pct;
+    const int8_t turn = s_cfg->turn_pct;
+
+    if (hitL && !hitR) { s_turnL = +turn; s_turnR = -turn; }   // krawędź po lewej → w prawo
+    else               { s_turnL = -turn; s_turnR = +turn; }   // po prawej / obie → w lewo
+
+    Edge_OnEscape(hitR, hitL);                      // przed override: Tank_SetTarget() hooka nie nadpisze manewru
+    Tank_Override((int8_t)-rev, (int8_t)-rev);     // natychmiast: cofanie (neutral-gate chroni ESC)
+    s_phase  = EDGE_REVERSE;
+    s_tPhase = now;
+    s_count++;
+}
+
+static void edge_run_phase(uint32_t now)
+{
+    const uint32_t dt = (uint32_t)(now - s_tPhase);
+
+    if (s_phase == EDGE_REVERSE && dt >= s_cfg->rev_ms) {
+        Tank_Override(s_turnL, s_turnR);
+        s_phase  = EDGE_TURN;
+        s_tPhase = now;
+    } else if (s_phase == EDGE_TURN && dt >= s_cfg->turn_ms) {
+        Tank_Stop();                                // łagodny powrót rampą do zera
+        Tank_OverrideRelease();                     // robot stoi, dopóki aplikacja nie zada nowego celu
+        s_phase = EDGE_IDLE;
+    }
+}
+
+/* ==== API ==== */
+void Edge_Init(TCS3472_t *right, TCS3472_t *left)
+{
+    s_cfg  = CFG_Edge();
+    s_tcsR = right;
+    s_tcsL = left;
+    memset(&s_detR, 0, sizeof(s_detR));
+    memset(&s_detL, 0, sizeof(s_detL));
+    s_phase = EDGE_IDLE;
+    s_count = 0u;
+    s_fast  = 0u;
+
+    if (!s_cfg->enable) return;
+
+    /* kalibracja czerni teraz — robot stoi na macie, jazda jeszcze nie ruszyła */
+    edge_pin(HAL_GetTick());
+    HAL_Delay(edge_settle_ms());
+    const uint32_t period = (s_cfg->poll_ms != 0u) ? s_cfg->poll_ms : 1u;
+    for (uint16_t k = 0; k < 2u * s_cfg->cal_samples; ++k) {   // limit: czujnik bez odpowiedzi
+        if (s_detR.cal_n >= s_cfg->cal_samples && s_detL.cal_n >= s_cfg->cal_samples) break;
+        HAL_Delay(period);
+        uint16_t c = 0;
+        if (s_detR.cal_n < s_cfg->cal_samples && TCS3472_ReadClear(s_tcsR, &c)) (void)EdgeDet_Step(&s_detR, c, s_cfg);
+        if (s_detL.cal_n < s_cfg->cal_samples && TCS3472_ReadClear(s_tcsL, &c)) (void)EdgeDet_Step(&s_detL, c, s_cfg);
+    }
+    s_tPoll = s_tIdle = HAL_GetTick();              // postój od teraz → zwolnienie po EDGE_IDLE_RELEASE_MS
+}
+
+void Edge_Poll(void)
+{
+    if (!s_cfg || !s_cfg->enable) return;
+
+    const uint32_t now = HAL_GetTick();
+    if (s_phase != EDGE_IDLE) edge_run_phase(now);
+
+    /* tryb szybki tylko w ruchu; na postoju czujniki wracają do kolorów */
+    if (edge_drive_active()) {
+        s_tIdle = now;
+        if (!s_fast) edge_pin(now);
+    } else if (s_fast && (uint32_t)(now - s_tIdle) >= EDGE_IDLE_RELEASE_MS) {
+        edge_release();
+    }
+    if (!s_fast || (int32_t)(now - s_tValid) < 0) return;
+
+    if ((uint32_t)(now - s_tPoll) < s_cfg->poll_ms) return;
+    s_tPoll = now;
+
+    uint16_t cR = 0, cL = 0;
+    uint8_t  hitR = 0u, hitL = 0u;
+    if (TCS3472_ReadClear(s_tcsR, &cR)) hitR = EdgeDet_Step(&s_detR, cR, s_cfg);
+    if (TCS3472_ReadClear(s_tcsL, &cL)) hitL = EdgeDet_Step(&s_detL, cL, s_cfg);
+
+    /* nowa krawędź: start (lub restart z fazy TURN); w REVERSE już uciekamy */
+    if ((hitR || hitL) && s_phase != EDGE_REVERSE) edge_start_escape(hitR, hitL, now);
+}
+
+bool Edge_IsEscaping(void)
+{
+    return (s_phase != EDGE_IDLE);
+}
+
+uint8_t Edge_Flags(void)
+{
+    return (uint8_t)((s_detR.on ? 0x01u : 0u) | (s_detL.on ? 0x02u : 0u));
+}
+
+uint32_t Edge_Count(void)
+{
+    return s_count;
+}
@@ -15,7 +15,7 @@
  */
 
 #include "i2c_scan.h"
-#include "debug_uart.h"   // DebugUART_Printf()
+#include "dzlog.h"        // DZLOG_CRIT()
 #include <stdio.h>
 
 /* --- UCHWYTY I2C Z MAIN.C (generuje CubeMX) ------------------------------ */
@@ -34,14 +34,14 @@ uint8_t I2C_Scan_Bus(const char* busName,
                      uint8_t trials, uint32_t timeout)
 {
     if (!hi2c) {
-        DebugUART_Printf("  [%s] ERROR: NULL I2C handle", busName ? busName : "?");
+        DZLOG_CRIT("  [%s] ERROR: NULL I2C handle", busName ? busName : "?");
         return 0;
     }
 
     if (start7b < 0x08) start7b = 0x08;   // 0x00..0x07 zarezerwowane
     if (end7b   > 0x77) end7b   = 0x77;
 
-    DebugUART_Printf("  [%s] scanning 0x%02X..0x%02X ...", busName, start7b, end7b);
+    DZLOG_CRIT("  [%s] scanning 0x%02X..0x%02X ...", busName, start7b, end7b);
 
     uint8_t found = 0;
     for (uint8_t addr7 = start7b; addr7 <= end7b; addr7++)
@@ -53,22 +53,22 @@ uint8_t I2C_Scan_Bus(const char* busName,
         if (st == HAL_OK)
         {
             found++;
-            DebugUART_Printf("    -> Found device at 0x%02X", addr7);
+            DZLOG_CRIT("    -> Found device at 0x%02X", addr7);
         }
         /* HAL_ERROR / HAL_TIMEOUT / HAL_BUSY – ignorujemy, idziemy dalej */
     }
 
     if (found == 0) {
-        DebugUART_Printf("  [%s] no devices found.", busName);
+        DZLOG_CRIT("  [%s] no devices found.", busName);
     } else {
-        DebugUART_Printf("  [%s] total: %u device(s).", busName, found);
+        DZLOG_CRIT("  [%s] total: %u device(s).", busName, found);
     }
     return found;
 }
 
 void I2C_Scan_All(void)
 {
-    DebugUART_Printf("\r\n[I2C scan] start");
+    DZLOG_CRIT("\r\n[I2C scan] start");
 
     /* 1) Prawa magistrala – I2C1 (Right) */
     (void)I2C_Scan_Bus("Right (I2C1)", &hi2c1,
@@ -80,6 +80,6 @@ void I2C_Scan_All(void)
                        I2C_SCAN_START_ADDR, I2C_SCAN_END_ADDR,
                        I2C_SCAN_TRIALS, I2C_SCAN_TIMEOUT_MS);
 
-    DebugUART_Printf("[I2C scan] done\r\n");
+    DZLOG_CRIT("[I2C scan] done\r\n");
     HAL_Delay(500);
 }
@@ -0,0 +1,429 @@
+/*
+ * ============================================================================
+ *  MODULE: matchlog — trwały log meczów we FLASH (implementacja)
+ *  ----------------------------------------------------------------------------
+ *  CO:
+ *    - Nagłówek strony: dword0 = {magic, seq}, dword1 = {mecz, nr strony, 0xFFFFFFFF};
+ *      dword1 programowany pierwszy → strona ważna dopiero z kompletnym nagłówkiem.
+ *    - Najnowsza strona = max seq; kolejna do zapisu = następna w pierścieniu.
+ *      s_blank = bitmapa stron wymazanych (sprawdzone przy starcie / po erase).
+ *    - Slot: blok blackbox zaokrąglony do 8 B; dwordy 1..n-1, potem dword 0 (len).
+ *    - Zrzut: blok meczu n = strona (n / 7), slot (n % 7); koniec = brak strony
+ *      lub pusty slot.
+ *    - Okno zapisu: start przy pierwszym Poll z napędem w ruchu (kopiowany jest też
+ *      blok otwarty w tej chwili), koniec MATCHLOG_TAIL_MS po powrocie do postoju,
+ *      gdy pisarz nadrobił zamknięte bloki. Poza oknem s_nextSeq nadąża za blackbox
+ *      (nic nie trafia do FLASH). Nowe okno = nowy mecz od świeżej strony.
+ * ============================================================================
+ */
+
+#include "matchlog.h"
+#include "blackbox.h"
+#include "debug_uart.h"
+#include "dzlog.h"           // DZLOG_CRIT() — komunikaty; linie BBX zostają tekstem (bb_decode.py)
+#include "stm32l4xx_hal.h"   // HAL_FLASH_*, HAL_GetTick
+#include <string.h>
+
+#define ML_MAGIC        0x4C4D5A44u   // "DZML"
+#define ML_HDR          16u
+#define ML_SLOT         BLACKBOX_BLOCK_SIZE
+#define ML_DUMP_LINE    112u          // maks. linia zrzutu — + zapas zdarzeń CRIT
+#define ML_DUMP_LINES   4u
+#define ML_RAW_CHUNK    32u
+#define ML_LIST_MAX     16u           // mecze wypisywane przez MatchLog_ListLine
+
+_Static_assert(ML_HDR + MATCHLOG_SLOTS * ML_SLOT <= MATCHLOG_PAGE_SIZE, "sloty na stronie");
+_Static_assert(MATCHLOG_PAGES <= 32u, "bitmapa s_blank (uint32_t)");
+
+typedef struct {
+    uint32_t magic;
+    uint32_t seq;
+    uint16_t match;
+    uint16_t page;                     // nr strony w meczu
+    uint32_t rsv;
+} ML_PageHdr_t;
+
+/* Region z linkera (FLASH_LOG) */
+extern const uint8_t __match_log_start[];
+
+/* Indeks / pisarz */
+static uint32_t s_blank = 0;          // bit p = strona p wymazana
+static uint32_t s_seqNext = 1;        // seq kolejnej strony
+static uint16_t s_match = 1;          // mecz w zapisie
+static uint16_t s_pim = 0;            // nr kolejnej strony meczu
+static uint8_t  s_nextPage = 0;       // kolejna strona pierścienia
+static int8_t   s_wrPage = -1;        // strona w zapisie (−1 = brak)
+static uint8_t  s_wrSlot = 0;
+static uint32_t s_lastErase = 0;
+static uint8_t  s_waiting = 0;
+static uint8_t  s_rec = 0;            // 1 = okno zapisu (mecz / jazda) otwarte
+static uint8_t  s_matchUsed = 0;      // s_match ma już strony we FLASH
+static uint32_t s_lastActive = 0;     // ostatni Poll z napędem w ruchu
+
+/* Blok w zapisie (kopia z SRAM2) */
+static uint8_t  s_buf[ML_SLOT];
+static uint8_t  s_busy = 0;
+static uint8_t  s_ndw = 0;            // double-wordy bloku
+static uint8_t  s_k = 0;              // zaprogramowane
+static uint32_t s_nextSeq = 1;        // kolejny blok blackbox do skopiowania
+static uint32_t s_blocks = 0;
+static uint32_t s_lost = 0;
+
+/* Zrzut */
+static uint8_t  s_dumping = 0;
+static uint16_t s_dMatch = 0;
+static uint16_t s_dBlk = 0;
+static uint16_t s_dOff = 0;
+
+/* ==== Porty FLASH (weak — host podmienia na symulację) ==== */
+
+__attribute__((weak)) const uint8_t* MatchLog_PortBase(void)
+{
+    return __match_log_start;
+}
+
+__attribute__((weak)) uint8_t MatchLog_PortErase(uint8_t page)
+{
+    FLASH_EraseInitTypeDef er = {0};
+    uint32_t bad = 0u;
+    er.TypeErase = FLASH_TYPEERASE_PAGES;
+    er.Banks     = FLASH_BANK_1;
+    er.Page      = (uint32_t)((uintptr_t)__match_log_start - FLASH_BASE) / FLASH_PAGE_SIZE + page;
+    er.NbPages   = 1u;
+    HAL_FLASH_Unlock();
+    __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_ALL_ERRORS);
+    const HAL_StatusTypeDef st = HAL_FLASHEx_Erase(&er, &bad);
+    HAL_FLASH_Lock();
+    return (uint8_t)(st == HAL_OK);
+}
+
+__attribute__((weak)) uint8_t MatchLog_PortProgram(uint32_t offset, uint64_t dword)
+{
+    HAL_FLASH_Unlock();
+    __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_ALL_ERRORS);
+    const HAL_StatusTypeDef st = HAL_FLASH_Program(FLASH_TYPEPROGRAM_DOUBLEWORD,
+                                                   (uint32_t)(uintptr_t)__match_log_start + offset, dword);
+    HAL_FLASH_Lock();
+    return (uint8_t)(st == HAL_OK);
+}
+
+/* ==== Pomocnicze ==== */
+
+static inline const uint8_t* page_ptr(uint8_t p)
+{
+    return MatchLog_PortBase() + (uint32_t)p * MATCHLOG_PAGE_SIZE;
+}
+
+static uint8_t page_hdr(uint8_t p, ML_PageHdr_t *h)
+{
+    memcpy(h, page_ptr(p), sizeof(*h));
+    return (uint8_t)(h->magic == ML_MAGIC && h->seq != 0xFFFFFFFFu);
+}
+
+static uint16_t slot_len(uint8_t p, uint8_t slot)
+{
+    const uint8_t *s = page_ptr(p) + ML_HDR + (uint32_t)slot * ML_SLOT;
+    const uint16_t n = (uint16_t)(s[0] | (s[1] << 8));
+    return (n >= 4u && n <= ML_SLOT) ? n : 0u;
+}
+
+static uint8_t page_is_blank(uint8_t p)
+{
+    const uint8_t *pg = page_ptr(p);
+    for (uint32_t i = 0; i < MATCHLOG_PAGE_SIZE; i += 4u) {
+        uint32_t w;
+        memcpy(&w, pg + i, sizeof(w));
+        if (w != 0xFFFFFFFFu) return 0u;
+    }
+    return 1u;
+}
+
+static uint8_t erase_page(uint8_t p)
+{
+    s_lastErase = HAL_GetTick();
+    if (!MatchLog_PortErase(p)) return 0u;
+    s_blank |= 1u << p;
+    return 1u;
+}
+
+static inline uint8_t ring_next(uint8_t p) { return (uint8_t)((p + 1u) % MATCHLOG_PAGES); }
+
+/* Strona meczu o numerze pim; −1 = brak */
+static int8_t find_page(uint16_t match, uint16_t pim)
+{
+    for (uint8_t p = 0; p < MATCHLOG_PAGES; p++) {
+        ML_PageHdr_t h;
+        if (page_hdr(p, &h) && h.match == match && h.page == pim) return (int8_t)p;
+    }
+    return -1;
+}
+
+static uint8_t crit_room(void)
+{
+    return DebugUART_CritRoom(ML_DUMP_LINE);
+}
+
+/* Nowa strona do zapisu: wymazana → nagłówek; inaczej erase (gdy wolno) albo czekaj */
+static uint8_t open_page(uint8_t allow_erase)
+{
+    const uint8_t p = s_nextPage;
+    if (!(s_blank & (1u << p))) {
+        if (!allow_erase || (uint32_t)(HAL_GetTick() - s_lastErase) < MATCHLOG_ERASE_GAP_MS) return 0u;
+        (void)erase_page(p);
+        return 0u;                                   // erase zużył ten slot czasu
+    }
+    const uint64_t dw0 = (uint64_t)ML_MAGIC | ((uint64_t)s_seqNext << 32);
+    const uint64_t dw1 = (uint64_t)s_match | ((uint64_t)s_pim << 16) | (0xFFFFFFFFull << 32);
+    s_blank &= ~(1u << p);
+    s_nextPage = ring_next(p);
+    if (!MatchLog_PortProgram((uint32_t)p * MATCHLOG_PAGE_SIZE + 8u, dw1) ||
+        !MatchLog_PortProgram((uint32_t)p * MATCHLOG_PAGE_SIZE, dw0)) {
+        return 0u;                                   // strona zepsuta — następna przy kolejnym Poll
+    }
+    s_seqNext++;
+    s_pim++;
+    s_matchUsed = 1u;
+    s_wrPage = (int8_t)p;
+    s_wrSlot = 0u;
+    return 1u;
+}
+
+/* Pobierz kolejny zamknięty blok z SRAM2 do s_buf */
+static void fetch_block(void)
+{
+    const uint32_t cur = BlackBox_BlockSeq();
+    while (s_nextSeq < cur) {
+        const uint8_t *b = BlackBox_PeekBlock(s_nextSeq);
+        if (!b) { s_lost++; s_nextSeq++; continue; }      // nadpisany przed zapisem
+        const uint16_t n = (uint16_t)(b[0] | (b[1] << 8));
+        if (n < 4u || n > ML_SLOT) { s_nextSeq++; continue; }
+        memset(s_buf, 0xFF, sizeof(s_buf));
+        memcpy(s_buf, b, n);
+        s_ndw  = (uint8_t)((n + 7u) / 8u);
+        s_k    = 0u;
+        s_busy = 1u;
+        return;
+    }
+}
+
+static void write_step(uint8_t allow_erase)
+{
+    if (!s_busy) fetch_block();
+    if (!s_busy) return;
+
+    if (s_wrPage < 0 || s_wrSlot >= MATCHLOG_SLOTS) {
+        s_waiting = (uint8_t)!open_page(allow_erase);
+        if (s_waiting) return;
+    }
+
+    const uint32_t base = (uint32_t)s_wrPage * MATCHLOG_PAGE_SIZE + ML_HDR + (uint32_t)s_wrSlot * ML_SLOT;
+    for (uint8_t n = 0; n < MATCHLOG_DW_PER_POLL && s_k < s_ndw; n++) {
+        const uint8_t idx = (uint8_t)((s_k + 1u < s_ndw) ? s_k + 1u : 0u);   // dword 0 (len) na końcu
+        uint64_t dw;
+        memcpy(&dw, s_buf + (uint32_t)idx * 8u, sizeof(dw));
+        if (!MatchLog_PortProgram(base + (uint32_t)idx * 8u, dw)) {
+            s_wrSlot = MATCHLOG_SLOTS;                 // zamknij stronę, blok od nowa na kolejnej
+            s_k = 0u;
+            return;
+        }
+        s_k++;
+    }
+    if (s_k >= s_ndw) {
+        s_wrSlot++;
+        s_busy = 0u;
+        s_nextSeq++;
+        s_blocks++;
+    }
+}
+
+/* Wymazywanie z wyprzedzeniem (jedno na wywołanie, gdy napęd stoi) */
+static void erase_ahead(uint8_t allow_erase)
+{
+    if (!allow_erase || (uint32_t)(HAL_GetTick() - s_lastErase) < MATCHLOG_ERASE_GAP_MS) return;
+    uint8_t p = s_nextPage;
+    for (uint8_t k = 0; k < MATCHLOG_AHEAD; k++, p = ring_next(p)) {
+        if ((int8_t)p == s_wrPage) return;
+        if (!(s_blank & (1u << p))) { (void)erase_page(p); return; }
+    }
+}
+
+static void dump_step(void)
+{
+    static const char k_hex[] = "0123456789ABCDEF";
+    for (uint8_t n = 0; s_dumping && n < ML_DUMP_LINES && crit_room(); n++) {
+        const int8_t  p    = find_page(s_dMatch, (uint16_t)(s_dBlk / MATCHLOG_SLOTS));
+        const uint8_t slot = (uint8_t)(s_dBlk % MATCHLOG_SLOTS);
+        const uint16_t len = (p >= 0) ? slot_len((uint8_t)p, slot) : 0u;
+        if (len == 0u) {
+            DZLOG_CRIT("ML: koniec (%u blokow)", (unsigned)s_dBlk);
+            s_dumping = 0u;
+            return;
+        }
+        const uint8_t *b = page_ptr((uint8_t)p) + ML_HDR + (uint32_t)slot * ML_SLOT;
+        char line[2u * ML_RAW_CHUNK + 1u];
+        uint16_t k = 0u;
+        for (uint16_t i = s_dOff; i < len && k < 2u * ML_RAW_CHUNK; i++) {
+            line[k++] = k_hex[b[i] >> 4];
+            line[k++] = k_hex[b[i] & 0x0Fu];
+        }
+        line[k] = '\0';
+        DebugUART_CritPrintf("BBX %u %u %s", (unsigned)s_dBlk, (unsigned)s_dOff, line);
+        s_dOff = (uint16_t)(s_dOff + k / 2u);
+        if (s_dOff >= len) { s_dBlk++; s_dOff = 0u; }
+    }
+}
+
+/* Okno zapisu: otwarcie przy ruchu napędu, zamknięcie po ogonie i nadrobieniu bloków */
+static void rec_update(uint8_t idle)
+{
+    const uint32_t now = HAL_GetTick();
+    if (!idle) {
+        if (!s_rec) {
+            if (s_matchUsed) {                       // kolejne okno = nowy mecz, świeża strona
+                s_match++;
+                s_matchUsed = 0u;
+                s_pim = 0u;
+                s_wrPage = -1;
+            }
+            s_rec = 1u;
+        }
+        s_lastActive = now;
+        return;
+    }
+    if (s_rec && !s_busy && s_nextSeq >= BlackBox_BlockSeq() &&
+        (uint32_t)(now - s_lastActive) >= MATCHLOG_TAIL_MS) {
+        s_rec = 0u;
+    }
+}
+
+/* ==== API ==== */
+
+void MatchLog_Init(void)
+{
+    uint32_t maxSeq = 0u;
+    uint16_t maxMatch = 0u;
+    int8_t   last = -1;
+
+    s_blank = 0u;
+    for (uint8_t p = 0; p < MATCHLOG_PAGES; p++) {
+        ML_PageHdr_t h;
+        if (page_hdr(p, &h)) {
+            if (h.seq >= maxSeq) { maxSeq = h.seq; last = (int8_t)p; }
+            if (h.match > maxMatch) maxMatch = h.match;
+        } else if (page_is_blank(p)) {
+            s_blank |= 1u << p;
+        }
+    }
+    s_seqNext  = maxSeq + 1u;
+    s_match    = (uint16_t)(maxMatch + 1u);
+    s_pim      = 0u;
+    s_nextPage = (last >= 0) ? ring_next((uint8_t)last) : 0u;
+    s_wrPage   = -1;
+    s_busy     = 0u;
+    s_nextSeq  = BlackBox_BlockSeq() + 1u;   // pierwszy blok tej sesji (BlackBox_Init wymusza nowy)
+    s_blocks   = 0u;
+    s_lost     = 0u;
+    s_waiting  = 0u;
+    s_dumping  = 0u;
+    s_rec      = 0u;
+    s_matchUsed = 0u;
+
+    /* start: napęd w neutralu → przygotuj MATCHLOG_AHEAD pustych stron (blokująco) */
+    uint8_t p = s_nextPage;
+    for (uint8_t k = 0; k < MATCHLOG_AHEAD; k++, p = ring_next(p)) {
+        if (!(s_blank & (1u << p))) (void)erase_page(p);
+    }
+}
+
+void MatchLog_Poll(uint8_t idle)
+{
+    rec_update(idle);
+    if (s_dumping) dump_step();
+    if (s_rec) write_step(idle);
+    else       s_nextSeq = BlackBox_BlockSeq() ? BlackBox_BlockSeq() : 1u;  // postój: bez zapisu (0 = brak bloku)
+    erase_ahead(idle);
+}
+
+/* Indeks meczów ze skanu nagłówków stron (bez stanu — shell pyta linia po linii) */
+static uint8_t ml_index(uint16_t *id, uint8_t *pages, uint16_t *blocks)
+{
+    uint8_t n = 0u;
+    for (uint8_t p = 0; p < MATCHLOG_PAGES; p++) {
+        ML_PageHdr_t h;
+        if (!page_hdr(p, &h)) continue;
+        uint8_t i = 0u;
+        while (i < n && id[i] != h.match) i++;
+        if (i == n) {
+            if (n >= ML_LIST_MAX) continue;
+            id[n] = h.match; pages[n] = 0u; blocks[n] = 0u; n++;
+        }
+        pages[i]++;
+        for (uint8_t s = 0; s < MATCHLOG_SLOTS; s++) if (slot_len(p, s)) blocks[i]++;
+    }
+    return n;
+}
+
+uint8_t MatchLog_ListLine(uint8_t line)
+{
+    uint16_t id[ML_LIST_MAX];
+    uint8_t  pages[ML_LIST_MAX];
+    uint16_t blocks[ML_LIST_MAX];
+    const uint8_t n = ml_index(id, pages, blocks);
+
+    if (line == 0u) {
+        DZLOG_CRIT("ml: %u mecz(e), w zapisie %u", (unsigned)n, (unsigned)s_match);
+        return 1u;
+    }
+    const uint8_t i = (uint8_t)(line - 1u);
+    if (i >= n) return 0u;
+    DZLOG_CRIT("  mecz %u: %u str., %u blokow%s", (unsigned)id[i], (unsigned)pages[i],
+               (unsigned)blocks[i], (id[i] == s_match) ? " (biezacy)" : "");
+    return 1u;
+}
+
+uint8_t MatchLog_DumpStart(uint16_t match, uint16_t from_block)
+{
+    if (find_page(match, (uint16_t)(from_block / MATCHLOG_SLOTS)) < 0) return 0u;
+    s_dMatch  = match;
+    s_dBlk    = from_block;
+    s_dOff    = 0u;
+    s_dumping = 1u;
+    DZLOG_CRIT("ML: mecz %u od bloku %u", (unsigned)match, (unsigned)from_block);
+    return 1u;
+}
+
+void MatchLog_Erase(void)
+{
+    for (uint8_t p = 0; p < MATCHLOG_PAGES; p++) (void)erase_page(p);
+    s_wrPage   = -1;
+    s_nextPage = 0u;
+    s_pim      = 0u;
+    s_seqNext  = 1u;
+    s_dumping  = 0u;
+    s_matchUsed = 0u;
+    s_k        = 0u;                     // blok w toku — od nowa na nowej stronie
+}
+
+void MatchLog_GetInfo(MatchLog_Info_t *out)
+{
+    if (!out) return;
+    uint8_t blank = 0u;
+    for (uint8_t p = 0; p < MATCHLOG_PAGES; p++) if (s_blank & (1u << p)) blank++;
+    uint16_t ids[ML_LIST_MAX];
+    uint8_t  n = 0u;
+    for (uint8_t p = 0; p < MATCHLOG_PAGES; p++) {
+        ML_PageHdr_t h;
+        if (!page_hdr(p, &h)) continue;
+        uint8_t i = 0u;
+        while (i < n && ids[i] != h.match) i++;
+        if (i == n && n < ML_LIST_MAX) ids[n++] = h.match;
+    }
+    out->match   = s_match;
+    out->matches = n;
+    out->blank   = blank;
+    out->blocks  = s_blocks;
+    out->lost    = s_lost;
+    out->waiting = s_waiting;
+    out->recording = s_rec;
+    out->dumping = s_dumping;
+}
@@ -172,3 +172,20 @@ void ESC_SetNeutralAll(void)
 uint16_t ESC_GetMinUs(void) { return ESC_MIN_US; }      /* 1000 µs — „pełny wstecz”    */
 uint16_t ESC_GetNeuUs(void) { return ESC_NEU_US; }      /* 1500 µs — neutral           */
 uint16_t ESC_GetMaxUs(void) { return ESC_MAX_US; }      /* 2000 µs — „pełny naprzód”   */
+
+/* ESC_FailSafe:
+ *  - neutral wprost do CCR1/CCR4 TIM1 (1 tick = 1 µs) — bez s_tim1 i HAL. */
+void ESC_FailSafe(void)
+{
+    TIM1->CCR1 = ESC_NEU_US;                            /* Right → neutral             */
+    TIM1->CCR4 = ESC_NEU_US;                            /* Left  → neutral             */
+}
+
+/* ESC_GetPulseUs:
+ *  - odczyt bieżącego CCR kanału (to, co faktycznie idzie do ESC). */
+uint16_t ESC_GetPulseUs(ESC_Channel_t ch)
+{
+    if (!s_tim1) return ESC_NEU_US;                     /* brak TIM1 → neutral         */
+    return (uint16_t)((ch == ESC_CH1) ? __HAL_TIM_GET_COMPARE(s_tim1, TIM_CHANNEL_1)
+                                      : __HAL_TIM_GET_COMPARE(s_tim1, TIM_CHANNEL_4));
+}
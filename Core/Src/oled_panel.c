@@ -7,14 +7,16 @@
  *   Zachowaj spójność z resztą modułów oraz konwencje projektu.
  *
  * Funkcje w pliku (skrót):
- *   - OLED_Panel_ShowSensors(const TF_LunaData_t *R,
-                            const TF_LunaData_t *L,
-                            const TCS3472_Data_t *CR,
-                            const TCS3472_Data_t *CL)
+ *   - OLED_Panel_Render(const TF_LunaData_t *R,
+                       const TF_LunaData_t *L,
+                       const TCS3472_Data_t *CR,
+                       const TCS3472_Data_t *CL)
+ *   - OLED_Panel_ShowSensors(...)  — Render + SSD1306_UpdateScreen()
  */
 
 #include "oled_panel.h"
 #include "ssd1306.h"
+#include "fmt.h"      // Fmt_Fixed — temperatura bez %f
 #include <stdio.h>   // snprintf
 #include <string.h>
 
@@ -27,10 +29,10 @@
  * 5: RGB Right       /64
  * 6: RGB Left        /64
  */
-void OLED_Panel_ShowSensors(const TF_LunaData_t *R,
-                            const TF_LunaData_t *L,
-                            const TCS3472_Data_t *CR,
-                            const TCS3472_Data_t *CL)
+void OLED_Panel_Render(const TF_LunaData_t *R,
+                       const TF_LunaData_t *L,
+                       const TCS3472_Data_t *CR,
+                       const TCS3472_Data_t *CL)
 {
     if (!R || !L || !CR || !CL) return;
 
@@ -51,9 +53,13 @@ void OLED_Panel_ShowSensors(const TF_LunaData_t *R,
              (unsigned)R->strength_filt, (unsigned)L->strength_filt);
     SSD1306_DrawTextAt(2, 0, line);
 
-    // 3: temperatura [°C] – sterownik TF-Luna zwraca już float °C
-    snprintf(line, sizeof(line), "T  R:%4.1fC L:%4.1fC",
-             R->temperature, L->temperature);
+    // 3: temperatura [°C] – float °C z drivera, tekst bez %f (Fmt_Fixed)
+    {
+        char tR[8], tL[8];
+        snprintf(line, sizeof(line), "T  R:%sC L:%sC",
+                 Fmt_Fixed(tR, sizeof(tR), R->temperature, 1u, 4u),
+                 Fmt_Fixed(tL, sizeof(tL), L->temperature, 1u, 4u));
+    }
     SSD1306_DrawTextAt(3, 0, line);
 
     // 4: kanał Clear (jasność) – skrót /64, żeby się mieściło
@@ -74,6 +80,14 @@ void OLED_Panel_ShowSensors(const TF_LunaData_t *R,
              (unsigned)(CL->green/64U),
              (unsigned)(CL->blue/64U));
     SSD1306_DrawTextAt(6, 0, line);
+}
 
+void OLED_Panel_ShowSensors(const TF_LunaData_t *R,
+                            const TF_LunaData_t *L,
+                            const TCS3472_Data_t *CR,
+                            const TCS3472_Data_t *CL)
+{
+    if (!R || !L || !CR || !CL) return;
+    OLED_Panel_Render(R, L, CR, CL);
     SSD1306_UpdateScreen();
 }
@@ -0,0 +1,77 @@
+/*
+ * ============================================================================
+ *  MODULE: ramfunc — statystyka cykli ścieżek w SRAM2 (implementacja)
+ *  ----------------------------------------------------------------------------
+ *  CO:
+ *    - g_ramfnStat[]: pomiary dopisywane w miejscu wywołania (RamFn_Add).
+ *    - RamFn_ReportLine(): adres funkcji mówi, skąd naprawdę się wykonuje (0x1000xxxx =
+ *      SRAM2, 0x080xxxxx = FLASH), plus rozmiar sekcji .ramfunc z linkera.
+ *
+ *  POMIAR A/B:
+ *    - Zbudować z DZB_RAMFUNC=1 i =0, ten sam scenariusz (np. drive + panel UART),
+ *      "ramfn reset", odczekać kilka sekund, "ramfn". Liczą się min/avg — max zawiera
+ *      przerwania (Tank_Update) i zależy od trafień ICache przy kodzie z FLASH.
+ * ============================================================================
+ */
+
+#include "ramfunc.h"
+#include "debug_uart.h"
+#include "dzlog.h"           // DZLOG_CRIT()
+#include "tank_drive.h"      // Tank_Update
+#include "tcs3472.h"         // TCS3472_Process
+#include "prof.h"            // Prof_CyclesToUs
+#include "stm32l4xx_hal.h"   // HAL_UART_TxCpltCallback, __disable_irq
+#include <string.h>
+
+RamFn_Stat_t g_ramfnStat[RAMFN_COUNT];
+
+/* Linker: granice sekcji .ramfunc w SRAM2 */
+extern uint8_t _sramfunc[], _eramfunc[];
+
+static const char *const k_names[RAMFN_COUNT] = {
+    [RAMFN_TANK]     = "Tank_Update",
+    [RAMFN_TCS]      = "TCS3472_Process",
+    [RAMFN_UART_TXC] = "UART_TxCplt",
+};
+
+static uintptr_t ramfn_addr(RamFn_Id_t id)
+{
+    switch (id) {
+    case RAMFN_TANK:     return (uintptr_t)&Tank_Update;
+    case RAMFN_TCS:      return (uintptr_t)&TCS3472_Process;
+    case RAMFN_UART_TXC: return (uintptr_t)&HAL_UART_TxCpltCallback;
+    default:             return 0u;
+    }
+}
+
+void RamFn_Reset(void)
+{
+    __disable_irq();                  // TxCplt dopisuje z ISR
+    memset(g_ramfnStat, 0, sizeof(g_ramfnStat));
+    __enable_irq();
+}
+
+uint8_t RamFn_ReportLine(uint8_t line)
+{
+    if (line == 0u) {
+        DZLOG_CRIT("ramfn: .ramfunc %lu B @%08lX (DZB_RAMFUNC=%d)",
+                   (unsigned long)(_eramfunc - _sramfunc), (unsigned long)(uintptr_t)_sramfunc,
+                   (int)DZB_RAMFUNC);
+        return 1u;
+    }
+    const uint32_t i = (uint32_t)line - 1u;
+    if (i >= (uint32_t)RAMFN_COUNT) return 0u;
+
+    __disable_irq();                  // spójna kopia (sum 64-bit)
+    const RamFn_Stat_t s = g_ramfnStat[i];
+    __enable_irq();
+
+    const uintptr_t a   = ramfn_addr((RamFn_Id_t)i) & ~(uintptr_t)1u;   // bez bitu Thumb
+    const uint32_t  avg = s.n ? (uint32_t)(s.sum / s.n) : 0u;
+    /* 2 napisy + 6 liczb > DZLOG_PAYLOAD_MAX → wiersz tabeli zostaje tekstem */
+    DebugUART_CritPrintf("  %-16s @%08lX %-5s n=%lu cyc min/avg/max %lu/%lu/%lu (max %lu us)",
+                         k_names[i], (unsigned long)a, (a >= 0x10000000u && a < 0x10004000u) ? "SRAM2" : "FLASH",
+                         (unsigned long)s.n, (unsigned long)s.min, (unsigned long)avg,
+                         (unsigned long)s.max, (unsigned long)Prof_CyclesToUs(s.max));
+    return 1u;
+}
@@ -0,0 +1,225 @@
+/*
+ * ============================================================================
+ *  MODULE: sensor.c — rejestr instancji czujników + adaptery driverów
+ *  ----------------------------------------------------------------------------
+ *  MECHANIKA:
+ *    - Statyczne pule: TF_Luna_t[SENSOR_LUNA_MAX], TCS3472_t[SENSOR_TCS_MAX]
+ *      + ich snapshoty; s_reg[] wskazuje na nie (kolejność: Luny, potem TCS).
+ *    - Adaptery (luna_*, tcs_*) tłumaczą SensorOps_t na API driverów.
+ *    - complete() pisze do bufora roboczego, potem SeqLock_Store() do snapshotu;
+ *      gettery kopiują przez SeqLock_Load().
+ *    - Round-robin per (bus, typ): s_next[bus][kind] = indeks w s_reg[].
+ *    - Provisioning adresu TF-Luna (CFG_Luna()->provision) przy starcie — tylko gdy
+ *      jednoznaczny: na magistrali dokładnie jeden adres z tabeli milczy, a 0x10 nie jest
+ *      w tabeli (inaczej przeadresowalibyśmy działający lidar albo kilka fabrycznych naraz).
+ * ============================================================================
+ */
+
+#include "sensor.h"
+#include "i2c.h"           // hi2c1, hi2c3
+#include "dzlog.h"         // log provisioningu (DZLOG_CRIT)
+#include <string.h>
+
+/* ==== Pule instancji i snapshotów ==== */
+static TF_Luna_t      s_luna[SENSOR_LUNA_MAX];
+static TF_LunaData_t  s_lunaOut[SENSOR_LUNA_MAX];
+static TCS3472_t      s_tcs[SENSOR_TCS_MAX];
+static TCS3472_Data_t s_tcsOut[SENSOR_TCS_MAX];
+static SeqLock_t      s_lunaLock[SENSOR_LUNA_MAX];
+static SeqLock_t      s_tcsLock[SENSOR_TCS_MAX];
+
+/* Bufor roboczy complete() — jeden pisarz naraz (pętla główna / jeden callback) */
+static union {
+    TF_LunaData_t  luna;
+    TCS3472_Data_t tcs;
+} s_scratch;
+
+#define SENSOR_LOAD_TRIES  4u     // limit powtórzeń czytelnika (nie kręcimy się w nieskończoność)
+
+static Sensor_t       s_reg[SENSOR_MAX];
+static uint8_t        s_regCount  = 0;
+static uint8_t        s_lunaCount = 0;
+static uint8_t        s_tcsCount  = 0;
+static uint8_t        s_next[2][SENSOR_KIND_COUNT];   // round-robin (bus × typ)
+
+static const TF_LunaData_t  k_lunaEmpty = { .age_ms = TFLUNA_AGE_UNKNOWN };
+static const TCS3472_Data_t k_tcsEmpty  = {0};
+
+/* ==== Adaptery: TF-Luna ==== */
+static void luna_start(void *dev)
+{
+    TF_Luna_Trigger((TF_Luna_t*)dev);
+}
+static void luna_complete(void *dev, void *out)
+{
+    *(TF_LunaData_t*)out = TF_Luna_Read((TF_Luna_t*)dev);
+}
+static const SensorOps_t k_lunaOps     = { NULL,       NULL, luna_complete, NULL };   // ciągły
+static const SensorOps_t k_lunaTrigOps = { luna_start, NULL, luna_complete, NULL };   // trigger
+
+/* ==== Adaptery: TCS3472 ==== */
+static uint8_t tcs_poll(void *dev)
+{
+    return TCS3472_Poll((TCS3472_t*)dev);
+}
+static void tcs_complete(void *dev, void *out)
+{
+    *(TCS3472_Data_t*)out = TCS3472_Complete((TCS3472_t*)dev);
+}
+static void tcs_stale(void *out)
+{
+    ((TCS3472_Data_t*)out)->fresh = 0u;                 // brak nowej integracji
+}
+static const SensorOps_t k_tcsOps = { NULL, tcs_poll, tcs_complete, tcs_stale };
+
+/* ==== Pomocnicze ==== */
+static I2C_HandleTypeDef *sensor_bus(CFG_I2CBus_t bus)
+{
+    return (bus == CFG_BUS_I2C3) ? &hi2c3 : &hi2c1;
+}
+
+static void sensor_register(SensorKind_t kind, CFG_I2CBus_t bus, uint8_t idx, const char *name,
+                            const SensorOps_t *ops, void *dev, void *out, uint16_t out_size, SeqLock_t *lock)
+{
+    if (s_regCount >= SENSOR_MAX) return;
+    Sensor_t *s = &s_reg[s_regCount++];
+    s->kind = kind; s->bus = bus; s->idx = idx; s->name = name;
+    s->ops  = ops;  s->dev = dev; s->out = out;
+    s->out_size = out_size; s->lock = lock;
+}
+
+static void sensor_service(const Sensor_t *s)
+{
+    if (s->ops->poll && !s->ops->poll(s->dev)) {
+        if (s->ops->stale) {                            // krótki zapis pod seqlockiem
+            SeqLock_WriteBegin(s->lock);
+            s->ops->stale(s->out);
+            SeqLock_WriteEnd(s->lock);
+        }
+        return;
+    }
+    s->ops->complete(s->dev, &s_scratch);               // I²C poza sekcją snapshotu
+    SeqLock_Store(s->lock, s->out, &s_scratch, s->out_size);
+}
+
+/* Provisioning TF-Luna na jednej magistrali: fabryczne 0x10 → jedyny milczący adres z tabeli.
+ * Kilka fabrycznych układów pod 0x10 odpowiada jednym ACK (nie do odróżnienia), więc
+ * wymagamy jednoznaczności po stronie tabeli i przeadresowujemy najwyżej jeden na start. */
+static void sensor_luna_provision(CFG_I2CBus_t busId, const ConfigLunaDev_t *ld, uint8_t n)
+{
+    I2C_HandleTypeDef *bus = sensor_bus(busId);
+    uint8_t missing = 0u, target = 0xFFu;
+    for (uint8_t i = 0; i < n; ++i) {
+        if (ld[i].bus != busId) continue;
+        if (ld[i].addr7 == TFLUNA_ADDR_DEFAULT) return;        // 0x10 to zwykły wpis tabeli — nie ruszamy
+        if (!TF_Luna_IsPresent(bus, ld[i].addr7)) { missing++; target = i; }
+    }
+    if (missing == 0u || !TF_Luna_IsPresent(bus, TFLUNA_ADDR_DEFAULT)) return;
+    if (missing > 1u) {
+        DZLOG_CRIT("TF-Luna: %u adresy milcza na I2C%u - provisioning pominiety (podlaczaj po jednym)",
+                   (unsigned)missing, (busId == CFG_BUS_I2C3) ? 3u : 1u);
+        return;
+    }
+    const uint8_t ok = TF_Luna_ProvisionAddr(bus, TFLUNA_ADDR_DEFAULT, ld[target].addr7);
+    DZLOG_CRIT("TF-Luna %s: 0x10 -> 0x%02X %s", ld[target].name,
+                     (unsigned)ld[target].addr7, ok ? "OK" : "FAIL");
+}
+
+/* ==== API ==== */
+void Sensors_Init(void)
+{
+    const ConfigLuna_t *LC = CFG_Luna();
+    s_regCount = s_lunaCount = s_tcsCount = 0u;
+    memset(s_next, 0, sizeof(s_next));
+
+    /* TF-Luna: tabela z configu (+ opcjonalny provisioning adresu) */
+    uint8_t n = 0;
+    const ConfigLunaDev_t *ld = CFG_LunaDevs(&n);
+    if (n > SENSOR_LUNA_MAX) n = SENSOR_LUNA_MAX;
+    if (LC->provision) {                                       // przed Init: adresy już docelowe
+        sensor_luna_provision(CFG_BUS_I2C1, ld, n);
+        sensor_luna_provision(CFG_BUS_I2C3, ld, n);
+    }
+    for (uint8_t i = 0; i < n; ++i) {
+        TF_Luna_Init(&s_luna[i], sensor_bus(ld[i].bus), ld[i].addr7, ld[i].dist_offset_mm, ld[i].name);
+        s_lunaOut[i]  = k_lunaEmpty;
+        s_lunaLock[i].seq = 0u;
+        sensor_register(SENSOR_LUNA, ld[i].bus, i, ld[i].name,
+                        LC->trigger_mode ? &k_lunaTrigOps : &k_lunaOps, &s_luna[i], &s_lunaOut[i],
+                        (uint16_t)sizeof(TF_LunaData_t), &s_lunaLock[i]);
+    }
+    s_lunaCount = n;
+
+    /* TCS3472: tabela z configu */
+    const ConfigTcsDev_t *td = CFG_TcsDevs(&n);
+    if (n > SENSOR_TCS_MAX) n = SENSOR_TCS_MAX;
+    for (uint8_t i = 0; i < n; ++i) {
+        TCS3472_Init(&s_tcs[i], sensor_bus(td[i].bus), td[i].name);
+        s_tcsOut[i]  = k_tcsEmpty;
+        s_tcsLock[i].seq = 0u;
+        sensor_register(SENSOR_TCS, td[i].bus, i, td[i].name, &k_tcsOps, &s_tcs[i], &s_tcsOut[i],
+                        (uint16_t)sizeof(TCS3472_Data_t), &s_tcsLock[i]);
+    }
+    s_tcsCount = n;
+}
+
+uint8_t Sensors_Count(void)                 { return s_regCount; }
+const Sensor_t* Sensors_Get(uint8_t i)      { return (i < s_regCount) ? &s_reg[i] : NULL; }
+
+void Sensors_StartKind(SensorKind_t kind)
+{
+    for (uint8_t i = 0; i < s_regCount; ++i) {
+        if (s_reg[i].kind == kind && s_reg[i].ops->start) s_reg[i].ops->start(s_reg[i].dev);
+    }
+}
+
+void Sensors_ServiceKind(SensorKind_t kind)
+{
+    for (uint8_t i = 0; i < s_regCount; ++i) {
+        if (s_reg[i].kind == kind) sensor_service(&s_reg[i]);
+    }
+}
+
+const Sensor_t* Sensors_ServiceNext(CFG_I2CBus_t bus, SensorKind_t kind)
+{
+    if (s_regCount == 0u || (unsigned)bus > 1u || kind >= SENSOR_KIND_COUNT) return NULL;
+
+    uint8_t *next = &s_next[bus][kind];
+    for (uint8_t k = 0; k < s_regCount; ++k) {
+        const uint8_t i = (uint8_t)((*next + k) % s_regCount);
+        const Sensor_t *s = &s_reg[i];
+        if (s->bus == bus && s->kind == kind) {
+            sensor_service(s);
+            *next = (uint8_t)((i + 1u) % s_regCount);
+            return s;
+        }
+    }
+    return NULL;
+}
+
+uint8_t Sensors_LunaCount(void) { return s_lunaCount; }
+uint8_t Sensors_TcsCount(void)  { return s_tcsCount;  }
+
+/* Gettery: spójna kopia; przy nieudanym odczycie (pisarz wciąż aktywny) — pusty wynik */
+TF_LunaData_t Sensors_Luna(uint8_t idx)
+{
+    TF_LunaData_t d = k_lunaEmpty;
+    if (idx < s_lunaCount &&
+        !SeqLock_Load(&s_lunaLock[idx], &d, &s_lunaOut[idx], sizeof(d), SENSOR_LOAD_TRIES)) {
+        d = k_lunaEmpty;
+    }
+    return d;
+}
+TCS3472_Data_t Sensors_Color(uint8_t idx)
+{
+    TCS3472_Data_t d = k_tcsEmpty;
+    if (idx < s_tcsCount &&
+        !SeqLock_Load(&s_tcsLock[idx], &d, &s_tcsOut[idx], sizeof(d), SENSOR_LOAD_TRIES)) {
+        d = k_tcsEmpty;
+    }
+    return d;
+}
+TCS3472_t* Sensors_ColorDev(uint8_t idx)
+{
+    return (idx < s_tcsCount) ? &s_tcs[idx] : NULL;
+}
@@ -0,0 +1,521 @@
+/*
+ * ============================================================================
+ *  MODULE: shell — interaktywny shell na USART2 RX (implementacja)
+ *  ----------------------------------------------------------------------------
+ *  CO:
+ *    - Bufor linii + tokenizacja (spacje), tabela poleceń k_cmds[].
+ *    - Pola konfiguracji przez CFG_FieldFind/Get/Set (config.c) — bez kopii stanu.
+ *    - Stronicowanie (help/list/dump/ml list/ramfn): generator linii s_pageFn + kursor,
+ *      linia tylko przy wolnym miejscu w CRIT (pas nie czeka — pełny odrzuca linię).
+ *    - store save|load|erase|info: trwały zapis konfiguracji (cfg_store) — blokuje pętlę;
+ *      save/erase (i ml erase) tylko na postoju (App_DriveIdle), inaczej odmowa.
+ *    - bb dump|raw|arm|freeze|info: rejestrator SRAM2 (zrzut stronicuje sam blackbox).
+ *    - ml list|get|info|erase: log meczów we FLASH (zrzut stronicuje sam matchlog).
+ *    - crash [clear|test]: raport ostatniego błędu rdzenia; test = celowy UsageFault.
+ *    - drive L R ms: cel Tank do czasu s_driveUntil (nieblokujące, sprawdzane w Poll);
+ *      odrzucane w trakcie ucieczki od krawędzi, Edge_OnEscape kasuje cel (Shell_DriveCancel).
+ * ============================================================================
+ */
+
+#include "shell.h"
+#include "app.h"
+#include "config.h"
+#include "debug_uart.h"
+#include "dzlog.h"           // DZLOG_CRIT() — odpowiedzi o stałym formacie
+#include "tank_drive.h"
+#include "drive_test.h"
+#include "edge_detect.h"     // Edge_IsEscaping — drive odrzucany w trakcie ucieczki
+#include "color_class.h"
+#include "sensor.h"
+#include "cfg_store.h"
+#include "blackbox.h"
+#include "matchlog.h"
+#include "crash.h"
+#include "ramfunc.h"
+#include "stack_mon.h"
+#include "arena.h"
+#include "bench.h"
+#include "fmt.h"             // Fmt_Fixed / Fmt_ParseNum (bez %f i strtof)
+#include "stm32l4xx_hal.h"   // HAL_GetTick
+#include <string.h>
+
+#define SHELL_MAX_TOK     4u
+#define SHELL_DRIVE_MS    1000u    // domyślny czas "drive L R"
+#define SHELL_DRIVE_MAX   10000u   // bezpiecznik: maks. czas ręcznego celu
+#define SHELL_PAGE_LINE   128u     // maks. linia strony (ramfn ~110 B) — + zapas zdarzeń CRIT
+#define SHELL_PAGE_LINES  4u       // maks. linii strony na jedno Shell_Poll()
+
+/* Linia w budowie */
+static char    s_line[SHELL_LINE_MAX + 1];
+static uint8_t s_len = 0;
+static uint8_t s_overflow = 0;     // linia za długa → odrzucona przy Enter
+
+/* Stronicowanie: generator wypisuje linię od kursora i go przesuwa (0 = koniec);
+ * s_pageBlock = filtr bloku dla list/dump cfg */
+typedef uint8_t (*ShellPageFn_t)(uint8_t *cur);
+static ShellPageFn_t s_pageFn = NULL;
+static uint8_t       s_pageIdx = 0;
+static char          s_pageBlock[12];
+
+/* Ręczny cel Tank z limitem czasu */
+static uint8_t  s_driveOn = 0;
+static uint32_t s_driveUntil = 0;
+
+static uint8_t  s_panel = 1;
+
+/* ==== Pomocnicze ==== */
+
+static uint8_t parse_num(const char *tok, float *out)
+{
+    return Fmt_ParseNum(tok, out);                 // bez strtof (newlib: malloc)
+}
+
+static void print_field(const CFG_Field_t *f)
+{
+    const float v = CFG_FieldGet(f);
+    if (f->type == CFG_T_F32) {
+        char b[16];
+        Fmt_Fixed(b, sizeof(b), v, 3u, 0u);
+        if (f->live) DZLOG_CRIT("%s.%s = %s", f->block, f->name, b);
+        else         DZLOG_CRIT("%s.%s = %s  (restart)", f->block, f->name, b);
+    } else {
+        if (f->live) DZLOG_CRIT("%s.%s = %ld", f->block, f->name, (long)v);
+        else         DZLOG_CRIT("%s.%s = %ld  (restart)", f->block, f->name, (long)v);
+    }
+}
+
+static uint8_t crit_has_room(void)
+{
+    return DebugUART_CritRoom(SHELL_PAGE_LINE);
+}
+
+static void page_start(ShellPageFn_t fn, const char *block)
+{
+    s_pageFn  = fn;
+    s_pageIdx = 0u;
+    s_pageBlock[0] = '\0';
+    if (block) {
+        strncpy(s_pageBlock, block, sizeof(s_pageBlock) - 1u);
+        s_pageBlock[sizeof(s_pageBlock) - 1u] = '\0';
+    }
+}
+
+static void page_tick(void)
+{
+    for (uint8_t lines = 0u; s_pageFn && lines < SHELL_PAGE_LINES; lines++) {
+        if (!crit_has_room()) return;               // wróć w następnym Poll
+        if (!s_pageFn(&s_pageIdx)) s_pageFn = NULL;
+    }
+}
+
+/* ==== Generatory linii stron ==== */
+
+static uint8_t page_cfg(uint8_t *cur)
+{
+    uint8_t n = 0u;
+    const CFG_Field_t *tab = CFG_Fields(&n);
+    while (*cur < n) {
+        const CFG_Field_t *f = &tab[(*cur)++];
+        if (s_pageBlock[0] != '\0' && strcmp(s_pageBlock, f->block) != 0) continue;
+        print_field(f);
+        return 1u;
+    }
+    return 0u;
+}
+
+static uint8_t page_uart(uint8_t *cur)
+{
+    static const char *const k_lane[DEBUG_UART_LANES] = { "CRIT", "BULK" };
+    const uint8_t i = (*cur)++;
+    if (i < DEBUG_UART_LANES) {
+        DebugUART_LaneStats_t st;
+        DebugUART_GetLaneStats((DebugUART_Lane_t)i, &st);
+        DZLOG_CRIT("%s ok=%lu drop=%lu (%lu B) lat=%lu/%lu ms used=%lu/%lu",
+                   k_lane[i], (unsigned long)st.frames_ok, (unsigned long)st.frames_dropped,
+                   (unsigned long)st.bytes_dropped, (unsigned long)st.lat_last_ms,
+                   (unsigned long)st.lat_max_ms, (unsigned long)st.used, (unsigned long)st.size);
+        return 1u;
+    }
+    if (i > DEBUG_UART_LANES) return 0u;
+    DZLOG_CRIT("zapis do kolejki max %lu us (lat = commit -> ostatni bajt wyslany)",
+               (unsigned long)DebugUART_WriteMaxUs());
+    return 1u;
+}
+
+static uint8_t page_mem(uint8_t *cur)
+{
+    const uint8_t i = (*cur)++;
+    if (i == 0u) {
+        StackMon_Info_t sk;
+        StackMon_GetInfo(&sk);
+        DZLOG_CRIT("STACK max=%lu B, rezerwa %lu B, obszar %lu B%s", (unsigned long)sk.used,
+                   (unsigned long)sk.reserve, (unsigned long)sk.region,
+                   sk.exhausted ? " KOLIZJA" : (sk.over ? " >REZERWA" : ""));
+        return 1u;
+    }
+    if (i == 1u) {
+        Arena_Info_t ai;
+        Arena_GetInfo(&ai);
+        DZLOG_CRIT("ARENA %lu/%lu B, przydzialow %u, odmow %u%s (sterta: brak)",
+                   (unsigned long)ai.used, (unsigned long)ai.size, (unsigned)ai.allocs,
+                   (unsigned)ai.fails, ai.sealed ? ", zamknieta" : "");
+        return 1u;
+    }
+    const char *tag;
+    uint32_t sz;
+    if (!Arena_GetEntry((uint8_t)(i - 2u), &tag, &sz)) return 0u;
+    DZLOG_CRIT("  %-12s %lu B", tag, (unsigned long)sz);
+    return 1u;
+}
+
+static uint8_t page_sens(uint8_t *cur)
+{
+    const uint8_t i = (*cur)++;
+    if (i >= Sensors_Count()) return 0u;
+    const Sensor_t *s = Sensors_Get(i);
+    if (s->kind == SENSOR_LUNA) {
+        const TF_LunaData_t d = Sensors_Luna(s->idx);
+        DZLOG_CRIT("Luna %s: %u cm str=%u %s", s->name, (unsigned)d.distance_filt,
+                   (unsigned)d.strength_filt, d.frameReady ? "OK" : "NO FRAME");
+    } else {
+        const TCS3472_Data_t d = Sensors_Color(s->idx);
+        DZLOG_CRIT("TCS %s: C=%u R=%u G=%u B=%u %s", s->name, (unsigned)d.clear,
+                   (unsigned)d.red, (unsigned)d.green, (unsigned)d.blue,
+                   ColorClass_Name(ColorClass_Classify(&d).cls));
+    }
+    return 1u;
+}
+
+static uint8_t page_ml_list(uint8_t *cur) { return MatchLog_ListLine((*cur)++); }
+static uint8_t page_ramfn(uint8_t *cur)   { return RamFn_ReportLine((*cur)++); }
+
+/* Zapis/erase FLASH zatrzymuje CPU (do ~0.7 s): TIM1 trzyma ostatnie wypełnienie, rampy
+ * Tank stoją → tylko na postoju; ręczny cel i scenariusz jazdy kasowane przed operacją. */
+static uint8_t flash_op_allowed(void)
+{
+    if (!App_DriveIdle()) {
+        DZLOG_CRIT("err: naped pracuje - najpierw 'drive stop'");
+        return 0u;
+    }
+    s_driveOn = 0u;
+    DriveTest_Stop();
+    return 1u;
+}
+
+/* ==== Polecenia ==== */
+
+typedef void (*ShellFn_t)(uint8_t argc, char **argv);
+typedef struct {
+    const char *name;
+    const char *help;
+    ShellFn_t   fn;
+} ShellCmd_t;
+
+static void cmd_help(uint8_t argc, char **argv);
+
+static void cmd_list(uint8_t argc, char **argv)
+{
+    page_start(page_cfg, argc > 1 ? argv[1] : NULL);
+}
+
+static void cmd_get(uint8_t argc, char **argv)
+{
+    const CFG_Field_t *f = (argc > 1) ? CFG_FieldFind(argv[1]) : NULL;
+    if (!f) { DZLOG_CRIT("err: nieznane pole (list)"); return; }
+    print_field(f);
+}
+
+static void cmd_set(uint8_t argc, char **argv)
+{
+    const CFG_Field_t *f = (argc > 1) ? CFG_FieldFind(argv[1]) : NULL;
+    float v;
+    if (!f)                                   { DZLOG_CRIT("err: nieznane pole (list)"); return; }
+    if (argc < 3 || !parse_num(argv[2], &v))  { DZLOG_CRIT("err: set blok.pole wartosc"); return; }
+    if (!CFG_FieldSet(f, v)) {
+        const char *rule = (v >= f->min && v <= f->max) ? CFG_FieldConflict(f, v) : NULL;
+        if (rule) { DebugUART_CritPrintf("err: wymaga %s", rule); return; }   // reguła > DZLOG_STR_MAX: tekst
+        char lo[16], hi[16];
+        DZLOG_CRIT("err: zakres %s.%s = %s..%s", f->block, f->name,
+                   Fmt_Fixed(lo, sizeof(lo), f->min, 3u, 0u), Fmt_Fixed(hi, sizeof(hi), f->max, 3u, 0u));
+        return;
+    }
+    print_field(f);
+}
+
+static void cmd_drive(uint8_t argc, char **argv)
+{
+    if (Edge_IsEscaping() && !(argc > 1 && strcmp(argv[1], "stop") == 0)) {
+        DZLOG_CRIT("err: ucieczka od krawedzi trwa");
+        return;
+    }
+    if (argc > 1 && strcmp(argv[1], "test") == 0) {
+        s_driveOn = 0u;
+        DriveTest_Start();
+        DZLOG_CRIT("drive: test");
+        return;
+    }
+    if (argc > 1 && strcmp(argv[1], "stop") == 0) {
+        s_driveOn = 0u;
+        DriveTest_Stop();
+        Tank_Stop();
+        DZLOG_CRIT("drive: stop");
+        return;
+    }
+    float l, r, ms = (float)SHELL_DRIVE_MS;
+    if (argc < 3 || !parse_num(argv[1], &l) || !parse_num(argv[2], &r) ||
+        (argc > 3 && !parse_num(argv[3], &ms)) ||
+        l < -100.0f || l > 100.0f || r < -100.0f || r > 100.0f || ms < 0.0f) {
+        DZLOG_CRIT("err: drive L R [ms] | drive test | drive stop");
+        return;
+    }
+    if (ms > (float)SHELL_DRIVE_MAX) ms = (float)SHELL_DRIVE_MAX;
+    DriveTest_Stop();                               // ręczny cel zastępuje scenariusz
+    Tank_SetTarget((int8_t)l, (int8_t)r);
+    s_driveOn    = 1u;
+    s_driveUntil = HAL_GetTick() + (uint32_t)ms;
+    DZLOG_CRIT("drive: L=%d R=%d na %lu ms", (int)l, (int)r, (unsigned long)ms);
+}
+
+static void cmd_dump(uint8_t argc, char **argv)
+{
+    const char *what = (argc > 1) ? argv[1] : "";
+    if (strcmp(what, "cfg") == 0)       page_start(page_cfg, NULL);
+    else if (strcmp(what, "uart") == 0) page_start(page_uart, NULL);
+    else if (strcmp(what, "mem") == 0)  page_start(page_mem, NULL);
+    else if (strcmp(what, "sens") == 0) page_start(page_sens, NULL);
+    else                                DZLOG_CRIT("err: dump cfg | uart | mem | sens");
+}
+
+static void cmd_cal(uint8_t argc, char **argv)
+{
+    const char c = (argc > 1) ? argv[1][0] : '\0';
+    switch (c) {
+        case 'b': ColorClass_RequestCapture(COLOR_BLACK); break;   // robot nad czarną matą
+        case 'w': ColorClass_RequestCapture(COLOR_WHITE); break;   // czujniki nad białą krawędzią
+        case 'p': ColorClass_RequestPrint();              break;   // wiersze do k_color_table[]
+        default:  DZLOG_CRIT("err: cal b | w | p");   break;
+    }
+}
+
+static void cmd_panel(uint8_t argc, char **argv)
+{
+    if (argc > 1 && strcmp(argv[1], "off") == 0)     s_panel = 0u;
+    else if (argc > 1 && strcmp(argv[1], "on") == 0) s_panel = 1u;
+    DZLOG_CRIT("panel: %s", s_panel ? "on" : "off");
+}
+
+static void cmd_store(uint8_t argc, char **argv)
+{
+    const char *what = (argc > 1) ? argv[1] : "info";
+    if (strcmp(what, "save") == 0) {
+        if (!flash_op_allowed()) return;               // zapis/erase FLASH wstrzymuje CPU
+        if (CfgStore_Save()) DZLOG_CRIT("store: zapisano");
+        else                 DZLOG_CRIT("err: zapis FLASH");
+    } else if (strcmp(what, "load") == 0) {
+        DZLOG_CRIT("store: wczytano %u blok(ow)", (unsigned)CfgStore_Load());
+    } else if (strcmp(what, "erase") == 0) {
+        if (!flash_op_allowed()) return;
+        if (CfgStore_Erase()) DZLOG_CRIT("store: skasowano (domyslne po restarcie)");
+        else                  DZLOG_CRIT("err: erase FLASH");
+    } else if (strcmp(what, "info") != 0) {
+        DZLOG_CRIT("err: store save | load | erase | info");
+        return;
+    }
+    CfgStore_Info_t ci;
+    CfgStore_GetInfo(&ci);
+    DZLOG_CRIT("store: strona %d seq %lu zajete %u/%u B bledne %u poza zakresem %u",
+               (int)ci.active, (unsigned long)ci.seq, (unsigned)ci.used,
+               (unsigned)CFGS_PAGE_SIZE, (unsigned)ci.bad, (unsigned)ci.rejected);
+}
+
+static void cmd_bb(uint8_t argc, char **argv)
+{
+    const char *what = (argc > 1) ? argv[1] : "info";
+    if (strcmp(what, "dump") == 0)        { BlackBox_DumpStart(0u); return; }   // linie z BlackBox_DumpPoll()
+    else if (strcmp(what, "raw") == 0)    { BlackBox_DumpStart(1u); return; }   // hex → Tools/bb_decode.py
+    else if (strcmp(what, "arm") == 0)    BlackBox_Arm();
+    else if (strcmp(what, "freeze") == 0) BlackBox_Freeze();
+    else if (strcmp(what, "info") != 0)   { DZLOG_CRIT("err: bb dump | raw | arm | freeze | info"); return; }
+
+    BlackBox_Info_t bi;
+    BlackBox_GetInfo(&bi);
+    DZLOG_CRIT("bb: %u rek. %u/%u blokow %u B (surowo %lu B) boot %u rst=0x%02X %s",
+               (unsigned)bi.count, (unsigned)bi.blocks, (unsigned)BLACKBOX_BLOCKS, (unsigned)bi.bytes,
+               (unsigned long)(bi.count * sizeof(BlackBox_Rec_t)), (unsigned)bi.boots, (unsigned)bi.reset_flags, bi.frozen ? "zamrozony" : "nagrywa");
+}
+
+static void cmd_ml(uint8_t argc, char **argv)
+{
+    const char *what = (argc > 1) ? argv[1] : "info";
+    if (strcmp(what, "list") == 0) { page_start(page_ml_list, NULL); return; }
+    if (strcmp(what, "get") == 0) {
+        float m, b = 0.0f;
+        if (argc < 3 || !parse_num(argv[2], &m) || (argc > 3 && !parse_num(argv[3], &b)) ||
+            m < 0.0f || m > 65535.0f || b < 0.0f || b > 65535.0f) {
+            DZLOG_CRIT("err: ml get mecz [blok]");
+        } else if (!MatchLog_DumpStart((uint16_t)m, (uint16_t)b)) {
+            DZLOG_CRIT("err: brak meczu/bloku (ml list)");
+        }
+        return;
+    }
+    if (strcmp(what, "erase") == 0) {
+        if (!flash_op_allowed()) return;               // erase 32 stron wstrzymuje CPU (~0.7 s)
+        MatchLog_Erase();
+    } else if (strcmp(what, "info") != 0) {
+        DZLOG_CRIT("err: ml list | get mecz [blok] | info | erase");
+        return;
+    }
+    MatchLog_Info_t mi;
+    MatchLog_GetInfo(&mi);
+    DZLOG_CRIT("ml: mecz %u, %s, blokow %lu, utraconych %lu, pustych stron %u%s", (unsigned)mi.match,
+               mi.recording ? "zapis" : "postoj", (unsigned long)mi.blocks, (unsigned long)mi.lost,
+               (unsigned)mi.blank, mi.waiting ? " (czeka na postoj)" : "");
+}
+
+static void cmd_crash(uint8_t argc, char **argv)
+{
+    const char *what = (argc > 1) ? argv[1] : "";
+    if (strcmp(what, "clear") == 0) {
+        Crash_Clear();
+        DZLOG_CRIT("crash: wyczyszczono");
+    } else if (strcmp(what, "test") == 0) {
+        Tank_Stop();
+        DZLOG_CRIT("crash: test (UDF) -> reset");
+        __builtin_trap();                             // Thumb: UDF (UNDEFINSTR) → HardFault → raport po restarcie
+    } else if (!Crash_Report(1u)) {
+        DZLOG_CRIT("crash: brak zapisu");
+    }
+}
+
+static void cmd_ramfn(uint8_t argc, char **argv)
+{
+    if (argc > 1 && strcmp(argv[1], "reset") == 0) {
+        RamFn_Reset();
+        DZLOG_CRIT("ramfn: statystyka wyzerowana");
+        return;
+    }
+    page_start(page_ramfn, NULL);
+}
+
+#ifdef DZB_BENCH
+/* bench [prefiks]: mikrobenchmarki (blokuje pętlę na czas pomiaru) — tylko na postoju */
+static void cmd_bench(uint8_t argc, char **argv)
+{
+    s_driveOn = 0u;
+    DriveTest_Stop();
+    Tank_Stop();
+    if (Bench_Run((argc > 1) ? argv[1] : NULL, 1u) == 0u) {
+        DZLOG_CRIT("err: bench — brak przypadkow dla prefiksu");
+    }
+}
+#endif
+
+static const ShellCmd_t k_cmds[] = {
+    { "help",  "lista polecen",                       cmd_help  },
+    { "list",  "[blok] pola konfiguracji",            cmd_list  },
+    { "get",   "blok.pole",                           cmd_get   },
+    { "set",   "blok.pole wartosc",                   cmd_set   },
+    { "drive", "L R [ms] | test | stop",              cmd_drive },
+    { "dump",  "cfg | uart | mem | sens",             cmd_dump  },
+    { "cal",   "b | w | p (kalibracja koloru)",       cmd_cal   },
+    { "panel", "on | off",                            cmd_panel },
+    { "store", "save | load | erase | info (FLASH)",  cmd_store },
+    { "bb",    "dump | raw | arm | freeze | info",    cmd_bb    },
+    { "ml",    "list | get mecz [blok] | info | erase", cmd_ml  },
+    { "crash", "[clear | test] raport bledu rdzenia",  cmd_crash },
+    { "ramfn", "[reset] cykle sciezek w SRAM2",        cmd_ramfn },
+#ifdef DZB_BENCH
+    { "bench", "[prefiks] mikrobenchmarki (postoj)",   cmd_bench },
+#endif
+};
+#define SHELL_NCMDS  (sizeof(k_cmds) / sizeof(k_cmds[0]))
+
+static uint8_t page_help(uint8_t *cur)
+{
+    const uint8_t i = (*cur)++;
+    if (i >= SHELL_NCMDS) return 0u;
+    DebugUART_CritPrintf("  %-6s %s", k_cmds[i].name, k_cmds[i].help);   // opis > DZLOG_STR_MAX: tekst
+    return 1u;
+}
+
+static void cmd_help(uint8_t argc, char **argv)
+{
+    (void)argc; (void)argv;
+    page_start(page_help, NULL);
+}
+
+/* Wykonanie linii: tokenizacja w miejscu + wyszukanie polecenia */
+static void shell_exec(char *line)
+{
+    char *argv[SHELL_MAX_TOK];
+    uint8_t argc = 0u;
+    for (char *p = line; *p != '\0' && argc < SHELL_MAX_TOK; ) {
+        while (*p == ' ') *p++ = '\0';
+        if (*p == '\0') break;
+        argv[argc++] = p;
+        while (*p != '\0' && *p != ' ') p++;
+    }
+    if (argc == 0u) return;
+
+    s_pageFn = NULL;                                // nowe polecenie przerywa stronicowanie
+    for (uint8_t i = 0; i < SHELL_NCMDS; i++) {
+        if (strcmp(argv[0], k_cmds[i].name) == 0) { k_cmds[i].fn(argc, argv); return; }
+    }
+    DebugUART_CritPrintf("err: '%s'? (help)", argv[0]);   // token z linii: tekst
+}
+
+/* ==== API ==== */
+
+void Shell_Init(void)
+{
+    s_len = 0u; s_overflow = 0u;
+    s_pageFn = NULL;
+    s_driveOn = 0u;
+    s_panel = 1u;
+    DZLOG_CRIT("shell: 'help' = lista polecen");
+}
+
+void Shell_Poll(void)
+{
+    /* limit czasu ręcznego celu Tank */
+    if (s_driveOn && (int32_t)(HAL_GetTick() - s_driveUntil) >= 0) {
+        s_driveOn = 0u;
+        Tank_SetTarget(0, 0);
+    }
+
+    page_tick();                                    // kolejne linie strony (gdy jest miejsce)
+
+    for (uint8_t k = 0; k < SHELL_POLL_CHARS; k++) {
+        const int c = DebugUART_ReadChar();
+        if (c < 0) return;                          // kolejka RX pusta
+        if (c == '\r' || c == '\n') {
+            if (s_len == 0u && !s_overflow) continue;   // CRLF / pusta linia
+            s_line[s_len] = '\0';
+            if (s_overflow) DZLOG_CRIT("err: linia za dluga");
+            else {
+                DebugUART_CritPrintf("> %s", s_line);   // echo wykonywanej linii (tekst: dowolna długość)
+                shell_exec(s_line);
+            }
+            s_len = 0u; s_overflow = 0u;
+            return;                                 // jedno polecenie na Poll
+        }
+        if (c == 0x08 || c == 0x7F) {               // backspace / DEL
+            if (s_len > 0u) s_len--;
+            continue;
+        }
+        if (c < 0x20 || c > 0x7E) continue;         // pomiń znaki sterujące / nie-ASCII
+        if (s_len < SHELL_LINE_MAX) s_line[s_len++] = (char)c;
+        else                        s_overflow = 1u;
+    }
+}
+
+/* Ucieczka od krawędzi (Edge_OnEscape): ręczny cel anulowany — po manewrze robot stoi */
+void Shell_DriveCancel(void)
+{
+    s_driveOn = 0u;
+}
+
+uint8_t Shell_PanelEnabled(void)
+{
+    return s_panel;
+}
@@ -25,6 +25,7 @@
  */
 
 #include "ssd1306.h"
+#include "fmt.h"      // Fmt_Fixed — temperatura bez %f
 #include <string.h>
 #include <stdio.h>
 
@@ -275,6 +276,20 @@ static void draw_char_6x8(uint8_t x, uint8_t page, char c)
     s_buffer[bufIndex + 5] = 0x00;
 }
 
+#ifdef DZB_BENCH
+/* Akcesor benchmarku (bench.c): znaki po całym buforze, bez wysyłki I²C */
+uint32_t SSD1306_BenchDrawChar(uint32_t n)
+{
+    uint32_t acc = 0u;
+    for (uint32_t i = 0; i < n; ++i) {
+        const uint8_t x = (uint8_t)((i % 21u) * 6u), page = (uint8_t)((i / 21u) & 7u);
+        draw_char_6x8(x, page, (char)(0x20 + (i % 95u)));
+        acc += s_buffer[(uint16_t)page * SSD1306_WIDTH + x + 2u];
+    }
+    return acc;
+}
+#endif
+
 void SSD1306_DrawChar(uint8_t x, uint8_t page, char c)
 {
     draw_char_6x8(x, page, c);
@@ -319,9 +334,13 @@ void OLED_ShowSensors(const TF_LunaData_t *R, const TF_LunaData_t *L,
              (unsigned)R->strength, (unsigned)L->strength);
     SSD1306_DrawTextAt(2, 0, line);
 
-    /* Linia 3: temperatura [°C] – masz włączony float */
-    snprintf(line, sizeof(line), "T  R:%4.1fC  L:%4.1fC",
-             R->temperature, L->temperature);
+    /* Linia 3: temperatura [°C] – bez %f (Fmt_Fixed; firmware bez sterty) */
+    {
+        char tR[8], tL[8];
+        snprintf(line, sizeof(line), "T  R:%sC  L:%sC",
+                 Fmt_Fixed(tR, sizeof(tR), R->temperature, 1u, 4u),
+                 Fmt_Fixed(tL, sizeof(tL), L->temperature, 1u, 4u));
+    }
     SSD1306_DrawTextAt(3, 0, line);
 
     /* Linia 4: jasnosc (clear) — /64, by skrócić liczby */
@@ -0,0 +1,47 @@
+/*
+ * ============================================================================
+ *  MODULE: stack_mon — „high-water mark” stosu MSP (implementacja)
+ *  ----------------------------------------------------------------------------
+ *  CO:
+ *    - s_low: najniższe nadpisane słowo znalezione dotąd (startowo _estack).
+ *    - Skan w górę od _sstack; pierwsze słowo ≠ wzorzec → nowy znak (jeśli niżej),
+ *      dojście do s_low bez trafienia → stos nie sięgnął głębiej, restart od dołu.
+ *    - Słowo stosu równe przypadkiem wzorcowi zaniża wynik o ≤ 4 B — bez znaczenia.
+ * ============================================================================
+ */
+
+#include "stack_mon.h"
+#include <stddef.h>
+
+/* Linker (STM32L432KCUX_FLASH.ld) */
+extern uint32_t _sstack[], _estack[];
+extern uint8_t  _Min_Stack_Size[];      // symbol absolutny: adres = wartość
+
+static const uint32_t *s_scan = NULL;   // następne słowo do sprawdzenia
+static const uint32_t *s_low  = NULL;   // najniższe nadpisane słowo (znak)
+
+void StackMon_Poll(void)
+{
+    if (!s_scan) { s_scan = _sstack; s_low = _estack; }
+
+    for (uint32_t n = 0; n < STACK_MON_SCAN_WORDS; n++) {
+        if (s_scan >= s_low) { s_scan = _sstack; return; }   // bez zmian → od dołu
+        if (*s_scan != STACK_MON_PAINT) {
+            s_low  = s_scan;                                  // głębiej niż dotąd
+            s_scan = _sstack;
+            return;
+        }
+        s_scan++;
+    }
+}
+
+void StackMon_GetInfo(StackMon_Info_t *out)
+{
+    if (!out) return;
+    const uint32_t *low = s_low ? s_low : _estack;
+    out->used      = (uint32_t)((uintptr_t)_estack - (uintptr_t)low);
+    out->reserve   = (uint32_t)(uintptr_t)_Min_Stack_Size;
+    out->region    = (uint32_t)((uintptr_t)_estack - (uintptr_t)_sstack);
+    out->over      = (uint8_t)(out->used > out->reserve);
+    out->exhausted = (uint8_t)(_sstack[0] != STACK_MON_PAINT);
+}
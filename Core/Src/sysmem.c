@@ -7,40 +7,46 @@
  *   Zachowaj spójność z resztą modułów oraz konwencje projektu.
  */
 
+/*
+ * Bez sterty (_Min_Heap_Size = 0 w skrypcie linkera), ale link musi przejść:
+ *   - snprintf/vsnprintf z newlib(-nano) odwołują się (przez __ssputs_r/__ssprint_r)
+ *     do _malloc_r/_realloc_r/_free_r — dla bufora znakowego nigdy ich nie wołają,
+ *     ale symbole muszą istnieć.
+ *   - Alokator definiujemy tutaj, więc ten z newlib (i jego _sbrk) nie trafia do
+ *     obrazu. Każde faktyczne wywołanie (np. %f przez _dtoa_r, stdio na FILE) kończy
+ *     się heap_trap() → UDF → HardFault → raport crash po restarcie (pc = pułapka,
+ *     lr = funkcja alokatora). To sprawdza rzeczywisty graf wywołań, nie samą obecność
+ *     symbolu.
+ *   - _sbrk zostaje jako siatka bezpieczeństwa: zawsze ENOMEM, sterta nie rośnie.
+ * Bufory pochodzą z areny (arena.c) albo są statyczne.
+ */
+
 /* Includes */
 #include <errno.h>
+#include <stddef.h>
 #include <stdint.h>
 
-/**
- * Pointer to the current high watermark of the heap usage
- */
-static uint8_t *__sbrk_heap_end = NULL;
+struct _reent;
 
+/* Pułapka: alokacja w firmware bez sterty = błąd programu, nie cichy NULL */
+static __attribute__((noreturn, noinline)) void heap_trap(void)
+{
+  __builtin_trap();                     /* Thumb: UDF → HardFault → crash.c */
+}
 
 void *_sbrk(ptrdiff_t incr)
 {
-  extern uint8_t _end; /* Symbol defined in the linker script */
-  extern uint8_t _estack; /* Symbol defined in the linker script */
-  extern uint32_t _Min_Stack_Size; /* Symbol defined in the linker script */
-  const uint32_t stack_limit = (uint32_t)&_estack - (uint32_t)&_Min_Stack_Size;
-  const uint8_t *max_heap = (uint8_t *)stack_limit;
-  uint8_t *prev_heap_end;
-
-  /* Initialize heap end at first call */
-  if (NULL == __sbrk_heap_end)
-  {
-    __sbrk_heap_end = &_end;
-  }
-
-  /* Protect heap from growing into the reserved MSP stack */
-  if (__sbrk_heap_end + incr > max_heap)
-  {
-    errno = ENOMEM;
-    return (void *)-1;
-  }
+  (void)incr;
+  errno = ENOMEM;
+  return (void *)-1;
+}
 
-  prev_heap_end = __sbrk_heap_end;
-  __sbrk_heap_end += incr;
+void *_malloc_r(struct _reent *r, size_t n)             { (void)r; (void)n; heap_trap(); }
+void *_calloc_r(struct _reent *r, size_t k, size_t n)   { (void)r; (void)k; (void)n; heap_trap(); }
+void *_realloc_r(struct _reent *r, void *p, size_t n)   { (void)r; (void)p; (void)n; heap_trap(); }
+void  _free_r(struct _reent *r, void *p)                { (void)r; if (p) heap_trap(); }
 
-  return (void *)prev_heap_end;
-}
+void *malloc(size_t n)                                  { (void)n; heap_trap(); }
+void *calloc(size_t k, size_t n)                        { (void)k; (void)n; heap_trap(); }
+void *realloc(void *p, size_t n)                        { (void)p; (void)n; heap_trap(); }
+void  free(void *p)                                     { if (p) heap_trap(); }
@@ -37,6 +37,7 @@
  *   - Tank_Update(void)
  *   - Tank_Stop/Forward/Backward/TurnLeft/TurnRight/RotateLeft/RotateRight
  *   - Tank_SetTarget(int8_t left_pct, int8_t right_pct)
+ *   - Tank_Override(int8_t left_pct, int8_t right_pct) / Tank_OverrideRelease(void)
  *
  *
  * ============================================================================
@@ -84,6 +85,7 @@
 #include "tank_drive.h"     // deklaracje API tank drive (spójne z projektem)
 #include "motor_bldc.h"     // wyjście do warstwy ESC (ESC_WritePercentRaw, ESC_SetNeutralAll)
 #include "config.h"         // dostęp do CFG_Motors() — parametry rampy/okna/EMA itp.
+#include "ramfunc.h"        // RAMFUNC — Tank_Update wykonywany z SRAM2
 #include "stm32l4xx_hal.h"  // HAL_GetTick() — zegar systemowy (ms)
 
 #include <string.h>         // memset()
@@ -108,6 +110,14 @@ static const ConfigMotors_t *C = NULL;        /* skrót do konfiguracji CFG_Moto
 static uint8_t  gate_L_active = 0, gate_R_active = 0;  /* 1=bramka aktywna, trzymaj neutral  */
 static uint32_t gate_L_until  = 0, gate_R_until  = 0;  /* czas (ms), do którego bramka trwa  */
 
+/* Override (np. ucieczka od krawędzi dohyo): cel stosowany bez rampy i EMA.
+ * Bramka neutralu zostaje — chroni ESC przy nagłym reverse. W trakcie override
+ * cele z API wysokiego poziomu trafiają do zatrzasku (latch) i wchodzą dopiero
+ * po Tank_OverrideRelease() — limit czasu shella czy DriveTest_Stop() nie przerwą
+ * manewru w połowie. */
+static uint8_t  s_override = 0;
+static int8_t   s_latch_L = 0, s_latch_R = 0;  /* cel odłożony na czas override       */
+
 /* ============================================================================
  *                                 POMOCNICZE
  * ==========================================================================*/
@@ -128,9 +138,17 @@ static inline float clampf(float v, float lo, float hi)
     return v;                           /* zwrot wartości przyciętej                */
 }
 
+/* set_target: cel z API wysokiego poziomu — w trakcie override tylko zatrzask */
+static void set_target(int8_t l, int8_t r)
+{
+    if (s_override) { s_latch_L = l; s_latch_R = r; return; }
+    s.tgt_L = l;
+    s.tgt_R = r;
+}
+
 /* ramp_once: wykonuje P O J E D Y N C Z Y krok rampy z cur → tgt o max |step|.
  * Dzięki temu zmiany są „miękkie” (bez skoków), co odciąża mechanicę i ESC. */
-static void ramp_once(int8_t *cur, int8_t tgt, uint8_t step)
+RAMFUNC_HELPER static void ramp_once(int8_t *cur, int8_t tgt, uint8_t step)
 {
     int d = (int)tgt - (int)*cur;       /* różnica: ile brakuje do celu             */
     if (d >  (int)step)  d =  (int)step;/* ogranicz: nie przekraczaj dodatniego kroku */
@@ -140,7 +158,7 @@ static void ramp_once(int8_t *cur, int8_t tgt, uint8_t step)
 
 /* ema_step: pojedynczy krok wygładzania EMA (Exponential Moving Average).
  * alpha=0 → pełny filtr (brak zmian), alpha=1 → brak filtracji (natychmiast). */
-static float ema_step(float prev, float in, float alpha)
+RAMFUNC_HELPER static float ema_step(float prev, float in, float alpha)
 {
     return (1.0f - alpha) * prev + alpha * in;  /* klasyczny wzór EMA             */
 }
@@ -150,7 +168,7 @@ static float ema_step(float prev, float in, float alpha)
  *  - wyjście: „surowy” % wokół neutralu dla ESC, ale zawężony do [start..max],
  *  - 0 → neutral (0%), dodatnie → powyżej neutralu, ujemne → poniżej.
  *  - docelowo warstwa ESC przemapuje % liniowo na 1000..2000 µs (1..2 ms). */
-static int8_t map_logic_to_esc_window(int8_t x)
+RAMFUNC_HELPER static int8_t map_logic_to_esc_window(int8_t x)
 {
     const uint8_t start = C->esc_start_pct;   /* np. 30% — wyjście z martwej strefy        */
     const uint8_t max   = C->esc_max_pct;     /* np. 60% — nasz „sufit” dla 100% logicznego */
@@ -173,8 +191,8 @@ static int8_t map_logic_to_esc_window(int8_t x)
  *  - jeżeli wykryto zmianę znaku (ponad próg reverse_threshold_pct) → włącz bramkę,
  *    ustaw czas wygaśnięcia i natychmiast zwróć neutral (0%),
  *  - w przeciwnym wypadku zwróć docelową wartość 'tgt'. */
-static int8_t apply_neutral_gate_one(int8_t cur, int8_t tgt,
-                                     uint8_t *gate_active, uint32_t *gate_until)
+RAMFUNC_HELPER static int8_t apply_neutral_gate_one(int8_t cur, int8_t tgt,
+                                                    uint8_t *gate_active, uint32_t *gate_until)
 {
     const uint32_t now      = HAL_GetTick();           /* bieżący czas [ms]             */
     const uint16_t dwell_ms = C->neutral_dwell_ms;     /* czas trwania bramki           */
@@ -213,14 +231,18 @@ void Tank_Init(TIM_HandleTypeDef *htim1)
 
     gate_L_active = gate_R_active = 0; /* brak aktywnych bramek na starcie           */
     gate_L_until  = gate_R_until  = 0; /* czasy wygaszenia = 0                       */
+    s_override    = 0;                 /* normalna rampa                             */
+    s_latch_L     = s_latch_R = 0;     /* brak odłożonego celu                       */
 
     ESC_SetNeutralAll();               /* obie strony 1500 µs — bezpieczny start     */
 }
 
 /* Tank_Update:
  *  - wywoływać periodycznie co C->tick_ms (np. co 20 ms),
- *  - kolejność: neutral-gate → rampa → EMA → kompensacja L/R → okno ESC → wyjście. */
-void Tank_Update(void)
+ *  - kolejność: neutral-gate → rampa → EMA → kompensacja L/R → okno ESC → wyjście,
+ *  - RAMFUNC: kod w SRAM2 razem z helperami (RAMFUNC_HELPER); wyjścia ESC_* i
+ *    HAL_GetTick zostają we FLASH (wywołania przez weneer). */
+RAMFUNC void Tank_Update(void)
 {
     if (!C) {                          /* zabezpieczenie: jeżeli ktoś wołał przed Init */
         C = CFG_Motors();              /* dociągnij konfigurację, by nie dereferencjon. */
@@ -233,16 +255,18 @@ void Tank_Update(void)
                                                       &gate_R_active, &gate_R_until);
 
     /* 1) Rampa — pojedynczy krok cur→tgt (lub neutral, jeśli gate aktywna) */
-    if (gate_L_active) s.cur_L = 0;    /* gdy gate → twardy neutral bez rampy       */
-    else               ramp_once(&s.cur_L, gated_tgt_L, C->ramp_step_pct);
+    if (gate_L_active)   s.cur_L = 0;  /* gdy gate → twardy neutral bez rampy       */
+    else if (s_override) s.cur_L = gated_tgt_L; /* override → skok do celu         */
+    else                 ramp_once(&s.cur_L, gated_tgt_L, C->ramp_step_pct);
 
-    if (gate_R_active) s.cur_R = 0;    /* jw. dla prawego koła                      */
-    else               ramp_once(&s.cur_R, gated_tgt_R, C->ramp_step_pct);
+    if (gate_R_active)   s.cur_R = 0;  /* jw. dla prawego koła                      */
+    else if (s_override) s.cur_R = gated_tgt_R;
+    else                 ramp_once(&s.cur_R, gated_tgt_R, C->ramp_step_pct);
 
     /* 2) Wygładzanie (EMA) — redukuje drobne oscylacje, czyni sterowanie „miękkim” */
     const float inL = (float)s.cur_L;  /* rzutowanie na float do filtra             */
     const float inR = (float)s.cur_R;
-    if (C->smooth_alpha > 0.0f) {      /* 0.0 = wyłączony filtr EMA                 */
+    if (C->smooth_alpha > 0.0f && !s_override) { /* 0.0 = wyłączony filtr EMA       */
         s.flt_L = ema_step(s.flt_L, inL, C->smooth_alpha);
         s.flt_R = ema_step(s.flt_R, inR, C->smooth_alpha);
     } else {
@@ -266,22 +290,19 @@ void Tank_Update(void)
 
 void Tank_Stop(void)
 {
-    s.tgt_L = 0;                        /* zatrzymaj lewe koło  (0% = neutral)       */
-    s.tgt_R = 0;                        /* zatrzymaj prawe koło (0% = neutral)       */
+    set_target(0, 0);                   /* zatrzymaj oba koła (0% = neutral)         */
 }
 
 void Tank_Forward(int8_t pct)
 {
     pct = clamp_i8(pct, 0, 100);        /* upewnij się, że 0..100                    */
-    s.tgt_L = +pct;                     /* oba koła „w przód”                        */
-    s.tgt_R = +pct;
+    set_target(+pct, +pct);             /* oba koła „w przód”                        */
 }
 
 void Tank_Backward(int8_t pct)
 {
     pct = clamp_i8(pct, 0, 100);        /* upewnij się, że 0..100                    */
-    s.tgt_L = -pct;                     /* oba koła „w tył”                          */
-    s.tgt_R = -pct;
+    set_target(-pct, -pct);             /* oba koła „w tył”                          */
 }
 
 /* arc_pair: pomocniczo — skręt po łuku (wewnętrzne ≈ 50% zewnętrznego).
@@ -301,8 +322,7 @@ void Tank_TurnLeft(int8_t pct)
     pct = clamp_i8(pct, 0, 100);        /* 0..100, skręt w lewo po łuku              */
     int8_t in, out;
     arc_pair(pct, &in, &out);
-    s.tgt_L = +in;                       /* lewe = wewnętrzne                         */
-    s.tgt_R = +out;                      /* prawe = zewnętrzne                        */
+    set_target(+in, +out);               /* lewe = wewnętrzne, prawe = zewnętrzne     */
 }
 
 void Tank_TurnRight(int8_t pct)
@@ -310,26 +330,94 @@ void Tank_TurnRight(int8_t pct)
     pct = clamp_i8(pct, 0, 100);        /* 0..100, skręt w prawo po łuku             */
     int8_t in, out;
     arc_pair(pct, &in, &out);
-    s.tgt_L = +out;                      /* lewe  = zewnętrzne                        */
-    s.tgt_R = +in;                       /* prawe = wewnętrzne                        */
+    set_target(+out, +in);               /* lewe = zewnętrzne, prawe = wewnętrzne     */
 }
 
 void Tank_RotateLeft(int8_t pct)
 {
     pct = clamp_i8(pct, 0, 100);        /* 0..100, obrót w miejscu w lewo            */
-    s.tgt_L = -pct;                      /* lewe  wstecz                               */
-    s.tgt_R = +pct;                      /* prawe w przód                              */
+    set_target(-pct, +pct);              /* lewe wstecz, prawe w przód                */
 }
 
 void Tank_RotateRight(int8_t pct)
 {
     pct = clamp_i8(pct, 0, 100);        /* 0..100, obrót w miejscu w prawo           */
-    s.tgt_L = +pct;                      /* lewe  w przód                              */
-    s.tgt_R = -pct;                      /* prawe wstecz                               */
+    set_target(+pct, -pct);              /* lewe w przód, prawe wstecz                */
 }
 
 void Tank_SetTarget(int8_t left_pct, int8_t right_pct)
 {
-    s.tgt_L = clamp_i8(left_pct,  -100, 100);  /* bezpośrednie cele (−100..+100)       */
+    set_target(clamp_i8(left_pct,  -100, 100),  /* bezpośrednie cele (−100..+100)      */
+               clamp_i8(right_pct, -100, 100));
+}
+
+/* Tank_Override:
+ *  - cel natychmiast (bez rampy i EMA) + od razu wyjście do ESC (nie czekamy na tick),
+ *  - bramka neutralu działa jak zwykle (zmiana znaku → neutral_dwell_ms),
+ *  - trwa do Tank_OverrideRelease(); kolejne wywołania tylko zmieniają cel,
+ *  - pierwszy override zatrzaskuje bieżący cel użytkownika (wraca po Release). */
+void Tank_Override(int8_t left_pct, int8_t right_pct)
+{
+    if (!s_override) { s_latch_L = s.tgt_L; s_latch_R = s.tgt_R; }
+    s.tgt_L = clamp_i8(left_pct,  -100, 100);
     s.tgt_R = clamp_i8(right_pct, -100, 100);
+    s_override = 1;
+    Tank_Update();                             /* natychmiastowe wyjście PWM          */
+}
+
+/* Tank_OverrideRelease: zatrzaśnięty cel wraca, rampa/EMA od bieżącego stanu (bez skoku) */
+void Tank_OverrideRelease(void)
+{
+    if (!s_override) return;
+    s_override = 0;
+    s.tgt_L = s_latch_L;
+    s.tgt_R = s_latch_R;
+}
+
+uint8_t Tank_IsOverridden(void)
+{
+    return s_override;
+}
+
+void Tank_GetState(int8_t *tgt_l, int8_t *tgt_r, int8_t *cur_l, int8_t *cur_r)
+{
+    if (tgt_l) *tgt_l = s.tgt_L;
+    if (tgt_r) *tgt_r = s.tgt_R;
+    if (cur_l) *cur_l = s.cur_L;
+    if (cur_r) *cur_r = s.cur_R;
+}
+
+#ifdef DZB_BENCH
+/* ============================================================================
+ *  Akcesory benchmarków (bench.c) — pętle po helperach statycznych
+ * ==========================================================================*/
+uint32_t Tank_BenchRamp(uint32_t n)
+{
+    int8_t   cur = 0;
+    uint32_t acc = 0u;
+    for (uint32_t i = 0; i < n; ++i) {
+        ramp_once(&cur, (i & 32u) ? 100 : -100, 7u);   /* piła ±100, krok 7%   */
+        acc += (uint8_t)cur;
+    }
+    return acc;
+}
+
+uint32_t Tank_BenchEma(uint32_t n)
+{
+    float y = 0.0f;
+    for (uint32_t i = 0; i < n; ++i) {
+        y = ema_step(y, (float)(int8_t)(i * 37u), 0.25f);
+    }
+    return (uint32_t)(int32_t)(y * 1000.0f);
+}
+
+uint32_t Tank_BenchEscWindow(uint32_t n)
+{
+    if (!C) C = CFG_Motors();                  /* bez Tank_Init (host)                 */
+    uint32_t acc = 0u;
+    for (uint32_t i = 0; i < n; ++i) {
+        acc += (uint8_t)map_logic_to_esc_window((int8_t)((int)(i % 201u) - 100));
+    }
+    return acc;
 }
+#endif /* DZB_BENCH */
@@ -1,23 +1,32 @@
 /**
  * ============================================================================
- *  MODULE: tcs3472.c — RAW C/R/G/B + auto-gain + EMA (bez zmian API)
+ *  MODULE: tcs3472.c — RAW C/R/G/B + auto-gain/ATIME + EMA (instancje TCS3472_t)
  * -----------------------------------------------------------------------------
  *  API:
- *    void           TCS3472_Right_Init(I2C_HandleTypeDef *hi2c1);
- *    void           TCS3472_Left_Init (I2C_HandleTypeDef *hi2c3);
- *    TCS3472_Data_t TCS3472_Right_Read(void);
- *    TCS3472_Data_t TCS3472_Left_Read (void);
- *    void           TCS3472_Config    (I2C_HandleTypeDef *hi2c);
+ *    void           TCS3472_Init      (TCS3472_t *dev, I2C_HandleTypeDef *hi2c, const char *name);
+ *    void           TCS3472_Config    (TCS3472_t *dev);
+ *    uint8_t        TCS3472_Poll      (TCS3472_t *dev);   // STATUS: nowa integracja?
+ *    TCS3472_Data_t TCS3472_Complete  (TCS3472_t *dev);   // burst + EMA + auto-gain/ATIME
+ *    TCS3472_Data_t TCS3472_Process   (TCS3472_t *dev, const TCS3472_Data_t *raw); // sama obróbka (SRAM2)
+ *    TCS3472_Data_t TCS3472_Read      (TCS3472_t *dev);   // Poll ? Complete : ostatni (fresh=0)
+ *    void           TCS3472_SetFastClear(TCS3472_t *dev, uint8_t atime_cycles, TCS_Gain_t gain);
+ *    uint8_t        TCS3472_ReadClear (TCS3472_t *dev, uint16_t *clear);
  *
  *  MECHANIKA:
- *    - Histereza auto-gain na Clear (progi z getterów CFG_TCS_AG_*()).
- *    - EMA na C/R/G/B (alfa z CFG_TCS_EMA_Alpha()), z kompensacją przy zmianie gainu.
+ *    - Histereza auto-gain/ATIME na Clear (progi z getterów CFG_TCS_AG_*()),
+ *      progi względem FS bieżącego ATIME; drabinka kroków: tcs_step_*().
+ *    - EMA na C/R/G/B (alfa z CFG_TCS_EMA_Alpha()), z kompensacją przy zmianie kroku.
  *    - I²C transakcje krótkie; bez opóźnień blokujących.
+ *    - STATUS (AVALID/AINT) przed odczytem danych: nowa integracja → burst 8 B
+ *      (auto-increment), brak → zwracamy ostatni wynik z fresh=0.
+ *    - Po zmianie gainu pierwsza kompletna integracja jest odrzucana.
  * ============================================================================
  */
 
 #include "tcs3472.h"
 #include "config.h"
+#include "prof.h"       // DWT: czas TCS3472_Process
+#include "ramfunc.h"
 #include "stm32l4xx_hal.h"
 #include <string.h>
 #include <math.h>
@@ -26,49 +35,62 @@
 /* --- Adresy/rejestry --- */
 #define TCS3472_ADDR   (0x29u << 1)
 #define CMD(x)         (0x80u | (x))
+#define CMD_AUTO(x)    (0xA0u | (x))   /* auto-increment (burst, spójne LSB/MSB) */
+#define CMD_CLR_AINT   0xE6u           /* special function: kasuj przerwanie RGBC */
 #define REG_ENABLE     0x00u
 #define REG_ATIME      0x01u
+#define REG_PERS       0x0Cu
 #define REG_CONTROL    0x0Fu
 #define REG_ID         0x12u
+#define REG_STATUS     0x13u   /* bit0 AVALID, bit4 AINT */
 #define REG_CDATAL     0x14u   /* 8 B: C,R,G,B (LSB,MSB) */
 
+#define ENABLE_PON     0x01u
+#define ENABLE_AEN     0x02u
+#define ENABLE_AIEN    0x10u   /* AINT co cykl (PERS=0); pin INT nieużywany */
+#define STATUS_AVALID  0x01u
+#define STATUS_AINT    0x10u
+
+#define TCS_RATE_WIN_MS 1000u    // okno liczenia rate_hz
+
 #define TCS_FS_16      (65535u)  // pełna skala 16-bit
+#define TCS_CYCLE_MS   2.4f      // jeden cykl integracji
+#define TCS_SAT_PCT    0.98f     // Clear ≥ 98% FS → saturacja (predykcja niewiarygodna)
+#define TCS_UP_GUARD   1.15f     // zapas przy zwiększaniu czułości (anty-oscylacja)
+
+/* --- Dostępne ATIME (w cyklach 2.4 ms): 2.4, 4.8, 9.6, 24, 50, 101, 154 ms --- */
+static const uint8_t k_atime_cycles[] = { 1u, 2u, 4u, 10u, 21u, 42u, 64u };
+#define TCS_ATIME_STEPS  ((uint8_t)(sizeof(k_atime_cycles) / sizeof(k_atime_cycles[0])))
 
 /* --- (weak) gettery tuningu — można nadpisać w config.c --- */
 __attribute__((weak)) float CFG_TCS_EMA_Alpha(void) { return 0.30f; }
 __attribute__((weak)) float CFG_TCS_AG_LoPct(void)  { return 0.60f; }
 __attribute__((weak)) float CFG_TCS_AG_HiPct(void)  { return 0.70f; }
 
-/* --- Uchwyty I²C przypisane do stron --- */
-static I2C_HandleTypeDef *tcs_right = NULL;  // Right  (I2C1)
-static I2C_HandleTypeDef *tcs_left  = NULL;  // Left   (I2C3)
-
-/* --- Stan per strona --- */
-typedef struct {
-    I2C_HandleTypeDef *bus;      // magistrala I²C
-    TCS_Gain_t         gain;     // aktualny gain
-    float ema_c, ema_r, ema_g, ema_b; // stan EMA
-    uint8_t ema_init;            // 0=niezainicjalizowany, 1=zainicjalizowany
-} TCS_State_t;
-
-static TCS_State_t s_right = {0};
-static TCS_State_t s_left  = {0};
-
 /* --- (weak) hook: log zmiany gainu --- */
-__attribute__((weak)) void TCS3472_OnGainChange(const char* side, TCS_Gain_t oldg, TCS_Gain_t newg)
+__attribute__((weak)) void TCS3472_OnGainChange(const char* name, TCS_Gain_t oldg, TCS_Gain_t newg)
 {
-    (void)side; (void)oldg; (void)newg; // domyślnie nic
+    (void)name; (void)oldg; (void)newg; // domyślnie nic
 }
 
 /* --- Helpery: atime/gain/reg --- */
-static uint8_t tcs_atime_from_ms(float ms)
+static uint8_t tcs_atime_idx_from_ms(float ms)
 {
-    if (ms < 2.4f)   ms = 2.4f;          // dół zakresu
-    if (ms > 614.0f) ms = 614.0f;        // góra zakresu
-    int reg = (int)(256.0f - (ms / 2.4f) + 0.5f);
-    if (reg < 0)   reg = 0;
-    if (reg > 255) reg = 255;
-    return (uint8_t)reg;
+    uint8_t best = 0u;                                   // najbliższy dostępny krok
+    float   err  = 1e9f;
+    for (uint8_t i = 0; i < TCS_ATIME_STEPS; ++i) {
+        float e = (float)k_atime_cycles[i] * TCS_CYCLE_MS - ms;
+        if (e < 0.0f) e = -e;
+        if (e < err) { err = e; best = i; }
+    }
+    return best;
+}
+static inline uint8_t tcs_atime_reg(uint8_t idx)       { return (uint8_t)(256u - k_atime_cycles[idx]); }
+static inline float   tcs_atime_ms (uint8_t idx)       { return (float)k_atime_cycles[idx] * TCS_CYCLE_MS; }
+static inline uint32_t tcs_fullscale(uint8_t idx)
+{
+    const uint32_t fs = 1024u * (uint32_t)k_atime_cycles[idx];
+    return (fs > TCS_FS_16) ? TCS_FS_16 : fs;
 }
 static inline uint8_t tcs_gain_to_reg(TCS_Gain_t g)
 {
@@ -97,85 +119,223 @@ static void tcs_write_u8(I2C_HandleTypeDef *hi2c, uint8_t reg, uint8_t val)
     uint8_t cmd[2] = { CMD(reg), val };                 // [CMD|reg, val]
     (void)HAL_I2C_Master_Transmit(hi2c, TCS3472_ADDR, cmd, 2, 20u);
 }
-static TCS3472_Data_t tcs_read_raw(I2C_HandleTypeDef *hi2c)
+static void tcs_clear_int(I2C_HandleTypeDef *hi2c)
+{
+    uint8_t cmd = CMD_CLR_AINT;                         // special function (bez danych)
+    (void)HAL_I2C_Master_Transmit(hi2c, TCS3472_ADDR, &cmd, 1, 20u);
+}
+/* STATUS (1 B); 0 przy błędzie I²C (traktowane jak „brak nowych danych”) */
+static uint8_t tcs_read_status(I2C_HandleTypeDef *hi2c)
+{
+    uint8_t reg = CMD(REG_STATUS), st = 0u;
+    if (HAL_I2C_Master_Transmit(hi2c, TCS3472_ADDR, &reg, 1, 20u) != HAL_OK) return 0u;
+    if (HAL_I2C_Master_Receive (hi2c, TCS3472_ADDR, &st, 1, 20u) != HAL_OK) return 0u;
+    return st;
+}
+/* Burst C,R,G,B (auto-increment) — 1 = OK */
+static uint8_t tcs_read_raw(I2C_HandleTypeDef *hi2c, TCS3472_Data_t *d)
 {
-    TCS3472_Data_t d = (TCS3472_Data_t){0};
-    if (!hi2c) return d;
+    if (!hi2c || !d) return 0u;
 
-    uint8_t reg = CMD(REG_CDATAL);                      // bazowy rejestr danych
+    uint8_t reg = CMD_AUTO(REG_CDATAL);                 // bazowy rejestr danych
     uint8_t buf[8];                                     // 4×(LSB,MSB)
 
-    if (HAL_I2C_Master_Transmit(hi2c, TCS3472_ADDR, &reg, 1, 20u) != HAL_OK) return d;
-    if (HAL_I2C_Master_Receive (hi2c, TCS3472_ADDR, buf, sizeof(buf), 20u) != HAL_OK) return d;
+    if (HAL_I2C_Master_Transmit(hi2c, TCS3472_ADDR, &reg, 1, 20u) != HAL_OK) return 0u;
+    if (HAL_I2C_Master_Receive (hi2c, TCS3472_ADDR, buf, sizeof(buf), 20u) != HAL_OK) return 0u;
 
-    d.clear = (uint16_t)(buf[0] | (buf[1] << 8));
-    d.red   = (uint16_t)(buf[2] | (buf[3] << 8));
-    d.green = (uint16_t)(buf[4] | (buf[5] << 8));
-    d.blue  = (uint16_t)(buf[6] | (buf[7] << 8));
-    return d;
+    d->clear = (uint16_t)(buf[0] | (buf[1] << 8));
+    d->red   = (uint16_t)(buf[2] | (buf[3] << 8));
+    d->green = (uint16_t)(buf[4] | (buf[5] << 8));
+    d->blue  = (uint16_t)(buf[6] | (buf[7] << 8));
+    return 1u;
 }
 
-/* --- Zmiana gainu z kompensacją EMA + hook --- */
-static void tcs_set_gain(TCS_State_t *S, TCS_Gain_t new_gain)
+/* --- Drabinka gain×ATIME ---
+ *  Kroki 0..3: 1×/4×/16×/60× przy ATIME = a_min (najkrótsza integracja),
+ *  dalej: 60× i kolejne ATIME aż do a_max. Czułość rośnie monotonicznie,
+ *  a czas integracji nie maleje → „pierwszy pasujący krok” = najświeższa próbka.
+ */
+static inline uint8_t tcs_step_count(const TCS3472_t *S)
+{
+    return (uint8_t)(4u + (uint8_t)(S->a_max - S->a_min));
+}
+static inline TCS_Gain_t tcs_step_gain(const TCS3472_t *S, uint8_t k)
+{
+    (void)S;
+    return (k < 4u) ? (TCS_Gain_t)k : TCS_GAIN_60X;
+}
+static inline uint8_t tcs_step_atime(const TCS3472_t *S, uint8_t k)
+{
+    return (k < 4u) ? S->a_min : (uint8_t)(S->a_min + (k - 3u));
+}
+static inline float tcs_step_sens(const TCS3472_t *S, uint8_t k)
 {
-    if (!S || (S->gain == new_gain)) return;
+    return tcs_gain_multiplier(tcs_step_gain(S, k)) * (float)k_atime_cycles[tcs_step_atime(S, k)];
+}
+/* Krok najbliższy czułości startowej z configu (gain × atime_ms) */
+static uint8_t tcs_step_from_cfg(const TCS3472_t *S, const ConfigTCS_t *T)
+{
+    const float want = tcs_gain_multiplier(T->gain) * (float)k_atime_cycles[tcs_atime_idx_from_ms((float)T->atime_ms)];
+    uint8_t best = 0u;
+    for (uint8_t k = 0; k < tcs_step_count(S); ++k) {
+        if (tcs_step_sens(S, k) <= want) best = k;      // ostatni nie czulszy niż start
+    }
+    return best;
+}
+
+/* --- Zmiana kroku (gain/ATIME) z kompensacją EMA + hook --- */
+static void tcs_set_step(TCS3472_t *S, uint8_t new_step)
+{
+    if (!S || (S->step == new_step)) return;
 
     const TCS_Gain_t oldg = S->gain;                     // zapamiętaj stary gain
-    const float old_m = tcs_gain_multiplier(S->gain);    // krotność starego gainu
-    const float new_m = tcs_gain_multiplier(new_gain);   // krotność nowego gainu
-    const float k     = (new_m > 0.0f) ? (old_m / new_m) : 1.0f;
+    const float old_s = tcs_step_sens(S, S->step);       // czułość starego kroku
+    const float new_s = tcs_step_sens(S, new_step);      // czułość nowego kroku
+    const float k     = (new_s > 0.0f) ? (new_s / old_s) : 1.0f;
+    const TCS_Gain_t ng = tcs_step_gain(S, new_step);
+    const uint8_t    na = tcs_step_atime(S, new_step);
 
     S->ema_c *= k; S->ema_r *= k; S->ema_g *= k; S->ema_b *= k; // anty-skoki
-    tcs_write_u8(S->bus, REG_CONTROL, tcs_gain_to_reg(new_gain));
-    S->gain = new_gain;
+    if (na != tcs_step_atime(S, S->step)) tcs_write_u8(S->bus, REG_ATIME, tcs_atime_reg(na));
+    if (ng != oldg)                       tcs_write_u8(S->bus, REG_CONTROL, tcs_gain_to_reg(ng));
+    tcs_clear_int(S->bus);                               // bieżąca integracja = mieszana…
+    S->skip = 1u;                                        // …więc jej wynik odrzucamy
+    S->step = new_step;
+    S->gain = ng;
 
-    const char* side = (S == &s_right) ? "Right" : (S == &s_left) ? "Left" : "?";
-    TCS3472_OnGainChange(side, oldg, new_gain);          // opcjonalny log
+    if (ng != oldg) TCS3472_OnGainChange(S->name, oldg, ng);  // opcjonalny log (nazwa instancji)
+}
+
+/* --- Wybór kroku na podstawie surowego Clear (predykcja przez stosunek czułości) ---
+ *  • Clear w [lo..hi]·FS → bez zmian (histereza).
+ *  • Saturacja → krok w dół (wartość niewiarygodna do predykcji).
+ *  • W p.p.: pierwszy krok z przewidywanym Clear w [lo..hi]·FS; gdy pasma nie da się
+ *    trafić — najczulszy krok, który nie przekracza hi·FS.
+ */
+RAMFUNC_HELPER static uint8_t tcs_pick_step(const TCS3472_t *S, uint16_t clear, float lo, float hi)
+{
+    const uint32_t fs  = tcs_fullscale(tcs_step_atime(S, S->step));
+    const float    frac = (float)clear / (float)fs;
+
+    if (S->pinned)                return S->step;     // tryb szybki: bez auto-gain/ATIME
+    if (frac >= lo && frac <= hi) return S->step;
+    if (frac >= TCS_SAT_PCT)      return (S->step > 0u) ? (uint8_t)(S->step - 1u) : 0u;
+
+    const float s0 = tcs_step_sens(S, S->step);
+    uint8_t fit = 0xFFu, best = 0u;
+    for (uint8_t k = 0; k < tcs_step_count(S); ++k) {
+        float p = (float)clear * (tcs_step_sens(S, k) / s0) / (float)tcs_fullscale(tcs_step_atime(S, k));
+        if (k > S->step) p *= TCS_UP_GUARD;              // ostrożniej w górę
+        if (p <= hi) best = k;
+        if (fit == 0xFFu && p >= lo && p <= hi) fit = k;
+    }
+    return (fit != 0xFFu) ? fit : best;
 }
 
 /* --- Konfiguracja rejestrów (publiczna) --- */
-void TCS3472_Config(I2C_HandleTypeDef *hi2c)
+void TCS3472_Config(TCS3472_t *S)
 {
-    if (!hi2c) return;
+    if (!S || !S->bus) return;
+    I2C_HandleTypeDef *hi2c = S->bus;
 
     const ConfigTCS_t *T = CFG_TCS();                    // atime/gain startowe
-    tcs_write_u8(hi2c, REG_ENABLE,  0x03u);              // PON | AEN
-    tcs_write_u8(hi2c, REG_ATIME,   tcs_atime_from_ms(T->atime_ms));
-    tcs_write_u8(hi2c, REG_CONTROL, tcs_gain_to_reg(T->gain));
-
-    if (hi2c == tcs_right) {                             // reset stanu (Right)
-        s_right.gain = T->gain;
-        s_right.ema_c = s_right.ema_r = s_right.ema_g = s_right.ema_b = 0.0f;
-        s_right.ema_init = 0u;
-    } else if (hi2c == tcs_left) {                       // reset stanu (Left)
-        s_left.gain  = T->gain;
-        s_left.ema_c = s_left.ema_r = s_left.ema_g = s_left.ema_b = 0.0f;
-        s_left.ema_init = 0u;
-    }
+    tcs_write_u8(hi2c, REG_ENABLE,  ENABLE_PON | ENABLE_AEN | ENABLE_AIEN);
+    tcs_write_u8(hi2c, REG_PERS,    0x00u);              // AINT po każdej integracji
+
+    /* zakres ATIME dla drabinki (min ≤ max) */
+    S->a_min = tcs_atime_idx_from_ms((float)T->atime_min_ms);
+    S->a_max = tcs_atime_idx_from_ms((float)T->atime_max_ms);
+    if (S->a_max < S->a_min) S->a_max = S->a_min;
+
+    S->step = tcs_step_from_cfg(S, T);                   // start możliwie blisko configu
+    S->gain = tcs_step_gain(S, S->step);
+    tcs_write_u8(hi2c, REG_ATIME,   tcs_atime_reg(tcs_step_atime(S, S->step)));
+    tcs_write_u8(hi2c, REG_CONTROL, tcs_gain_to_reg(S->gain));
+    tcs_clear_int(hi2c);                                 // start „na czysto”
+
+    S->ema_c = S->ema_r = S->ema_g = S->ema_b = 0.0f;    // reset stanu
+    S->ema_init = 0u; S->skip = 0u; S->pinned = 0u;
+    S->last_poll = HAL_GetTick();
+}
+
+/* --- Tryb szybki (detektor krawędzi): stały krótki ATIME + stały gain --- */
+void TCS3472_SetFastClear(TCS3472_t *S, uint8_t atime_cycles, TCS_Gain_t gain)
+{
+    if (!S || !S->bus) return;
+
+    const uint8_t idx = tcs_atime_idx_from_ms((float)atime_cycles * TCS_CYCLE_MS);
+    S->a_min = S->a_max = idx;                           // drabinka = tylko ten ATIME
+    S->step   = (uint8_t)gain;                           // krok k<4 ≡ gain przy a_min
+    S->gain   = gain;
+    S->pinned = 1u;
+    tcs_write_u8(S->bus, REG_ATIME,   tcs_atime_reg(idx));
+    tcs_write_u8(S->bus, REG_CONTROL, tcs_gain_to_reg(gain));
+    tcs_clear_int(S->bus);
+
+    S->ema_c = S->ema_r = S->ema_g = S->ema_b = 0.0f;    // nowa skala → EMA od zera
+    S->ema_init = 0u; S->skip = 1u;
 }
 
-/* --- Init Right/Left (API bez zmian) --- */
-void TCS3472_Right_Init(I2C_HandleTypeDef *hi2c1)
+/* --- Szybki odczyt samego Clear (2 B, auto-increment; bez STATUS) ---
+ *  Dla trybu szybkiego: czujnik integruje ciągle, a odczyt co ≥ ATIME daje świeże dane.
+ *  Odczyt CDATAL zatrzaskuje CDATAH → para LSB/MSB spójna.
+ */
+uint8_t TCS3472_ReadClear(TCS3472_t *dev, uint16_t *clear)
 {
-    tcs_right = hi2c1; s_right.bus = hi2c1; s_right.gain = CFG_TCS()->gain;
-    s_right.ema_c = s_right.ema_r = s_right.ema_g = s_right.ema_b = 0.0f; s_right.ema_init = 0u;
-    TCS3472_Config(hi2c1);
+    if (!dev || !dev->bus || !clear) return 0u;
+    I2C_HandleTypeDef *hi2c = dev->bus;
+
+    uint8_t reg = CMD_AUTO(REG_CDATAL);
+    uint8_t buf[2];
+    if (HAL_I2C_Master_Transmit(hi2c, TCS3472_ADDR, &reg, 1, 5u) != HAL_OK) return 0u;
+    if (HAL_I2C_Master_Receive (hi2c, TCS3472_ADDR, buf, sizeof(buf), 5u) != HAL_OK) return 0u;
+
+    *clear = (uint16_t)(buf[0] | (buf[1] << 8));
+    return 1u;
 }
-void TCS3472_Left_Init(I2C_HandleTypeDef *hi2c3)
+
+/* --- Init instancji: bus + nazwa, reset stanu, konfiguracja rejestrów --- */
+void TCS3472_Init(TCS3472_t *dev, I2C_HandleTypeDef *hi2c, const char *name)
 {
-    tcs_left  = hi2c3; s_left.bus  = hi2c3; s_left.gain  = CFG_TCS()->gain;
-    s_left.ema_c  = s_left.ema_r  = s_left.ema_g  = s_left.ema_b  = 0.0f;  s_left.ema_init  = 0u;
-    TCS3472_Config(hi2c3);
+    if (!dev) return;
+    memset(dev, 0, sizeof(*dev));
+    dev->bus     = hi2c;
+    dev->name    = name ? name : "?";
+    dev->gain    = CFG_TCS()->gain;
+    dev->rate_t0 = HAL_GetTick();
+    TCS3472_Config(dev);
 }
 
 /* --- EMA helper --- */
 static inline float ema_update(float y, float x, float a) { return y + a * (x - y); }
 
-/* --- Rdzeń: odczyt + auto-gain + EMA --- */
-static TCS3472_Data_t TCS3472_Process(TCS_State_t *S)
+/* --- Poll: STATUS → 1 = zakończona integracja (AVALID + AINT) --- */
+uint8_t TCS3472_Poll(TCS3472_t *S)
+{
+    if (!S || !S->bus) return 0u;
+
+    /* efektywna częstość nowych próbek (okno TCS_RATE_WIN_MS) */
+    const uint32_t now = HAL_GetTick();
+    const uint32_t dt  = (uint32_t)(now - S->rate_t0);
+    if (dt >= TCS_RATE_WIN_MS) {
+        S->last.rate_hz = (float)S->rate_cnt * 1000.0f / (float)dt;
+        S->rate_cnt = 0u;
+        S->rate_t0  = now;
+    }
+
+    S->poll_prev = S->last_poll;            // do latency (czas „czekania” AINT)
+    S->last_poll = now;
+
+    const uint8_t st = tcs_read_status(S->bus);
+    return ((st & (STATUS_AVALID | STATUS_AINT)) == (STATUS_AVALID | STATUS_AINT)) ? 1u : 0u;
+}
+
+/* --- Process: EMA + auto-gain/ATIME na surowej próbce (bez odczytu I²C; SRAM2) --- */
+RAMFUNC TCS3472_Data_t TCS3472_Process(TCS3472_t *S, const TCS3472_Data_t *rawp)
 {
     TCS3472_Data_t out = (TCS3472_Data_t){0};
-    if (!S || !S->bus) return out;
+    const TCS3472_Data_t raw = *rawp;
+    const uint32_t now = S->last_poll;
 
     /* parametry tuningu z configu (mogą być nadpisane) */
     const float a = CFG_TCS_EMA_Alpha();
@@ -183,24 +343,15 @@ static TCS3472_Data_t TCS3472_Process(TCS_State_t *S)
     if (lo < 0.05f) lo = 0.05f;             // sanity
     if (hi > 0.95f) hi = 0.95f;
     if (hi < lo + 0.02f) hi = lo + 0.02f;   // min. 2% histerezy
-    const uint32_t thr_lo = (uint32_t)(lo * (float)TCS_FS_16 + 0.5f);
-    const uint32_t thr_hi = (uint32_t)(hi * (float)TCS_FS_16 + 0.5f);
-
-    /* surowy odczyt */
-    const TCS3472_Data_t raw = tcs_read_raw(S->bus);
-
-    /* auto-gain (Clear) */
-    if (raw.clear > thr_hi) {
-        if      (S->gain == TCS_GAIN_16X) tcs_set_gain(S, TCS_GAIN_4X);
-        else if (S->gain == TCS_GAIN_4X)  tcs_set_gain(S, TCS_GAIN_1X);
-        else if (S->gain == TCS_GAIN_1X)  { /* min */ }
-        else /*60X*/                      tcs_set_gain(S, TCS_GAIN_16X); // zejście z 60×
-    } else if (raw.clear < thr_lo) {
-        if      (S->gain == TCS_GAIN_1X)  tcs_set_gain(S, TCS_GAIN_4X);
-        else if (S->gain == TCS_GAIN_4X)  tcs_set_gain(S, TCS_GAIN_16X);
-        else if (S->gain == TCS_GAIN_16X) tcs_set_gain(S, TCS_GAIN_60X);
-        else /*60X*/                      { /* max */ }
-    }
+
+    /* metadane próbki — zanim krok się zmieni (dotyczą TEJ integracji) */
+    const TCS_Gain_t smp_gain  = S->gain;
+    const float      smp_itime = tcs_atime_ms(tcs_step_atime(S, S->step));
+    uint32_t lat = (uint32_t)(smp_itime + 0.5f) + (uint32_t)(now - S->poll_prev);
+    if (lat > 0xFFFFu) lat = 0xFFFFu;
+
+    /* decyzja auto-gain/ATIME na surowym Clear (EMA nie opóźnia reakcji) */
+    const uint16_t raw_clear = raw.clear;
 
     /* EMA (pierwsza próbka = init bez opóźnienia) */
     if (!S->ema_init) {
@@ -218,9 +369,71 @@ static TCS3472_Data_t TCS3472_Process(TCS_State_t *S)
     out.red   = (uint16_t)(S->ema_r < 0.0f ? 0.0f : (S->ema_r > (float)TCS_FS_16 ? (float)TCS_FS_16 : S->ema_r));
     out.green = (uint16_t)(S->ema_g < 0.0f ? 0.0f : (S->ema_g > (float)TCS_FS_16 ? (float)TCS_FS_16 : S->ema_g));
     out.blue  = (uint16_t)(S->ema_b < 0.0f ? 0.0f : (S->ema_b > (float)TCS_FS_16 ? (float)TCS_FS_16 : S->ema_b));
+    out.fresh      = 1u;
+    out.rate_hz    = S->last.rate_hz;
+    out.gain       = smp_gain;
+    out.itime_ms   = smp_itime;
+    out.latency_ms = (uint16_t)lat;
+
+    /* wspólny auto-gain + auto-ATIME — po EMA, by reskalować ją na nowy krok */
+    tcs_set_step(S, tcs_pick_step(S, raw_clear, lo, hi));
+    S->last     = out;
+    S->rate_cnt++;
     return out;
 }
 
-/* publiczne odczyty */
-TCS3472_Data_t TCS3472_Right_Read(void) { return TCS3472_Process(&s_right); }
-TCS3472_Data_t TCS3472_Left_Read (void) { return TCS3472_Process(&s_left);  }
+/* --- Complete: burst + auto-gain/ATIME + EMA (po Poll()=1) --- */
+TCS3472_Data_t TCS3472_Complete(TCS3472_t *S)
+{
+    TCS3472_Data_t out = (TCS3472_Data_t){0};
+    if (!S || !S->bus) return out;
+
+    TCS3472_Data_t raw = (TCS3472_Data_t){0};
+    if (!tcs_read_raw(S->bus, &raw)) {
+        out = S->last;
+        out.fresh = 0u;
+        return out;
+    }
+    tcs_clear_int(S->bus);                  // potwierdź — czekamy na kolejną integrację
+
+    if (S->skip) {                          // integracja po zmianie gain/ATIME → odrzuć
+        S->skip--;
+        out = S->last;
+        out.fresh = 0u;
+        return out;
+    }
+
+    const uint32_t t0 = Prof_Cycles();
+    out = TCS3472_Process(S, &raw);
+    RamFn_Add(RAMFN_TCS, Prof_Cycles() - t0);
+    return out;
+}
+
+/* --- Read: Poll + Complete w jednym (brak nowej integracji → ostatni wynik, fresh=0) --- */
+TCS3472_Data_t TCS3472_Read(TCS3472_t *S)
+{
+    if (S && TCS3472_Poll(S)) return TCS3472_Complete(S);
+
+    TCS3472_Data_t out = S ? S->last : (TCS3472_Data_t){0};
+    out.fresh = 0u;
+    return out;
+}
+
+#ifdef DZB_BENCH
+/* --- Akcesor benchmarku (bench.c): wybór kroku na pełnej drabince (bez I²C) --- */
+uint32_t TCS3472_BenchPickStep(uint32_t n)
+{
+    TCS3472_t S;
+    memset(&S, 0, sizeof(S));
+    S.a_min = 0u;
+    S.a_max = (uint8_t)(sizeof(k_atime_cycles) - 1u);
+
+    uint32_t acc = 0u, x = 3u;
+    for (uint32_t i = 0; i < n; ++i) {
+        x = x * 1103515245u + 12345u;
+        S.step = (uint8_t)(i % tcs_step_count(&S));
+        acc += tcs_pick_step(&S, (uint16_t)(x >> 16), 0.60f, 0.70f);
+    }
+    return acc;
+}
+#endif /* DZB_BENCH */
@@ -7,6 +7,10 @@
  *    • Temperatura w I²C jest w setnych °C → tempC = (int16_t(TEMP) / 100.0f).
  *    • Filtry: MED (distance) + MA (strength) wg okien z config.c (1..5; MED nieparzyste).
  *    • Zwracamy °C zaokrąglone do 0.1°C (bez <math.h>).
+ *    • Tryb trigger (opcjonalny): MODE=1 (0x23), pomiar na zapis TRIG_ONE_SHOT (0x24).
+ *      Czas triggera trzymamy per czujnik → age_ms = odczyt − trigger (deterministyczny).
+ *    • Instancje TF_Luna_t: adres 7-bit + offset + filtry per czujnik (brak statycznych
+ *      „Right/Left” w driverze). Provisioning adresu: 0x22 (SLAVE_ADDR) → 0x20 SAVE → 0x21 REBOOT.
  *
  *  PO CO:
  *    • Prościej, krócej, czytelniej — zero nieużywanych ścieżek (burst/CRC/auto-detect/reset).
@@ -18,34 +22,85 @@
 #include <string.h>          // memset
 #include "stm32l4xx_hal.h"   // HAL I2C, HAL_Delay (krótka przerwa między próbami)
 
-/* ───────────── Adres i time-outy I²C ───────────── */
-#define TFLUNA_ADDR            (0x10u << 1)   /* 7-bit 0x10 → 8-bit dla HAL */
+/* ───────────── Time-outy I²C ───────────── */
 #define TFLUNA_TRIES           3u             /* ile prób odczytu rejestrów */
 #define TFLUNA_TO_TX           10u            /* timeout TX (ms)            */
 #define TFLUNA_TO_RX           10u            /* timeout RX (ms)            */
+#define TFLUNA_HAL_ADDR(a7)    ((uint16_t)((a7) << 1)) /* 7-bit → 8-bit dla HAL */
+
+/* ───────────── Rejestry konfiguracyjne (trigger / adres) ───────────── */
+#define TFLUNA_REG_SAVE        0x20u          /* zapis 0x01 → zapis ustawień do flash  */
+#define TFLUNA_REG_REBOOT      0x21u          /* zapis 0x02 → restart układu            */
+#define TFLUNA_REG_SLAVE_ADDR  0x22u          /* nowy adres 7-bit (0x08..0x77)          */
+#define TFLUNA_REG_MODE        0x23u          /* 0x00 = ciągły, 0x01 = trigger */
+#define TFLUNA_REG_TRIG        0x24u          /* zapis 0x01 → jeden pomiar     */
+#define TFLUNA_REBOOT_MS       100u           /* czas restartu po REBOOT (ms)           */
+
+/* ───────────── Zapis jednego rejestru [reg, val] ───────────── */
+static uint8_t tfluna_write_reg(I2C_HandleTypeDef *hi2c, uint8_t addr7, uint8_t reg, uint8_t val)
+{
+    if (!hi2c) return 0u;
+    uint8_t cmd[2] = { reg, val };
+    return (HAL_I2C_Master_Transmit(hi2c, TFLUNA_HAL_ADDR(addr7), cmd, 2, TFLUNA_TO_TX) == HAL_OK) ? 1u : 0u;
+}
 
-/* ───────────── Uchwyt I²C dla prawego/lewego czujnika ───────────── */
-static I2C_HandleTypeDef *luna_right = NULL;  /* I2C1: prawa TF-Luna  */
-static I2C_HandleTypeDef *luna_left  = NULL;  /* I2C3: lewa  TF-Luna  */
+void TF_Luna_SetTriggerMode(TF_Luna_t *dev, uint8_t enable)
+{
+    if (!dev) return;
+    (void)tfluna_write_reg(dev->hi2c, dev->addr7, TFLUNA_REG_MODE, enable ? 0x01u : 0x00u);
+}
 
-void TF_Luna_Right_Init(I2C_HandleTypeDef *hi2c1) { luna_right = hi2c1; }  /* zapamiętaj I²C1 */
-void TF_Luna_Left_Init (I2C_HandleTypeDef *hi2c3) { luna_left  = hi2c3; }  /* zapamiętaj I²C3 */
+/* Init: zapamiętaj bus/adres/offset, wyzeruj filtry + ustaw tryb wg config (ciągły/trigger) */
+void TF_Luna_Init(TF_Luna_t *dev, I2C_HandleTypeDef *hi2c, uint8_t addr7,
+                  int16_t dist_offset_mm, const char *name)
+{
+    if (!dev) return;
+    memset(dev, 0, sizeof(*dev));
+    dev->hi2c           = hi2c;
+    dev->addr7          = addr7;
+    dev->dist_offset_mm = dist_offset_mm;
+    dev->name           = name ? name : "?";
+    TF_Luna_SetTriggerMode(dev, CFG_Luna()->trigger_mode);
+}
 
-/* ───────────── Proste filtry: MED/MA w buforze pierścieniowym ───────────── */
-#define WIN_MAX 5u
+/* ───────────── Trigger one-shot: zapis 0x24 + znacznik czasu ───────────── */
+void TF_Luna_Trigger(TF_Luna_t *dev)
+{
+    if (!dev || !dev->hi2c) return;
+    if (tfluna_write_reg(dev->hi2c, dev->addr7, TFLUNA_REG_TRIG, 0x01u)) {
+        dev->filt.trig_ts      = HAL_GetTick();           /* start pomiaru ≈ teraz   */
+        dev->filt.trig_pending = 1u;
+    }
+}
 
-typedef struct {
-    uint16_t dist_hist[WIN_MAX];  /* historia dystansu (dla mediany)            */
-    uint16_t str_hist [WIN_MAX];  /* historia siły (dla średniej)               */
-    uint8_t  count;               /* ile wpisów mamy (<= WIN_MAX)               */
-    uint8_t  idx;                 /* indeks do nadpisania (ring buffer)         */
-    float    last_tempC;          /* ostatnia dobra temperatura (°C)            */
-    uint16_t last_med;            /* ostatnia mediana dystansu (cm)             */
-    uint16_t last_ma;             /* ostatnia średnia siły (raw)                */
-} tfluna_filt_t;
+/* ───────────── Provisioning adresu (blokujące, tylko serwis/start) ───────────── */
+uint8_t TF_Luna_IsPresent(I2C_HandleTypeDef *hi2c, uint8_t addr7)
+{
+    if (!hi2c) return 0u;
+    return (HAL_I2C_IsDeviceReady(hi2c, TFLUNA_HAL_ADDR(addr7), 2u, 2u) == HAL_OK) ? 1u : 0u;
+}
 
-static tfluna_filt_t filt_right = {0};  /* stan filtrów: prawy czujnik */
-static tfluna_filt_t filt_left  = {0};  /* stan filtrów: lewy  czujnik */
+uint8_t TF_Luna_ProvisionAddr(I2C_HandleTypeDef *hi2c, uint8_t from_addr7, uint8_t new_addr7)
+{
+    if (!hi2c) return 0u;
+    if (new_addr7 < 0x08u || new_addr7 > 0x77u) return 0u;   /* zakres dozwolony przez TF-Luna */
+    if (from_addr7 == new_addr7) return TF_Luna_IsPresent(hi2c, new_addr7);
+
+    if (!tfluna_write_reg(hi2c, from_addr7, TFLUNA_REG_SLAVE_ADDR, new_addr7)) return 0u;
+    HAL_Delay(10);
+    /* Po zmianie adresu układ odpowiada już pod nowym — SAVE/REBOOT wysyłamy tam,
+       a w razie NACK próbujemy jeszcze pod starym (zależnie od wersji firmware). */
+    if (!tfluna_write_reg(hi2c, new_addr7, TFLUNA_REG_SAVE, 0x01u)) {
+        (void)tfluna_write_reg(hi2c, from_addr7, TFLUNA_REG_SAVE, 0x01u);
+    }
+    HAL_Delay(10);
+    if (!tfluna_write_reg(hi2c, new_addr7, TFLUNA_REG_REBOOT, 0x02u)) {
+        (void)tfluna_write_reg(hi2c, from_addr7, TFLUNA_REG_REBOOT, 0x02u);
+    }
+    HAL_Delay(TFLUNA_REBOOT_MS);
+
+    return TF_Luna_IsPresent(hi2c, new_addr7);
+}
 
 /* ───────────── Pomocnicze: zaokrąglenie do 0.1°C ───────────── */
 static float round_01(float v)
@@ -59,15 +114,16 @@ static float round_01(float v)
 /* ───────────── Proste MED/MA (bez <math.h>) ───────────── */
 static uint16_t median_u16(const uint16_t *arr, uint8_t n)
 {
-    uint16_t tmp[WIN_MAX];                   /* lokalna kopia do sortowania           */
-    for (uint8_t i = 0; i < n; ++i) tmp[i] = arr[i];
-    for (uint8_t i = 1; i < n; ++i) {        /* sortowanie wstawieniowe               */
-        uint16_t key = tmp[i];
-        int j = (int)i - 1;
-        while (j >= 0 && tmp[j] > key) { tmp[j + 1] = tmp[j]; j--; }
-        tmp[j + 1] = key;
+    uint16_t tmp[TFLUNA_WIN_MAX] = {0};      /* posortowana kopia (n ≤ TFLUNA_WIN_MAX) */
+    if (n == 0u) return 0u;
+    if (n > TFLUNA_WIN_MAX) n = TFLUNA_WIN_MAX;
+    for (uint8_t i = 0; i < n; ++i) {        /* wstawianie już przy kopiowaniu        */
+        const uint16_t key = arr[i];
+        uint8_t j = i;
+        while (j > 0u && tmp[j - 1u] > key) { tmp[j] = tmp[j - 1u]; j--; }
+        tmp[j] = key;
     }
-    return tmp[n / 2];                       /* element środkowy                      */
+    return tmp[n / 2u];                      /* element środkowy                      */
 }
 
 static uint16_t mean_u16(const uint16_t *arr, uint8_t n)
@@ -78,27 +134,27 @@ static uint16_t mean_u16(const uint16_t *arr, uint8_t n)
 }
 
 /* ───────────── Aktualizacja filtrów wg okien z config.c ─────────────
- *  MED: wymuszamy okno nieparzyste; oba okna CLAMP do 1..WIN_MAX (1..5).
+ *  MED: wymuszamy okno nieparzyste; oba okna CLAMP do 1..TFLUNA_WIN_MAX (1..5).
  */
-static void filt_update_cfg(tfluna_filt_t *f, uint16_t dist, uint16_t str,
+static void filt_update_cfg(TF_LunaFilt_t *f, uint16_t dist, uint16_t str,
                             uint16_t *out_med, uint16_t *out_ma)
 {
     const ConfigLuna_t *L = CFG_Luna();      /* pobierz okna filtrów                   */
 
     uint8_t wmed = L->median_win;            /* okno mediany                           */
     if (wmed < 1u) wmed = 1u;
-    if (wmed > WIN_MAX) wmed = WIN_MAX;
+    if (wmed > TFLUNA_WIN_MAX) wmed = TFLUNA_WIN_MAX;
     if ((wmed & 1u) == 0u) wmed--;           /* mediana wymaga okna nieparzystego      */
 
     uint8_t wma = L->ma_win;                 /* okno średniej kroczącej                */
     if (wma < 1u) wma = 1u;
-    if (wma > WIN_MAX) wma = WIN_MAX;
+    if (wma > TFLUNA_WIN_MAX) wma = TFLUNA_WIN_MAX;
 
     f->dist_hist[f->idx] = dist;             /* wpisz nowe wartości do buforów         */
     f->str_hist [f->idx] = str;
 
-    if (f->count < WIN_MAX) f->count++;      /* zwiększ licznik do maks. okna          */
-    f->idx = (uint8_t)((f->idx + 1u) % WIN_MAX); /* pierścieniowo                      */
+    if (f->count < TFLUNA_WIN_MAX) f->count++;      /* zwiększ licznik do maks. okna          */
+    f->idx = (uint8_t)((f->idx + 1u) % TFLUNA_WIN_MAX); /* pierścieniowo                      */
 
     uint8_t nmed = (f->count < wmed) ? f->count : wmed; /* realna liczba próbek */
     uint8_t nma  = (f->count < wma ) ? f->count : wma;
@@ -113,19 +169,39 @@ static void filt_update_cfg(tfluna_filt_t *f, uint16_t dist, uint16_t str,
     if (out_ma)  *out_ma  = ma;
 }
 
+/* ───────────── Offset instancji: mm → cm (dystans TF-Luna jest w cm) ───────────── */
+static uint16_t tfluna_apply_offset(uint16_t dist_cm, int16_t offset_mm)
+{
+    if (dist_cm == 0u) return 0u;             /* 0 = brak echa — offset nie tworzy celu */
+    const int32_t off_cm = ((int32_t)offset_mm + (offset_mm >= 0 ? 5 : -5)) / 10;  /* zaokrąglenie */
+    int32_t v = (int32_t)dist_cm + off_cm;
+    if (v < 0) {
+        v = 0;
+    }
+    if (v > 65535) {
+        v = 65535;
+    }
+    return (uint16_t)v;
+}
+
 /* ───────────── Odczyt rejestrowy 0x00..0x05 (1 próba) ───────────── */
-static uint8_t tfluna_read_regs_once(I2C_HandleTypeDef *hi2c, TF_LunaData_t *out, tfluna_filt_t *fs)
+static uint8_t tfluna_read_regs_once(TF_Luna_t *dev, TF_LunaData_t *out)
 {
-    if (!hi2c || !out || !fs) return 0u;     /* zabezpieczenie argumentów              */
+    if (!dev || !dev->hi2c || !out) return 0u; /* zabezpieczenie argumentów            */
+
+    I2C_HandleTypeDef *hi2c = dev->hi2c;
+    TF_LunaFilt_t     *fs   = &dev->filt;
+    const uint16_t     addr = TFLUNA_HAL_ADDR(dev->addr7);
 
     uint8_t reg  = 0x00u;                    /* start od 0x00                          */
     uint8_t data[6] = {0};                   /* 0..5: D_L,D_H,A_L,A_H,T_L,T_H          */
 
-    if (HAL_I2C_Master_Transmit(hi2c, TFLUNA_ADDR, &reg, 1, TFLUNA_TO_TX) != HAL_OK) return 0u;
-    if (HAL_I2C_Master_Receive (hi2c, TFLUNA_ADDR, data, sizeof(data), TFLUNA_TO_RX) != HAL_OK) return 0u;
+    if (HAL_I2C_Master_Transmit(hi2c, addr, &reg, 1, TFLUNA_TO_TX) != HAL_OK) return 0u;
+    if (HAL_I2C_Master_Receive (hi2c, addr, data, sizeof(data), TFLUNA_TO_RX) != HAL_OK) return 0u;
 
     /* Złóż słowa 16-bit z par bajtów (LOW|HIGH<<8) */
     uint16_t dist     = (uint16_t)(data[0] | (data[1] << 8));  /* dystans [cm]  */
+    dist = tfluna_apply_offset(dist, dev->dist_offset_mm);      /* offset instancji przed filtrami */
     uint16_t strength = (uint16_t)(data[2] | (data[3] << 8));  /* siła   [raw]  */
     int16_t  traw     = (int16_t)(data[4] | (data[5] << 8));   /* temp [0.01°C] */
 
@@ -156,14 +232,25 @@ static uint8_t tfluna_read_regs_once(I2C_HandleTypeDef *hi2c, TF_LunaData_t *out
  *  Jeśli wszystkie próby padną, zwracamy ostatnie przefiltrowane
  *  wartości i ostatnią temp. (frameReady=0), aby UI nie „skakało”.
  */
-static TF_LunaData_t TF_Luna_Read_Generic(I2C_HandleTypeDef *hi2c, tfluna_filt_t *fs)
+TF_LunaData_t TF_Luna_Read(TF_Luna_t *dev)
 {
     TF_LunaData_t out;                         /* lokalna struktura wynikowa           */
     memset(&out, 0, sizeof(out));              /* wyzeruj przed użyciem                */
-    if (!hi2c || !fs) return out;              /* brak uchwytu → pusta ramka           */
+    out.age_ms = TFLUNA_AGE_UNKNOWN;
+    if (!dev || !dev->hi2c) return out;        /* brak uchwytu → pusta ramka           */
+
+    TF_LunaFilt_t *fs = &dev->filt;
 
     for (uint8_t i = 0; i < TFLUNA_TRIES; ++i) {
-        if (tfluna_read_regs_once(hi2c, &out, fs)) return out;  /* sukces → zwróć  */
+        if (tfluna_read_regs_once(dev, &out)) {                 /* sukces → zwróć  */
+            out.timestamp = HAL_GetTick();
+            if (fs->trig_pending) {                             /* wiek = od triggera */
+                const uint32_t age = (uint32_t)(out.timestamp - fs->trig_ts);
+                out.age_ms = (age < TFLUNA_AGE_UNKNOWN) ? (uint16_t)age : (uint16_t)(TFLUNA_AGE_UNKNOWN - 1u);
+                fs->trig_pending = 0u;
+            }
+            return out;
+        }
         HAL_Delay(2);                                           /* krótka przerwa  */
     }
 
@@ -172,52 +259,11 @@ static TF_LunaData_t TF_Luna_Read_Generic(I2C_HandleTypeDef *hi2c, tfluna_filt_t
     out.strength_filt = fs->last_ma;
     out.temperature   = (fs->last_tempC == 0.0f) ? 25.0f : fs->last_tempC;
     out.frameReady    = 0u;
+    out.timestamp     = HAL_GetTick();
+    fs->trig_pending  = 0u;                    /* pomiar stracony — nowy trigger w kolejnym ticku */
     return out;
 }
 
-/* ───────────── Publiczne API: aliasy prawa/lewa + offsety z config ───────────── */
-TF_LunaData_t TF_Luna_Right_Read(void)
-{
-    TF_LunaData_t d = TF_Luna_Read_Generic(luna_right, &filt_right);
-
-    /* BYŁO:
-       int32_t v = (int32_t)d.distance + (int32_t)CFG_Luna()->dist_offset_right_mm;
-       if (v < 0) v = 0; if (v > 65535) v = 65535;
-       d.distance = (uint16_t)v;
-    */
-
-    int32_t v = (int32_t)d.distance + (int32_t)CFG_Luna()->dist_offset_right_mm;
-    if (v < 0) {
-        v = 0;
-    }
-    if (v > 65535) {
-        v = 65535;
-    }
-    d.distance = (uint16_t)v;
-    return d;
-}
-
-TF_LunaData_t TF_Luna_Left_Read(void)
-{
-    TF_LunaData_t d = TF_Luna_Read_Generic(luna_left, &filt_left);
-
-    /* BYŁO:
-       int32_t v = (int32_t)d.distance + (int32_t)CFG_Luna()->dist_offset_left_mm;
-       if (v < 0) v = 0; if (v > 65535) v = 65535;
-       d.distance = (uint16_t)v;
-    */
-
-    int32_t v = (int32_t)d.distance + (int32_t)CFG_Luna()->dist_offset_left_mm;
-    if (v < 0) {
-        v = 0;
-    }
-    if (v > 65535) {
-        v = 65535;
-    }
-    d.distance = (uint16_t)v;
-    return d;
-}
-
 /* ============================================================================
  *  TF_Luna_AmbientEstimateC
  *  ----------------------------------------------------------------------------
@@ -256,3 +302,32 @@ float TF_Luna_AmbientEstimateC(const TF_LunaData_t *d)
     int tenths = (int)(t * 10.0f + sign * 0.5f);   /* zaokrągl do najbliższej 0.1        */
     return (float)tenths / 10.0f;                  /* wynik w °C z dokładnością 0.1      */
 }
+
+#ifdef DZB_BENCH
+/* ───────────── Akcesory benchmarków (bench.c) ───────────── */
+uint32_t TF_Luna_BenchMedian(uint32_t n)
+{
+    uint16_t win[TFLUNA_WIN_MAX] = { 120u, 80u, 300u, 95u, 101u };
+    uint32_t acc = 0u, x = 1u;
+    for (uint32_t i = 0; i < n; ++i) {
+        x = x * 1103515245u + 12345u;                 /* LCG: zmienne dane wejściowe */
+        win[i % TFLUNA_WIN_MAX] = (uint16_t)((x >> 16) & 0x3FFu);
+        acc += median_u16(win, TFLUNA_WIN_MAX);
+    }
+    return acc;
+}
+
+uint32_t TF_Luna_BenchFilter(uint32_t n)
+{
+    TF_LunaFilt_t f;
+    memset(&f, 0, sizeof(f));
+    uint32_t acc = 0u, x = 7u;
+    uint16_t med = 0u, ma = 0u;
+    for (uint32_t i = 0; i < n; ++i) {
+        x = x * 1103515245u + 12345u;
+        filt_update_cfg(&f, (uint16_t)((x >> 16) & 0x3FFu), (uint16_t)(x >> 20), &med, &ma);
+        acc += (uint32_t)med + ma;
+    }
+    return acc;
+}
+#endif /* DZB_BENCH */
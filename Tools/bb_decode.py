@@ -0,0 +1,125 @@
+#!/usr/bin/env python3
+"""
+bb_decode.py — dekoder surowego zrzutu czarnej skrzynki ("bb raw" w shellu UART).
+
+Użycie:
+    bb_decode.py capture.txt            # log terminala z liniami "BBX ..."
+    bb_decode.py < capture.txt          # ze stdin
+Wyjście: CSV (te same kolumny co "bb dump").
+
+Linia zrzutu: "BBX <blok> <offset> <hex>" — bloki od najstarszego.
+Blok:   [len u16 LE][nrec u8][rsv u8] + rekordy (len = bajty z nagłówkiem).
+Rekord: [maska varint] + dla każdego bitu 1: [zigzag varint (wartość − predykcja)].
+    Predykcja: pierwszy rekord bloku → 0; dalej poprzedni rekord,
+    dla czasu t_ms: t_poprz + (t_poprz − t_poprzpoprz).
+Kolejność pól (bit 0..14) jak rec_to_vec() w Core/Src/blackbox.c.
+"""
+
+import sys
+
+# (nazwa, bity, ze znakiem) — kolejność kodowania
+FIELDS = [
+    ("t_ms", 32, False),
+    ("lunaR", 16, False), ("lunaL", 16, False),
+    ("clrR", 16, False), ("clrL", 16, False),
+    ("tank_us", 16, False), ("loop_us", 16, False),
+    ("curL", 8, True), ("curR", 8, True),
+    ("tgtL", 8, True), ("tgtR", 8, True),
+    ("escR", 16, False), ("escL", 16, False),
+    ("dt", 16, False), ("flags", 8, False),
+]
+COLUMNS = ["t_ms", "tgtL", "tgtR", "curL", "curR", "escR", "escL",
+           "lunaR", "lunaL", "clrR", "clrL", "dt", "tank_us", "loop_us", "flags"]
+HDR = 4
+M32 = 0xFFFFFFFF
+
+
+def varint(buf, pos):
+    val, shift = 0, 0
+    while True:
+        if pos >= len(buf) or shift >= 35:
+            raise ValueError("urwany varint")
+        b = buf[pos]
+        pos += 1
+        val |= (b & 0x7F) << shift
+        if not b & 0x80:
+            return val, pos
+        shift += 7
+
+
+def unzigzag(u):
+    return (u >> 1) ^ -(u & 1)
+
+
+def as_field(v, bits, signed):
+    v &= (1 << bits) - 1
+    if signed and v >= 1 << (bits - 1):
+        v -= 1 << bits
+    return v
+
+
+def decode_block(blk):
+    """Zwraca listę rekordów (dict) z jednego bloku."""
+    n = blk[0] | (blk[1] << 8)
+    nrec = blk[2]
+    if n < HDR or n > len(blk):
+        raise ValueError(f"zla dlugosc bloku {n}")
+    prev = [0] * len(FIELDS)
+    dt = 0
+    pos, out = HDR, []
+    while pos < n:
+        mask, pos = varint(blk, pos)
+        v = []
+        for i in range(len(FIELDS)):
+            pred = (prev[0] + dt) & M32 if i == 0 else prev[i]
+            zz = 0
+            if mask >> i & 1:
+                zz, pos = varint(blk, pos)
+            v.append((pred + unzigzag(zz)) & M32)
+        dt = (v[0] - prev[0]) & M32
+        prev = v
+        out.append({name: as_field(x, bits, sg) for (name, bits, sg), x in zip(FIELDS, v)})
+    if len(out) != nrec:
+        print(f"# uwaga: blok deklaruje {nrec} rek., zdekodowano {len(out)}", file=sys.stderr)
+    return out
+
+
+def read_blocks(lines):
+    """Składa bloki z linii "BBX <blok> <offset> <hex>" (kolejność bloków zachowana)."""
+    blocks = {}
+    for line in lines:
+        parts = line.strip().split()
+        if len(parts) != 4 or parts[0] != "BBX":
+            continue
+        idx, off, data = int(parts[1]), int(parts[2]), bytes.fromhex(parts[3])
+        blk = blocks.setdefault(idx, bytearray())
+        if off != len(blk):
+            print(f"# uwaga: luka w bloku {idx} (offset {off}, mam {len(blk)})", file=sys.stderr)
+            blk.extend(b"\x00" * max(0, off - len(blk)))
+            del blk[off:]
+        blk.extend(data)
+    return [blocks[k] for k in sorted(blocks)]
+
+
+def main():
+    src = open(sys.argv[1], errors="replace") if len(sys.argv) > 1 else sys.stdin
+    blocks = read_blocks(src)
+    print(",".join(COLUMNS))
+    nrec, nbytes = 0, 0
+    for i, blk in enumerate(blocks):
+        try:
+            recs = decode_block(blk)
+        except ValueError as e:
+            print(f"# blok {i}: {e} — pominiety", file=sys.stderr)
+            continue
+        nrec += len(recs)
+        nbytes += len(blk)
+        for r in recs:
+            r["flags"] = f"{r['flags']:02X}"
+            print(",".join(str(r[c]) for c in COLUMNS))
+    if nrec:
+        print(f"# {nrec} rek., {nbytes} B ({nbytes / nrec:.1f} B/rek. vs 28 B surowo)", file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,156 @@
+#!/usr/bin/env python3
+"""
+bench.py — mikrobenchmarki czystej logiki (Core/Src/bench.c) na PC i porównanie z bazą.
+
+Host (domyślnie): kompiluje moduły z -DDZB_BENCH razem z Tools/host/ (zamiennik HAL),
+uruchamia i porównuje cyc/op z Tools/bench/baseline_host.txt:
+    bench.py                            # wszystkie przypadki, próg regresji 20%
+    bench.py --filter tank. --scale 200
+    bench.py --save                     # zapisz bieżący wynik jako bazę
+    bench.py --cflags "-O2 -march=native"
+
+Target: firmware z -DDZB_BENCH, w shellu "bench [prefiks]"; zapisany log UART:
+    bench.py --log uart.txt --baseline Tools/bench/baseline_target.txt [--save]
+
+Linie wyniku: "BENCH <case> <iters> <ns/op> <cyc/op>" (target: cykle DWT @SystemCoreClock,
+host: „cykl” = 1 ns, minimum z --runs uruchomień). Porównujemy cyc/op; kod wyjścia 1 =
+regresja ponad próg albo przypadek z bazy zniknął. Liczby hosta porównuj tylko z bazą
+z tej samej maszyny; na targecie DWT jest powtarzalny co do cykli, więc próg można zaostrzyć.
+"""
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+import tempfile
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+HOST_DIR = os.path.join(ROOT, "Tools", "host")
+BASE_HOST = os.path.join(ROOT, "Tools", "bench", "baseline_host.txt")
+
+# Moduły czystej logiki + ich zależności (bez HAL/UART — te daje Tools/host/)
+SOURCES = [
+    "Core/Src/bench.c", "Core/Src/tank_drive.c", "Core/Src/motor_bldc.c",
+    "Core/Src/throttle_map.c", "Core/Src/tf_luna_i2c.c", "Core/Src/tcs3472.c",
+    "Core/Src/ssd1306.c", "Core/Src/oled_panel.c", "Core/Src/config.c", "Core/Src/dzlog.c",
+    "Tools/host/host_port.c", "Tools/host/bench_main.c",
+]
+
+RE_LINE = re.compile(r'^BENCH\s+(\S+)\s+(\d+)\s+([\d.]+)\s+([\d.]+)\s*$')
+
+
+def parse(text):
+    """case → (iters, ns/op, cyc/op); linie '# ...' to nagłówki"""
+    out = {}
+    for line in text.splitlines():
+        m = RE_LINE.match(line.strip())
+        if m:
+            out[m.group(1)] = (int(m.group(2)), float(m.group(3)), float(m.group(4)))
+    return out
+
+
+def build_and_run(cc, cflags, prefix, scale, runs):
+    exe = os.path.join(tempfile.mkdtemp(prefix="dzb_bench_"), "bench_host")
+    cmd = [cc, "-std=gnu11", "-DDZB_BENCH", "-DDZB_RAMFUNC=0", "-I" + HOST_DIR,
+           "-I" + os.path.join(ROOT, "Core", "Inc")] + cflags.split()
+    cmd += [os.path.join(ROOT, s) for s in SOURCES] + ["-o", exe, "-lm"]
+    r = subprocess.run(cmd, capture_output=True, text=True)
+    if r.returncode != 0:
+        sys.exit("kompilacja nieudana:\n" + " ".join(cmd) + "\n" + r.stderr)
+    outs = []
+    for _ in range(max(1, runs)):
+        r = subprocess.run([exe, prefix, str(scale)], capture_output=True, text=True)
+        if r.returncode != 0:
+            sys.exit("bench_host: brak przypadków dla '%s'\n%s" % (prefix, r.stdout + r.stderr))
+        outs.append(r.stdout)
+    return outs
+
+
+def best_of(outs):
+    """minimum cyc/op z kilku uruchomień (szum planisty hosta)"""
+    best = {}
+    for text in outs:
+        for k, v in parse(text).items():
+            if k not in best or v[2] < best[k][2]:
+                best[k] = v
+    return best
+
+
+def compare(cur, base, threshold):
+    """wydruk tabeli; zwraca liczbę regresji (+ zaginionych przypadków)"""
+    bad = 0
+    print("%-20s %9s %10s %10s %10s %8s" % ("case", "iters", "ns/op", "cyc/op", "baza", "zmiana"))
+    for name, (it, ns, cyc) in cur.items():
+        if name in base and base[name][2] > 0.0:
+            ref = base[name][2]
+            d = (cyc - ref) / ref * 100.0
+            flag = ""
+            if d > threshold:
+                flag, bad = "  REGRESJA", bad + 1
+            elif d < -threshold:
+                flag = "  szybciej"
+            print("%-20s %9d %10.1f %10.1f %10.1f %+7.1f%%%s" % (name, it, ns, cyc, ref, d, flag))
+        else:
+            print("%-20s %9d %10.1f %10.1f %10s %8s" % (name, it, ns, cyc, "-", "nowy"))
+    for name in base:
+        if name not in cur:
+            print("%-20s %9s %10s %10s %10.1f %8s" % (name, "-", "-", "-", base[name][2], "BRAK"))
+            bad += 1
+    return bad
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Mikrobenchmarki bench.c (host lub log z targetu)")
+    ap.add_argument("--log", help="log UART z targetu (linie BENCH) zamiast builda hosta")
+    ap.add_argument("--baseline", help="plik bazy (domyślnie host: Tools/bench/baseline_host.txt)")
+    ap.add_argument("--save", action="store_true", help="zapisz wynik jako bazę")
+    ap.add_argument("--threshold", type=float, default=20.0, help="próg regresji cyc/op w %%")
+    ap.add_argument("--filter", default="", help="prefiks nazw przypadków (np. tank.)")
+    ap.add_argument("--scale", type=int, default=50, help="mnożnik iteracji na hoście")
+    ap.add_argument("--runs", type=int, default=5, help="uruchomień na hoście (minimum z nich)")
+    ap.add_argument("--cc", default=os.environ.get("CC", "gcc"))
+    ap.add_argument("--cflags", default="-O2")
+    args = ap.parse_args()
+
+    if args.log:
+        with open(args.log, encoding="utf-8", errors="replace") as fh:
+            text = fh.read()
+        cur = parse(text)
+        base_path = args.baseline
+    else:
+        outs = build_and_run(args.cc, args.cflags, args.filter, args.scale, args.runs)
+        text, cur = outs[0], best_of(outs)
+        base_path = args.baseline or BASE_HOST
+
+    if args.filter:
+        cur = {k: v for k, v in cur.items() if k.startswith(args.filter)}
+    if not cur:
+        sys.exit("brak linii BENCH w wyniku")
+
+    if args.save:
+        if not base_path:
+            sys.exit("--save z --log wymaga --baseline")
+        header = [l.strip() for l in text.splitlines() if l.strip().startswith("BENCH #")]
+        with open(base_path, "w", encoding="utf-8") as fh:
+            fh.write("\n".join(header + ["BENCH %-20s %7d %10.1f %10.1f" % (k, *v) for k, v in cur.items()]) + "\n")
+        print("baza zapisana: %s (%d przypadków)" % (os.path.relpath(base_path), len(cur)))
+        return
+
+    base = {}
+    if base_path and os.path.exists(base_path):
+        with open(base_path, encoding="utf-8") as fh:
+            base = parse(fh.read())
+        if args.filter:
+            base = {k: v for k, v in base.items() if k.startswith(args.filter)}
+    else:
+        print("(brak bazy — sam wynik; zapisz przez --save)")
+
+    bad = compare(cur, base, args.threshold)
+    if bad:
+        print("\n%d regresji/braków powyżej %.0f%%" % (bad, args.threshold))
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
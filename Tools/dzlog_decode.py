@@ -0,0 +1,150 @@
+#!/usr/bin/env python3
+"""
+dzlog_decode.py — dekoder strumienia UART z rekordami binarnymi dzlog (DZB_LOG_BINARY).
+
+Użycie:
+    dzlog_decode.py firmware.elf                 # strumień z stdin
+    dzlog_decode.py firmware.elf capture.bin     # z pliku
+    dzlog_decode.py firmware.elf /dev/ttyACM0    # z portu (wymaga pyserial), 115200 8N1
+
+Rekord: [0x00][len][ID lo][ID hi][argumenty: len B]
+    ID    = adres formatu w sekcji .dzlog (mod 2^16) — tabela formatów z ELF tego builda.
+    %d %i             → int32 LE
+    %u %x %X %o %c %p → uint32 LE
+    %f %e %g          → float32 LE
+    %s                → [n][n B]
+Pozostałe bajty (tekst panelu ANSI) przechodzą bez zmian.
+"""
+
+import re
+import struct
+import sys
+
+SYNC = 0x00
+SPEC = re.compile(r"%([-+ #0]*)(\d+|\*)?(?:\.(\d+))?(hh|h|ll|l|z|j|t|L)?([diouxXcsfFeEgGp%])")
+
+
+def load_formats(elf_path):
+    """Zwraca {ID: format} z sekcji .dzlog (ELF32/ELF64, LE/BE)."""
+    data = open(elf_path, "rb").read()
+    if data[:4] != b"\x7fELF":
+        raise SystemExit(f"{elf_path}: to nie jest plik ELF")
+    is64 = data[4] == 2
+    end = "<" if data[5] == 1 else ">"
+    if is64:
+        shoff, = struct.unpack_from(end + "Q", data, 0x28)
+        shentsize, shnum, shstrndx = struct.unpack_from(end + "HHH", data, 0x3A)
+        fmt = end + "IIQQQQIIQQ"
+    else:
+        shoff, = struct.unpack_from(end + "I", data, 0x20)
+        shentsize, shnum, shstrndx = struct.unpack_from(end + "HHH", data, 0x2E)
+        fmt = end + "IIIIIIIIII"
+    sects = [struct.unpack_from(fmt, data, shoff + i * shentsize) for i in range(shnum)]
+    strtab_off = sects[shstrndx][4]
+
+    def name(sh):
+        start = strtab_off + sh[0]
+        return data[start:data.index(b"\0", start)].decode()
+
+    for sh in sects:
+        if name(sh) == ".dzlog":
+            addr, off, size = sh[3], sh[4], sh[5]
+            blob = data[off:off + size]
+            table, i = {}, 0
+            while i < len(blob):
+                j = blob.find(b"\0", i)
+                if j < 0:
+                    break
+                if j > i:
+                    table[(addr + i) & 0xFFFF] = blob[i:j].decode("utf-8", "replace")
+                i = j + 1
+            return table
+    raise SystemExit(f"{elf_path}: brak sekcji .dzlog (build bez DZB_LOG_BINARY?)")
+
+
+def render(fmt, payload):
+    """Formatuje rekord wg formatu C, pobierając argumenty z payload."""
+    out, pos, i = [], 0, 0
+    for m in SPEC.finditer(fmt):
+        out.append(fmt[i:m.start()])
+        i = m.end()
+        flags, width, prec, _length, conv = m.groups()
+        if conv == "%":
+            out.append("%")
+            continue
+        py = "%" + (flags or "") + (width or "") + ("." + prec if prec is not None else "")
+        if conv == "s":
+            n = payload[pos]
+            val = payload[pos + 1:pos + 1 + n].decode("utf-8", "replace")
+            pos += 1 + n
+            out.append((py + "s") % val)
+            continue
+        raw = payload[pos:pos + 4]
+        pos += 4
+        if len(raw) < 4:
+            out.append("<?>")
+            continue
+        if conv in "di":
+            out.append((py + "d") % struct.unpack("<i", raw)[0])
+        elif conv in "fFeEgG":
+            out.append((py + conv) % struct.unpack("<f", raw)[0])
+        elif conv == "c":
+            out.append((py + "c") % chr(raw[0]))
+        elif conv == "p":
+            out.append("0x%08x" % struct.unpack("<I", raw)[0])
+        else:
+            out.append((py + conv) % struct.unpack("<I", raw)[0])
+    out.append(fmt[i:])
+    return "".join(out)
+
+
+def decode(stream, table, write):
+    buf = bytearray()
+    while True:
+        chunk = stream.read(256)
+        if not chunk:
+            break
+        buf += chunk
+        while buf:
+            k = buf.find(SYNC)
+            if k < 0:
+                write(buf.decode("utf-8", "replace"))
+                buf.clear()
+                break
+            if k > 0:
+                write(buf[:k].decode("utf-8", "replace"))
+                del buf[:k]
+            if len(buf) < 4 or len(buf) < 4 + buf[1]:
+                break                                   # rekord niepełny — czekaj na resztę
+            n, rid = buf[1], buf[2] | (buf[3] << 8)
+            payload = bytes(buf[4:4 + n])
+            del buf[:4 + n]
+            fmt = table.get(rid)
+            write((render(fmt, payload) if fmt is not None else f"<dzlog ?id=0x{rid:04x} len={n}>") + "\r\n")
+
+
+def main(argv):
+    if len(argv) < 2:
+        raise SystemExit(__doc__)
+    table = load_formats(argv[1])
+    src = argv[2] if len(argv) > 2 else None
+    if src is None:
+        stream = sys.stdin.buffer
+    elif src.startswith("/dev/") or src.upper().startswith("COM"):
+        import serial  # pyserial
+        stream = serial.Serial(src, 115200, timeout=0.1)
+    else:
+        stream = open(src, "rb")
+
+    def write(text):
+        sys.stdout.write(text)
+        sys.stdout.flush()
+
+    try:
+        decode(stream, table, write)
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main(sys.argv)
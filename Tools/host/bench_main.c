@@ -0,0 +1,62 @@
+/*
+ * ============================================================================
+ *  HOST: bench_main.c — punkt wejścia mikrobenchmarków na PC (Tools/bench.py)
+ *  ----------------------------------------------------------------------------
+ *  Użycie: bench_host [prefiks] [skala]   (domyślnie: wszystkie, skala 50)
+ *
+ *  Bench linkuje tylko moduły czystej logiki — tu zaślepki reszty (raporty → stdout)
+ *  i porty Bench_* na zegarze monotonicznym („cykl” = 1 ns).
+ * ============================================================================
+ */
+
+#include "bench.h"
+#include "ramfunc.h"
+#include "debug_uart.h"      // DebugUART_Lane_t (zaślepka WriteRaw)
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* ==== Moduły targetu, których bench nie kompiluje ==== */
+RamFn_Stat_t g_ramfnStat[RAMFN_COUNT];
+
+void DebugUART_Crit(const char *msg)
+{
+    if (msg) printf("%s\n", msg);
+}
+
+void DebugUART_CritPrintf(const char *fmt, ...)
+{
+    va_list ap;
+    va_start(ap, fmt);
+    vprintf(fmt, ap);
+    va_end(ap);
+    putchar('\n');
+}
+
+/* dzlog.c z -DDZB_LOG_BINARY (przypadek dzlog.emit nie wysyła — DzLog_End nieużywany) */
+uint8_t DebugUART_WriteRaw(DebugUART_Lane_t lane, const void *data, size_t len)
+{
+    (void)lane; (void)data; (void)len;
+    return 0u;
+}
+
+/* ==== Bench: „cykle” = ns zegara monotonicznego ==== */
+uint32_t Bench_PortCycles(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec);
+}
+
+uint32_t Bench_PortHz(void)
+{
+    return 1000000000u;
+}
+
+int main(int argc, char **argv)
+{
+    const char    *prefix = (argc > 1) ? argv[1] : "";
+    const uint32_t scale  = (argc > 2) ? (uint32_t)strtoul(argv[2], NULL, 0) : 50u;
+    return (Bench_Run(prefix, scale) > 0u) ? 0 : 1;
+}
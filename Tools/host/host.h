@@ -0,0 +1,85 @@
+/*
+ * ============================================================================
+ *  HOST: host.h — sterowanie portami HAL z programu na PC (zegar, UART, I²C)
+ *  ----------------------------------------------------------------------------
+ *  CO:
+ *    - Zegar wirtualny w µs: Host_AdvanceUs() przesuwa czas, kończy transmisje UART
+ *      (TxCplt/RxCplt jak z ISR) i woła hook kroku (np. model fizyczny symulatora).
+ *      HAL_Delay() też idzie przez Host_AdvanceUs — fizyka działa w trakcie ESC_ArmNeutral.
+ *    - Każde HAL_GetTick() „kosztuje” HOST_POLL_US: pętle czekające na czas (np.
+ *      timeouty HAL) kończą się tak jak na targecie, a nie wiszą w nieskończoność.
+ *    - UART (huart1/huart2): nadawanie trwa n × 10 bit / BaudRate; bajty trafiają do
+ *      zlewu (Host_UartSetSink) w chwili startu transmisji. Host_UartInject() kolejkuje
+ *      bajty RX — dostarczane po jednym w rytmie łącza (HAL_UART_RxCpltCallback).
+ *    - I²C: urządzenia wirtualne przypięte do (uchwyt magistrali, adres 7-bit);
+ *      brak urządzenia = NAK (HAL_ERROR), jak na pustej magistrali. Czas transakcji
+ *      liczony dla 400 kHz. Błędy wstrzykiwane per urządzenie (Host_I2CFault_t):
+ *        nak        — urządzenie nie potwierdza adresu (HAL_ERROR, ErrorCode AF),
+ *        nak_pct    — losowy NAK w danym % transakcji (deterministyczny PRNG),
+ *        stretch_us — clock stretching: transakcja dłuższa o tyle µs; powyżej
+ *                     timeoutu wywołania HAL → HAL_ERROR (ErrorCode TIMEOUT) po timeoucie,
+ *        stuck      — SDA trzymana nisko: KAŻDA transakcja na tej magistrali czeka
+ *                     HOST_I2C_BUSY_MS (jak I2C_TIMEOUT_BUSY w HAL) i kończy się błędem.
+ *    - FLASH (porty cfg_store/matchlog): Host_FlashPowerCut(n) — „zanik zasilania” po n
+ *      zapisach double-word: kolejne zapisy i erase zwracają błąd i nic nie zmieniają
+ *      (rekord urwany w połowie, jak po resecie w trakcie zapisu); −1 = zasilanie wraca.
+ *
+ *  KIEDY:
+ *    - Buildy hosta (Tools/bench.py, Tools/sim.py). Kod targetu tego nie widzi.
+ * ============================================================================
+ */
+
+#ifndef HOST_H_
+#define HOST_H_
+
+#include "stm32l4xx_hal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define HOST_POLL_US     1u       // „koszt” jednego HAL_GetTick() w czasie wirtualnym
+#define HOST_UART_RXQ    256u     // kolejka wstrzykniętych bajtów RX (potęga 2)
+
+/* ==== Zegar ==== */
+uint64_t Host_NowUs(void);
+void     Host_AdvanceUs(uint32_t us);
+/* Hook kroku: wołany z Host_AdvanceUs w kawałkach ≤ 1 ms (dt_us), po przesunięciu zegara */
+void     Host_SetStepHook(void (*hook)(uint32_t dt_us));
+
+/* ==== UART ==== */
+void     Host_UartSetSink(void (*sink)(UART_HandleTypeDef *h, const uint8_t *data, uint16_t n));
+uint16_t Host_UartInject(const char *s);    // zwraca liczbę przyjętych bajtów
+
+/* ==== I²C: urządzenie wirtualne ==== */
+#define HOST_I2C_BUSY_MS  25u     // HAL: I2C_TIMEOUT_BUSY (oczekiwanie na wolną magistralę)
+
+typedef struct {
+    uint8_t  nak;                 // 1 = brak ACK adresu
+    uint8_t  nak_pct;             // 0..100: losowy NAK
+    uint8_t  stuck;               // 1 = magistrala zablokowana (wszystkie urządzenia)
+    uint32_t stretch_us;          // dodatkowy czas transakcji
+} Host_I2CFault_t;
+
+typedef struct Host_I2CDev Host_I2CDev_t;
+struct Host_I2CDev {
+    /* Zapis/odczyt całej transakcji (START…STOP); wynik jak z HAL (HAL_OK/HAL_ERROR/…) */
+    HAL_StatusTypeDef (*write)(Host_I2CDev_t *d, const uint8_t *data, uint16_t n);
+    HAL_StatusTypeDef (*read) (Host_I2CDev_t *d, uint8_t *data, uint16_t n);
+    void              *ctx;       // stan modelu
+    Host_I2CFault_t    fault;     // wstrzykiwane błędy (zero = sprawne)
+};
+
+/* Przypięcie do magistrali (NULL dev = odpięcie); 0 = brak wolnego slotu */
+uint8_t Host_I2C_Attach(I2C_HandleTypeDef *bus, uint8_t addr7, Host_I2CDev_t *dev);
+/* Przepięcie pod inny adres (np. TF-Luna po zmianie 0x22); 0 = brak miejsca */
+uint8_t Host_I2C_Move(I2C_HandleTypeDef *bus, uint8_t from7, uint8_t to7, Host_I2CDev_t *dev);
+
+/* FLASH: zanik zasilania po n kolejnych zapisach double-word (−1 = wyłączone) */
+void     Host_FlashPowerCut(int32_t programs);
+uint32_t Host_FlashPrograms(void);          // licznik udanych zapisów double-word od startu
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* HOST_H_ */
@@ -0,0 +1,376 @@
+/*
+ * ============================================================================
+ *  HOST: host_port.c — porty HAL/CMSIS i drobne zaślepki dla buildów na PC
+ *  ----------------------------------------------------------------------------
+ *  CO:
+ *    - Zegar wirtualny w µs (host.h): HAL_GetTick = µs/1000, DWT->CYCCNT = µs × 80,
+ *      HAL_Delay przesuwa zegar (z krokami hooka) zamiast czekać.
+ *    - UART: nadawanie/odbiór przerwaniami w czasie wirtualnym (callbacki HAL).
+ *    - I²C: tablica urządzeń wirtualnych; brak urządzenia = NAK (HAL_ERROR);
+ *      błędy wstrzykiwane per urządzenie (NAK, losowy NAK, stretching, zablokowana SDA).
+ *    - TIM1: rejestry CCR w pamięci (htim1) — ESC_* piszą tu szerokość impulsu.
+ *    - FLASH: porty cfg_store/matchlog (silne — podmieniają weak) na tablicach w RAM,
+ *      semantyka NOR: erase = 0xFF, program tylko na wymazane double-wordy;
+ *      Host_FlashPowerCut() — zapis urwany po n double-wordach (testy odporności).
+ *    - Symbole linkera (_sstack/_estack, _sramfunc/_eramfunc) i zaślepki crash
+ *      (crash.c to asembler ARM — na hoście go nie ma; raport zawsze pusty).
+ *
+ *  UWAGA:
+ *    - Zaślepki modułów, których bench nie kompiluje (DebugUART_Crit, g_ramfnStat,
+ *      porty Bench_*), są w bench_main.c — symulator linkuje prawdziwe moduły.
+ * ============================================================================
+ */
+
+#include "host.h"
+#include "cfg_store.h"
+#include "matchlog.h"
+#include "stack_mon.h"
+#include "crash.h"
+#include <string.h>
+
+/* ==== CMSIS / zegar ==== */
+static DWT_Type       s_dwt;
+static CoreDebug_Type s_coreDebug;
+DWT_Type       *DWT       = &s_dwt;
+CoreDebug_Type *CoreDebug = &s_coreDebug;
+uint32_t SystemCoreClock  = 80000000u;
+
+static uint64_t s_nowUs = 0u;
+static void   (*s_stepHook)(uint32_t dt_us) = NULL;
+
+static void host_uart_advance(void);
+
+uint64_t Host_NowUs(void) { return s_nowUs; }
+
+void Host_SetStepHook(void (*hook)(uint32_t dt_us)) { s_stepHook = hook; }
+
+void Host_AdvanceUs(uint32_t us)
+{
+    while (us > 0u) {
+        const uint32_t dt = (us > 1000u) ? 1000u : us;   // hook w krokach ≤ 1 ms
+        s_nowUs += dt;
+        us -= dt;
+        DWT->CYCCNT = (uint32_t)(s_nowUs * (SystemCoreClock / 1000000u));
+        host_uart_advance();                             // „przerwania” UART
+        if (s_stepHook) s_stepHook(dt);
+    }
+}
+
+uint32_t HAL_GetTick(void)
+{
+    Host_AdvanceUs(HOST_POLL_US);                        // odpytywanie też zajmuje czas
+    return (uint32_t)(s_nowUs / 1000u);
+}
+
+void HAL_Delay(uint32_t ms) { Host_AdvanceUs(ms * 1000u); }
+
+/* ==== UART: transmisja IT w czasie wirtualnym ==== */
+UART_HandleTypeDef huart1 = { NULL, { 115200u }, 0u };
+UART_HandleTypeDef huart2 = { NULL, { 115200u }, 0u };
+
+typedef struct {
+    UART_HandleTypeDef *h;
+    uint64_t tx_done;          // koniec bieżącej transmisji (µs); 0 = wolny
+    uint8_t *rx_ptr;           // bufor Receive_IT (1 bajt); NULL = odbiór nieuzbrojony
+    uint64_t rx_next;          // najwcześniejszy czas dostarczenia kolejnego bajtu
+} HostUart_t;
+
+static HostUart_t s_uart[2] = { { &huart1, 0u, NULL, 0u }, { &huart2, 0u, NULL, 0u } };
+static void (*s_uartSink)(UART_HandleTypeDef *h, const uint8_t *data, uint16_t n) = NULL;
+
+/* RX wstrzykiwany zawsze na huart2 (konsola shella) */
+static uint8_t  s_rxq[HOST_UART_RXQ];
+static uint16_t s_rxHead = 0u, s_rxTail = 0u;
+
+static HostUart_t* host_uart(UART_HandleTypeDef *h)
+{
+    for (uint32_t i = 0; i < 2u; i++) if (s_uart[i].h == h) return &s_uart[i];
+    return NULL;
+}
+
+static inline uint64_t host_byte_us(const UART_HandleTypeDef *h, uint32_t n)
+{
+    const uint32_t baud = h->Init.BaudRate ? h->Init.BaudRate : 115200u;
+    return ((uint64_t)n * 10u * 1000000u + baud - 1u) / baud;   // 8N1 = 10 bit/B
+}
+
+void Host_UartSetSink(void (*sink)(UART_HandleTypeDef *h, const uint8_t *data, uint16_t n))
+{
+    s_uartSink = sink;
+}
+
+uint16_t Host_UartInject(const char *s)
+{
+    uint16_t n = 0u;
+    while (s && *s && (uint16_t)(s_rxHead - s_rxTail) < HOST_UART_RXQ) {
+        s_rxq[s_rxHead++ & (HOST_UART_RXQ - 1u)] = (uint8_t)*s++;
+        n++;
+    }
+    return n;
+}
+
+HAL_StatusTypeDef HAL_UART_Transmit_IT(UART_HandleTypeDef *huart, const uint8_t *data, uint16_t n)
+{
+    HostUart_t *u = host_uart(huart);
+    if (!u || !data || n == 0u) return HAL_ERROR;
+    if (u->tx_done != 0u)       return HAL_BUSY;
+    if (s_uartSink) s_uartSink(huart, data, n);
+    u->tx_done = s_nowUs + host_byte_us(huart, n);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_Receive_IT(UART_HandleTypeDef *huart, uint8_t *data, uint16_t n)
+{
+    HostUart_t *u = host_uart(huart);
+    if (!u || !data || n != 1u) return HAL_ERROR;       // moduły używają tylko 1 B
+    if (u->rx_ptr)              return HAL_BUSY;
+    u->rx_ptr = data;
+    return HAL_OK;
+}
+
+/* Zakończenia transmisji i dostarczenie RX (callbacki jak z ISR) */
+static void host_uart_advance(void)
+{
+    for (uint32_t i = 0; i < 2u; i++) {
+        HostUart_t *u = &s_uart[i];
+        if (u->tx_done != 0u && s_nowUs >= u->tx_done) {
+            u->tx_done = 0u;
+            HAL_UART_TxCpltCallback(u->h);              // może od razu wystartować kolejną porcję
+        }
+    }
+    HostUart_t *u = &s_uart[1];
+    if (u->rx_ptr && s_rxTail != s_rxHead && s_nowUs >= u->rx_next) {
+        uint8_t *p = u->rx_ptr;
+        u->rx_ptr  = NULL;                              // callback uzbraja ponownie
+        *p = s_rxq[s_rxTail++ & (HOST_UART_RXQ - 1u)];
+        u->rx_next = s_nowUs + host_byte_us(u->h, 1u);
+        HAL_UART_RxCpltCallback(u->h);
+    }
+}
+
+/* Domyślne (weak) callbacki — moduł debug_uart dostarcza właściwe */
+__weak void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart) { (void)huart; }
+__weak void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart) { (void)huart; }
+__weak void HAL_UART_ErrorCallback (UART_HandleTypeDef *huart) { (void)huart; }
+
+/* ==== I²C: urządzenia wirtualne + wstrzykiwanie błędów ==== */
+I2C_HandleTypeDef hi2c1, hi2c3;
+
+#define HOST_I2C_SLOTS  8u
+
+typedef struct {
+    I2C_HandleTypeDef *bus;
+    uint8_t            addr7;
+    Host_I2CDev_t     *dev;
+} HostI2CSlot_t;
+
+static HostI2CSlot_t s_i2c[HOST_I2C_SLOTS];
+static uint32_t      s_i2cRng = 0x6C078965u;            // PRNG losowych NAK (powtarzalny)
+
+uint8_t Host_I2C_Attach(I2C_HandleTypeDef *bus, uint8_t addr7, Host_I2CDev_t *dev)
+{
+    HostI2CSlot_t *free_slot = NULL;
+    for (uint32_t i = 0; i < HOST_I2C_SLOTS; i++) {
+        HostI2CSlot_t *s = &s_i2c[i];
+        if (s->dev && s->bus == bus && s->addr7 == addr7) { s->dev = dev; return 1u; }
+        if (!s->dev && !free_slot) free_slot = s;
+    }
+    if (!dev)       return 1u;
+    if (!free_slot) return 0u;
+    free_slot->bus = bus; free_slot->addr7 = addr7; free_slot->dev = dev;
+    return 1u;
+}
+
+uint8_t Host_I2C_Move(I2C_HandleTypeDef *bus, uint8_t from7, uint8_t to7, Host_I2CDev_t *dev)
+{
+    if (from7 == to7) return 1u;
+    if (!Host_I2C_Attach(bus, to7, dev)) return 0u;
+    for (uint32_t i = 0; i < HOST_I2C_SLOTS; i++) {
+        HostI2CSlot_t *s = &s_i2c[i];
+        if (s->dev == dev && s->bus == bus && s->addr7 == from7) s->dev = NULL;
+    }
+    return 1u;
+}
+
+static Host_I2CDev_t* host_i2c_find(I2C_HandleTypeDef *bus, uint16_t addr8)
+{
+    for (uint32_t i = 0; i < HOST_I2C_SLOTS; i++) {
+        const HostI2CSlot_t *s = &s_i2c[i];
+        if (s->dev && s->bus == bus && s->addr7 == (uint8_t)(addr8 >> 1)) return s->dev;
+    }
+    return NULL;
+}
+
+static uint8_t host_i2c_stuck(const I2C_HandleTypeDef *bus)
+{
+    for (uint32_t i = 0; i < HOST_I2C_SLOTS; i++) {
+        const HostI2CSlot_t *s = &s_i2c[i];
+        if (s->dev && s->bus == bus && s->dev->fault.stuck) return 1u;
+    }
+    return 0u;
+}
+
+/* Wspólna część transakcji: czas na magistrali i błędy; HAL_OK = można oddać urządzeniu.
+ * Czas @400 kHz: (adres + n bajtów) × 9 bit ≈ 22.5 µs/B. */
+static HAL_StatusTypeDef host_i2c_begin(I2C_HandleTypeDef *hi2c, Host_I2CDev_t *d, uint16_t n, uint32_t timeout)
+{
+    hi2c->ErrorCode = HAL_I2C_ERROR_NONE;
+    if (host_i2c_stuck(hi2c)) {                          // BUSY do timeoutu HAL
+        Host_AdvanceUs(HOST_I2C_BUSY_MS * 1000u);
+        hi2c->ErrorCode = HAL_I2C_ERROR_TIMEOUT;
+        return HAL_ERROR;
+    }
+    uint8_t nak = (uint8_t)(!d || d->fault.nak);
+    if (!nak && d->fault.nak_pct) {
+        s_i2cRng = s_i2cRng * 1103515245u + 12345u;
+        nak = (uint8_t)(((s_i2cRng >> 16) % 100u) < d->fault.nak_pct);
+    }
+    if (nak) {                                           // NAK adresu: sam bajt adresu
+        Host_AdvanceUs(23u);
+        hi2c->ErrorCode = HAL_I2C_ERROR_AF;
+        return HAL_ERROR;
+    }
+    const uint32_t bus_us = ((uint32_t)n + 1u) * 45u / 2u + 1u;
+    if (d->fault.stretch_us > timeout * 1000u) {         // slave trzyma SCL dłużej niż timeout
+        Host_AdvanceUs(timeout * 1000u);
+        hi2c->ErrorCode = HAL_I2C_ERROR_TIMEOUT;
+        return HAL_ERROR;
+    }
+    Host_AdvanceUs(bus_us + d->fault.stretch_us);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Transmit(I2C_HandleTypeDef *hi2c, uint16_t addr, uint8_t *data, uint16_t n, uint32_t timeout)
+{
+    Host_I2CDev_t *d = host_i2c_find(hi2c, addr);
+    const HAL_StatusTypeDef st = host_i2c_begin(hi2c, d, n, timeout);
+    if (st != HAL_OK) return st;
+    return d->write ? d->write(d, data, n) : HAL_ERROR;
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Receive(I2C_HandleTypeDef *hi2c, uint16_t addr, uint8_t *data, uint16_t n, uint32_t timeout)
+{
+    Host_I2CDev_t *d = host_i2c_find(hi2c, addr);
+    const HAL_StatusTypeDef st = host_i2c_begin(hi2c, d, n, timeout);
+    if (st != HAL_OK) return st;
+    return d->read ? d->read(d, data, n) : HAL_ERROR;
+}
+
+HAL_StatusTypeDef HAL_I2C_IsDeviceReady(I2C_HandleTypeDef *hi2c, uint16_t addr, uint32_t trials, uint32_t timeout)
+{
+    for (uint32_t t = 0; t < (trials ? trials : 1u); t++) {
+        Host_I2CDev_t *d = host_i2c_find(hi2c, addr);
+        if (host_i2c_begin(hi2c, d, 0u, timeout) != HAL_OK) continue;
+        if (d->write && d->write(d, NULL, 0u) == HAL_OK) return HAL_OK;   // sam adres (ACK)
+    }
+    return HAL_ERROR;
+}
+
+/* ==== TIM1 (PWM ESC) ==== */
+static TIM_TypeDef s_tim1;
+TIM_TypeDef       *TIM1  = &s_tim1;
+TIM_HandleTypeDef  htim1 = { &s_tim1 };
+
+HAL_StatusTypeDef HAL_TIM_PWM_Start(TIM_HandleTypeDef *htim, uint32_t ch)
+{
+    (void)htim; (void)ch;
+    return HAL_OK;
+}
+
+/* ==== RCC: zimny start (brak flag resetu) ==== */
+static RCC_TypeDef s_rcc;
+RCC_TypeDef       *RCC = &s_rcc;
+
+/* ==== FLASH: HAL zawsze odmawia; moduły idą przez porty poniżej ==== */
+HAL_StatusTypeDef HAL_FLASH_Unlock(void) { return HAL_OK; }
+HAL_StatusTypeDef HAL_FLASH_Lock(void)   { return HAL_OK; }
+
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef *er, uint32_t *bad)
+{
+    (void)er;
+    if (bad) *bad = 0xFFFFFFFFu;
+    return HAL_ERROR;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t type, uint32_t addr, uint64_t data)
+{
+    (void)type; (void)addr; (void)data;
+    return HAL_ERROR;
+}
+
+/* Regiony z linkera — na hoście zwykłe tablice (fabrycznie wymazane, patrz Host_FlashInit) */
+uint8_t __cfg_store_start[CFGS_PAGES * CFGS_PAGE_SIZE];
+uint8_t __match_log_start[MATCHLOG_PAGES * MATCHLOG_PAGE_SIZE];
+
+static int32_t  s_flashCut = -1;                       // zapisy do „zaniku zasilania”, −1 = brak
+static uint32_t s_flashPrograms = 0u;
+
+void Host_FlashPowerCut(int32_t programs) { s_flashCut = programs; }
+uint32_t Host_FlashPrograms(void)         { return s_flashPrograms; }
+
+static uint8_t host_flash_erase(uint8_t *base, uint8_t page, uint8_t pages, uint32_t page_size)
+{
+    if (page >= pages || s_flashCut == 0) return 0u;
+    memset(base + (uint32_t)page * page_size, 0xFF, page_size);
+    return 1u;
+}
+
+static uint8_t host_flash_program(uint8_t *base, uint32_t size, uint32_t offset, uint64_t dword)
+{
+    if ((offset & 7u) != 0u || offset + 8u > size || s_flashCut == 0) return 0u;
+    uint64_t cur;
+    memcpy(&cur, base + offset, 8u);
+    if (cur != 0xFFFFFFFFFFFFFFFFull) return 0u;        // PROGERR: double-word nie wymazany
+    memcpy(base + offset, &dword, 8u);
+    s_flashPrograms++;
+    if (s_flashCut > 0) s_flashCut--;
+    return 1u;
+}
+
+__attribute__((constructor)) static void host_flash_init(void)
+{
+    memset(__cfg_store_start, 0xFF, sizeof(__cfg_store_start));
+    memset(__match_log_start, 0xFF, sizeof(__match_log_start));
+}
+
+const uint8_t* CfgStore_PortBase(void) { return __cfg_store_start; }
+uint8_t CfgStore_PortErase(uint8_t page)
+{
+    return host_flash_erase(__cfg_store_start, page, CFGS_PAGES, CFGS_PAGE_SIZE);
+}
+uint8_t CfgStore_PortProgram(uint32_t offset, uint64_t dword)
+{
+    return host_flash_program(__cfg_store_start, sizeof(__cfg_store_start), offset, dword);
+}
+
+const uint8_t* MatchLog_PortBase(void) { return __match_log_start; }
+uint8_t MatchLog_PortErase(uint8_t page)
+{
+    return host_flash_erase(__match_log_start, page, MATCHLOG_PAGES, MATCHLOG_PAGE_SIZE);
+}
+uint8_t MatchLog_PortProgram(uint32_t offset, uint64_t dword)
+{
+    return host_flash_program(__match_log_start, sizeof(__match_log_start), offset, dword);
+}
+
+/* ==== Symbole linkera ==== */
+#define HOST_STACK_WORDS  1024u                         // „stos” 4 KB — tylko dla stack_mon
+
+uint32_t _sstack[HOST_STACK_WORDS];
+uint8_t  _sramfunc[8];                                  // .ramfunc pusta (DZB_RAMFUNC=0)
+__asm__(".globl _estack\n\t.set _estack, _sstack + 4096\n\t"
+        ".globl _eramfunc\n\t.set _eramfunc, _sramfunc\n\t"
+        ".globl _Min_Stack_Size\n\t.set _Min_Stack_Size, 0x400");
+
+__attribute__((constructor)) static void host_stack_paint(void)
+{
+    for (uint32_t i = 0; i < HOST_STACK_WORDS; i++) _sstack[i] = STACK_MON_PAINT;   // jak startup
+}
+
+/* ==== Moduły targetu, których host nie kompiluje ==== */
+Crash_Trace_t g_crashTrace;
+
+uint8_t Crash_Report(uint8_t force) { (void)force; return 0u; }
+void    Crash_Clear(void) {}
+
+void Error_Handler(void) {}
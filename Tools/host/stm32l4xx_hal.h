@@ -0,0 +1,119 @@
+/*
+ * ============================================================================
+ *  HOST: stm32l4xx_hal.h — minimalny zamiennik HAL/CMSIS do buildów na PC
+ *  ----------------------------------------------------------------------------
+ *  CO:
+ *    - Typy uchwytów (I2C/UART/TIM), HAL_StatusTypeDef, DWT/CoreDebug, SystemCoreClock.
+ *    - TIM: prawdziwe rejestry CCR1..CCR4 w pamięci — __HAL_TIM_SET_COMPARE zapisuje,
+ *      host czyta (szerokość impulsu ESC w µs, 1 tick = 1 µs jak na targecie).
+ *    - FLASH/RCC: typy i stałe, żeby cfg_store/matchlog/blackbox kompilowały się bez
+ *      zmian (porty FLASH hosta podmieniają weak-i modułów — host_port.c).
+ *    - Funkcje HAL (czas, I²C, UART) definiuje Tools/host/host_port.c; sterowanie
+ *      z hosta (zegar, wstrzykiwanie RX, magistrale) — Tools/host/host.h.
+ *
+ *  KIEDY:
+ *    - Tylko buildy hosta (Tools/bench.py, Tools/sim.py): katalog podany w -I PRZED
+ *      Core/Inc, więc Core/Inc/main.h dołącza ten plik zamiast prawdziwego HAL.
+ * ============================================================================
+ */
+
+#ifndef HOST_STM32L4XX_HAL_H_
+#define HOST_STM32L4XX_HAL_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum { HAL_OK = 0, HAL_ERROR, HAL_BUSY, HAL_TIMEOUT } HAL_StatusTypeDef;
+
+/* ==== I²C / UART ==== */
+typedef struct { void *Instance; uint32_t ErrorCode; } I2C_HandleTypeDef;
+typedef struct { uint32_t BaudRate; } UART_InitTypeDef;
+typedef struct { void *Instance; UART_InitTypeDef Init; uint32_t ErrorCode; } UART_HandleTypeDef;
+
+#define HAL_MAX_DELAY         0xFFFFFFFFu
+#define HAL_I2C_ERROR_NONE    0x00u
+#define HAL_I2C_ERROR_AF      0x04u       // NAK
+#define HAL_I2C_ERROR_TIMEOUT 0x20u
+#define I2C_MEMADD_SIZE_8BIT  1u
+
+HAL_StatusTypeDef HAL_I2C_Master_Transmit(I2C_HandleTypeDef *hi2c, uint16_t addr, uint8_t *data, uint16_t n, uint32_t timeout);
+HAL_StatusTypeDef HAL_I2C_Master_Receive (I2C_HandleTypeDef *hi2c, uint16_t addr, uint8_t *data, uint16_t n, uint32_t timeout);
+HAL_StatusTypeDef HAL_I2C_IsDeviceReady  (I2C_HandleTypeDef *hi2c, uint16_t addr, uint32_t trials, uint32_t timeout);
+
+HAL_StatusTypeDef HAL_UART_Transmit_IT(UART_HandleTypeDef *huart, const uint8_t *data, uint16_t n);
+HAL_StatusTypeDef HAL_UART_Receive_IT (UART_HandleTypeDef *huart, uint8_t *data, uint16_t n);
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart);
+void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart);
+void HAL_UART_ErrorCallback (UART_HandleTypeDef *huart);
+
+/* ==== TIM (PWM ESC) ==== */
+typedef struct { volatile uint32_t CCR1, CCR2, CCR3, CCR4; } TIM_TypeDef;
+typedef struct { TIM_TypeDef *Instance; } TIM_HandleTypeDef;
+extern TIM_TypeDef *TIM1;
+
+#define TIM_CHANNEL_1  0x0u
+#define TIM_CHANNEL_2  0x4u
+#define TIM_CHANNEL_3  0x8u
+#define TIM_CHANNEL_4  0xCu
+#define HOST_TIM_CCR(h, ch)              ((&(h)->Instance->CCR1)[(ch) / 4u])
+#define __HAL_TIM_SET_COMPARE(h, ch, v)  (HOST_TIM_CCR((h), (ch)) = (uint32_t)(v))
+#define __HAL_TIM_GET_COMPARE(h, ch)     (HOST_TIM_CCR((h), (ch)))
+
+HAL_StatusTypeDef HAL_TIM_PWM_Start(TIM_HandleTypeDef *htim, uint32_t ch);
+
+/* ==== FLASH (zapis tylko przez porty hosta; HAL_FLASH_* = błąd) ==== */
+typedef struct { uint32_t TypeErase, Banks, Page, NbPages; } FLASH_EraseInitTypeDef;
+#define FLASH_BASE                    0x08000000u
+#define FLASH_PAGE_SIZE               2048u
+#define FLASH_BANK_1                  1u
+#define FLASH_TYPEERASE_PAGES         0u
+#define FLASH_TYPEPROGRAM_DOUBLEWORD  0u
+#define FLASH_FLAG_ALL_ERRORS         0xFFu
+#define __HAL_FLASH_CLEAR_FLAG(f)     ((void)(f))
+
+HAL_StatusTypeDef HAL_FLASH_Unlock(void);
+HAL_StatusTypeDef HAL_FLASH_Lock(void);
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef *er, uint32_t *bad);
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t type, uint32_t addr, uint64_t data);
+
+/* ==== RCC (flagi resetu: host = zimny start) ==== */
+typedef struct { volatile uint32_t CSR; } RCC_TypeDef;
+extern RCC_TypeDef *RCC;
+#define RCC_CSR_BORRSTF    (1u << 27)
+#define RCC_CSR_SFTRSTF    (1u << 28)
+#define RCC_CSR_IWDGRSTF   (1u << 29)
+#define RCC_CSR_WWDGRSTF   (1u << 30)
+#define __HAL_RCC_CLEAR_RESET_FLAGS()  (RCC->CSR = 0u)
+
+/* ==== Czas (wirtualny: host_port.c — HAL_Delay przesuwa zegar zamiast czekać) ==== */
+uint32_t HAL_GetTick(void);
+void     HAL_Delay(uint32_t ms);
+
+/* ==== CMSIS: DWT, sekcje krytyczne ==== */
+typedef struct { volatile uint32_t CTRL, CYCCNT; } DWT_Type;
+typedef struct { volatile uint32_t DEMCR; } CoreDebug_Type;
+extern DWT_Type       *DWT;
+extern CoreDebug_Type *CoreDebug;
+#define DWT_CTRL_CYCCNTENA_Msk      (1u << 0)
+#define CoreDebug_DEMCR_TRCENA_Msk  (1u << 24)
+
+extern uint32_t SystemCoreClock;
+
+static inline uint32_t __get_PRIMASK(void) { return 0u; }
+static inline void     __set_PRIMASK(uint32_t v) { (void)v; }
+static inline void     __disable_irq(void) {}
+static inline void     __enable_irq(void)  {}
+static inline void     __DMB(void) { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+static inline void     __DSB(void) { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+static inline void     __ISB(void) {}
+
+#define __weak  __attribute__((weak))
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* HOST_STM32L4XX_HAL_H_ */
@@ -0,0 +1,49 @@
+/*
+ * ============================================================================
+ *  HOST: test.h — minimalne asercje testów hosta (Tools/test.py)
+ *  ----------------------------------------------------------------------------
+ *  CO:
+ *    - TEST_CHECK(warunek) / TEST_EQ(a, b): porażka → linia "FAIL plik:linia …" na stdout,
+ *      licznik błędów rośnie, test biegnie dalej (widać wszystkie różnice naraz).
+ *    - TEST_RUN(fn): wywołuje przypadek i drukuje "TEST <nazwa> OK|FAIL".
+ *    - TEST_EXIT(): kod wyjścia programu testu (0 = wszystko zielone).
+ *
+ *  KIEDY:
+ *    - Jeden plik Tools/host/test_<moduł>.c = jeden program testu; test.py kompiluje go
+ *      z modułami z Core/Src i Tools/host/host_port.c (zegar wirtualny, I²C, FLASH).
+ * ============================================================================
+ */
+
+#ifndef HOST_TEST_H_
+#define HOST_TEST_H_
+
+#include <stdio.h>
+
+static unsigned s_testFails = 0u;          // błędy w całym programie
+static unsigned s_testCaseFails = 0u;      // błędy bieżącego przypadku
+
+#define TEST_CHECK(cond) do {                                                   \
+        if (!(cond)) {                                                          \
+            printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);              \
+            s_testFails++; s_testCaseFails++;                                   \
+        }                                                                       \
+    } while (0)
+
+#define TEST_EQ(a, b) do {                                                      \
+        const long long _a = (long long)(a), _b = (long long)(b);               \
+        if (_a != _b) {                                                         \
+            printf("FAIL %s:%d: %s == %s (%lld != %lld)\n",                     \
+                   __FILE__, __LINE__, #a, #b, _a, _b);                         \
+            s_testFails++; s_testCaseFails++;                                   \
+        }                                                                       \
+    } while (0)
+
+#define TEST_RUN(fn) do {                                                       \
+        s_testCaseFails = 0u;                                                   \
+        fn();                                                                   \
+        printf("TEST %-32s %s\n", #fn, s_testCaseFails ? "FAIL" : "OK");        \
+    } while (0)
+
+#define TEST_EXIT()  ((s_testFails != 0u) ? 1 : 0)
+
+#endif /* HOST_TEST_H_ */
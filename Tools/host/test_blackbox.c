@@ -0,0 +1,408 @@
+/*
+ * ============================================================================
+ *  HOST: test_blackbox.c — rejestrator SRAM2 (blackbox.c): zamrażanie i zrzut
+ *  ----------------------------------------------------------------------------
+ *  CO:
+ *    - Reset ciepły = ponowne BlackBox_Init() na tej samej pamięci (statyczna s_bb
+ *      przeżywa jak SRAM2), flagi resetu ustawiane w RCC->CSR przed Init.
+ *    - BOR/watchdog przy starcie → log zamrożony, automatyczny zrzut, po "BB: koniec"
+ *      nagrywanie wraca samo; "bb freeze" w trakcie sesji trzyma log aż do "bb arm".
+ *    - Reset z pinu (brak flag) → log poprzedniej sesji zostaje, nagrywanie trwa.
+ *    - Kodek: rekordy (skoki, wartości skrajne, zawinięcie t_ms przez 2^32) → "bb dump"
+ *      zwraca te same wiersze CSV; "bb raw" przez Tools/bb_decode.py daje identyczny CSV
+ *      (dekoder Pythona zgodny z blackbox.c).
+ *    - BB_ENC_MAX: keyframe i delty z każdym polem na skraju zakresu (t_ms: różnica
+ *      2^31) — rekord nigdy nie przekracza BB_ENC_MAX B; najgorszy przypadek liczony z
+ *      długości varintów musi być osiągnięty (test naprawdę sprawdza granicę).
+ *
+ *  Linie CRIT przechwytuje lokalna zaślepka debug_uart (CritRoom zawsze = miejsce).
+ *  bb_decode.py: interpreter i katalog repo z DZB_PYTHON / DZB_ROOT (ustawia test.py).
+ * ============================================================================
+ */
+
+#include "test.h"
+#include "host.h"
+#include "blackbox.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ==== Zaślepki debug_uart: linie CRIT do bufora ==== */
+#define CAP_LINES  4096u
+static char     s_cap[CAP_LINES][128];
+static unsigned s_capN = 0u;
+
+void DebugUART_Crit(const char *msg)
+{
+    if (s_capN < CAP_LINES) snprintf(s_cap[s_capN++], sizeof(s_cap[0]), "%s", msg);
+}
+
+void DebugUART_CritPrintf(const char *fmt, ...)
+{
+    if (s_capN >= CAP_LINES) return;
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(s_cap[s_capN++], sizeof(s_cap[0]), fmt, ap);
+    va_end(ap);
+}
+
+uint8_t DebugUART_CritRoom(size_t line_max) { (void)line_max; return 1u; }
+
+static unsigned cap_find(const char *prefix)
+{
+    unsigned n = 0u;
+    for (unsigned i = 0; i < s_capN; i++) n += (strncmp(s_cap[i], prefix, strlen(prefix)) == 0);
+    return n;
+}
+
+/* ==== Pomocnicze ==== */
+
+static BlackBox_Rec_t make_rec(uint32_t i)
+{
+    BlackBox_Rec_t r;
+    memset(&r, 0, sizeof(r));
+    r.t_ms     = 1000u + 20u * i;
+    r.tgt_l    = (int8_t)(i % 100u);
+    r.tgt_r    = (int8_t)-(int8_t)(i % 100u);
+    r.cur_l    = (int8_t)(i % 50u);
+    r.cur_r    = (int8_t)(i % 30u);
+    r.esc_r_us = (uint16_t)(1500u + i % 200u);
+    r.esc_l_us = (uint16_t)(1500u - i % 200u);
+    r.luna_r   = (uint16_t)(120u - i % 100u);
+    r.luna_l   = (uint16_t)(90u + i % 7u);
+    r.clr_r    = (uint16_t)(3000u + 17u * (i % 13u));
+    r.clr_l    = (uint16_t)(2900u + 11u * (i % 9u));
+    r.dt_ms    = 20u;
+    r.tank_us  = (uint16_t)(40u + i % 5u);
+    r.loop_us  = (uint16_t)(300u + i % 50u);
+    return r;
+}
+
+static BlackBox_Info_t info(void)
+{
+    BlackBox_Info_t bi;
+    BlackBox_GetInfo(&bi);
+    return bi;
+}
+
+static void push_n(uint32_t first, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++) {
+        const BlackBox_Rec_t r = make_rec(first + i);
+        BlackBox_Push(&r);
+    }
+}
+
+/* Zrzut do końca (limit iteracji = zabezpieczenie przed pętlą) */
+static void dump_drain(void)
+{
+    for (unsigned k = 0; info().dumping && k < 10000u; k++) BlackBox_DumpPoll();
+    TEST_EQ(info().dumping, 0);
+}
+
+/* Start „zimny” (power-on): log pusty, nagrywanie */
+static void cold_boot(void)
+{
+    RCC->CSR = 0u;
+    BlackBox_Init();
+    BlackBox_Arm();
+    s_capN = 0u;
+}
+
+static void warm_boot(uint32_t csr)
+{
+    RCC->CSR = csr;
+    BlackBox_Init();
+}
+
+/* ==== Przypadki ==== */
+
+static void test_bor_freezes_then_rearms_after_dump(void)
+{
+    cold_boot();
+    push_n(0u, 100u);
+    TEST_EQ(info().count, 100);
+
+    warm_boot(RCC_CSR_BORRSTF);
+    TEST_EQ(info().frozen, 1);
+    TEST_EQ(info().dumping, 1);                             // zrzut rusza sam
+    push_n(100u, 10u);                                      // w trakcie zrzutu: bez zapisu
+    TEST_EQ(info().count, 100);
+
+    dump_drain();
+    TEST_EQ(cap_find("BB: koniec"), 1);
+    TEST_EQ(cap_find("BB: zrzucony"), 1);
+    TEST_EQ(info().frozen, 0);
+    TEST_EQ(info().count, 0);                               // log już na UART → czysty
+
+    const uint32_t seq0 = BlackBox_BlockSeq();
+    push_n(200u, 70u);                                      // > BB_BLOCK_RECS → blok zamknięty
+    TEST_EQ(info().count, 70);
+    TEST_CHECK(BlackBox_BlockSeq() > seq0);
+    TEST_CHECK(BlackBox_PeekBlock(BlackBox_BlockSeq() - 1u) != NULL);
+}
+
+static void test_watchdog_twice_in_a_row(void)
+{
+    cold_boot();
+    push_n(0u, 50u);
+    warm_boot(RCC_CSR_IWDGRSTF);
+    dump_drain();
+    push_n(50u, 30u);
+    TEST_EQ(info().count, 30);
+
+    s_capN = 0u;
+    warm_boot(RCC_CSR_IWDGRSTF);                            // drugi reset: log tej sesji zamrożony
+    TEST_EQ(info().frozen, 1);
+    dump_drain();
+    TEST_EQ(info().frozen, 0);
+    push_n(80u, 5u);
+    TEST_EQ(info().count, 5);
+}
+
+static void test_session_freeze_holds_until_arm(void)
+{
+    cold_boot();
+    push_n(0u, 40u);
+    BlackBox_Freeze();
+    BlackBox_DumpStart(0u);
+    dump_drain();
+    TEST_EQ(cap_find("BB: zrzucony"), 0);
+    TEST_EQ(info().frozen, 1);                              // "bb freeze" trzyma log
+    push_n(40u, 10u);
+    TEST_EQ(info().count, 40);
+
+    BlackBox_Arm();
+    push_n(50u, 10u);
+    TEST_EQ(info().count, 10);
+}
+
+static void test_freeze_during_boot_dump_holds(void)
+{
+    cold_boot();
+    push_n(0u, 40u);
+    warm_boot(RCC_CSR_SFTRSTF);
+    BlackBox_Freeze();                                      // błąd w trakcie zrzutu startowego
+    dump_drain();
+    TEST_EQ(info().frozen, 1);
+    TEST_EQ(info().count, 40);
+}
+
+static void test_pin_reset_keeps_recording(void)
+{
+    cold_boot();
+    push_n(0u, 40u);
+    warm_boot(0u);                                          // NRST: log zostaje, bez zamrożenia
+    TEST_EQ(info().frozen, 0);
+    TEST_EQ(info().dumping, 0);
+    TEST_EQ(info().boots, 2);
+    push_n(40u, 10u);
+    TEST_EQ(info().count, 50);
+}
+
+/* ==== Kodek ==== */
+
+/* Wiersz CSV jak dump_csv_line() w blackbox.c (kolumny "bb dump") */
+static void rec_csv(const BlackBox_Rec_t *r, char *out, size_t n)
+{
+    snprintf(out, n, "%lu,%d,%d,%d,%d,%u,%u,%u,%u,%u,%u,%u,%u,%u,%02X",
+             (unsigned long)r->t_ms, (int)r->tgt_l, (int)r->tgt_r, (int)r->cur_l, (int)r->cur_r,
+             (unsigned)r->esc_r_us, (unsigned)r->esc_l_us, (unsigned)r->luna_r, (unsigned)r->luna_l,
+             (unsigned)r->clr_r, (unsigned)r->clr_l, (unsigned)r->dt_ms, (unsigned)r->tank_us,
+             (unsigned)r->loop_us, (unsigned)r->flags);
+}
+
+static uint32_t s_rng = 12345u;
+static uint32_t rnd(void)
+{
+    s_rng = s_rng * 1664525u + 1013904223u;                 // LCG — powtarzalny ciąg
+    return s_rng >> 8;
+}
+
+/* Rekord i: zwykle płynne zmiany, co kilka — skok lub wartości skrajne; czas przez 2^32 */
+static BlackBox_Rec_t codec_rec(uint32_t i)
+{
+    BlackBox_Rec_t r = make_rec(i);
+    r.t_ms = 0xFFFFFF00u + 20u * i + (i % 17u == 0u ? rnd() % 500u : 0u);
+    if (i % 5u == 0u) {
+        r.luna_r = (uint16_t)rnd(); r.clr_l = (uint16_t)rnd();
+        r.tgt_l  = (int8_t)rnd();   r.cur_r = (int8_t)rnd();
+    }
+    if (i % 23u == 0u) {
+        r.luna_l = 0xFFFFu; r.esc_r_us = 0u; r.tgt_r = -128; r.cur_l = 127;
+        r.loop_us = 0xFFFFu; r.dt_ms = 0xFFFFu; r.flags = 0x7Fu;
+    }
+    r.flags |= (uint8_t)(rnd() & (BB_F_EDGE_R | BB_F_EDGE_L | BB_F_ESCAPE | BB_F_OVERRIDE));
+    return r;
+}
+
+#define CODEC_RECS  300u                                    // kilkanaście bloków, bez przepełnienia pierścienia
+static char s_exp[CODEC_RECS][128];
+
+/* Nagrywa CODEC_RECS rekordów, oczekiwane wiersze CSV → s_exp */
+static void codec_record(void)
+{
+    cold_boot();
+    s_rng = 12345u;
+    for (uint32_t i = 0; i < CODEC_RECS; i++) {
+        BlackBox_Rec_t r = codec_rec(i);
+        BlackBox_Push(&r);
+        if (i == 0u) r.flags |= BB_F_BOOT;                  // pierwszy rekord sesji
+        rec_csv(&r, s_exp[i], sizeof(s_exp[i]));
+    }
+    TEST_EQ(info().count, CODEC_RECS);
+    TEST_CHECK(info().blocks > 1u && info().blocks < BLACKBOX_BLOCKS);
+}
+
+static void test_codec_roundtrip(void)
+{
+    codec_record();
+    s_capN = 0u;
+    BlackBox_DumpStart(0u);
+    dump_drain();
+
+    unsigned row = 0u;
+    for (unsigned i = 0; i < s_capN; i++) {
+        if (s_cap[i][0] < '0' || s_cap[i][0] > '9') continue;   // nagłówek / kolumny / koniec
+        if (row < CODEC_RECS && strcmp(s_cap[i], s_exp[row]) != 0) {
+            printf("  rek. %u: '%s' != '%s'\n", row, s_cap[i], s_exp[row]);
+            TEST_CHECK(0);
+        }
+        row++;
+    }
+    TEST_EQ(row, CODEC_RECS);
+}
+
+static void test_bb_decode_agrees(void)
+{
+    const char *py = getenv("DZB_PYTHON"), *root = getenv("DZB_ROOT");
+    TEST_CHECK(py && root);
+    if (!py || !root) return;
+
+    codec_record();
+    s_capN = 0u;
+    BlackBox_DumpStart(1u);
+    dump_drain();
+
+    char path[] = "/tmp/dzb_bbxXXXXXX";
+    const int fd = mkstemp(path);
+    TEST_CHECK(fd >= 0);
+    if (fd < 0) return;
+    FILE *f = fdopen(fd, "w");
+    for (unsigned i = 0; i < s_capN; i++) fprintf(f, "%s\r\n", s_cap[i]);   // jak log terminala
+    fclose(f);
+
+    char cmd[512];
+    snprintf(cmd, sizeof(cmd), "\"%s\" \"%s/Tools/bb_decode.py\" %s 2>/dev/null", py, root, path);
+    FILE *p = popen(cmd, "r");
+    TEST_CHECK(p != NULL);
+    if (!p) { remove(path); return; }
+
+    char line[256];
+    unsigned row = 0u;
+    uint8_t hdr = 0u;
+    while (fgets(line, sizeof(line), p)) {
+        line[strcspn(line, "\r\n")] = '\0';
+        if (!hdr) { TEST_CHECK(strncmp(line, "t_ms,", 5) == 0); hdr = 1u; continue; }
+        if (row < CODEC_RECS && strcmp(line, s_exp[row]) != 0) {
+            printf("  rek. %u: '%s' != '%s'\n", row, line, s_exp[row]);
+            TEST_CHECK(0);
+        }
+        row++;
+    }
+    TEST_EQ(pclose(p), 0);
+    remove(path);
+    TEST_EQ(row, CODEC_RECS);
+}
+
+/* Długość varinta i najgorszy rekord z definicji pól (maska 15 bitów + różnice) */
+static unsigned varint_len(uint32_t u)
+{
+    unsigned n = 1u;
+    while (u >= 0x80u) { u >>= 7; n++; }
+    return n;
+}
+
+static unsigned enc_bound(void)
+{
+    const unsigned zz32 = varint_len(0xFFFFFFFFu);          // t_ms: dowolna różnica 32-bit
+    const unsigned zz16 = varint_len(2u * 0xFFFFu);         // u16: |Δ| ≤ 65535
+    const unsigned zz8  = varint_len(2u * 0xFFu);           // i8 / flags: |Δ| ≤ 255
+    return varint_len((1u << 15) - 1u) + zz32 + 9u * zz16 + 5u * zz8;
+}
+
+/* Rekord „skrajny”: hi = maksima (i8: +127), inaczej minima (i8: −128) */
+static BlackBox_Rec_t extreme_rec(uint32_t t, uint8_t hi)
+{
+    BlackBox_Rec_t r;
+    memset(&r, 0, sizeof(r));
+    const uint16_t u = hi ? 0xFFFFu : 0u;
+    const int8_t   s = hi ? 127 : -128;
+    r.t_ms = t;
+    r.tgt_l = r.tgt_r = r.cur_l = r.cur_r = s;
+    r.esc_r_us = r.esc_l_us = r.luna_r = r.luna_l = u;
+    r.clr_r = r.clr_l = r.dt_ms = r.tank_us = r.loop_us = u;
+    r.flags = hi ? 0x7Fu : 0x80u;                            // |Δ| = 255 z BB_F_BOOT pierwszego rekordu
+    return r;
+}
+
+/* Push jednego rekordu → jego rozmiar po kodowaniu (przyrost bajtów logu) */
+static unsigned push_size(const BlackBox_Rec_t *r)
+{
+    const uint16_t b0 = info().bytes;
+    BlackBox_Push(r);
+    return (unsigned)(uint16_t)(info().bytes - b0);
+}
+
+static void test_enc_max_worst_case(void)
+{
+    const unsigned bound = enc_bound();
+    TEST_CHECK(bound <= BB_ENC_MAX);
+
+    /* keyframe: predykcja 0, t_ms = 0x7FFFFFFF → zigzag 0xFFFFFFFE (5 B), reszta na maksimach/minimach */
+    cold_boot();
+    BlackBox_Rec_t r = extreme_rec(0x7FFFFFFFu, 0u);
+    const unsigned key = push_size(&r);
+    TEST_CHECK(key <= BB_ENC_MAX);
+
+    /* delty: naprzemiennie skrajności; czas skacze o 2^31 przez zawinięcie 32-bit */
+    unsigned worst = key;
+    uint32_t t = 0x7FFFFFFFu;
+    for (uint32_t i = 1u; i < 200u; i++) {
+        t += (i & 1u) ? 0x80000001u : 0x7FFFFFFEu;
+        r = extreme_rec(t, (uint8_t)(i & 1u));
+        const unsigned n = push_size(&r);
+        TEST_CHECK(n <= BB_ENC_MAX);
+        if (n > worst) worst = n;
+    }
+
+    /* losowe skrajności i pełny zakres czasu */
+    s_rng = 777u;
+    for (uint32_t i = 0; i < 20000u; i++) {
+        if ((i % 200u) == 0u) cold_boot();                  // bez przepełnienia pierścienia
+        r = extreme_rec(rnd() ^ (rnd() << 24), (uint8_t)(rnd() & 1u));
+        r.luna_r = (uint16_t)rnd(); r.cur_l = (int8_t)rnd();
+        const unsigned n = push_size(&r);
+        TEST_CHECK(n <= BB_ENC_MAX);
+        if (n > worst) worst = n;
+    }
+    TEST_EQ(worst, bound);                                  // granica osiągnięta, nie przekroczona
+
+    BlackBox_DumpStart(0u);                                 // skrajne rekordy też się dekodują
+    dump_drain();
+    TEST_EQ(cap_find("BB: koniec"), 1);
+}
+
+int main(void)
+{
+    TEST_RUN(test_bor_freezes_then_rearms_after_dump);
+    TEST_RUN(test_watchdog_twice_in_a_row);
+    TEST_RUN(test_session_freeze_holds_until_arm);
+    TEST_RUN(test_freeze_during_boot_dump_holds);
+    TEST_RUN(test_pin_reset_keeps_recording);
+    TEST_RUN(test_codec_roundtrip);
+    TEST_RUN(test_bb_decode_agrees);
+    TEST_RUN(test_enc_max_worst_case);
+    return TEST_EXIT();
+}
@@ -0,0 +1,254 @@
+/*
+ * ============================================================================
+ *  HOST: test_cfg_store.c — magazyn konfiguracji na symulowanej FLASH (NOR)
+ *  ----------------------------------------------------------------------------
+ *  CO:
+ *    - Zapis → przywrócenie domyślnych → Load: te same wartości wracają do RAM.
+ *    - Kontrola zakresów przy Load: rekord z poprawnym CRC, ale tick_ms = 0 albo
+ *      smooth_alpha = NaN → blok odrzucony (rejected), zostają domyślne; inne bloki wczytane.
+ *    - Reguły między polami (CFG_BlockCheck): set odrzuca esc_max_pct ≤ esc_start_pct,
+ *      Load odrzuca blok edge z delta_off ≥ delta_on (zakresy pól poprawne).
+ *    - Urwany rekord: Host_FlashPowerCut() po k double-wordach dla każdego k — Load
+ *      widzi poprzednią wartość, następny Save dopisuje poprawnie.
+ *    - Przerwane kompaktowanie: zanik po k zapisach na nowej stronie (erase, rekordy,
+ *      nagłówek) — aktywna zostaje stara strona ze starymi wartościami, ponowny Save
+ *      kończy zamianę (seq + 1).
+ *
+ *  Wartości domyślne: kopia bloków z config.c zrobiona na starcie programu.
+ * ============================================================================
+ */
+
+#include "test.h"
+#include "host.h"
+#include "cfg_store.h"
+#include "config.h"
+#include <math.h>
+#include <string.h>
+
+static uint8_t s_def[CFG_BLOCKS_MAX][128];           // ≥ największy blok (rekord ≤ 128 B)
+
+static void defaults_snapshot(void)
+{
+    uint8_t n = 0u;
+    const CFG_Block_t *b = CFG_Blocks(&n);
+    for (uint8_t i = 0; i < n; i++) {
+        TEST_CHECK(b[i].size <= sizeof(s_def[i]));
+        memcpy(s_def[i], b[i].ptr, b[i].size);
+    }
+}
+
+static void defaults_restore(void)
+{
+    uint8_t n = 0u;
+    const CFG_Block_t *b = CFG_Blocks(&n);
+    for (uint8_t i = 0; i < n; i++) memcpy(b[i].ptr, s_def[i], b[i].size);
+}
+
+/* Czysta FLASH, zasilanie OK, RAM = domyślne */
+static void fresh(void)
+{
+    Host_FlashPowerCut(-1);
+    TEST_CHECK(CfgStore_Erase());
+    defaults_restore();
+}
+
+static uint32_t *tick_ms(void)
+{
+    return (uint32_t *)CFG_FieldFind("motors.tick_ms")->ptr;
+}
+
+/* Double-wordy rekordu bloku motors (nagłówek + dane + trailer) */
+static uint32_t motors_rec_dwords(void)
+{
+    const CFG_Block_t *b = CFG_Blocks(NULL);
+    return 2u + (b[0].size + 7u) / 8u;
+}
+
+static CfgStore_Info_t info(void)
+{
+    CfgStore_Info_t ci;
+    CfgStore_GetInfo(&ci);
+    return ci;
+}
+
+static void test_empty_flash_keeps_defaults(void)
+{
+    fresh();
+    const uint32_t def = *tick_ms();
+    TEST_EQ(CfgStore_Load(), 0);
+    TEST_EQ(info().active, -1);
+    TEST_EQ(*tick_ms(), def);
+}
+
+static void test_save_load_roundtrip(void)
+{
+    uint8_t n = 0u;
+    (void)CFG_Blocks(&n);
+    fresh();
+    TEST_CHECK(CFG_FieldSet(CFG_FieldFind("motors.tick_ms"), 30.0f));
+    TEST_CHECK(CFG_FieldSet(CFG_FieldFind("edge.delta_on"), 777.0f));
+    TEST_CHECK(CfgStore_Save());
+
+    defaults_restore();
+    TEST_EQ(CfgStore_Load(), n);
+    TEST_EQ(*tick_ms(), 30);
+    TEST_EQ(CFG_FieldGet(CFG_FieldFind("edge.delta_on")), 777);
+    TEST_EQ(info().bad, 0);
+    TEST_EQ(info().rejected, 0);
+}
+
+static void test_out_of_range_block_rejected(void)
+{
+    uint8_t n = 0u;
+    (void)CFG_Blocks(&n);
+    fresh();
+    const uint32_t def = *tick_ms();
+    *tick_ms() = 0u;                                        // z pominięciem CFG_FieldSet
+    TEST_CHECK(CFG_FieldSet(CFG_FieldFind("sched.sens_ms"), 111.0f));
+    TEST_CHECK(CfgStore_Save());
+
+    defaults_restore();
+    TEST_EQ(CfgStore_Load(), n - 1u);
+    TEST_EQ(info().rejected, 1);
+    TEST_EQ(info().bad, 0);                                 // CRC był poprawny
+    TEST_EQ(*tick_ms(), def);                               // blok motors: domyślne
+    TEST_EQ(CFG_FieldGet(CFG_FieldFind("sched.sens_ms")), 111);
+}
+
+static void test_nan_rejected(void)
+{
+    fresh();
+    const CFG_Field_t *f = CFG_FieldFind("motors.smooth_alpha");
+    const float def = CFG_FieldGet(f);
+    *(float *)f->ptr = NAN;
+    TEST_CHECK(CfgStore_Save());
+
+    defaults_restore();
+    (void)CfgStore_Load();
+    TEST_EQ(info().rejected, 1);
+    TEST_CHECK(CFG_FieldGet(f) == def);
+}
+
+static void test_cross_field_rejected(void)
+{
+    uint8_t n = 0u;
+    (void)CFG_Blocks(&n);
+    fresh();
+    const CFG_Field_t *mx = CFG_FieldFind("motors.esc_max_pct");
+    const float def_max = CFG_FieldGet(mx);
+    TEST_EQ(CFG_FieldSet(mx, 0.0f), 0);                     // w zakresie 0..100, ale < start
+    TEST_CHECK(CFG_FieldConflict(mx, 0.0f) != NULL);
+    TEST_CHECK(CFG_FieldGet(mx) == def_max);                // pole bez zmian
+
+    const CFG_Field_t *on  = CFG_FieldFind("edge.delta_on");
+    const CFG_Field_t *off = CFG_FieldFind("edge.delta_off");
+    const float def_on = CFG_FieldGet(on);
+    TEST_EQ(CFG_FieldSet(off, def_on), 0);                  // histereza odwrócona
+    *(uint16_t *)off->ptr = (uint16_t)(def_on + 50.0f);     // z pominięciem CFG_FieldSet
+    TEST_CHECK(CFG_FieldSet(CFG_FieldFind("sched.sens_ms"), 111.0f));
+    TEST_CHECK(CfgStore_Save());
+
+    defaults_restore();
+    TEST_EQ(CfgStore_Load(), n - 1u);
+    TEST_EQ(info().rejected, 1);
+    TEST_CHECK(CFG_FieldGet(off) < def_on);                 // blok edge: domyślne
+    TEST_EQ(CFG_FieldGet(CFG_FieldFind("sched.sens_ms")), 111);
+}
+
+static void test_torn_record(void)
+{
+    const uint32_t dw = motors_rec_dwords();
+    for (uint32_t k = 0u; k < dw; k++) {
+        fresh();
+        *tick_ms() = 30u;
+        TEST_CHECK(CfgStore_Save());
+
+        *tick_ms() = 40u;
+        Host_FlashPowerCut((int32_t)k);                     // rekord urwany po k double-wordach
+        TEST_EQ(CfgStore_Save(), 0);
+        Host_FlashPowerCut(-1);
+
+        defaults_restore();
+        (void)CfgStore_Load();
+        TEST_EQ(*tick_ms(), 30);
+        TEST_EQ(info().bad, k > 0u ? 1 : 0);                // od nagłówka: rekord ze złym CRC
+
+        *tick_ms() = 40u;                                   // po „restarcie”: zapis od nowa
+        TEST_CHECK(CfgStore_Save());
+        defaults_restore();
+        (void)CfgStore_Load();
+        TEST_EQ(*tick_ms(), 40);
+    }
+}
+
+/* Zapisy naprzemienne aż do zapisu, który kompaktuje; zwraca ich liczbę (bez pierwszego) */
+static uint32_t fill_until_compaction(uint32_t *programs)
+{
+    fresh();
+    TEST_CHECK(CfgStore_Save());
+    const int8_t page = info().active;
+    for (uint32_t i = 1u; i < 1000u; i++) {
+        *tick_ms() = 20u + (i & 1u);
+        const uint32_t p0 = Host_FlashPrograms();
+        TEST_CHECK(CfgStore_Save());
+        if (info().active != page) {
+            *programs = Host_FlashPrograms() - p0;
+            return i;
+        }
+    }
+    TEST_CHECK(0);
+    return 0u;
+}
+
+static void test_compaction_interrupted(void)
+{
+    uint32_t programs = 0u;
+    const uint32_t saves = fill_until_compaction(&programs);
+    uint8_t n = 0u;
+    (void)CFG_Blocks(&n);
+    TEST_CHECK(saves > 1u);
+    TEST_CHECK(programs > n);                               // rekordy wszystkich bloków + nagłówek
+
+    for (uint32_t k = 0u; k < programs; k++) {
+        fresh();
+        TEST_CHECK(CfgStore_Save());
+        for (uint32_t i = 1u; i < saves; i++) {
+            *tick_ms() = 20u + (i & 1u);
+            TEST_CHECK(CfgStore_Save());
+        }
+        const uint32_t last = *tick_ms();
+        const CfgStore_Info_t before = info();
+
+        *tick_ms() = 33u;
+        Host_FlashPowerCut((int32_t)k);                     // zanik w trakcie kompaktowania
+        TEST_EQ(CfgStore_Save(), 0);
+        Host_FlashPowerCut(-1);
+
+        defaults_restore();
+        TEST_EQ(CfgStore_Load(), n);
+        TEST_EQ(info().active, before.active);              // bez nagłówka nowa strona nieważna
+        TEST_EQ(info().seq, before.seq);
+        TEST_EQ(*tick_ms(), last);
+
+        *tick_ms() = 33u;
+        TEST_CHECK(CfgStore_Save());                        // ponowne kompaktowanie
+        TEST_EQ(info().seq, before.seq + 1u);
+        defaults_restore();
+        TEST_EQ(CfgStore_Load(), n);
+        TEST_EQ(info().active, 1 - before.active);
+        TEST_EQ(*tick_ms(), 33);
+    }
+}
+
+int main(void)
+{
+    defaults_snapshot();
+    TEST_RUN(test_empty_flash_keeps_defaults);
+    TEST_RUN(test_save_load_roundtrip);
+    TEST_RUN(test_out_of_range_block_rejected);
+    TEST_RUN(test_nan_rejected);
+    TEST_RUN(test_cross_field_rejected);
+    TEST_RUN(test_torn_record);
+    TEST_RUN(test_compaction_interrupted);
+    return TEST_EXIT();
+}
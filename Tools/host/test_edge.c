@@ -0,0 +1,323 @@
+/*
+ * ============================================================================
+ *  HOST: test_edge.c — testy detektora krawędzi (edge_detect.c) na odtwarzanych śladach
+ *  ----------------------------------------------------------------------------
+ *  CO:
+ *    - EdgeDet_Step(): ślady Clear (zliczenia jak z TCS 2.4 ms/16x) — kalibracja czerni,
+ *      histereza delta_on/delta_off, drgania przy progu, potwierdzenie 'confirm'.
+ *    - Edge_Init/Edge_Poll z prawdziwym tcs3472.c/tank_drive.c za wirtualnym I²C
+ *      (vdev_tcs): ślad odbicia w czasie → maszyna stanów ucieczki (REVERSE → TURN →
+ *      stop), restart z TURN, brak restartu w REVERSE, tryb szybki tylko w ruchu.
+ * ============================================================================
+ */
+
+#include "test.h"
+#include "host.h"
+#include "vdev.h"
+#include "edge_detect.h"
+#include "tank_drive.h"
+#include "motor_bldc.h"
+#include "config.h"
+#include "i2c.h"            // hi2c1, hi2c3
+#include "tim.h"            // htim1
+#include <string.h>
+
+/* ==== Zaślepki modułów, których test nie kompiluje ==== */
+void DebugUART_Crit(const char *msg) { (void)msg; }
+void DebugUART_CritPrintf(const char *fmt, ...) { (void)fmt; }
+
+/* Hook aplikacji: liczymy starty ucieczki i stronę krawędzi */
+static unsigned s_onEscape = 0u;
+static uint8_t  s_escR = 0u, s_escL = 0u;
+void Edge_OnEscape(uint8_t hitR, uint8_t hitL)
+{
+    s_onEscape++;
+    s_escR = hitR; s_escL = hitL;
+}
+
+/* ==== EdgeDet_Step: ślady zliczeń ==== */
+static ConfigEdge_t cfg_trace(uint8_t cal, uint8_t confirm)
+{
+    ConfigEdge_t c = *CFG_Edge();
+    c.cal_samples = cal;
+    c.delta_on    = 200u;
+    c.delta_off   = 100u;
+    c.confirm     = confirm;
+    return c;
+}
+
+/* Odtwarza ślad; out[i] = wynik kroku (1 = nowa krawędź). Zwraca liczbę detekcji. */
+static unsigned replay(EdgeDet_t *d, const ConfigEdge_t *c, const uint16_t *tr, unsigned n, uint8_t *out)
+{
+    unsigned hits = 0u;
+    for (unsigned i = 0; i < n; i++) {
+        const uint8_t h = EdgeDet_Step(d, tr[i], c);
+        if (out) out[i] = h;
+        hits += h;
+    }
+    return hits;
+}
+
+static void test_calibration(void)
+{
+    /* mata z szumem + jeden pik bieli w trakcie kalibracji (robot drgnął) */
+    static const uint16_t tr[8] = { 38, 41, 40, 37, 43, 39, 42, 900 };
+    const ConfigEdge_t c = cfg_trace(8u, 1u);
+    EdgeDet_t d;
+    memset(&d, 0, sizeof(d));
+
+    uint32_t sum = 0u;
+    for (unsigned i = 0; i < 8u; i++) {
+        TEST_EQ(EdgeDet_Step(&d, tr[i], &c), 0);           // w kalibracji brak detekcji
+        TEST_EQ(d.on, 0);
+        sum += tr[i];
+    }
+    TEST_EQ(d.cal_n, 8);
+    TEST_EQ(d.black, sum / 8u);                             // średnia (pik wchodzi w czerń)
+
+    /* po kalibracji: próg = czerń + delta_on */
+    EdgeDet_t e;
+    memset(&e, 0, sizeof(e));
+    static const uint16_t mat[4] = { 40, 40, 40, 40 };
+    const ConfigEdge_t c4 = cfg_trace(4u, 1u);
+    (void)replay(&e, &c4, mat, 4u, NULL);
+    TEST_EQ(e.black, 40);
+    TEST_EQ(EdgeDet_Step(&e, 239u, &c4), 0);                // tuż pod progiem
+    TEST_EQ(EdgeDet_Step(&e, 240u, &c4), 1);                // na progu
+}
+
+static void test_hysteresis(void)
+{
+    /* czerń 40 → wejście ≥ 240, wyjście ≤ 140. Przejazd przez biały pas z drganiami przy
+     * progu wejścia (granica mata/farba) i powrót na matę, potem drugi wjazd. */
+    static const uint16_t tr[] = {
+        40, 40, 40, 40,                         // kalibracja
+        45, 120, 235, 241, 236, 250, 239, 700,  // wjazd: drgania wokół 240 → JEDNA detekcja
+        720, 300, 150, 141,                     // biel → zjazd; 141 > 140: wciąż krawędź
+        140, 180, 239,                          // ≤ 140: mata; poniżej progu wejścia
+        240,                                    // drugi wjazd
+    };
+    static const uint8_t want[] = {
+        0, 0, 0, 0,
+        0, 0, 0, 1, 0, 0, 0, 0,
+        0, 0, 0, 0,
+        0, 0, 0,
+        1,
+    };
+    const unsigned n = (unsigned)(sizeof(tr) / sizeof(tr[0]));
+    const ConfigEdge_t c = cfg_trace(4u, 1u);
+    EdgeDet_t d;
+    uint8_t out[sizeof(tr) / sizeof(tr[0])];
+    memset(&d, 0, sizeof(d));
+
+    TEST_EQ(replay(&d, &c, tr, n, out), 2);
+    for (unsigned i = 0; i < n; i++) {
+        if (out[i] != want[i]) printf("  probka %u: %u (oczekiwane %u)\n", i, out[i], want[i]);
+        TEST_EQ(out[i], want[i]);
+    }
+    TEST_EQ(d.on, 1);
+}
+
+static void test_confirm(void)
+{
+    /* confirm = 2: pojedyncza próbka nad progiem (odblask) to nie krawędź */
+    static const uint16_t tr[] = { 40, 40, 40, 40, 260, 100, 260, 100, 260, 260, 260 };
+    const unsigned n = (unsigned)(sizeof(tr) / sizeof(tr[0]));
+    const ConfigEdge_t c = cfg_trace(4u, 2u);
+    EdgeDet_t d;
+    uint8_t out[sizeof(tr) / sizeof(tr[0])];
+    memset(&d, 0, sizeof(d));
+
+    TEST_EQ(replay(&d, &c, tr, n, out), 1);
+    TEST_EQ(out[9], 1);                                     // druga z rzędu
+    TEST_EQ(out[10], 0);                                    // już widoczna — bez ponownego zbocza
+}
+
+/* ==== Edge_Init/Edge_Poll: ślad odbicia w czasie ==== */
+static VDev_Tcs_t s_vR, s_vL;
+static TCS3472_t  s_tR, s_tL;
+static uint64_t   s_tTank = 0u;
+
+#define REFL_MAT    0.04f
+#define REFL_WHITE  0.80f
+
+/* Jedna iteracja jak App_Tick: Edge_Poll zawsze, Tank_Update co tick_ms; pętla 100 µs */
+static void step(void)
+{
+    Edge_Poll();
+    if (Host_NowUs() - s_tTank >= (uint64_t)CFG_Motors()->tick_ms * 1000u) {
+        s_tTank = Host_NowUs();
+        Tank_Update();
+    }
+    Host_AdvanceUs(100u);
+}
+
+static void run_ms(uint32_t ms)
+{
+    const uint64_t end = Host_NowUs() + (uint64_t)ms * 1000u;
+    while (Host_NowUs() < end) step();
+}
+
+/* Czeka na warunek (≤ limit ms); zwraca czas w ms albo 0xFFFFFFFF */
+static uint32_t run_until(uint8_t (*cond)(void), uint32_t limit_ms)
+{
+    const uint64_t t0 = Host_NowUs();
+    while (!cond()) {
+        if (Host_NowUs() - t0 >= (uint64_t)limit_ms * 1000u) return 0xFFFFFFFFu;
+        step();
+    }
+    return (uint32_t)((Host_NowUs() - t0) / 1000u);
+}
+
+static uint8_t cond_escaping(void) { return Edge_IsEscaping() ? 1u : 0u; }
+
+static void set_refl(float r, float l)
+{
+    VDev_Tcs_Update(&s_vR);                                 // integracja do „teraz” starym wejściem
+    VDev_Tcs_Update(&s_vL);
+    s_vR.in_refl = r;
+    s_vL.in_refl = l;
+}
+
+static void targets(int8_t *tl, int8_t *tr)
+{
+    int8_t cl, cr;
+    Tank_GetState(tl, tr, &cl, &cr);
+}
+
+static void rig_init(void)
+{
+    VDev_Tcs_Init(&s_vR);
+    VDev_Tcs_Init(&s_vL);
+    (void)Host_I2C_Attach(&hi2c1, VDEV_TCS_ADDR, &s_vR.io);
+    (void)Host_I2C_Attach(&hi2c3, VDEV_TCS_ADDR, &s_vL.io);
+    set_refl(REFL_MAT, REFL_MAT);
+    TCS3472_Init(&s_tR, &hi2c1, "R");
+    TCS3472_Init(&s_tL, &hi2c3, "L");
+    ESC_Init(&htim1);
+    Tank_Init(&htim1);
+    s_tTank = Host_NowUs();
+}
+
+static void test_init_calibrates(void)
+{
+    const uint64_t t0 = Host_NowUs();
+    Edge_Init(&s_tR, &s_tL);
+    const uint32_t took = (uint32_t)((Host_NowUs() - t0) / 1000u);
+    const ConfigEdge_t *c = CFG_Edge();
+
+    TEST_CHECK(took >= (uint32_t)c->cal_samples * c->poll_ms);   // kalibracja synchronicznie
+    TEST_CHECK(took < 200u);
+    TEST_EQ(s_tR.pinned, 1);
+    TEST_EQ(s_tL.pinned, 1);
+    TEST_EQ(Edge_Flags(), 0);
+    TEST_CHECK(!Edge_IsEscaping());
+
+    run_ms(1100u);                                          // postój → powrót do kolorów
+    TEST_EQ(s_tR.pinned, 0);
+    TEST_EQ(s_tL.pinned, 0);
+    set_refl(REFL_WHITE, REFL_MAT);
+    run_ms(50u);
+    TEST_EQ(Edge_Count(), 0);                               // na postoju krawędź nieśledzona
+    set_refl(REFL_MAT, REFL_MAT);
+    run_ms(50u);
+}
+
+static void test_escape_right(void)
+{
+    int8_t tl, tr;
+    const ConfigEdge_t *c = CFG_Edge();
+    s_onEscape = 0u;
+
+    Tank_SetTarget(50, 50);
+    run_ms(200u);                                           // jazda: czujniki przypięte
+    TEST_EQ(s_tR.pinned, 1);
+    TEST_EQ(s_tL.pinned, 1);
+    TEST_EQ(Edge_Count(), 0);                               // mata po przepięciu ≠ krawędź
+
+    set_refl(REFL_WHITE, REFL_MAT);                         // prawy czujnik nad bielą
+    const uint32_t lat = run_until(cond_escaping, 100u);
+    TEST_CHECK(lat <= 10u);                                 // 2 × ATIME + poll_ms (+ zaokrąglenia)
+    TEST_EQ(Edge_Count(), 1);
+    TEST_EQ(s_onEscape, 1);
+    TEST_EQ(s_escR, 1);
+    TEST_EQ(s_escL, 0);
+    TEST_CHECK(Tank_IsOverridden());
+    targets(&tl, &tr);
+    TEST_EQ(tl, -c->rev_pct);
+    TEST_EQ(tr, -c->rev_pct);
+
+    /* biel pod czujnikiem w REVERSE: bez restartu */
+    run_ms((uint32_t)c->rev_ms / 2u);
+    TEST_EQ(Edge_Count(), 1);
+    set_refl(REFL_MAT, REFL_MAT);
+
+    /* TURN od krawędzi po prawej → w lewo */
+    run_ms((uint32_t)c->rev_ms / 2u + 5u);
+    targets(&tl, &tr);
+    TEST_EQ(tl, -c->turn_pct);
+    TEST_EQ(tr, +c->turn_pct);
+    TEST_CHECK(Edge_IsEscaping());
+
+    /* koniec manewru: stop, override zwolniony */
+    run_ms((uint32_t)c->turn_ms + 5u);
+    TEST_CHECK(!Edge_IsEscaping());
+    TEST_CHECK(!Tank_IsOverridden());
+    targets(&tl, &tr);
+    TEST_EQ(tl, 0);
+    TEST_EQ(tr, 0);
+    TEST_EQ(s_onEscape, 1);
+}
+
+static void test_escape_restart_in_turn(void)
+{
+    int8_t tl, tr;
+    const ConfigEdge_t *c = CFG_Edge();
+    s_onEscape = 0u;
+    const uint32_t n0 = Edge_Count();
+
+    Tank_SetTarget(40, 40);
+    run_ms(100u);
+    set_refl(REFL_MAT, REFL_WHITE);                         // lewa krawędź
+    TEST_CHECK(run_until(cond_escaping, 100u) != 0xFFFFFFFFu);
+    TEST_EQ(s_escR, 0);
+    TEST_EQ(s_escL, 1);
+    set_refl(REFL_MAT, REFL_MAT);
+    run_ms((uint32_t)c->rev_ms + 5u);
+    targets(&tl, &tr);
+    TEST_EQ(tl, +c->turn_pct);                              // lewa krawędź → w prawo
+    TEST_EQ(tr, -c->turn_pct);
+
+    /* nowa krawędź w fazie TURN → manewr od początku (REVERSE) */
+    set_refl(REFL_WHITE, REFL_WHITE);
+    run_ms(15u);
+    TEST_EQ(Edge_Count(), n0 + 2u);
+    TEST_EQ(s_onEscape, 2);
+    targets(&tl, &tr);
+    TEST_EQ(tl, -c->rev_pct);
+    TEST_EQ(tr, -c->rev_pct);
+    set_refl(REFL_MAT, REFL_MAT);
+
+    run_ms((uint32_t)c->rev_ms + (uint32_t)c->turn_ms + 10u);
+    TEST_CHECK(!Edge_IsEscaping());
+    targets(&tl, &tr);
+    TEST_EQ(tl, 0);
+    TEST_EQ(tr, 0);
+
+    /* po ucieczce rampa do zera (70% / ramp_step_pct ticków), potem 1 s postoju → kolory */
+    run_ms(1500u);
+    TEST_EQ(s_tR.pinned, 0);
+}
+
+int main(void)
+{
+    TEST_RUN(test_calibration);
+    TEST_RUN(test_hysteresis);
+    TEST_RUN(test_confirm);
+
+    rig_init();
+    TEST_RUN(test_init_calibrates);
+    TEST_RUN(test_escape_right);
+    TEST_RUN(test_escape_restart_in_turn);
+    return TEST_EXIT();
+}
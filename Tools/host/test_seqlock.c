@@ -0,0 +1,163 @@
+/*
+ * ============================================================================
+ *  HOST: test_seqlock.c — test obciążeniowy seqlock.h na wątkach (pthread)
+ *  ----------------------------------------------------------------------------
+ *  CO:
+ *    - Jeden pisarz, kilku czytelników na jednym snapshocie: pisarz wypełnia całą
+ *      strukturę numerem generacji (+ suma kontrolna), czytelnicy SeqLock_Load() i
+ *      sprawdzają, czy każde słowo pochodzi z tej samej generacji (rozerwany odczyt = błąd)
+ *      i czy generacje u danego czytelnika nie maleją.
+ *    - Limit prób: zapis „w toku” → SeqLock_Load(max_tries) zwraca 0, po WriteEnd 1.
+ *    - Kontrola detektora: ten sam wyścig bez seqlocka — liczba rozerwanych kopii
+ *      tylko drukowana (na jednym rdzeniu może wyjść 0).
+ *
+ *  Na hoście wątki są naprawdę równoległe (gorzej niż ISR ⇄ pętla na jednym rdzeniu),
+ *  więc test sprawdza też bariery, nie tylko kolejność liczników.
+ * ============================================================================
+ */
+
+#include "test.h"
+#include "seqlock.h"
+#include <pthread.h>
+#include <stdint.h>
+
+#define SNAP_WORDS     62u              // 256 B: szerokie okno na rozerwanie kopii
+#define READERS        3u
+#define WRITES         400000u
+
+typedef struct {
+    uint32_t gen;
+    uint32_t w[SNAP_WORDS];
+    uint32_t sum;                       // gen × SNAP_WORDS (kontrola spójności)
+} Snap_t;
+
+static SeqLock_t     s_lock = SEQLOCK_INIT;
+static Snap_t        s_snap;
+static volatile int  s_stop = 0;
+static volatile int  s_useLock = 1;
+
+typedef struct {
+    uint64_t loads, torn, fails, backwards;
+} ReaderStat_t;
+
+static void snap_fill(Snap_t *s, uint32_t gen)
+{
+    s->gen = gen;
+    for (uint32_t i = 0; i < SNAP_WORDS; i++) s->w[i] = gen;
+    s->sum = gen * SNAP_WORDS;
+}
+
+static int snap_torn(const Snap_t *s)
+{
+    for (uint32_t i = 0; i < SNAP_WORDS; i++) {
+        if (s->w[i] != s->gen) return 1;
+    }
+    return s->sum != s->gen * SNAP_WORDS;
+}
+
+static void *writer(void *arg)
+{
+    (void)arg;
+    Snap_t fresh;
+    for (uint32_t g = 1u; g <= WRITES; g++) {
+        snap_fill(&fresh, g);
+        if (s_useLock) SeqLock_Store(&s_lock, &s_snap, &fresh, sizeof(fresh));
+        else           memcpy(&s_snap, &fresh, sizeof(fresh));
+    }
+    s_stop = 1;
+    return NULL;
+}
+
+static void *reader(void *arg)
+{
+    ReaderStat_t *st = (ReaderStat_t *)arg;
+    Snap_t copy;
+    uint32_t last = 0u;
+    while (!s_stop) {
+        if (s_useLock) {
+            if (!SeqLock_Load(&s_lock, &copy, &s_snap, sizeof(copy), 0u)) { st->fails++; continue; }
+        } else {
+            memcpy(&copy, (const void *)&s_snap, sizeof(copy));
+        }
+        st->loads++;
+        if (snap_torn(&copy)) { st->torn++; continue; }
+        if (copy.gen < last) st->backwards++;
+        last = copy.gen;
+    }
+    return NULL;
+}
+
+/* Pisarz + READERS czytelników; zwraca sumy statystyk */
+static ReaderStat_t race(int useLock)
+{
+    pthread_t     tw, tr[READERS];
+    ReaderStat_t  st[READERS], tot = { 0u, 0u, 0u, 0u };
+
+    memset(st, 0, sizeof(st));
+    snap_fill(&s_snap, 0u);
+    s_lock.seq = 0u;
+    s_stop     = 0;
+    s_useLock  = useLock;
+
+    for (uint32_t i = 0; i < READERS; i++) (void)pthread_create(&tr[i], NULL, reader, &st[i]);
+    (void)pthread_create(&tw, NULL, writer, NULL);
+    (void)pthread_join(tw, NULL);
+    for (uint32_t i = 0; i < READERS; i++) {
+        (void)pthread_join(tr[i], NULL);
+        tot.loads += st[i].loads; tot.torn += st[i].torn;
+        tot.fails += st[i].fails; tot.backwards += st[i].backwards;
+    }
+    return tot;
+}
+
+static void test_stress_no_torn_reads(void)
+{
+    const ReaderStat_t st = race(1);
+    printf("  seqlock: %llu odczytow, rozerwane %llu, cofniete %llu\n",
+           (unsigned long long)st.loads, (unsigned long long)st.torn, (unsigned long long)st.backwards);
+    TEST_CHECK(st.loads > 0u);
+    TEST_EQ(st.torn, 0);
+    TEST_EQ(st.backwards, 0);
+    TEST_EQ(st.fails, 0);                                   // max_tries = 0: bez limitu
+    TEST_EQ(s_lock.seq, 2u * WRITES);                       // parzysty: żaden zapis nie wisi
+}
+
+static void test_detector_without_lock(void)
+{
+    const ReaderStat_t st = race(0);
+    printf("  bez seqlocka: %llu odczytow, rozerwane %llu (informacyjnie)\n",
+           (unsigned long long)st.loads, (unsigned long long)st.torn);
+    TEST_CHECK(st.loads > 0u);
+}
+
+static void test_bounded_tries(void)
+{
+    Snap_t copy;
+    snap_fill(&s_snap, 7u);
+    s_lock.seq = 0u;
+
+    SeqLock_WriteBegin(&s_lock);                            // pisarz „wywłaszczony” w połowie
+    s_snap.w[0] = 8u;
+    TEST_EQ(SeqLock_Load(&s_lock, &copy, &s_snap, sizeof(copy), 4u), 0);
+    TEST_EQ(s_lock.seq & 1u, 1);
+
+    snap_fill(&s_snap, 8u);
+    SeqLock_WriteEnd(&s_lock);
+    TEST_EQ(SeqLock_Load(&s_lock, &copy, &s_snap, sizeof(copy), 4u), 1);
+    TEST_EQ(copy.gen, 8);
+    TEST_CHECK(!snap_torn(&copy));
+
+    /* licznik zmieniony między ReadBegin a ReadRetry → retry */
+    const uint32_t s = SeqLock_ReadBegin(&s_lock);
+    SeqLock_Store(&s_lock, &s_snap, &copy, sizeof(copy));
+    TEST_EQ(SeqLock_ReadRetry(&s_lock, s), 1);
+    TEST_EQ(SeqLock_ReadRetry(&s_lock, SeqLock_ReadBegin(&s_lock)), 0);
+}
+
+int main(void)
+{
+    TEST_RUN(test_bounded_tries);
+    TEST_RUN(test_stress_no_torn_reads);
+    TEST_RUN(test_detector_without_lock);
+    return TEST_EXIT();
+}
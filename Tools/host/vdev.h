@@ -0,0 +1,123 @@
+/*
+ * ============================================================================
+ *  HOST: vdev.h — wirtualne urządzenia I²C (modele rejestrowe za HAL_I2C_*)
+ *  ----------------------------------------------------------------------------
+ *  CO:
+ *    - TF-Luna: wskaźnik rejestru; dane 0x00..0x05 (dystans cm, amplituda, temperatura
+ *      0.01 °C), TICK 0x06, ERROR 0x08, wersja 0x0A, SN 0x10; konfiguracja 0x20..0x31:
+ *      SAVE, REBOOT, SLAVE_ADDR (aktywny od razu, trwały po SAVE), MODE, TRIG, ENABLE,
+ *      FPS, AMP_THR, DUMMY/MIN/MAX_DIST, RESTORE_FACTORY. Pomiar ciągły co 1/FPS,
+ *      w trybie trigger jeden pomiar VDEV_LUNA_MEAS_US po zapisie TRIG.
+ *    - TCS3472: bajt komendy (repeated / auto-increment / special function), ENABLE
+ *      (PON/AEN/WEN/AIEN), ATIME, WTIME (+WLONG), progi AILT/AIHT + PERS, CONTROL (gain),
+ *      ID, STATUS.AVALID/AINT. Integracja po rozgrzewce 2.4 ms od PON; CDATA = średnie
+ *      wejście z całego okna, zatrzaskiwane na jego końcu.
+ *    - SSD1306: dekoder strumienia (bajt kontrolny Co/D#C, polecenia z argumentami także
+ *      rozbite na kilka transakcji), GRAM 128×64 z trybami adresowania poziomym/pionowym/
+ *      stronicowym i oknem 0x21/0x22, stan wyświetlania (ON/OFF, kontrast, inwersja, remap).
+ *    - Wejścia fizyczne (pola "in_*") ustawia program hosta, np. symulator z geometrii.
+ *    - Błędy (NAK, stretching, zablokowana magistrala): pole io.fault (host.h).
+ *
+ *  KIEDY:
+ *    - VDev_*_Init(), potem Host_I2C_Attach(&hi2cX, addr7, &dev.io) — TF-Luna przez
+ *      VDev_Luna_Attach (pamięta magistralę: zmiana adresu przepina model).
+ *    - VDev_*_Update() PRZED zmianą wejść: pomiar/integracja do „teraz” ze starymi
+ *      wartościami (odczyty I²C wołają to same).
+ * ============================================================================
+ */
+
+#ifndef HOST_VDEV_H_
+#define HOST_VDEV_H_
+
+#include "host.h"
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ==== TF-Luna (I²C, domyślnie 0x10) ==== */
+#define VDEV_LUNA_ADDR      0x10u
+#define VDEV_LUNA_MEAS_US   2500u      // trigger → dane gotowe
+#define VDEV_LUNA_BOOT_US   80000u     // po REBOOT: brak ACK przez tyle µs (driver czeka 100 ms)
+#define VDEV_LUNA_NREG      0x40u
+
+typedef struct {
+    Host_I2CDev_t io;
+    /* wejścia fizyczne */
+    uint16_t in_dist_cm;               // odległość do celu
+    uint16_t in_amp;                   // siła sygnału
+    int16_t  in_temp_c100;             // temperatura [0.01 °C]
+    /* rejestry: bieżące i zapisane (SAVE → „flash” układu, REBOOT/RESTORE wraca do nich) */
+    uint8_t  reg[VDEV_LUNA_NREG];
+    uint8_t  saved[VDEV_LUNA_NREG];
+    uint8_t  ptr;                      // wskaźnik rejestru (pierwszy bajt zapisu)
+    I2C_HandleTypeDef *bus;            // do przepięcia po zmianie adresu
+    uint8_t  addr7;                    // adres, pod którym model jest przypięty
+    uint64_t t_next;                   // następna ramka (ciągły) / koniec pomiaru (trigger)
+    uint8_t  trig_pending;             // trigger: pomiar w toku
+    uint64_t t_boot;                   // koniec restartu (do tego czasu NAK)
+    uint32_t frames;                   // licznik pomiarów (statystyka)
+} VDev_Luna_t;
+
+void    VDev_Luna_Init(VDev_Luna_t *d);
+uint8_t VDev_Luna_Attach(VDev_Luna_t *d, I2C_HandleTypeDef *bus, uint8_t addr7);
+void    VDev_Luna_Update(VDev_Luna_t *d);
+
+/* ==== TCS3472 (I²C, 0x29) ==== */
+#define VDEV_TCS_ADDR       0x29u
+#define VDEV_TCS_ID         0x44u      // TCS34721/34725 (0x4D = 34723/34727)
+#define VDEV_TCS_CNT_1X     60.0f      // zliczenia Clear / cykl przy gain 1× i odbiciu 1.0
+#define VDEV_TCS_CYCLE_US   2400u      // jeden cykl integracji / oczekiwania
+
+typedef struct {
+    Host_I2CDev_t io;
+    /* wejście fizyczne */
+    float    in_refl;                  // współczynnik odbicia pod czujnikiem (0..1)
+    /* rejestry */
+    uint8_t  reg[0x20];                // ENABLE, ATIME, …, CONTROL, ID, STATUS, dane
+    uint8_t  ptr;                      // adres z ostatniej komendy
+    uint8_t  autoinc;                  // 1 = auto-increment (typ 01)
+    /* cykl RGBC: [rozgrzewka] integracja [oczekiwanie WTIME] integracja … */
+    uint64_t t_start;                  // początek bieżącego okna integracji (µs)
+    uint64_t t_acc;                    // do kiedy wejście jest scałkowane
+    float    acc;                      // całka odbicia w bieżącym oknie [× µs]
+    uint8_t  pers_cnt;                 // kolejne wyniki poza progami (PERS)
+    uint32_t noise;                    // stan PRNG szumu
+    uint32_t cycles;                   // zakończone integracje (statystyka)
+} VDev_Tcs_t;
+
+void VDev_Tcs_Init(VDev_Tcs_t *d);
+void VDev_Tcs_Update(VDev_Tcs_t *d);
+
+/* ==== SSD1306 (I²C, 0x3C) ==== */
+#define VDEV_OLED_ADDR      0x3Cu
+#define VDEV_OLED_W         128u
+#define VDEV_OLED_PAGES     8u
+
+typedef struct {
+    Host_I2CDev_t io;
+    uint8_t  gram[VDEV_OLED_PAGES][VDEV_OLED_W];
+    /* wskaźnik zapisu i okno */
+    uint8_t  mode;                     // 0x20: 0 = poziomy, 1 = pionowy, 2 = stronicowy
+    uint8_t  col, page;
+    uint8_t  col_lo, col_hi, page_lo, page_hi;
+    /* polecenie z argumentami w toku (także przez granice transakcji) */
+    uint8_t  cmd, need, got, arg[6];
+    /* stan wyświetlania */
+    uint8_t  on, contrast, invert, entire_on, seg_remap, com_dec, start_line, mux;
+    uint8_t  charge_pump;
+    /* statystyka */
+    uint32_t n_cmd, n_data, n_bad;     // polecenia, bajty GRAM, nieznane polecenia
+} VDev_Oled_t;
+
+void    VDev_Oled_Init(VDev_Oled_t *d);
+/* Piksel widoczny (x 0..127, y 0..63) w układzie GRAM — uwzględnia ON/OFF, A5 i inwersję */
+uint8_t VDev_Oled_Pixel(const VDev_Oled_t *d, uint8_t x, uint8_t y);
+/* Ekran jako tekst: 64 wiersze × 128 znaków ('#' = świeci) */
+void    VDev_Oled_Dump(const VDev_Oled_t *d, FILE *f);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* HOST_VDEV_H_ */
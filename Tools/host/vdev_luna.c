@@ -0,0 +1,187 @@
+/*
+ * ============================================================================
+ *  HOST: vdev_luna.c — model rejestrowy TF-Luna (I²C)
+ *  ----------------------------------------------------------------------------
+ *  CO:
+ *    - Zapis: [reg] ustawia wskaźnik; [reg, val…] zapis rejestrów od reg.
+ *    - Odczyt od wskaźnika (bez auto-przesunięcia między transakcjami).
+ *    - Pomiar = zatrzaśnięcie wejść do 0x00..0x07: amplituda < AMP_THR → DUMMY_DIST,
+ *      dystans obcięty do [MIN_DIST, MAX_DIST]; TICK = czas pomiaru w ms.
+ *    - SLAVE_ADDR działa od razu (model przepina się na magistrali), ale bez SAVE
+ *      REBOOT wraca do zapisanego adresu — jak w układzie.
+ * ============================================================================
+ */
+
+#include "vdev.h"
+#include <string.h>
+
+#define LUNA_DIST      0x00u
+#define LUNA_AMP       0x02u
+#define LUNA_TEMP      0x04u
+#define LUNA_TICK      0x06u
+#define LUNA_ERROR     0x08u
+#define LUNA_VERSION   0x0Au
+#define LUNA_SN        0x10u
+#define LUNA_SAVE      0x20u
+#define LUNA_REBOOT    0x21u
+#define LUNA_ADDR      0x22u
+#define LUNA_MODE      0x23u
+#define LUNA_TRIG      0x24u
+#define LUNA_ENABLE    0x25u
+#define LUNA_FPS       0x26u
+#define LUNA_LOWPOWER  0x28u
+#define LUNA_RESTORE   0x29u
+#define LUNA_AMP_THR   0x2Au
+#define LUNA_DUMMY     0x2Cu
+#define LUNA_MIN_DIST  0x2Eu
+#define LUNA_MAX_DIST  0x30u
+#define LUNA_CFG_FIRST 0x20u           // od tego adresu: konfiguracja (SAVE/RESTORE)
+
+static inline uint16_t luna_get16(const VDev_Luna_t *d, uint8_t r)
+{
+    return (uint16_t)(d->reg[r] | (d->reg[r + 1u] << 8));
+}
+static inline void luna_put16(VDev_Luna_t *d, uint8_t r, uint16_t v)
+{
+    d->reg[r] = (uint8_t)(v & 0xFFu);
+    d->reg[r + 1u] = (uint8_t)(v >> 8);
+}
+
+/* Ustawienia fabryczne (obszar konfiguracji; adres zostaje bieżący) */
+static void luna_factory(VDev_Luna_t *d)
+{
+    memset(&d->reg[LUNA_CFG_FIRST], 0, VDEV_LUNA_NREG - LUNA_CFG_FIRST);
+    d->reg[LUNA_ADDR]   = d->addr7 ? d->addr7 : VDEV_LUNA_ADDR;
+    d->reg[LUNA_ENABLE] = 0x01u;
+    luna_put16(d, LUNA_FPS,      100u);
+    luna_put16(d, LUNA_AMP_THR,  100u);
+    luna_put16(d, LUNA_MAX_DIST, 800u);
+}
+
+static void luna_measure(VDev_Luna_t *d, uint64_t t_us)
+{
+    uint16_t dist = d->in_dist_cm;
+    if (d->in_amp < luna_get16(d, LUNA_AMP_THR)) {
+        dist = luna_get16(d, LUNA_DUMMY);
+    } else {
+        if (dist < luna_get16(d, LUNA_MIN_DIST)) dist = luna_get16(d, LUNA_MIN_DIST);
+        if (dist > luna_get16(d, LUNA_MAX_DIST)) dist = luna_get16(d, LUNA_MAX_DIST);
+    }
+    luna_put16(d, LUNA_DIST,  dist);
+    luna_put16(d, LUNA_AMP,   d->in_amp);
+    luna_put16(d, LUNA_TEMP,  (uint16_t)d->in_temp_c100);
+    luna_put16(d, LUNA_TICK,  (uint16_t)(t_us / 1000u));
+    luna_put16(d, LUNA_ERROR, 0u);
+    d->frames++;
+}
+
+void VDev_Luna_Update(VDev_Luna_t *d)
+{
+    const uint64_t now = Host_NowUs();
+    if (now < d->t_boot || !d->reg[LUNA_ENABLE]) return;
+
+    if (d->reg[LUNA_MODE] & 0x01u) {                     // trigger: jeden pomiar po TRIG
+        if (d->trig_pending && now >= d->t_next) {
+            luna_measure(d, d->t_next);
+            d->trig_pending = 0u;
+        }
+        return;
+    }
+    const uint16_t fps = luna_get16(d, LUNA_FPS);
+    if (fps == 0u) return;
+    const uint64_t period = 1000000u / fps;
+    if (now > d->t_next + 2u * period) {                // długa przerwa: wejście stałe → skok
+        const uint64_t k = (now - d->t_next) / period;
+        d->t_next += k * period;
+        d->frames += (uint32_t)k;
+    }
+    while (d->t_next <= now) {
+        luna_measure(d, d->t_next);
+        d->t_next += period;
+    }
+}
+
+static void luna_write_reg(VDev_Luna_t *d, uint8_t r, uint8_t v)
+{
+    const uint64_t now = Host_NowUs();
+    switch (r) {
+    case LUNA_SAVE:
+        if (v == 0x01u) memcpy(&d->saved[LUNA_CFG_FIRST], &d->reg[LUNA_CFG_FIRST], VDEV_LUNA_NREG - LUNA_CFG_FIRST);
+        break;
+    case LUNA_REBOOT:
+        if (v == 0x02u) {
+            memcpy(&d->reg[LUNA_CFG_FIRST], &d->saved[LUNA_CFG_FIRST], VDEV_LUNA_NREG - LUNA_CFG_FIRST);
+            if (d->bus && Host_I2C_Move(d->bus, d->addr7, d->reg[LUNA_ADDR], &d->io)) d->addr7 = d->reg[LUNA_ADDR];
+            d->t_boot = now + VDEV_LUNA_BOOT_US;
+            d->t_next = d->t_boot;
+            d->trig_pending = 0u;
+        }
+        break;
+    case LUNA_ADDR:
+        if (v >= 0x08u && v <= 0x77u && d->bus && Host_I2C_Move(d->bus, d->addr7, v, &d->io)) {
+            d->reg[LUNA_ADDR] = v;
+            d->addr7 = v;
+        }
+        break;
+    case LUNA_MODE:
+        d->reg[LUNA_MODE] = v & 0x01u;
+        d->t_next = now;
+        d->trig_pending = 0u;
+        break;
+    case LUNA_TRIG:
+        if ((d->reg[LUNA_MODE] & 0x01u) && v == 0x01u) {
+            d->trig_pending = 1u;
+            d->t_next = now + VDEV_LUNA_MEAS_US;
+        }
+        break;
+    case LUNA_RESTORE:
+        if (v == 0x01u) luna_factory(d);
+        break;
+    default:
+        if (r >= LUNA_ENABLE && r < VDEV_LUNA_NREG) d->reg[r] = v;   // 0x00..0x1F tylko do odczytu
+        break;
+    }
+}
+
+static HAL_StatusTypeDef luna_write(Host_I2CDev_t *io, const uint8_t *data, uint16_t n)
+{
+    VDev_Luna_t *d = (VDev_Luna_t *)io->ctx;
+    if (Host_NowUs() < d->t_boot) return HAL_ERROR;      // restart: brak ACK
+    if (n == 0u) return HAL_OK;                          // sam adres (IsDeviceReady)
+    VDev_Luna_Update(d);
+    d->ptr = data[0];
+    for (uint16_t i = 1u; i < n; i++) luna_write_reg(d, (uint8_t)(d->ptr + i - 1u), data[i]);
+    return HAL_OK;
+}
+
+static HAL_StatusTypeDef luna_read(Host_I2CDev_t *io, uint8_t *data, uint16_t n)
+{
+    VDev_Luna_t *d = (VDev_Luna_t *)io->ctx;
+    if (Host_NowUs() < d->t_boot) return HAL_ERROR;
+    VDev_Luna_Update(d);
+    for (uint16_t i = 0u; i < n; i++) data[i] = d->reg[(uint8_t)(d->ptr + i) & (VDEV_LUNA_NREG - 1u)];
+    return HAL_OK;
+}
+
+void VDev_Luna_Init(VDev_Luna_t *d)
+{
+    memset(d, 0, sizeof(*d));
+    d->io.write = luna_write;
+    d->io.read  = luna_read;
+    d->io.ctx   = d;
+    d->in_temp_c100 = 2500;
+    d->reg[LUNA_VERSION]      = 0x02u;                   // v3.0.2 — revision, minor, major
+    d->reg[LUNA_VERSION + 2u] = 0x03u;
+    memcpy(&d->reg[LUNA_SN], "DZBSIM00000001", 14u);
+    luna_factory(d);
+    memcpy(d->saved, d->reg, sizeof(d->saved));
+    d->t_next = Host_NowUs();
+}
+
+uint8_t VDev_Luna_Attach(VDev_Luna_t *d, I2C_HandleTypeDef *bus, uint8_t addr7)
+{
+    d->bus   = bus;
+    d->addr7 = addr7;
+    d->reg[LUNA_ADDR] = d->saved[LUNA_ADDR] = addr7;     // „fabrycznie” pod tym adresem
+    return Host_I2C_Attach(bus, addr7, &d->io);
+}
@@ -0,0 +1,159 @@
+/*
+ * ============================================================================
+ *  HOST: vdev_oled.c — model SSD1306 128×64 (I²C)
+ *  ----------------------------------------------------------------------------
+ *  CO:
+ *    - Transakcja = ciąg [bajt kontrolny, bajty…]: Co = 1 → jeden bajt, potem kolejny
+ *      bajt kontrolny; Co = 0 → reszta transakcji. D/C# = 1 → GRAM, 0 → polecenia.
+ *    - Polecenia z argumentami składane bajt po bajcie (driver wysyła każdy bajt w osobnej
+ *      transakcji [0x00, b]) — stan dekodera przeżywa STOP.
+ *    - Zapis GRAM przesuwa wskaźnik wg trybu 0x20 (poziomy/pionowy w oknie 0x21/0x22,
+ *      stronicowy: B0..B7 + 00..1F). Przewijanie (26/27/29/2A/A3/2E/2F) — tylko dekodowane.
+ * ============================================================================
+ */
+
+#include "vdev.h"
+#include <string.h>
+
+/* Liczba bajtów argumentów polecenia (0 = bez argumentów albo jednobajtowe) */
+static uint8_t oled_argc(uint8_t c)
+{
+    switch (c) {
+    case 0x20: case 0x81: case 0x8D: case 0xA8: case 0xD3:
+    case 0xD5: case 0xD9: case 0xDA: case 0xDB:
+        return 1u;
+    case 0x21: case 0x22: case 0xA3:
+        return 2u;
+    case 0x29: case 0x2A:
+        return 5u;
+    case 0x26: case 0x27:
+        return 6u;
+    default:
+        return 0u;
+    }
+}
+
+static void oled_exec(VDev_Oled_t *d, uint8_t c, const uint8_t *a)
+{
+    d->n_cmd++;
+    switch (c) {
+    case 0x20: if ((a[0] & 0x03u) != 0x03u) d->mode = a[0] & 0x03u; return;
+    case 0x21:
+        d->col_lo = a[0] & 0x7Fu; d->col_hi = a[1] & 0x7Fu; d->col = d->col_lo;
+        return;
+    case 0x22:
+        d->page_lo = a[0] & 0x07u; d->page_hi = a[1] & 0x07u; d->page = d->page_lo;
+        return;
+    case 0x81: d->contrast = a[0]; return;
+    case 0x8D: d->charge_pump = (a[0] & 0x04u) ? 1u : 0u; return;
+    case 0xA8: d->mux = a[0] & 0x3Fu; return;
+    case 0xA0: case 0xA1: d->seg_remap = c & 0x01u; return;
+    case 0xA4: case 0xA5: d->entire_on = c & 0x01u; return;
+    case 0xA6: case 0xA7: d->invert    = c & 0x01u; return;
+    case 0xAE: case 0xAF: d->on        = c & 0x01u; return;
+    case 0xC0: case 0xC8: d->com_dec   = (c == 0xC8u); return;
+    case 0xD3: case 0xD5: case 0xD9: case 0xDA: case 0xDB:   // offset, zegar, precharge, piny COM, VCOMH
+    case 0x26: case 0x27: case 0x29: case 0x2A: case 0xA3:   // przewijanie
+    case 0x2E: case 0x2F: case 0xE3:                         // stop/start przewijania, NOP
+        return;
+    default:
+        break;
+    }
+    if (c >= 0x40u && c <= 0x7Fu)      d->start_line = c & 0x3Fu;
+    else if (c >= 0xB0u && c <= 0xB7u) d->page = c & 0x07u;
+    else if (c <= 0x0Fu)               d->col = (uint8_t)((d->col & 0x70u) | c);
+    else if (c <= 0x1Fu)               d->col = (uint8_t)((d->col & 0x0Fu) | ((c & 0x07u) << 4));
+    else { d->n_cmd--; d->n_bad++; }
+}
+
+static void oled_cmd(VDev_Oled_t *d, uint8_t b)
+{
+    if (d->need) {
+        d->arg[d->got++] = b;
+        if (d->got == d->need) {
+            d->need = 0u;
+            oled_exec(d, d->cmd, d->arg);
+        }
+        return;
+    }
+    const uint8_t argc = oled_argc(b);
+    if (argc) { d->cmd = b; d->need = argc; d->got = 0u; }
+    else      oled_exec(d, b, d->arg);
+}
+
+static void oled_data(VDev_Oled_t *d, uint8_t b)
+{
+    d->gram[d->page][d->col] = b;
+    d->n_data++;
+    switch (d->mode) {
+    case 0u:                                             // poziomy: kolumna, potem strona
+        if (++d->col > d->col_hi) {
+            d->col = d->col_lo;
+            if (++d->page > d->page_hi) d->page = d->page_lo;
+        }
+        break;
+    case 1u:                                             // pionowy: strona, potem kolumna
+        if (++d->page > d->page_hi) {
+            d->page = d->page_lo;
+            if (++d->col > d->col_hi) d->col = d->col_lo;
+        }
+        break;
+    default:                                             // stronicowy: tylko kolumna
+        d->col = (uint8_t)((d->col + 1u) & (VDEV_OLED_W - 1u));
+        break;
+    }
+}
+
+static HAL_StatusTypeDef oled_write(Host_I2CDev_t *io, const uint8_t *data, uint16_t n)
+{
+    VDev_Oled_t *d = (VDev_Oled_t *)io->ctx;
+    uint16_t i = 0u;
+    while (i < n) {
+        const uint8_t ctrl = data[i++];
+        const uint8_t dc   = (ctrl & 0x40u) ? 1u : 0u;
+        const uint16_t end = (ctrl & 0x80u) ? (uint16_t)((i < n) ? i + 1u : i) : n;   // Co
+        for (; i < end; i++) {
+            if (dc) oled_data(d, data[i]);
+            else    oled_cmd(d, data[i]);
+        }
+    }
+    return HAL_OK;
+}
+
+static HAL_StatusTypeDef oled_read(Host_I2CDev_t *io, uint8_t *data, uint16_t n)
+{
+    VDev_Oled_t *d = (VDev_Oled_t *)io->ctx;
+    for (uint16_t i = 0u; i < n; i++) data[i] = d->on ? 0x03u : 0x43u;   // bajt statusu (D6 = OFF)
+    return HAL_OK;
+}
+
+void VDev_Oled_Init(VDev_Oled_t *d)
+{
+    memset(d, 0, sizeof(*d));
+    d->io.write = oled_write;
+    d->io.read  = oled_read;
+    d->io.ctx   = d;
+    d->mode     = 2u;                                    // reset: adresowanie stronicowe
+    d->col_hi   = VDEV_OLED_W - 1u;
+    d->page_hi  = VDEV_OLED_PAGES - 1u;
+    d->contrast = 0x7Fu;
+    d->mux      = 63u;
+}
+
+uint8_t VDev_Oled_Pixel(const VDev_Oled_t *d, uint8_t x, uint8_t y)
+{
+    if (!d->on || x >= VDEV_OLED_W || y >= VDEV_OLED_PAGES * 8u) return 0u;
+    uint8_t v = d->entire_on ? 1u : (uint8_t)((d->gram[y >> 3][x] >> (y & 7u)) & 1u);
+    return d->invert ? (uint8_t)(v ^ 1u) : v;
+}
+
+void VDev_Oled_Dump(const VDev_Oled_t *d, FILE *f)
+{
+    char line[VDEV_OLED_W + 2u];
+    for (uint8_t y = 0u; y < VDEV_OLED_PAGES * 8u; y++) {
+        for (uint8_t x = 0u; x < VDEV_OLED_W; x++) line[x] = VDev_Oled_Pixel(d, x, y) ? '#' : '.';
+        line[VDEV_OLED_W] = '\n';
+        line[VDEV_OLED_W + 1u] = '\0';
+        fputs(line, f);
+    }
+}
@@ -0,0 +1,221 @@
+/*
+ * ============================================================================
+ *  HOST: vdev_tcs.c — model rejestrowy TCS3472 (I²C)
+ *  ----------------------------------------------------------------------------
+ *  CO:
+ *    - Komenda: bit7 = CMD, bity 6:5 = typ (00 repeated, 01 auto-inc, 11 special),
+ *      bity 4:0 = rejestr; special 0x06 kasuje AINT. Bez bitu CMD — NAK.
+ *    - Cykl RGBC przy PON|AEN: rozgrzewka 2.4 ms od włączenia, integracja
+ *      T = (256 − ATIME) × 2.4 ms, przy WEN oczekiwanie (256 − WTIME) × 2.4 ms (× 12 przy
+ *      CONFIG.WLONG), znowu integracja… Wejście całkowane odcinkami (stałe między
+ *      wywołaniami VDev_Tcs_Update); na końcu okna CDATA = średnie odbicie × 60 × gain ×
+ *      cykle (+ szum ±1%), obcięte do pełnej skali min(65535, 1024 × cykle).
+ *    - Zapis ATIME/CONTROL przerywa bieżące okno i zaczyna nowe (wynik zawsze w jednym
+ *      ustawieniu — driver przy auto-gain i tak odrzuca próbkę z poprzedniego kroku).
+ *    - STATUS: AVALID po pierwszej integracji; AINT, gdy PERS kolejnych wyników jest poza
+ *      [AILT, AIHT] (PERS = 0 → po każdej integracji).
+ * ============================================================================
+ */
+
+#include "vdev.h"
+
+#define TCS_ENABLE    0x00u
+#define TCS_ATIME     0x01u
+#define TCS_WTIME     0x03u
+#define TCS_AILTL     0x04u
+#define TCS_AIHTL     0x06u
+#define TCS_PERS      0x0Cu
+#define TCS_CONFIG    0x0Du
+#define TCS_CONTROL   0x0Fu
+#define TCS_ID        0x12u
+#define TCS_STATUS    0x13u
+#define TCS_CDATAL    0x14u
+
+#define TCS_EN_PON    0x01u
+#define TCS_EN_AEN    0x02u
+#define TCS_EN_WEN    0x08u
+#define TCS_CFG_WLONG 0x02u
+#define TCS_ST_AVALID 0x01u
+#define TCS_ST_AINT   0x10u
+#define TCS_SF_CLR    0x06u
+
+static inline uint32_t tcs_cycles(const VDev_Tcs_t *d) { return 256u - d->reg[TCS_ATIME]; }
+static inline uint8_t  tcs_active(const VDev_Tcs_t *d)
+{
+    return (d->reg[TCS_ENABLE] & (TCS_EN_PON | TCS_EN_AEN)) == (TCS_EN_PON | TCS_EN_AEN);
+}
+static inline uint16_t tcs_get16(const VDev_Tcs_t *d, uint8_t reg)
+{
+    return (uint16_t)(d->reg[reg] | (d->reg[reg + 1u] << 8));
+}
+
+static float tcs_gain(const VDev_Tcs_t *d)
+{
+    static const float k_gain[4] = { 1.0f, 4.0f, 16.0f, 60.0f };
+    return k_gain[d->reg[TCS_CONTROL] & 0x03u];
+}
+
+/* Oczekiwanie po integracji (WEN) w µs */
+static uint64_t tcs_wait_us(const VDev_Tcs_t *d)
+{
+    if (!(d->reg[TCS_ENABLE] & TCS_EN_WEN)) return 0u;
+    uint64_t w = (uint64_t)(256u - d->reg[TCS_WTIME]) * VDEV_TCS_CYCLE_US;
+    return (d->reg[TCS_CONFIG] & TCS_CFG_WLONG) ? 12u * w : w;
+}
+
+/* PERS: ile kolejnych wyników poza progami potrzeba do AINT (0 = każdy wynik) */
+static uint8_t tcs_pers(const VDev_Tcs_t *d)
+{
+    const uint8_t p = d->reg[TCS_PERS] & 0x0Fu;
+    return (p <= 3u) ? p : (uint8_t)(5u * (p - 3u));
+}
+
+static void tcs_put16(VDev_Tcs_t *d, uint8_t reg, uint32_t v)
+{
+    d->reg[reg]      = (uint8_t)(v & 0xFFu);
+    d->reg[reg + 1u] = (uint8_t)(v >> 8);
+}
+
+/* Nowe okno integracji od t (po zmianie ATIME/CONTROL albo włączeniu) */
+static void tcs_restart(VDev_Tcs_t *d, uint64_t t)
+{
+    d->t_start = d->t_acc = t;
+    d->acc     = 0.0f;
+}
+
+/* Koniec okna: średnie odbicie → zliczenia C/R/G/B, flagi STATUS */
+static void tcs_latch(VDev_Tcs_t *d, float refl)
+{
+    d->noise = d->noise * 1103515245u + 12345u;
+    const float jitter = 1.0f + ((float)((d->noise >> 16) & 0xFFu) - 127.5f) * (0.01f / 127.5f);
+    const float fs = (float)((tcs_cycles(d) >= 64u) ? 65535u : 1024u * tcs_cycles(d));
+    float c = refl * VDEV_TCS_CNT_1X * tcs_gain(d) * (float)tcs_cycles(d) * jitter;
+    if (c > fs)   c = fs;
+    if (c < 0.0f) c = 0.0f;
+
+    tcs_put16(d, TCS_CDATAL,      (uint32_t)c);
+    tcs_put16(d, TCS_CDATAL + 2u, (uint32_t)(c * 0.40f));   // R
+    tcs_put16(d, TCS_CDATAL + 4u, (uint32_t)(c * 0.35f));   // G
+    tcs_put16(d, TCS_CDATAL + 6u, (uint32_t)(c * 0.30f));   // B
+    d->reg[TCS_STATUS] |= TCS_ST_AVALID;
+    d->cycles++;
+
+    const uint16_t cc = (uint16_t)c;
+    if (cc < tcs_get16(d, TCS_AILTL) || cc > tcs_get16(d, TCS_AIHTL)) {
+        if (d->pers_cnt < 0xFFu) d->pers_cnt++;
+    } else {
+        d->pers_cnt = 0u;
+    }
+    const uint8_t need = tcs_pers(d);
+    if (need == 0u || d->pers_cnt >= need) d->reg[TCS_STATUS] |= TCS_ST_AINT;
+}
+
+void VDev_Tcs_Update(VDev_Tcs_t *d)
+{
+    const uint64_t now = Host_NowUs();
+    if (!tcs_active(d)) return;
+
+    const uint64_t T      = (uint64_t)tcs_cycles(d) * VDEV_TCS_CYCLE_US;
+    const uint64_t period = T + tcs_wait_us(d);
+
+    if (now > d->t_start + 2u * period) {                // długa przerwa: wejście stałe → skok
+        const uint64_t k = (now - d->t_start) / period - 1u;
+        d->t_start += k * period;
+        d->cycles  += (uint32_t)k;
+        d->t_acc    = d->t_start;
+        d->acc      = 0.0f;
+    }
+    while (now > d->t_start) {
+        const uint64_t end = d->t_start + T;
+        if (d->t_acc < d->t_start) d->t_acc = d->t_start;
+        const uint64_t seg = (now < end) ? now : end;
+        d->acc  += d->in_refl * (float)(seg - d->t_acc);
+        d->t_acc = seg;
+        if (seg < end) break;
+        tcs_latch(d, d->acc / (float)T);
+        d->acc     = 0.0f;
+        d->t_start = end + (period - T);                 // oczekiwanie WTIME (albo 0)
+    }
+}
+
+static void tcs_write_reg(VDev_Tcs_t *d, uint8_t r, uint8_t v)
+{
+    const uint64_t now = Host_NowUs();
+    switch (r) {
+    case TCS_ENABLE: {
+        const uint8_t was = tcs_active(d), pon = d->reg[TCS_ENABLE] & TCS_EN_PON;
+        d->reg[TCS_ENABLE] = v & 0x1Bu;
+        if (!was && tcs_active(d)) tcs_restart(d, pon ? now : now + VDEV_TCS_CYCLE_US);   // rozgrzewka
+        if (!(v & TCS_EN_PON)) d->reg[TCS_STATUS] = 0u;
+        break;
+    }
+    case TCS_ATIME:
+    case TCS_CONTROL:
+        d->reg[r] = (r == TCS_CONTROL) ? (uint8_t)(v & 0x03u) : v;
+        if (tcs_active(d)) tcs_restart(d, now);
+        break;
+    case TCS_WTIME:
+    case TCS_AILTL: case TCS_AILTL + 1u:
+    case TCS_AIHTL: case TCS_AIHTL + 1u:
+    case TCS_PERS:
+    case TCS_CONFIG:
+        d->reg[r] = v;
+        break;
+    default:                                             // ID, STATUS, dane: tylko do odczytu
+        break;
+    }
+}
+
+static HAL_StatusTypeDef tcs_write(Host_I2CDev_t *io, const uint8_t *data, uint16_t n)
+{
+    VDev_Tcs_t *d = (VDev_Tcs_t *)io->ctx;
+    if (n == 0u) return HAL_OK;                          // sam adres (IsDeviceReady)
+    const uint8_t cmd = data[0];
+    if (!(cmd & 0x80u)) return HAL_ERROR;                // bez bitu CMD układ nie ACK-uje
+
+    const uint8_t type = (uint8_t)((cmd >> 5) & 0x03u);
+    if (type == 0x03u) {                                 // special function
+        if ((cmd & 0x1Fu) == TCS_SF_CLR) {
+            VDev_Tcs_Update(d);
+            d->reg[TCS_STATUS] &= (uint8_t)~TCS_ST_AINT;
+        }
+        return HAL_OK;
+    }
+    d->ptr     = cmd & 0x1Fu;
+    d->autoinc = (type == 0x01u);
+    for (uint16_t i = 1u; i < n; i++) {
+        VDev_Tcs_Update(d);                              // bieżąca integracja do starych ustawień
+        tcs_write_reg(d, d->ptr, data[i]);
+        if (d->autoinc) d->ptr = (uint8_t)((d->ptr + 1u) & 0x1Fu);
+    }
+    return HAL_OK;
+}
+
+static HAL_StatusTypeDef tcs_read(Host_I2CDev_t *io, uint8_t *data, uint16_t n)
+{
+    VDev_Tcs_t *d = (VDev_Tcs_t *)io->ctx;
+    VDev_Tcs_Update(d);
+    uint8_t p = d->ptr;
+    for (uint16_t i = 0u; i < n; i++) {
+        data[i] = d->reg[p];
+        if (d->autoinc) p = (uint8_t)((p + 1u) & 0x1Fu);
+    }
+    return HAL_OK;
+}
+
+void VDev_Tcs_Init(VDev_Tcs_t *d)
+{
+    for (uint32_t i = 0; i < sizeof(d->reg); i++) d->reg[i] = 0u;
+    d->io.write = tcs_write;
+    d->io.read  = tcs_read;
+    d->io.ctx   = d;
+    d->in_refl  = 0.0f;
+    d->reg[TCS_ATIME] = 0xFFu;                           // reset: 1 cykl
+    d->reg[TCS_WTIME] = 0xFFu;
+    d->reg[TCS_ID]    = VDEV_TCS_ID;
+    d->ptr = 0u; d->autoinc = 0u;
+    d->pers_cnt = 0u;
+    d->noise  = 0x2545F491u;
+    d->cycles = 0u;
+    tcs_restart(d, Host_NowUs());                        // ENABLE = 0: stoi do PON|AEN
+}
@@ -0,0 +1,114 @@
+#!/usr/bin/env python3
+"""
+sim.py — symulator robota i dohyo w pętli zamkniętej (prawdziwe app.c/tank_drive.c na PC).
+
+Kompiluje moduły Core/Src (bez CubeMX/HAL i crash.c) z Tools/host/ (zamiennik HAL, wirtualne
+I²C z modelami TF-Luna/TCS3472/SSD1306) i Tools/sim/ (fizyka), uruchamia i drukuje podsumowanie:
+    sim.py                                   # domyślny scenariusz: test jazdy od środka, 10 s
+    sim.py --pose 0.3,0,90 --opp charge,0.5,0.3,0.4 --time 8
+    sim.py --set motors.neutral_dwell_ms=60 --lockout 150
+    sim.py --sweep motors.ramp_step_pct=3,6,12 --sweep motors.esc_start_pct=10,20
+    sim.py --csv slad.csv --uart uart.txt    # ślad stanu i wyjście panelu UART
+    sim.py --fault luna_r=nak@4000-6000 --fault tcs_l=stretch:30000 --oled ekran.txt
+
+Opcje nieznane temu skryptowi idą wprost do sim_host (opis: Tools/sim/sim_main.c).
+--sweep: iloczyn kartezjański wartości pól configu, jeden przebieg na kombinację, tabela
+wyników. Kod wyjścia 1 = ring-out (pojedynczy przebieg) albo speedup poniżej --min-speedup.
+"""
+
+import argparse
+import itertools
+import os
+import re
+import subprocess
+import sys
+import tempfile
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+# Moduły aplikacji (bez CubeMX, HAL, crash.c — asembler ARM, bench.c — tylko DZB_BENCH)
+CORE = [
+    "app", "arena", "blackbox", "cfg_store", "color_class", "config", "debug_uart",
+    "drive_test", "dzlog", "edge_detect", "i2c_scan", "matchlog", "motor_bldc",
+    "oled_panel", "ramfunc", "sensor", "shell", "ssd1306", "stack_mon", "tank_drive",
+    "tcs3472", "tf_luna_i2c", "throttle_map",
+]
+HOST = ["Tools/host/host_port.c", "Tools/host/vdev_luna.c", "Tools/host/vdev_tcs.c",
+        "Tools/host/vdev_oled.c", "Tools/sim/sim_plant.c", "Tools/sim/sim_main.c"]
+
+RE_KV = re.compile(r'(\w+)=(\S+)')
+
+
+def build(cc, cflags):
+    exe = os.path.join(tempfile.mkdtemp(prefix="dzb_sim_"), "sim_host")
+    # -no-pie: _Min_Stack_Size to symbol absolutny (jak w skrypcie linkera targetu)
+    cmd = [cc, "-std=gnu11", "-DDZB_RAMFUNC=0", "-fno-pie", "-no-pie",
+           "-I" + os.path.join(ROOT, "Tools", "host"), "-I" + os.path.join(ROOT, "Tools", "sim"),
+           "-I" + os.path.join(ROOT, "Core", "Inc")] + cflags.split()
+    cmd += [os.path.join(ROOT, "Core", "Src", m + ".c") for m in CORE]
+    cmd += [os.path.join(ROOT, s) for s in HOST] + ["-o", exe, "-lm"]
+    r = subprocess.run(cmd, capture_output=True, text=True)
+    if r.returncode != 0:
+        sys.exit("kompilacja nieudana:\n" + " ".join(cmd) + "\n" + r.stderr)
+    return exe
+
+
+def run(exe, args):
+    """→ (kod wyjścia, słownik klucz → wartość z linii 'SIM ...')"""
+    r = subprocess.run([exe] + args, capture_output=True, text=True)
+    if r.returncode == 2:
+        sys.exit(r.stderr.strip())
+    res = {}
+    for line in r.stdout.splitlines():
+        if line.startswith("SIM "):
+            res.update(RE_KV.findall(line))
+    return r.returncode, res
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Symulator w pętli zamkniętej (host)",
+                                 epilog="pozostałe opcje → sim_host (Tools/sim/sim_main.c)")
+    ap.add_argument("--sweep", action="append", default=[], metavar="BLOK.POLE=V1,V2,...",
+                    help="przegląd wartości pola configu (można powtarzać)")
+    ap.add_argument("--min-speedup", type=float, default=100.0, help="minimalny stosunek sim/real")
+    ap.add_argument("--cc", default=os.environ.get("CC", "gcc"))
+    ap.add_argument("--cflags", default="-O2")
+    args, rest = ap.parse_known_args()
+
+    exe = build(args.cc, args.cflags)
+
+    if not args.sweep:
+        rc, res = run(exe, rest)
+        for k, v in res.items():
+            print("%-16s %s" % (k, v))
+        slow = float(res.get("speedup", 0)) < args.min_speedup
+        if slow:
+            print("\nspeedup %s < %.0f" % (res.get("speedup"), args.min_speedup))
+        sys.exit(1 if (rc != 0 or slow) else 0)
+
+    axes = []
+    for s in args.sweep:
+        name, _, vals = s.partition("=")
+        if not vals:
+            sys.exit("--sweep BLOK.POLE=V1,V2,...")
+        axes.append([(name, v) for v in vals.split(",")])
+
+    cols = ["ring_out", "t_out_s", "edge_det", "min_margin_m", "lat_neu_max_ms", "lat_rev_max_ms", "speedup"]
+    names = [a[0][0] for a in axes]
+    print(" ".join("%-22s" % n for n in names) + " " + " ".join("%14s" % c for c in cols))
+    slow = False
+    for combo in itertools.product(*axes):
+        extra = []
+        for name, v in combo:
+            extra += ["--set", "%s=%s" % (name, v)]
+        _, res = run(exe, rest + extra)
+        slow |= float(res.get("speedup", 0)) < args.min_speedup
+        print(" ".join("%-22s" % v for _, v in combo) + " " +
+              " ".join("%14s" % res.get(c, "-") for c in cols))
+    if slow:
+        print("\nspeedup poniżej %.0f w co najmniej jednym przebiegu" % args.min_speedup)
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
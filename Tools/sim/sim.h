@@ -0,0 +1,92 @@
+/*
+ * ============================================================================
+ *  SIM: sim.h — model fizyczny robota i dohyo do testów w pętli zamkniętej (host)
+ *  ----------------------------------------------------------------------------
+ *  CO:
+ *    - Napęd różnicowy: koła L/R, rozstaw track_m; prędkość z impulsu ESC (TIM1 CCR1 =
+ *      Right, CCR4 = Left) przez martwą strefę RC (±deadband_us wokół 1500 µs) i inercję
+ *      I rzędu (tau_s). Opcjonalna blokada wstecznego ESC (rev_lockout_ms): wsteczny
+ *      dopiero po tylu ms neutralu, wcześniej „wsteczny” = hamowanie.
+ *    - Dohyo: koło ring_r_m, biała krawędź edge_w_m; poza ringiem = ring-out.
+ *    - TCS3472 R/L (przednie narożniki): odbicie pod czujnikiem → vdev_tcs (zliczenia
+ *      liczy model rejestrowy z ATIME/gain ustawionych przez prawdziwy driver).
+ *    - TF-Luna R/L: promień od czujnika do przeciwnika (dysk) → dystans/amplituda vdev_luna.
+ *    - OLED SSD1306 na I2C1 (vdev_oled): obraz z prawdziwego oled_panel do podglądu.
+ *    - Sim_Device(nazwa) → urządzenie I²C do wstrzykiwania błędów (io.fault, host.h).
+ *    - Przeciwnik skryptowy: brak / stoi / szarżuje na robota / krąży; zderzenie = rozsunięcie.
+ *    - Statystyki: ring-out, najmniejszy zapas do krawędzi, latencja krawędź → neutral
+ *      i krawędź → ciąg wsteczny (z impulsów ESC, czyli przez cały kod app/edge/tank).
+ *
+ *  KIEDY:
+ *    - Sim_Init() przed App_Init() (przypina urządzenia do hi2c1/hi2c3), Sim_Step()
+ *      jako hook zegara hosta (Host_SetStepHook) — fizyka idzie też w HAL_Delay.
+ * ============================================================================
+ */
+
+#ifndef SIM_H_
+#define SIM_H_
+
+#include <stdint.h>
+#include "vdev.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    SIM_OPP_NONE = 0,
+    SIM_OPP_STATIC,            // stoi w (opp_x, opp_y)
+    SIM_OPP_CHARGE,            // jedzie na robota z opp_speed
+    SIM_OPP_CIRCLE,            // krąży wokół środka po promieniu |(opp_x, opp_y)|
+} Sim_OppMode_t;
+
+typedef struct {
+    /* robot */
+    float    track_m;          // rozstaw kół
+    float    body_r_m;         // promień obrysu (zapas do krawędzi, zderzenia)
+    float    vmax_mps;         // prędkość koła przy pełnym impulsie
+    float    tau_s;            // stała czasowa ESC+silnik (I rząd)
+    uint16_t deadband_us;      // martwa strefa ESC wokół 1500 µs
+    uint16_t rev_lockout_ms;   // 0 = brak blokady wstecznego
+    /* dohyo */
+    float    ring_r_m;         // promień (z krawędzią)
+    float    edge_w_m;         // szerokość białej krawędzi
+    float    refl_black, refl_white, refl_off;
+    /* przeciwnik */
+    Sim_OppMode_t opp;
+    float    opp_x, opp_y;     // pozycja startowa [m]
+    float    opp_speed;        // [m/s]
+} Sim_Params_t;
+
+typedef struct {
+    float    x, y, th;         // robot: środek [m], kurs [rad]
+    float    vl, vr;           // prędkości kół [m/s]
+    float    ox, oy;           // przeciwnik
+    uint16_t esc_r, esc_l;     // ostatnio widziane impulsy [µs]
+    float    refl_r, refl_l;   // odbicie pod czujnikami TCS
+    uint16_t luna_r, luna_l;   // dystans „prawdziwy” [cm] (0 = brak celu)
+    /* statystyki */
+    uint8_t  out;              // 1 = ring-out robota
+    uint64_t t_out_us;
+    uint8_t  opp_out;          // 1 = przeciwnik wypchnięty
+    float    min_margin_m;     // min(ring_r − |środek| − body_r)
+    uint32_t edges;            // wejścia czujnika na biel (zbocza)
+    uint32_t lat_n;            // zmierzone ucieczki
+    uint32_t lat_neu_max_us;   // krawędź → oba ESC bez ciągu naprzód
+    uint32_t lat_rev_max_us;   // krawędź → ciąg wsteczny (poza martwą strefą)
+    uint64_t lat_neu_sum_us, lat_rev_sum_us;
+} Sim_State_t;
+
+extern const Sim_Params_t SIM_DEFAULTS;
+
+void Sim_Init(const Sim_Params_t *p, float x, float y, float th_deg);
+void Sim_Step(uint32_t dt_us);
+const Sim_State_t* Sim_State(void);
+/* "tcs_r", "tcs_l", "luna_r", "luna_l", "oled" → urządzenie (NULL = nieznana nazwa) */
+Host_I2CDev_t*     Sim_Device(const char *name);
+const VDev_Oled_t* Sim_Oled(void);
+
+#ifdef __cplusplus
+}
+#endif
+#endif /* SIM_H_ */
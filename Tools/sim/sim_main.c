@@ -0,0 +1,241 @@
+/*
+ * ============================================================================
+ *  SIM: sim_main.c — symulator w pętli zamkniętej: prawdziwe App_Init/App_Tick na PC
+ *  ----------------------------------------------------------------------------
+ *  Użycie: sim_host [opcje]   (zwykle przez Tools/sim.py)
+ *    --time S              czas symulacji [s] (domyślnie 10, liczony od startu — z armingiem ESC)
+ *    --pose X,Y,DEG        poza startowa robota [m, m, °]            (0,0,0)
+ *    --opp none|static|charge|circle[,X,Y[,V]]   przeciwnik            (none)
+ *    --deadband US | --tau S | --vmax MPS | --lockout MS   parametry ESC/silnika
+ *    --set blok.pole=V     pole configu (jak shell "set"), przed App_Init
+ *    --cmd T_MS:"polecenie"  linia do shella UART w chwili T_MS
+ *    --loop US             okres iteracji pętli głównej [µs]         (100)
+ *    --csv PLIK [--csv-ms N]  ślad stanu co N ms (domyślnie 10)
+ *    --uart PLIK           zapis wyjścia USART2 (panel, logi)
+ *    --fault DEV=RODZAJ[@T0-T1]   błąd I²C urządzenia DEV (tcs_r|tcs_l|luna_r|luna_l|oled)
+ *                          w oknie [T0, T1) ms (bez okna: cały przebieg); RODZAJ:
+ *                          nak | nak:PROC | stuck | stretch:US   (opis: Tools/host/host.h)
+ *    --oled PLIK           zrzut ekranu OLED na koniec (64 × 128 znaków, '#' = świeci)
+ *
+ *  Wynik: linie "SIM klucz=wartość" (parsowane przez Tools/sim.py). Kod wyjścia:
+ *  0 = OK, 1 = ring-out robota, 2 = błąd argumentów.
+ * ============================================================================
+ */
+
+#include "sim.h"
+#include "host.h"
+#include "app.h"
+#include "config.h"
+#include "edge_detect.h"
+#include "motor_bldc.h"
+#include "usart.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define SIM_MAX_CMDS    16u
+#define SIM_MAX_FAULTS  8u
+
+typedef struct {
+    uint32_t    t_ms;
+    const char *text;
+} SimCmd_t;
+
+typedef struct {
+    Host_I2CDev_t  *dev;
+    Host_I2CFault_t f;
+    uint32_t        t0_ms, t1_ms;
+} SimFault_t;
+
+static FILE *s_uartFile = NULL;
+
+static void sim_uart_sink(UART_HandleTypeDef *h, const uint8_t *data, uint16_t n)
+{
+    if (h == &huart2 && s_uartFile) (void)fwrite(data, 1u, n, s_uartFile);
+}
+
+static int sim_usage(const char *msg)
+{
+    fprintf(stderr, "sim_host: %s (opis opcji: Tools/sim/sim_main.c)\n", msg);
+    return 2;
+}
+
+static double sim_wall_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static int sim_parse_opp(const char *arg, Sim_Params_t *p)
+{
+    char mode[16] = {0};
+    float x = p->opp_x, y = p->opp_y, v = p->opp_speed;
+    if (sscanf(arg, "%15[a-z],%f,%f,%f", mode, &x, &y, &v) < 1) return 0;
+    if      (!strcmp(mode, "none"))   p->opp = SIM_OPP_NONE;
+    else if (!strcmp(mode, "static")) p->opp = SIM_OPP_STATIC;
+    else if (!strcmp(mode, "charge")) p->opp = SIM_OPP_CHARGE;
+    else if (!strcmp(mode, "circle")) p->opp = SIM_OPP_CIRCLE;
+    else return 0;
+    p->opp_x = x; p->opp_y = y; p->opp_speed = v;
+    return 1;
+}
+
+/* DEV=nak|nak:PROC|stuck|stretch:US[@T0-T1] (urządzenia istnieją dopiero po Sim_Init) */
+static int sim_parse_fault(const char *arg, SimFault_t *sf)
+{
+    char dev[16] = {0}, kind[16] = {0};
+    unsigned long val = 0u, t0 = 0u, t1 = 0xFFFFFFFFu;
+    if (sscanf(arg, "%15[a-z_]=%15[a-z]", dev, kind) != 2) return 0;
+    const char *c = strchr(arg, ':'), *at = strchr(arg, '@');
+    const uint8_t has_val = (c && (!at || c < at)) ? 1u : 0u;
+    if (has_val) val = strtoul(c + 1, NULL, 0);
+    if (at && sscanf(at + 1, "%lu-%lu", &t0, &t1) != 2) return 0;
+
+    memset(sf, 0, sizeof(*sf));
+    if (!(sf->dev = Sim_Device(dev))) return 0;
+    if      (!strcmp(kind, "nak") && has_val) sf->f.nak_pct = (uint8_t)(val > 100u ? 100u : val);
+    else if (!strcmp(kind, "nak"))       sf->f.nak = 1u;
+    else if (!strcmp(kind, "stuck"))     sf->f.stuck = 1u;
+    else if (!strcmp(kind, "stretch"))   sf->f.stretch_us = (uint32_t)val;
+    else return 0;
+    sf->t0_ms = (uint32_t)t0; sf->t1_ms = (uint32_t)t1;
+    return 1;
+}
+
+/* Błędy aktywne w chwili now_ms; kilka wpisów na jedno urządzenie sumuje się */
+static void sim_apply_faults(const SimFault_t *sf, uint32_t n, uint32_t now_ms)
+{
+    for (uint32_t k = 0; k < n; k++) memset(&sf[k].dev->fault, 0, sizeof(sf[k].dev->fault));
+    for (uint32_t k = 0; k < n; k++) {
+        if (now_ms < sf[k].t0_ms || now_ms >= sf[k].t1_ms) continue;
+        Host_I2CFault_t *f = &sf[k].dev->fault;
+        f->nak   |= sf[k].f.nak;
+        f->stuck |= sf[k].f.stuck;
+        if (sf[k].f.nak_pct > f->nak_pct)       f->nak_pct = sf[k].f.nak_pct;
+        if (sf[k].f.stretch_us > f->stretch_us) f->stretch_us = sf[k].f.stretch_us;
+    }
+}
+
+static int sim_apply_set(const char *arg)
+{
+    char path[48];
+    const char *eq = strchr(arg, '=');
+    if (!eq || (size_t)(eq - arg) >= sizeof(path)) return 0;
+    memcpy(path, arg, (size_t)(eq - arg));
+    path[eq - arg] = '\0';
+    const CFG_Field_t *f = CFG_FieldFind(path);
+    return (f && CFG_FieldSet(f, strtof(eq + 1, NULL))) ? 1 : 0;
+}
+
+int main(int argc, char **argv)
+{
+    Sim_Params_t p = SIM_DEFAULTS;
+    float    t_s = 10.0f, x = 0.0f, y = 0.0f, th = 0.0f;
+    uint32_t loop_us = 100u, csv_ms = 10u;
+    const char *csv_path = NULL, *uart_path = NULL, *oled_path = NULL;
+    const char *fault_arg[SIM_MAX_FAULTS];
+    SimCmd_t   cmds[SIM_MAX_CMDS];
+    SimFault_t faults[SIM_MAX_FAULTS];
+    uint32_t   ncmd = 0u, nfault = 0u;
+
+    for (int i = 1; i < argc; i++) {
+        const char *o = argv[i];
+        const char *v = (i + 1 < argc) ? argv[i + 1] : NULL;
+        if (!v) return sim_usage("brak wartości opcji");
+        i++;
+        if      (!strcmp(o, "--time"))     t_s = strtof(v, NULL);
+        else if (!strcmp(o, "--pose"))   { if (sscanf(v, "%f,%f,%f", &x, &y, &th) != 3) return sim_usage("--pose X,Y,DEG"); }
+        else if (!strcmp(o, "--opp"))    { if (!sim_parse_opp(v, &p)) return sim_usage("--opp"); }
+        else if (!strcmp(o, "--deadband")) p.deadband_us = (uint16_t)strtoul(v, NULL, 0);
+        else if (!strcmp(o, "--tau"))      p.tau_s = strtof(v, NULL);
+        else if (!strcmp(o, "--vmax"))     p.vmax_mps = strtof(v, NULL);
+        else if (!strcmp(o, "--lockout"))  p.rev_lockout_ms = (uint16_t)strtoul(v, NULL, 0);
+        else if (!strcmp(o, "--loop"))     loop_us = (uint32_t)strtoul(v, NULL, 0);
+        else if (!strcmp(o, "--csv"))      csv_path = v;
+        else if (!strcmp(o, "--csv-ms"))   csv_ms = (uint32_t)strtoul(v, NULL, 0);
+        else if (!strcmp(o, "--uart"))     uart_path = v;
+        else if (!strcmp(o, "--oled"))     oled_path = v;
+        else if (!strcmp(o, "--fault")) {
+            if (nfault >= SIM_MAX_FAULTS) return sim_usage("--fault: za dużo wpisów");
+            fault_arg[nfault++] = v;
+        }
+        else if (!strcmp(o, "--set"))    { if (!sim_apply_set(v)) return sim_usage("--set: nieznane pole lub poza zakresem"); }
+        else if (!strcmp(o, "--cmd")) {
+            const char *c = strchr(v, ':');
+            if (!c || ncmd >= SIM_MAX_CMDS) return sim_usage("--cmd T_MS:tekst");
+            cmds[ncmd].t_ms = (uint32_t)strtoul(v, NULL, 0);
+            cmds[ncmd].text = c + 1;
+            ncmd++;
+        }
+        else return sim_usage("nieznana opcja");
+    }
+    if (loop_us == 0u) loop_us = 1u;
+    if (csv_ms == 0u)  csv_ms = 1u;
+
+    FILE *csv = NULL;
+    if (csv_path && !(csv = fopen(csv_path, "w")))        return sim_usage("nie można otworzyć --csv");
+    if (uart_path && !(s_uartFile = fopen(uart_path, "wb"))) return sim_usage("nie można otworzyć --uart");
+    if (csv) fprintf(csv, "t_ms,x,y,th_deg,vl,vr,esc_r,esc_l,refl_r,refl_l,luna_r,luna_l,edge,ox,oy\n");
+
+    const double   wall0 = sim_wall_s();
+    const uint64_t end   = (uint64_t)((double)t_s * 1e6);
+
+    Host_UartSetSink(sim_uart_sink);
+    Sim_Init(&p, x, y, th);
+    for (uint32_t k = 0; k < nfault; k++) {
+        if (!sim_parse_fault(fault_arg[k], &faults[k])) return sim_usage("--fault DEV=nak|nak:PROC|stuck|stretch:US[@T0-T1]");
+    }
+    sim_apply_faults(faults, nfault, 0u);
+    Host_SetStepHook(Sim_Step);
+    App_Init();                                           // w tym ESC_ArmNeutral(3000) — fizyka już liczy
+
+    uint32_t nextCsv = 0u;
+    while (Host_NowUs() < end && !Sim_State()->out) {
+        const uint32_t now_ms = (uint32_t)(Host_NowUs() / 1000u);
+        for (uint32_t k = 0; k < ncmd; k++) {
+            if (cmds[k].text && now_ms >= cmds[k].t_ms) {
+                (void)Host_UartInject(cmds[k].text);
+                (void)Host_UartInject("\r");
+                cmds[k].text = NULL;
+            }
+        }
+        sim_apply_faults(faults, nfault, now_ms);
+        App_Tick();
+        Host_AdvanceUs(loop_us);
+
+        if (csv && now_ms >= nextCsv) {
+            const Sim_State_t *s = Sim_State();
+            nextCsv = now_ms + csv_ms;
+            fprintf(csv, "%lu,%.4f,%.4f,%.1f,%.3f,%.3f,%u,%u,%.2f,%.2f,%u,%u,%u,%.4f,%.4f\n",
+                    (unsigned long)now_ms, s->x, s->y, s->th * 57.29578f, s->vl, s->vr,
+                    (unsigned)s->esc_r, (unsigned)s->esc_l, s->refl_r, s->refl_l,
+                    (unsigned)s->luna_r, (unsigned)s->luna_l, (unsigned)Edge_Flags(), s->ox, s->oy);
+        }
+    }
+
+    const double wall = sim_wall_s() - wall0;
+    const double sim  = (double)Host_NowUs() * 1e-6;
+    const Sim_State_t *s = Sim_State();
+
+    printf("SIM sim_s=%.3f wall_s=%.3f speedup=%.0f\n", sim, wall, (wall > 0.0) ? sim / wall : 0.0);
+    printf("SIM ring_out=%u t_out_s=%.3f opp_out=%u\n", (unsigned)s->out, (double)s->t_out_us * 1e-6, (unsigned)s->opp_out);
+    printf("SIM edge_hits=%lu edge_det=%lu min_margin_m=%.3f\n",
+           (unsigned long)s->edges, (unsigned long)Edge_Count(), (double)s->min_margin_m);
+    printf("SIM escapes=%lu lat_neu_avg_ms=%.1f lat_neu_max_ms=%.1f lat_rev_avg_ms=%.1f lat_rev_max_ms=%.1f\n",
+           (unsigned long)s->lat_n,
+           s->lat_n ? (double)s->lat_neu_sum_us / s->lat_n * 1e-3 : 0.0, s->lat_neu_max_us * 1e-3,
+           s->lat_n ? (double)s->lat_rev_sum_us / s->lat_n * 1e-3 : 0.0, s->lat_rev_max_us * 1e-3);
+    printf("SIM pose_x=%.3f pose_y=%.3f pose_deg=%.1f\n", s->x, s->y, s->th * 57.29578f);
+    const VDev_Oled_t *o = Sim_Oled();
+    printf("SIM oled_on=%u oled_cmd=%lu oled_data=%lu oled_bad=%lu\n", (unsigned)o->on,
+           (unsigned long)o->n_cmd, (unsigned long)o->n_data, (unsigned long)o->n_bad);
+
+    FILE *of = oled_path ? fopen(oled_path, "w") : NULL;
+    if (of) { VDev_Oled_Dump(o, of); fclose(of); }
+
+    if (csv) fclose(csv);
+    if (s_uartFile) fclose(s_uartFile);
+    return s->out ? 1 : 0;
+}
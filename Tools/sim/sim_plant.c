@@ -0,0 +1,290 @@
+/*
+ * ============================================================================
+ *  SIM: sim_plant.c — fizyka robota, dohyo, przeciwnik i synteza czujników
+ *  ----------------------------------------------------------------------------
+ *  CO:
+ *    - Sim_Step(dt): impulsy ESC z TIM1 → prędkości kół (martwa strefa + I rząd)
+ *      → kinematyka różnicowa → przeciwnik → wejścia vdev (TCS: odbicie, Luna: promień).
+ *    - Układ: x w prawo, y w górę, kurs th od osi x (CCW); lewe koło po +y robota.
+ *    - Latencja krawędzi liczona od chwili, gdy czujnik TCS wjeżdża z czerni na biel.
+ * ============================================================================
+ */
+
+#include "sim.h"
+#include "vdev.h"
+#include "i2c.h"
+#include <math.h>
+#include <string.h>
+
+#define SIM_PI          3.14159265f
+#define SIM_OPP_R       0.10f          // promień przeciwnika [m]
+#define SIM_ESC_NEU     1500
+#define SIM_ESC_SPAN    500
+#define SIM_BRAKE_TAU   0.3f           // hamowanie ESC = tau × 0.3
+#define SIM_LAT_GIVEUP  2000000u       // ucieczka bez ciągu wstecznego po 2 s = pominięta
+
+/* Montaż czujników (układ robota: x do przodu, y w lewo) */
+#define SIM_TCS_FWD     0.09f
+#define SIM_TCS_LAT     0.07f
+#define SIM_LUNA_FWD    0.08f
+#define SIM_LUNA_LAT    0.05f
+#define SIM_LUNA_YAW    (10.0f * SIM_PI / 180.0f)   // na zewnątrz
+
+const Sim_Params_t SIM_DEFAULTS = {
+    .track_m = 0.16f, .body_r_m = 0.10f, .vmax_mps = 2.0f, .tau_s = 0.12f,
+    .deadband_us = 60u, .rev_lockout_ms = 0u,
+    .ring_r_m = 0.77f, .edge_w_m = 0.05f,
+    .refl_black = 0.04f, .refl_white = 0.80f, .refl_off = 0.02f,
+    .opp = SIM_OPP_NONE, .opp_x = 0.4f, .opp_y = 0.0f, .opp_speed = 0.5f,
+};
+
+typedef struct {
+    float    v;                // prędkość koła [m/s]
+    uint32_t neu_us;           // czas ciągłego neutralu (blokada wstecznego)
+    uint8_t  rev_ok;           // wsteczny odblokowany
+} SimWheel_t;
+
+static Sim_Params_t s_p;
+static Sim_State_t  s_st;
+static SimWheel_t   s_wl, s_wr;
+static uint64_t     s_now;
+static float        s_oppAng;
+
+static VDev_Tcs_t   s_tcsR, s_tcsL;
+static VDev_Luna_t  s_lunaR, s_lunaL;
+static VDev_Oled_t  s_oled;
+
+/* Krawędź: zdarzenie w toku */
+static uint8_t  s_onWhite;     // bit0 = R, bit1 = L (poprzedni krok)
+static uint8_t  s_ev, s_evNeu;
+static uint64_t s_evT0;
+
+/* ==== ESC + silnik ==== */
+
+/* Impuls → wysterowanie −1..1 (martwa strefa wokół neutralu; brak impulsu = neutral) */
+static float sim_esc_u(uint32_t pulse)
+{
+    if (pulse == 0u) return 0.0f;
+    const int32_t d  = (int32_t)pulse - SIM_ESC_NEU;
+    const int32_t db = (int32_t)s_p.deadband_us;
+    const int32_t a  = (d < 0) ? -d : d;
+    if (a <= db) return 0.0f;
+    float u = (float)(a - db) / (float)(SIM_ESC_SPAN - db);
+    if (u > 1.0f) u = 1.0f;
+    return (d < 0) ? -u : u;
+}
+
+static void sim_wheel(SimWheel_t *w, uint32_t pulse, float dt, uint32_t dt_us)
+{
+    float u = sim_esc_u(pulse);
+    float tau = s_p.tau_s;
+
+    if (s_p.rev_lockout_ms) {
+        if (u == 0.0f) {
+            w->neu_us += dt_us;
+            if (w->neu_us >= (uint32_t)s_p.rev_lockout_ms * 1000u) w->rev_ok = 1u;
+        } else {
+            w->neu_us = 0u;
+            if (u > 0.0f) w->rev_ok = 0u;
+        }
+        if (u < 0.0f && !w->rev_ok) { u = 0.0f; tau *= SIM_BRAKE_TAU; }   // „wsteczny” = hamulec
+    }
+    const float target = u * s_p.vmax_mps;
+    w->v += (target - w->v) * (dt / (tau + dt));      // I rząd (dyskretnie, stabilnie)
+}
+
+/* ==== Dohyo / czujniki ==== */
+
+static float sim_refl(float px, float py)
+{
+    const float r = sqrtf(px * px + py * py);
+    if (r > s_p.ring_r_m)                 return s_p.refl_off;
+    if (r > s_p.ring_r_m - s_p.edge_w_m)  return s_p.refl_white;
+    return s_p.refl_black;
+}
+
+/* Punkt czujnika w układzie świata */
+static void sim_mount(float fwd, float lat, float *px, float *py)
+{
+    const float c = cosf(s_st.th), s = sinf(s_st.th);
+    *px = s_st.x + fwd * c - lat * s;
+    *py = s_st.y + fwd * s + lat * c;
+}
+
+/* Promień lidaru do dysku przeciwnika; 0 = brak trafienia */
+static uint16_t sim_ray(float lat, float yaw)
+{
+    if (s_p.opp == SIM_OPP_NONE || s_st.opp_out) return 0u;
+    float sx, sy;
+    sim_mount(SIM_LUNA_FWD, lat, &sx, &sy);
+    const float dx = cosf(s_st.th + yaw), dy = sinf(s_st.th + yaw);
+    const float ox = s_st.ox - sx, oy = s_st.oy - sy;
+    const float t  = ox * dx + oy * dy;
+    const float p2 = ox * ox + oy * oy - t * t;
+    if (t <= 0.0f || p2 > SIM_OPP_R * SIM_OPP_R) return 0u;
+    const float d = t - sqrtf(SIM_OPP_R * SIM_OPP_R - p2);
+    return (d > 0.0f) ? (uint16_t)(d * 100.0f + 0.5f) : 1u;
+}
+
+static void sim_luna(VDev_Luna_t *L, uint16_t cm)
+{
+    L->in_dist_cm = cm;
+    L->in_amp     = cm ? (uint16_t)(200000u / (cm + 10u)) : 40u;   // brak celu → słaby sygnał
+    if (cm && L->in_amp > 60000u) L->in_amp = 60000u;
+}
+
+/* ==== Przeciwnik ==== */
+
+static void sim_opponent(float dt)
+{
+    if (s_p.opp == SIM_OPP_NONE || s_st.opp_out) return;
+
+    if (s_p.opp == SIM_OPP_CHARGE) {
+        const float dx = s_st.x - s_st.ox, dy = s_st.y - s_st.oy;
+        const float d  = sqrtf(dx * dx + dy * dy);
+        if (d > 1e-3f) { s_st.ox += dx / d * s_p.opp_speed * dt; s_st.oy += dy / d * s_p.opp_speed * dt; }
+    } else if (s_p.opp == SIM_OPP_CIRCLE) {
+        const float rad = sqrtf(s_p.opp_x * s_p.opp_x + s_p.opp_y * s_p.opp_y);
+        if (rad > 1e-3f) s_oppAng += s_p.opp_speed / rad * dt;
+        s_st.ox = rad * cosf(s_oppAng);
+        s_st.oy = rad * sinf(s_oppAng);
+    }
+
+    /* Zderzenie: rozsunięcie po połowie zachodzenia (równe masy) */
+    const float dx = s_st.ox - s_st.x, dy = s_st.oy - s_st.y;
+    const float d  = sqrtf(dx * dx + dy * dy);
+    const float lim = s_p.body_r_m + SIM_OPP_R;
+    if (d < lim && d > 1e-4f) {
+        const float k = (lim - d) * 0.5f / d;
+        s_st.ox += dx * k; s_st.oy += dy * k;
+        if (!s_st.out) { s_st.x -= dx * k; s_st.y -= dy * k; }
+    }
+    if (sqrtf(s_st.ox * s_st.ox + s_st.oy * s_st.oy) > s_p.ring_r_m) s_st.opp_out = 1u;
+}
+
+/* ==== Latencja krawędź → ESC ==== */
+
+static void sim_edge_latency(void)
+{
+    const uint8_t white = (uint8_t)((s_st.refl_r >= s_p.refl_white ? 1u : 0u) |
+                                    (s_st.refl_l >= s_p.refl_white ? 2u : 0u));
+    const uint8_t rise  = (uint8_t)(white & (uint8_t)~s_onWhite);
+    s_onWhite = white;
+    if (rise) s_st.edges++;
+    if (rise && !s_ev) { s_ev = 1u; s_evNeu = 0u; s_evT0 = s_now; }
+    if (!s_ev) return;
+
+    const uint32_t lat = (uint32_t)(s_now - s_evT0);
+    const uint16_t fwd = (uint16_t)(SIM_ESC_NEU + s_p.deadband_us);
+    const uint16_t rev = (uint16_t)(SIM_ESC_NEU - s_p.deadband_us);
+    if (!s_evNeu && s_st.esc_r <= fwd && s_st.esc_l <= fwd) {
+        s_evNeu = 1u;
+        s_st.lat_neu_sum_us += lat;
+        if (lat > s_st.lat_neu_max_us) s_st.lat_neu_max_us = lat;
+    }
+    if (s_evNeu && ((s_st.esc_r && s_st.esc_r < rev) || (s_st.esc_l && s_st.esc_l < rev))) {
+        s_ev = 0u;
+        s_st.lat_n++;
+        s_st.lat_rev_sum_us += lat;
+        if (lat > s_st.lat_rev_max_us) s_st.lat_rev_max_us = lat;
+    } else if (lat > SIM_LAT_GIVEUP) {
+        s_ev = 0u;                                        // brak ucieczki (np. ring-out)
+    }
+}
+
+/* ==== API ==== */
+
+void Sim_Init(const Sim_Params_t *p, float x, float y, float th_deg)
+{
+    s_p = p ? *p : SIM_DEFAULTS;
+    memset(&s_st, 0, sizeof(s_st));
+    memset(&s_wl, 0, sizeof(s_wl));
+    memset(&s_wr, 0, sizeof(s_wr));
+    s_st.x = x; s_st.y = y; s_st.th = th_deg * SIM_PI / 180.0f;
+    s_st.ox = s_p.opp_x; s_st.oy = s_p.opp_y;
+    s_st.min_margin_m = s_p.ring_r_m;
+    s_oppAng = atan2f(s_p.opp_y, s_p.opp_x);
+    s_now = 0u; s_onWhite = 0u; s_ev = 0u;
+
+    /* Czujniki jak w config.c: Right na I2C1, Left na I2C3 */
+    VDev_Tcs_Init(&s_tcsR);   VDev_Tcs_Init(&s_tcsL);
+    VDev_Luna_Init(&s_lunaR); VDev_Luna_Init(&s_lunaL);
+    VDev_Oled_Init(&s_oled);
+    (void)Host_I2C_Attach(&hi2c1, VDEV_TCS_ADDR,  &s_tcsR.io);
+    (void)Host_I2C_Attach(&hi2c3, VDEV_TCS_ADDR,  &s_tcsL.io);
+    (void)VDev_Luna_Attach(&s_lunaR, &hi2c1, VDEV_LUNA_ADDR);
+    (void)VDev_Luna_Attach(&s_lunaL, &hi2c3, VDEV_LUNA_ADDR);
+    (void)Host_I2C_Attach(&hi2c1, VDEV_OLED_ADDR, &s_oled.io);
+    Sim_Step(0u);                                         // wejścia czujników od startu
+}
+
+void Sim_Step(uint32_t dt_us)
+{
+    const float dt = (float)dt_us * 1e-6f;
+    s_now += dt_us;
+
+    s_st.esc_r = (uint16_t)TIM1->CCR1;                    // CH1 = Right
+    s_st.esc_l = (uint16_t)TIM1->CCR4;                    // CH4 = Left
+
+    if (!s_st.out) {
+        sim_wheel(&s_wr, s_st.esc_r, dt, dt_us);
+        sim_wheel(&s_wl, s_st.esc_l, dt, dt_us);
+        s_st.vr = s_wr.v; s_st.vl = s_wl.v;
+
+        const float v = 0.5f * (s_st.vr + s_st.vl);
+        const float w = (s_st.vr - s_st.vl) / s_p.track_m;
+        s_st.x  += v * cosf(s_st.th) * dt;
+        s_st.y  += v * sinf(s_st.th) * dt;
+        s_st.th += w * dt;
+    }
+    sim_opponent(dt);
+
+    const float rc = sqrtf(s_st.x * s_st.x + s_st.y * s_st.y);
+    const float margin = s_p.ring_r_m - rc - s_p.body_r_m;
+    if (margin < s_st.min_margin_m) s_st.min_margin_m = margin;
+    if (!s_st.out && rc > s_p.ring_r_m) {
+        s_st.out = 1u; s_st.t_out_us = s_now;
+        s_st.vl = s_st.vr = 0.0f;
+    }
+
+    /* Czujniki → modele rejestrowe */
+    float px, py;
+    sim_mount(SIM_TCS_FWD, -SIM_TCS_LAT, &px, &py); s_st.refl_r = sim_refl(px, py);
+    sim_mount(SIM_TCS_FWD,  SIM_TCS_LAT, &px, &py); s_st.refl_l = sim_refl(px, py);
+    VDev_Tcs_Update(&s_tcsR);                             // okno integracji do starego wejścia
+    VDev_Tcs_Update(&s_tcsL);
+    s_tcsR.in_refl = s_st.refl_r;
+    s_tcsL.in_refl = s_st.refl_l;
+
+    s_st.luna_r = sim_ray(-SIM_LUNA_LAT, -SIM_LUNA_YAW);
+    s_st.luna_l = sim_ray( SIM_LUNA_LAT,  SIM_LUNA_YAW);
+    VDev_Luna_Update(&s_lunaR);                           // ramki do „teraz” ze starym celem
+    VDev_Luna_Update(&s_lunaL);
+    sim_luna(&s_lunaR, s_st.luna_r);
+    sim_luna(&s_lunaL, s_st.luna_l);
+
+    sim_edge_latency();
+}
+
+const Sim_State_t* Sim_State(void)
+{
+    return &s_st;
+}
+
+Host_I2CDev_t* Sim_Device(const char *name)
+{
+    static const struct { const char *name; Host_I2CDev_t *io; } k_dev[] = {
+        { "tcs_r",  &s_tcsR.io  }, { "tcs_l",  &s_tcsL.io  },
+        { "luna_r", &s_lunaR.io }, { "luna_l", &s_lunaL.io },
+        { "oled",   &s_oled.io  },
+    };
+    for (uint32_t i = 0; i < sizeof(k_dev) / sizeof(k_dev[0]); i++) {
+        if (strcmp(name, k_dev[i].name) == 0) return k_dev[i].io;
+    }
+    return NULL;
+}
+
+const VDev_Oled_t* Sim_Oled(void)
+{
+    return &s_oled;
+}
@@ -0,0 +1,216 @@
+#!/usr/bin/env python3
+"""
+stack_report.py — statyczna analiza stosu: ramki funkcji i najgłębsze łańcuchy wywołań.
+
+Kompilacja (CubeIDE → Properties → C/C++ Build → Settings → MCU GCC Compiler →
+Miscellaneous → Other flags):
+    -fstack-usage -fcallgraph-info=su
+Obok każdego .o powstaje .su (ramka funkcji) i .ci (graf wywołań, VCG, GCC ≥ 10).
+
+Użycie:
+    stack_report.py Debug                       # katalog builda (rekurencyjnie *.su / *.ci)
+    stack_report.py Debug --top 15 --ld STM32L432KCUX_FLASH.ld
+    stack_report.py Debug --lib vsnprintf=900   # koszt funkcji bez .su (biblioteki)
+
+Wynik:
+    - największe ramki (B, "dyn" = alloca/VLA — wartość to tylko część stała),
+    - najgłębszy łańcuch z main() i z każdego handlera przerwań (*_Handler / *_IRQHandler),
+    - szacunek MSP: main + najgłębsze ISR + ramka wyjątku (FPU: 104 B),
+      wariant pesymistyczny: wszystkie ISR zagnieżdżone naraz,
+    - porównanie z _Min_Stack_Size ze skryptu linkera i z pomiarem "stack=" z panelu UART.
+Wywołania pośrednie (wskaźniki na funkcje) i rekurencja są tylko zgłaszane — łańcuch
+przez nie liczony jest do miejsca przerwania.
+"""
+
+import argparse
+import os
+import re
+import sys
+
+EXC_FRAME_FPU = 104          # ramka wyjątku z kontekstem FPU (lazy stacking rezerwuje miejsce)
+
+# Oszacowania newlib-nano (brak .su dla bibliotek) — nadpisywane przez --lib
+LIB_COST = {
+    "vsnprintf": 600, "snprintf": 600, "_vsnprintf_r": 600, "_svfprintf_r": 560,
+    "memcpy": 16, "memset": 16, "strlen": 8, "strcmp": 16, "strtof": 200,
+    "__aeabi_memcpy": 16, "__aeabi_memset": 16, "__aeabi_memclr": 16,
+}
+
+RE_NODE = re.compile(r'node:\s*\{\s*title:\s*"([^"]+)"\s*label:\s*"([^"]*)"')
+RE_EDGE = re.compile(r'edge:\s*\{\s*sourcename:\s*"([^"]+)"\s*targetname:\s*"([^"]+)"')
+RE_BYTES = re.compile(r'\\n(\d+) bytes \(([^)]*)\)')
+
+
+def scan(build_dir):
+    su, ci = [], []
+    for root, _, files in os.walk(build_dir):
+        for f in files:
+            if f.endswith(".su"):
+                su.append(os.path.join(root, f))
+            elif f.endswith(".ci"):
+                ci.append(os.path.join(root, f))
+    return sorted(su), sorted(ci)
+
+
+def parse_su(paths):
+    """(plik, funkcja) → (bajty, kwalifikator)"""
+    out = {}
+    for p in paths:
+        base = os.path.splitext(os.path.basename(p))[0]
+        with open(p, encoding="utf-8", errors="replace") as fh:
+            for line in fh:
+                parts = line.rstrip("\n").split("\t")
+                if len(parts) < 3:
+                    continue
+                name = parts[0].rsplit(":", 1)[-1]
+                out[(base, name)] = (int(parts[1]), parts[2])
+    return out
+
+
+def parse_ci(paths):
+    """węzły zdefiniowane: (plik, nazwa) → (bajty, kwal.); krawędzie: (plik, źródło) → [cel]"""
+    nodes, edges = {}, {}
+    for p in paths:
+        base = os.path.splitext(os.path.basename(p))[0]
+        with open(p, encoding="utf-8", errors="replace") as fh:
+            text = fh.read()
+        for title, label in RE_NODE.findall(text):
+            m = RE_BYTES.search(label)
+            if m:
+                nodes[(base, title)] = (int(m.group(1)), m.group(2))
+        for src, dst in RE_EDGE.findall(text):
+            edges.setdefault((base, src), []).append(dst)
+    return nodes, edges
+
+
+def min_stack_from_ld(path):
+    if not path or not os.path.exists(path):
+        return None
+    with open(path, encoding="utf-8", errors="replace") as fh:
+        m = re.search(r'_Min_Stack_Size\s*=\s*(0x[0-9a-fA-F]+|\d+)', fh.read())
+    return int(m.group(1), 0) if m else None
+
+
+class Graph:
+    def __init__(self, nodes, edges, lib):
+        self.nodes, self.edges, self.lib = nodes, edges, lib
+        self.by_name = {}
+        for (f, n) in nodes:
+            self.by_name.setdefault(n, []).append((f, n))
+        self.memo = {}
+        self.indirect, self.recursive, self.unknown = set(), set(), set()
+
+    def resolve(self, f, name, path):
+        """static z tego samego pliku ma pierwszeństwo; przy kilku kandydatach — największy"""
+        if (f, name) in self.nodes:
+            return (f, name)
+        cands = self.by_name.get(name, [])
+        if not cands:
+            return None
+        return max(cands, key=lambda k: self.worst(k, path)[0])
+
+    def worst(self, key, path):
+        """(koszt, łańcuch) najgłębszej ścieżki od węzła key"""
+        if key in self.memo:
+            return self.memo[key]
+        if key in path:
+            self.recursive.add(key[1])
+            return (0, [])
+        frame = self.nodes[key][0]
+        best = (0, [])
+        for dst in self.edges.get(key, []):
+            if dst.startswith("__indirect"):
+                self.indirect.add(key[1])
+                continue
+            k2 = self.resolve(key[0], dst, path + (key,))
+            if k2 is None:
+                cost = self.lib.get(dst)
+                if cost is None:
+                    self.unknown.add(dst)
+                    cost = 0
+                cand = (cost, [(dst, cost, "lib")])
+            else:
+                cand = self.worst(k2, path + (key,))
+            if cand[0] > best[0]:
+                best = cand
+        res = (frame + best[0], [(key[1], frame, key[0])] + best[1])
+        self.memo[key] = res
+        return res
+
+
+def fmt_chain(chain):
+    # funkcje static mają w .ci tytuł "ścieżka/plik.c:nazwa"
+    return " → ".join("%s(%d)" % (n.rsplit(":", 1)[-1], b) for n, b, _ in chain)
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Raport stosu z -fstack-usage / -fcallgraph-info=su")
+    ap.add_argument("build", help="katalog builda (np. Debug)")
+    ap.add_argument("--top", type=int, default=10, help="liczba największych ramek")
+    ap.add_argument("--ld", default="STM32L432KCUX_FLASH.ld", help="skrypt linkera (_Min_Stack_Size)")
+    ap.add_argument("--lib", action="append", default=[], metavar="NAZWA=B",
+                    help="koszt funkcji bez .su (np. vsnprintf=900)")
+    args = ap.parse_args()
+
+    su_paths, ci_paths = scan(args.build)
+    if not su_paths:
+        sys.exit("brak plików .su w %s — zbuduj z -fstack-usage" % args.build)
+    frames = parse_su(su_paths)
+    lib = dict(LIB_COST)
+    for kv in args.lib:
+        name, _, val = kv.partition("=")
+        lib[name] = int(val, 0)
+
+    print("== Największe ramki (%d funkcji) ==" % len(frames))
+    for (f, n), (b, q) in sorted(frames.items(), key=lambda kv: -kv[1][0])[:args.top]:
+        print("  %6d B  %-32s %s%s" % (b, n, f, "" if q == "static" else "  [" + q + "]"))
+
+    if not ci_paths:
+        print("\n(brak .ci — dodaj -fcallgraph-info=su, by policzyć łańcuchy wywołań)")
+        return
+
+    nodes, edges = parse_ci(ci_paths)
+    g = Graph(nodes, edges, lib)
+    roots_isr = sorted(k for k in nodes if k[1].endswith("_Handler") or k[1].endswith("_IRQHandler"))
+    roots_isr = [k for k in roots_isr if k[1] != "Reset_Handler"]
+    mains = g.by_name.get("main", [])
+
+    total_main = 0
+    print("\n== Najgłębszy łańcuch z main() ==")
+    if mains:
+        total_main, chain = g.worst(mains[0], ())
+        print("  %6d B  %s" % (total_main, fmt_chain(chain)))
+    else:
+        print("  (brak main w .ci)")
+
+    print("\n== Przerwania (łańcuch + %d B ramki wyjątku) ==" % EXC_FRAME_FPU)
+    isr = []
+    for k in roots_isr:
+        cost, chain = g.worst(k, ())
+        isr.append((cost + EXC_FRAME_FPU, k[1], chain))
+    isr.sort(reverse=True)
+    for cost, name, chain in isr[:args.top]:
+        print("  %6d B  %s" % (cost, fmt_chain(chain)))
+
+    worst_isr = isr[0][0] if isr else 0
+    all_isr = sum(c for c, _, _ in isr)
+    print("\n== Szacunek MSP ==")
+    print("  main + najgłębsze ISR          : %6d B" % (total_main + worst_isr))
+    print("  main + wszystkie ISR naraz     : %6d B  (pesymistycznie, bez priorytetów)" % (total_main + all_isr))
+    reserve = min_stack_from_ld(args.ld)
+    if reserve is not None:
+        need = total_main + worst_isr
+        print("  _Min_Stack_Size (%s)   : %6d B  → %s" % (os.path.basename(args.ld), reserve,
+              "OK" if need <= reserve else "ZA MAŁO o %d B" % (need - reserve)))
+    print("  porównaj z pomiarem: panel UART 'stack=użyte/rezerwa' lub 'dump mem'")
+
+    if g.indirect:
+        print("\n! wywołania pośrednie (pominięte): " + ", ".join(sorted(g.indirect)))
+    if g.recursive:
+        print("! rekurencja (łańcuch ucięty): " + ", ".join(sorted(g.recursive)))
+    if g.unknown:
+        print("! bez .su i bez --lib (liczone jako 0): " + ", ".join(sorted(g.unknown)))
+
+
+if __name__ == "__main__":
+    main()
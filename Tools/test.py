@@ -0,0 +1,94 @@
+#!/usr/bin/env python3
+"""
+test.py — testy modułów na PC (Tools/host/test_*.c z prawdziwymi modułami Core/Src).
+
+Każdy test to osobny program: plik Tools/host/test_<nazwa>.c + moduły z TESTS + zamiennik
+HAL (Tools/host/host_port.c: zegar wirtualny, I²C z modelami, FLASH w RAM):
+    test.py                       # wszystkie testy
+    test.py edge cfg_store        # wybrane
+    test.py --cflags "-O0 -g -fsanitize=address,undefined"
+
+Wynik: linie "TEST <przypadek> OK|FAIL" (+ "FAIL plik:linia …" przy porażce).
+Kod wyjścia 1 = błąd kompilacji albo co najmniej jeden test czerwony.
+"""
+
+import argparse
+import os
+import subprocess
+import sys
+import tempfile
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+# test → moduły Core/Src (bez .c) + dodatkowe pliki Tools/host; libs = opcje linkera
+TESTS = {
+    "edge": {
+        "core": ["edge_detect", "tcs3472", "tank_drive", "motor_bldc", "throttle_map", "config", "ramfunc"],
+        "host": ["Tools/host/vdev_tcs.c"],
+    },
+    "cfg_store": {
+        "core": ["cfg_store", "config"],
+    },
+    "blackbox": {
+        "core": ["blackbox"],
+    },
+    "seqlock": {
+        "core": [],
+        "libs": ["-pthread"],
+    },
+}
+
+
+def build(name, spec, cc, cflags, outdir):
+    exe = os.path.join(outdir, "test_" + name)
+    # -no-pie: _Min_Stack_Size to symbol absolutny (jak w skrypcie linkera targetu)
+    cmd = [cc, "-std=gnu11", "-DDZB_RAMFUNC=0", "-fno-pie", "-no-pie", "-Wall", "-Wextra",
+           "-I" + os.path.join(ROOT, "Tools", "host"), "-I" + os.path.join(ROOT, "Core", "Inc")]
+    cmd += cflags.split()
+    cmd += [os.path.join(ROOT, "Core", "Src", m + ".c") for m in spec["core"]]
+    cmd += [os.path.join(ROOT, s) for s in spec.get("host", [])]
+    cmd += [os.path.join(ROOT, "Tools", "host", "host_port.c"),
+            os.path.join(ROOT, "Tools", "host", "test_%s.c" % name), "-o", exe, "-lm"]
+    cmd += spec.get("libs", [])
+    r = subprocess.run(cmd, capture_output=True, text=True)
+    if r.returncode != 0:
+        print("kompilacja %s nieudana:\n%s\n%s" % (name, " ".join(cmd), r.stderr))
+        return None
+    return exe
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Testy modułów na PC")
+    ap.add_argument("names", nargs="*", help="testy do uruchomienia (domyślnie wszystkie)")
+    ap.add_argument("--cc", default=os.environ.get("CC", "gcc"))
+    ap.add_argument("--cflags", default="-O1")
+    args = ap.parse_args()
+
+    names = args.names or list(TESTS)
+    unknown = [n for n in names if n not in TESTS]
+    if unknown:
+        sys.exit("nieznane testy: %s (są: %s)" % (", ".join(unknown), ", ".join(TESTS)))
+
+    outdir = tempfile.mkdtemp(prefix="dzb_test_")
+    failed = []
+    for name in names:
+        exe = build(name, TESTS[name], args.cc, args.cflags, outdir)
+        if not exe:
+            failed.append(name)
+            continue
+        # testy wołające narzędzia Pythona (blackbox → bb_decode.py) dostają interpreter i katalog repo
+        env = dict(os.environ, DZB_PYTHON=sys.executable, DZB_ROOT=ROOT)
+        r = subprocess.run([exe], capture_output=True, text=True, env=env)
+        sys.stdout.write(r.stdout)
+        if r.returncode != 0:
+            sys.stdout.write(r.stderr)
+            failed.append(name)
+        print("== %-12s %s" % (name, "FAIL" if r.returncode != 0 else "OK"))
+
+    if failed:
+        print("\nczerwone: %s" % ", ".join(failed))
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()